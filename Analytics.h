@@ -2,11 +2,12 @@
 #define ANALYTICS_H
 
 #include <Arduino.h>
-#include <Preferences.h>
 #include <time.h>
 #include "config.h"
 #include "EventQueue.h"
 #include "IntervalTimer.h"
+#include "NvsWriteLog.h"
+#include "QuantileSketch.h"
 
 // ============================================
 // Daily Stats Structure (compact for NVS storage)
@@ -20,6 +21,18 @@ struct DailyStats {
     bool valid;               // Is this entry valid?
 };
 
+// ============================================
+// Session distributions (all time, not reset at midnight)
+// ============================================
+enum SessionSketch : uint8_t {
+    SKETCH_FOCUS,      // Focus session length, seconds
+    SKETCH_PAUSES,     // Pauses within one focus session
+    SKETCH_BREAK,      // Break length, seconds
+    SKETCH_COUNT
+};
+
+static const uint8_t SESSION_SKETCH_BYTES = SKETCH_COUNT * QuantileSketch::SERIALIZED_SIZE;
+
 // ============================================
 // Weekly Report Structure
 // ============================================
@@ -48,13 +61,24 @@ public:
     
     // Recording events
     void recordTaskCompleted();
-    void recordFocusSession(uint16_t minutes);
-    void recordBreakSession(uint16_t minutes);
+    void recordFocusSession(uint16_t minutes, uint16_t seconds, uint8_t pauses);
+    void recordBreakSession(uint16_t minutes, uint16_t seconds);
+
+    // Journal replay: today's counters as a boot snapshot recorded them
+    void restoreToday(uint8_t tasks, uint16_t focusMins, uint16_t breakMins, uint8_t sessions);
+
+    // Backup restore: history replaced, today's stats only if the backup is from today;
+    // sketches (SESSION_SKETCH_BYTES, as getSketchBytes) kept when nullptr
+    void restoreBackup(const DailyStats& today, const char* date, const DailyStats (&history)[7],
+                       const uint8_t* sketchBytes);
     
     // Queries
     DailyStats getTodayStats();
     DailyStats getDayStats(uint8_t daysAgo);  // 0=today, 1=yesterday, etc.
+    DailyStats getHistoryDay(uint8_t dayOfWeek) const { return weekHistory[dayOfWeek % 7]; }
     WeeklyReport getWeeklyReport();
+    const QuantileSketch& getSketch(SessionSketch which) const { return sketches[which]; }
+    void getSketchBytes(uint8_t* out) const;
     
     // Time utilities
     bool isTimeValid();
@@ -70,7 +94,7 @@ public:
     void onMidnight(MidnightCallback callback) { midnightCallback = callback; }
 
 private:
-    Preferences prefs;
+    TracedPreferences prefs;
     
     // Current day tracking
     uint8_t currentDayOfWeek;
@@ -84,6 +108,10 @@ private:
     
     // Week history (7 days)
     DailyStats weekHistory[7];
+
+    // Session distributions, saved with today's stats when they changed
+    QuantileSketch sketches[SKETCH_COUNT];
+    bool sketchesChanged;
     
     // Midnight callback
     MidnightCallback midnightCallback;
@@ -93,7 +121,9 @@ private:
     void loadFromNVS();
     void saveToNVS();
     void saveDayToHistory(DailyStats& stats);
+    void putHistoryDay(uint8_t day, const DailyStats& stats);  // prefs already open
     void loadWeekHistory();
+    void loadSketches();
     void checkMidnight();
     void performDailyReset();
     String getDayName(uint8_t day);
@@ -109,6 +139,7 @@ Analytics::Analytics()
     currentDayOfWeek = 0;
     lastSaveTime = 0;
     statsChanged = false;
+    sketchesChanged = false;
     midnightCallback = nullptr;
     pendingMidnightCallback = false;
     
@@ -151,6 +182,7 @@ void Analytics::begin() {
     // Load saved data
     loadFromNVS();
     loadWeekHistory();
+    loadSketches();
     
     // Reset timer
     midnightCheckTimer.reset();
@@ -159,7 +191,7 @@ void Analytics::begin() {
 }
 
 void Analytics::loop() {
-    uint32_t now = millis();
+    uint32_t now = clockMillis();
     
     // Check if we need to fire a pending midnight callback (day changed at boot)
     if (pendingMidnightCallback) {
@@ -190,22 +222,40 @@ void Analytics::recordTaskCompleted() {
     todayStats.tasksCompleted++;
     todayStats.valid = true;
     statsChanged = true;
+    eventQueue.push(Event::STATS_CHANGED);
     DEBUG_PRINTF("Analytics: Task completed (total today: %d)\n", todayStats.tasksCompleted);
 }
 
-void Analytics::recordFocusSession(uint16_t minutes) {
+void Analytics::recordFocusSession(uint16_t minutes, uint16_t seconds, uint8_t pauses) {
     todayStats.focusMinutes += minutes;
     todayStats.sessionsCount++;
+    sketches[SKETCH_FOCUS].add(seconds);
+    sketches[SKETCH_PAUSES].add(pauses);
+    sketchesChanged = true;
     todayStats.valid = true;
     statsChanged = true;
+    eventQueue.push(Event::STATS_CHANGED);
     DEBUG_PRINTF("Analytics: Focus session +%d min (total: %d min)\n", 
                  minutes, todayStats.focusMinutes);
 }
 
-void Analytics::recordBreakSession(uint16_t minutes) {
+void Analytics::recordBreakSession(uint16_t minutes, uint16_t seconds) {
     todayStats.breakMinutes += minutes;
+    sketches[SKETCH_BREAK].add(seconds);
+    sketchesChanged = true;
+    todayStats.valid = true;
+    statsChanged = true;
+    eventQueue.push(Event::STATS_CHANGED);
+}
+
+void Analytics::restoreToday(uint8_t tasks, uint16_t focusMins, uint16_t breakMins, uint8_t sessions) {
+    todayStats.tasksCompleted = tasks;
+    todayStats.focusMinutes = focusMins;
+    todayStats.breakMinutes = breakMins;
+    todayStats.sessionsCount = sessions;
     todayStats.valid = true;
     statsChanged = true;
+    eventQueue.push(Event::STATS_CHANGED);
 }
 
 DailyStats Analytics::getTodayStats() {
@@ -354,6 +404,13 @@ void Analytics::saveToNVS() {
     prefs.putUShort("sBreak", todayStats.breakMinutes);
     prefs.putUChar("sSessions", todayStats.sessionsCount);
     
+    if (sketchesChanged) {
+        uint8_t blob[SESSION_SKETCH_BYTES];
+        getSketchBytes(blob);
+        prefs.putBytes("sketches", blob, sizeof(blob));
+        sketchesChanged = false;
+    }
+    
     prefs.end();
     
     DEBUG_PRINTLN("Analytics: Saved to NVS");
@@ -361,10 +418,24 @@ void Analytics::saveToNVS() {
 
 void Analytics::saveDayToHistory(DailyStats& stats) {
     prefs.begin(NVS_NAMESPACE, false);
+    putHistoryDay(stats.dayOfWeek, stats);
+    prefs.end();
+    
+    // Also update RAM
+    weekHistory[stats.dayOfWeek] = stats;
     
+    DEBUG_PRINTF("Analytics: Saved day %d to history\n", stats.dayOfWeek);
+}
+
+void Analytics::putHistoryDay(uint8_t day, const DailyStats& stats) {
     // Save to the appropriate day slot
     char key[12];
-    uint8_t day = stats.dayOfWeek;
+    
+    snprintf(key, sizeof(key), "h%dValid", day);
+    if (!stats.valid) {
+        prefs.putBool(key, false);
+        return;
+    }
     
     snprintf(key, sizeof(key), "h%dTasks", day);
     prefs.putUChar(key, stats.tasksCompleted);
@@ -380,13 +451,42 @@ void Analytics::saveDayToHistory(DailyStats& stats) {
     
     snprintf(key, sizeof(key), "h%dValid", day);
     prefs.putBool(key, true);
-    
+}
+
+void Analytics::restoreBackup(const DailyStats& today, const char* date, const DailyStats (&history)[7],
+                              const uint8_t* sketchBytes) {
+    for (uint8_t day = 0; day < 7; day++) {
+        weekHistory[day] = history[day];
+        weekHistory[day].dayOfWeek = day;
+    }
+
+    if (currentDateStr == date) {
+        todayStats = today;
+    } else {
+        // An older "today" is history by now
+        if (today.valid && today.dayOfWeek < 7) weekHistory[today.dayOfWeek] = today;
+        todayStats = {(uint8_t)currentDayOfWeek, 0, 0, 0, 0, false};
+    }
+    todayStats.dayOfWeek = currentDayOfWeek;
+
+    if (sketchBytes) {
+        for (uint8_t i = 0; i < SKETCH_COUNT; i++) {
+            sketches[i].load(sketchBytes + i * QuantileSketch::SERIALIZED_SIZE);
+        }
+        sketchesChanged = true;
+    }
+
+    prefs.begin(NVS_NAMESPACE, false);
+    for (uint8_t day = 0; day < 7; day++) {
+        putHistoryDay(day, weekHistory[day]);
+    }
     prefs.end();
-    
-    // Also update RAM
-    weekHistory[day] = stats;
-    
-    DEBUG_PRINTF("Analytics: Saved day %d to history\n", day);
+    saveToNVS();
+    statsChanged = false;
+    lastSaveTime = clockMillis();
+
+    DEBUG_PRINTF("Analytics: Backup restored (from %s)\n", date);
+    eventQueue.push(Event::STATS_CHANGED);
 }
 
 void Analytics::loadWeekHistory() {
@@ -420,6 +520,26 @@ void Analytics::loadWeekHistory() {
     DEBUG_PRINTLN("Analytics: Week history loaded");
 }
 
+void Analytics::getSketchBytes(uint8_t* out) const {
+    for (uint8_t i = 0; i < SKETCH_COUNT; i++) {
+        sketches[i].save(out + i * QuantileSketch::SERIALIZED_SIZE);
+    }
+}
+
+void Analytics::loadSketches() {
+    uint8_t blob[SESSION_SKETCH_BYTES];
+    prefs.begin(NVS_NAMESPACE, true);
+    bool found = prefs.getBytesLength("sketches") == sizeof(blob) &&
+                 prefs.getBytes("sketches", blob, sizeof(blob)) == sizeof(blob);
+    prefs.end();
+    
+    for (uint8_t i = 0; i < SKETCH_COUNT; i++) {
+        if (!found || !sketches[i].load(blob + i * QuantileSketch::SERIALIZED_SIZE)) sketches[i].reset();
+    }
+    DEBUG_PRINTF("Analytics: Session sketches %s (%d focus sessions)\n",
+                 found ? "loaded" : "empty", sketches[SKETCH_FOCUS].getCount());
+}
+
 void Analytics::checkMidnight() {
     if (!isTimeValid()) return;
     
@@ -459,6 +579,7 @@ void Analytics::performDailyReset() {
     todayStats = {0, 0, 0, 0, 0, false};
     statsChanged = true;
     saveToNVS();
+    eventQueue.push(Event::STATS_CHANGED);
 }
 
 void Analytics::forceDailyReset() {
@@ -0,0 +1,431 @@
+#ifndef BACKUP_ARCHIVE_H
+#define BACKUP_ARCHIVE_H
+
+/**
+ * ============================================
+ * BackupArchive - Tasks, plant and analytics in one file
+ * ============================================
+ *
+ * GET /api/backup streams the archive, POST /api/restore takes it back.
+ * Both sides work on a BackupImage (~750 bytes): the writer encodes it
+ * through a 256-byte chunk, the reader decodes the body as it arrives
+ * from the socket, so neither ever holds the archive itself.
+ *
+ * Archive: [magic "BLBK"][version u8] records... END
+ * Record:  [tag u8][len u8][payload], little-endian fields
+ * END:     CRC32 (zlib) of every byte before its payload
+ *
+ * A newer version is refused; unknown tags and trailing payload bytes
+ * of known ones are skipped, so a minor addition only needs a new tag.
+ *
+ * Restore is all or nothing: nothing is touched until the END record
+ * checks out. The validated image is then put in NVS as one blob,
+ * applied, and removed; a reset in between rolls it forward at boot
+ * (resumeBackupRestore), so the cube never keeps half a backup.
+ */
+
+#include <Arduino.h>
+#include <esp_rom_crc.h>
+#include "config.h"
+#include "SystemState.h"
+#include "Analytics.h"
+#include "NvsWriteLog.h"
+
+enum BackupRecord : uint8_t {
+    BK_PLANT = 1,    // stage, withered, pending, watered, daily goal, session goal
+    BK_TASK  = 2,    // id u32, focus u16, break u16, flags u8 (1 done, 2 started), name
+    BK_TODAY = 3,    // day of week, tasks u8, focus u16, break u16, sessions u8, date
+    BK_DAY   = 4,    // History day, same fields without the date
+    BK_SKETCHES = 5, // Session quantile sketches (Analytics::getSketchBytes)
+    BK_END   = 0xFF  // CRC32 u32
+};
+
+static const uint8_t BACKUP_MAGIC[4] = {'B', 'L', 'B', 'K'};
+static const uint8_t BACKUP_VERSION = 1;
+
+struct BackupImage {
+    uint8_t plantStage;
+    bool plantWithered;
+    uint8_t pendingWater;
+    uint8_t wateredCount;
+    uint8_t dailyGoal;
+    uint8_t sessionGoal;
+
+    TaskInfo tasks[MAX_TASKS];
+    uint8_t taskCount;
+
+    char statsDate[11];       // "YYYY-MM-DD" of today (empty: no record)
+    DailyStats today;
+    DailyStats history[7];    // By day of week
+
+    bool hasSketches;         // Archives from before the sketches have none
+    uint8_t sketches[SESSION_SKETCH_BYTES];
+};
+
+// ============================================
+// Writer
+// ============================================
+class BackupWriter {
+public:
+    typedef std::function<void(const uint8_t* data, size_t length)> Sink;
+
+    // No sink: only counts (Content-Length)
+    explicit BackupWriter(Sink sink = nullptr) : sink(sink) {}
+
+    // Returns the archive size
+    size_t write(const BackupImage& image) {
+        used = 0;
+        total = 0;
+        crc = 0;
+
+        put(BACKUP_MAGIC, sizeof(BACKUP_MAGIC));
+        put(BACKUP_VERSION);
+
+        start(BK_PLANT, 6);
+        put(image.plantStage);
+        put(image.plantWithered ? 1 : 0);
+        put(image.pendingWater);
+        put(image.wateredCount);
+        put(image.dailyGoal);
+        put(image.sessionGoal);
+
+        for (uint8_t i = 0; i < image.taskCount; i++) {
+            const TaskInfo& task = image.tasks[i];
+            uint8_t nameLength = strnlen(task.name, TASK_NAME_MAX_LENGTH - 1);
+            start(BK_TASK, 9 + nameLength);
+            put32(task.id);
+            put16(task.focusDuration);
+            put16(task.breakDuration);
+            put((task.completed ? 1 : 0) | (task.started ? 2 : 0));
+            put((const uint8_t*)task.name, nameLength);
+        }
+
+        if (image.today.valid) {
+            uint8_t dateLength = strnlen(image.statsDate, sizeof(image.statsDate) - 1);
+            start(BK_TODAY, 7 + dateLength);
+            putDay(image.today);
+            put((const uint8_t*)image.statsDate, dateLength);
+        }
+
+        for (uint8_t day = 0; day < 7; day++) {
+            if (!image.history[day].valid) continue;
+            start(BK_DAY, 7);
+            putDay(image.history[day]);
+        }
+
+        if (image.hasSketches) {
+            start(BK_SKETCHES, SESSION_SKETCH_BYTES);
+            put(image.sketches, SESSION_SKETCH_BYTES);
+        }
+
+        start(BK_END, 4);
+        uint32_t sum = crc;
+        put32(sum);
+        flush();
+        return total;
+    }
+
+private:
+    static const size_t CHUNK_SIZE = 256;
+
+    Sink sink;
+    uint8_t chunk[CHUNK_SIZE];
+    size_t used = 0;
+    size_t total = 0;
+    uint32_t crc = 0;
+
+    void put(const uint8_t* data, size_t length) {
+        crc = esp_rom_crc32_le(crc, data, length);
+        total += length;
+        if (!sink) return;
+        while (length > 0) {
+            size_t n = min(length, CHUNK_SIZE - used);
+            memcpy(chunk + used, data, n);
+            used += n;
+            data += n;
+            length -= n;
+            if (used == CHUNK_SIZE) flush();
+        }
+    }
+
+    void put(uint8_t value) { put(&value, 1); }
+    void put16(uint16_t value) { put(value & 0xFF); put(value >> 8); }
+    void put32(uint32_t value) { put16(value & 0xFFFF); put16(value >> 16); }
+
+    void start(BackupRecord tag, uint8_t length) {
+        put(tag);
+        put(length);
+    }
+
+    void putDay(const DailyStats& day) {
+        put(day.dayOfWeek);
+        put(day.tasksCompleted);
+        put16(day.focusMinutes);
+        put16(day.breakMinutes);
+        put(day.sessionsCount);
+    }
+
+    void flush() {
+        if (sink && used > 0) sink(chunk, used);
+        used = 0;
+    }
+};
+
+// ============================================
+// Reader (fed as the body arrives)
+// ============================================
+class BackupReader {
+public:
+    void begin(BackupImage& target) {
+        image = &target;
+        memset(image, 0, sizeof(BackupImage));
+        stage = HEADER;
+        have = 0;
+        crc = 0;
+        bytes = 0;
+        hasPlant = false;
+        error = nullptr;
+    }
+
+    // False once the archive is known to be bad
+    bool feed(const uint8_t* data, size_t length) {
+        for (size_t i = 0; i < length && stage != FAILED; i++) {
+            if (!(stage == PAYLOAD && tag == BK_END)) {
+                crc = esp_rom_crc32_le(crc, &data[i], 1);
+            }
+            bytes++;
+            consume(data[i]);
+        }
+        return stage != FAILED;
+    }
+
+    // End of body: true if the image is complete and checked
+    bool finish() {
+        if (stage == FAILED) return false;
+        if (stage != DONE) return fail(bytes == 0 ? "Empty body" : "Archive truncated");
+        if (!hasPlant) return fail("No plant record");
+        return true;
+    }
+
+    void abort(const char* reason) { fail(reason); }
+
+    const char* getError() const { return error ? error : "Archive incomplete"; }
+    uint32_t getBytes() const { return bytes; }
+
+private:
+    enum Stage : uint8_t { HEADER, RECORD_HEAD, PAYLOAD, DONE, FAILED };
+
+    BackupImage* image = nullptr;
+    uint8_t buffer[255];
+    uint8_t have = 0;
+    uint8_t length = 0;
+    uint8_t tag = 0;
+    Stage stage = FAILED;
+    uint32_t crc = 0;
+    uint32_t bytes = 0;
+    bool hasPlant = false;
+    const char* error = nullptr;
+
+    bool fail(const char* reason) {
+        if (stage != FAILED) {
+            stage = FAILED;
+            error = reason;
+            DEBUG_PRINTF("Backup: Rejected at byte %u - %s\n", (unsigned)bytes, reason);
+        }
+        return false;
+    }
+
+    void consume(uint8_t b) {
+        switch (stage) {
+            case HEADER:
+                buffer[have++] = b;
+                if (have < sizeof(BACKUP_MAGIC) + 1) return;
+                if (memcmp(buffer, BACKUP_MAGIC, sizeof(BACKUP_MAGIC)) != 0) {
+                    fail("Not a backup archive");
+                } else if (buffer[4] > BACKUP_VERSION) {
+                    fail("Archive from newer firmware");
+                } else {
+                    stage = RECORD_HEAD;
+                    have = 0;
+                }
+                return;
+
+            case RECORD_HEAD:
+                buffer[have++] = b;
+                if (have < 2) return;
+                tag = buffer[0];
+                length = buffer[1];
+                have = 0;
+                if (tag == BK_END && length != 4) {
+                    fail("Bad end record");
+                } else if (length == 0) {
+                    handleRecord();
+                } else {
+                    stage = PAYLOAD;
+                }
+                return;
+
+            case PAYLOAD:
+                buffer[have++] = b;
+                if (have < length) return;
+                have = 0;
+                stage = RECORD_HEAD;
+                handleRecord();
+                return;
+
+            case DONE:
+                fail("Data after end record");
+                return;
+
+            case FAILED:
+                return;
+        }
+    }
+
+    uint16_t get16(uint8_t at) const { return buffer[at] | (buffer[at + 1] << 8); }
+    uint32_t get32(uint8_t at) const { return get16(at) | ((uint32_t)get16(at + 2) << 16); }
+
+    bool getDay(DailyStats& day) {
+        if (buffer[0] > 6) return fail("Bad day of week");
+        day.dayOfWeek = buffer[0];
+        day.tasksCompleted = buffer[1];
+        day.focusMinutes = get16(2);
+        day.breakMinutes = get16(4);
+        day.sessionsCount = buffer[6];
+        day.valid = true;
+        return true;
+    }
+
+    void handleRecord() {
+        switch (tag) {
+            case BK_PLANT:
+                if (length < 6) { fail("Short plant record"); return; }
+                if (buffer[0] >= PLANT_STAGES) { fail("Bad plant stage"); return; }
+                image->plantStage = buffer[0];
+                image->plantWithered = buffer[1] != 0;
+                image->pendingWater = buffer[2];
+                image->wateredCount = buffer[3];
+                image->dailyGoal = buffer[4];
+                image->sessionGoal = buffer[5];
+                hasPlant = true;
+                return;
+
+            case BK_TASK: {
+                if (length < 9 + 1) { fail("Short task record"); return; }
+                uint8_t nameLength = length - 9;
+                if (nameLength > TASK_NAME_MAX_LENGTH - 1) { fail("Task name too long"); return; }
+                if (image->taskCount >= MAX_TASKS) { fail("Too many tasks"); return; }
+                uint32_t id = get32(0);
+                for (uint8_t i = 0; i < image->taskCount; i++) {
+                    if (image->tasks[i].id == id) { fail("Duplicate task id"); return; }
+                }
+                TaskInfo& task = image->tasks[image->taskCount++];
+                task.id = id;
+                task.focusDuration = get16(4);
+                task.breakDuration = get16(6);
+                task.completed = buffer[8] & 1;
+                task.started = buffer[8] & 2;
+                memcpy(task.name, buffer + 9, nameLength);
+                task.name[nameLength] = '\0';
+                return;
+            }
+
+            case BK_TODAY: {
+                if (length < 7) { fail("Short today record"); return; }
+                uint8_t dateLength = length - 7;
+                if (dateLength > sizeof(image->statsDate) - 1) { fail("Bad date"); return; }
+                if (!getDay(image->today)) return;
+                memcpy(image->statsDate, buffer + 7, dateLength);
+                image->statsDate[dateLength] = '\0';
+                return;
+            }
+
+            case BK_DAY: {
+                if (length < 7) { fail("Short day record"); return; }
+                DailyStats day;
+                if (getDay(day)) image->history[day.dayOfWeek] = day;
+                return;
+            }
+
+            case BK_SKETCHES:
+                if (length < SESSION_SKETCH_BYTES) { fail("Short sketch record"); return; }
+                memcpy(image->sketches, buffer, SESSION_SKETCH_BYTES);
+                image->hasSketches = true;
+                return;
+
+            case BK_END:
+                if (get32(0) != crc) { fail("Checksum mismatch"); return; }
+                stage = DONE;
+                return;
+
+            default:
+                return;  // Newer minor record: skipped
+        }
+    }
+};
+
+// ============================================
+// Capture / apply
+// ============================================
+
+inline void captureBackup(BackupImage& image, SystemState& state, Analytics& analytics) {
+    memset(&image, 0, sizeof(image));
+
+    PlantInfo plant = state.getPlantInfo();
+    image.plantStage = plant.stage;
+    image.plantWithered = plant.isWithered;
+    image.pendingWater = state.getPendingWaterCount();
+    image.wateredCount = plant.wateredCount;
+    image.dailyGoal = state.getDailyGoal();
+    image.sessionGoal = state.getSessionGoal();
+
+    image.taskCount = state.getTaskCount();
+    memcpy(image.tasks, state.getTasks(), image.taskCount * sizeof(TaskInfo));
+
+    image.today = analytics.getTodayStats();
+    strlcpy(image.statsDate, analytics.getCurrentDateString().c_str(), sizeof(image.statsDate));
+    for (uint8_t day = 0; day < 7; day++) {
+        image.history[day] = analytics.getHistoryDay(day);
+    }
+    analytics.getSketchBytes(image.sketches);
+    image.hasSketches = true;
+}
+
+inline void applyBackup(const BackupImage& image, SystemState& state, Analytics& analytics) {
+    state.restoreBackup(image.plantStage, image.plantWithered, image.pendingWater, image.wateredCount,
+                        image.dailyGoal, image.sessionGoal, image.tasks, image.taskCount);
+    analytics.restoreBackup(image.today, image.statsDate, image.history,
+                            image.hasSketches ? image.sketches : nullptr);
+}
+
+// Stage, apply, unstage
+inline void commitBackup(const BackupImage& image, SystemState& state, Analytics& analytics) {
+    TracedPreferences prefs;
+    prefs.begin(NVS_RESTORE_NAMESPACE, false);
+    prefs.putBytes("image", &image, sizeof(image));
+    prefs.end();
+
+    applyBackup(image, state, analytics);
+
+    prefs.begin(NVS_RESTORE_NAMESPACE, false);
+    prefs.remove("image");
+    prefs.end();
+    DEBUG_PRINTF("Backup: Restored %d tasks\n", image.taskCount);
+}
+
+// Boot, after analytics.begin(): finish a restore a reset interrupted
+inline bool resumeBackupRestore(SystemState& state, Analytics& analytics) {
+    TracedPreferences prefs;
+    if (!prefs.begin(NVS_RESTORE_NAMESPACE, true)) return false;  // Namespace never created
+    bool pending = prefs.getBytesLength("image") == sizeof(BackupImage);
+    static BackupImage image;
+    if (pending) prefs.getBytes("image", &image, sizeof(image));
+    prefs.end();
+    if (!pending) return false;
+
+    DEBUG_PRINTLN("Backup: Interrupted restore found, applying it");
+    commitBackup(image, state, analytics);
+    return true;
+}
+
+#endif // BACKUP_ARCHIVE_H
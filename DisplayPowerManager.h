@@ -0,0 +1,203 @@
+#ifndef DISPLAY_POWER_MANAGER_H
+#define DISPLAY_POWER_MANAGER_H
+
+/**
+ * ============================================
+ * DisplayPowerManager - OLED contrast and sleep
+ * ============================================
+ *
+ * An OLED draws current per lit pixel, scaled by the contrast (segment
+ * current) register. The panel used to run at a fixed contrast of 200
+ * around the clock, face-down focus sessions included.
+ *
+ * - Contrast follows the room: the LDR reading is smoothed and mapped
+ *   through a gamma 2.2 table. The divider already reads roughly
+ *   logarithmic in lux (perceived brightness); the table turns that into
+ *   the linear drive the segment current needs. The panel is only told
+ *   when the value moves by DISPLAY_CONTRAST_STEP, so a flickering lamp
+ *   does not cost an SPI command per sensor read.
+ * - Sleep: display off (SSD1327 sleep mode, RAM kept) while the cube lies
+ *   on its screen, or after DISPLAY_IDLE_SLEEP_MS idle with no input.
+ *   The renderer keeps feeding the web mirror but skips the SPI transfer.
+ * - Wake: the caller's draw function puts the current frame into the
+ *   panel while it is still dark, then the display is switched on, so
+ *   the first lit frame is never a stale one.
+ *
+ * Current is estimated from a simple model (dark panel + lit pixels at
+ * the current contrast, or sleep current) and integrated over time for
+ * /api/display. The constants are from the module datasheet, not a
+ * measurement of this board.
+ */
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+#include "config.h"
+#include "FeatureProfile.h"
+#include "SystemState.h"
+#include "DisplayRenderer.h"
+
+class DisplayPowerManager {
+public:
+    DisplayPowerManager(U8G2& u8g2, DisplayRenderer& display) : u8g2(u8g2), display(display) {}
+
+    // First LDR reading seeds the average
+    void begin(int ldrValue) {
+        uint32_t now = millis();
+        startMs = lastAccountMs = lastActivityMs = now;
+        lightLevel = (int32_t)ldrValue << DISPLAY_LIGHT_SMOOTHING;
+#if DISPLAY_POWER_MANAGER
+        contrast = contrastFor(ldrValue);
+#else
+        contrast = DISPLAY_CONTRAST_FIXED;
+#endif
+        u8g2.setContrast(contrast);
+    }
+
+    // Raw analogRead(LDR_PIN), every sensor tick
+    void updateLight(int ldrValue) {
+#if DISPLAY_POWER_MANAGER
+        // EMA kept scaled by 2^DISPLAY_LIGHT_SMOOTHING
+        lightLevel += ldrValue - (lightLevel >> DISPLAY_LIGHT_SMOOTHING);
+        uint8_t target = contrastFor(lightLevel >> DISPLAY_LIGHT_SMOOTHING);
+        if (abs((int)target - (int)contrast) < DISPLAY_CONTRAST_STEP) return;
+
+        account();
+        contrast = target;
+        if (!asleep) u8g2.setContrast(contrast);  // Applied on wake otherwise
+#else
+        (void)ldrValue;
+#endif
+    }
+
+    void setFaceDown(bool down) {
+        if (down != faceDown) faceDownSinceMs = millis();
+        faceDown = down;
+        noteActivity();
+    }
+
+    // Flips, web actions, state changes: restart the idle countdown
+    void noteActivity() { lastActivityMs = millis(); }
+
+    bool shouldSleep(SystemMode mode) const {
+#if DISPLAY_POWER_MANAGER
+        uint32_t now = millis();
+        if (DISPLAY_SLEEP_FACE_DOWN && faceDown && now - faceDownSinceMs >= DISPLAY_FACE_DOWN_DELAY_MS) {
+            return true;
+        }
+        return DISPLAY_IDLE_SLEEP_MS > 0 && mode == MODE_IDLE && now - lastActivityMs >= DISPLAY_IDLE_SLEEP_MS;
+#else
+        (void)mode;
+        return false;
+#endif
+    }
+
+    void sleep() {
+        if (asleep) return;
+        account();
+        u8g2.setPowerSave(1);
+        display.setPanelOutput(false);
+        asleep = true;
+        sleepCount++;
+        DEBUG_PRINTLN("Display: sleep");
+    }
+
+    // drawFrame renders the current screen; it reaches the dark panel first
+    template<typename DrawFn>
+    void wake(DrawFn drawFrame) {
+        if (!asleep) return;
+        display.setPanelOutput(true);
+        u8g2.setContrast(contrast);
+        drawFrame();
+        account();
+        u8g2.setPowerSave(0);
+        asleep = false;
+        DEBUG_PRINTLN("Display: wake");
+    }
+
+    // From onFrameCommitted: lit pixels of the mono layer (native tiles)
+    void onFrame(const uint8_t* tiles) {
+        const uint32_t* words = reinterpret_cast<const uint32_t*>(tiles);
+        uint32_t count = 0;
+        for (uint16_t i = 0; i < FRAME_BYTES / 4; i++) {
+            count += __builtin_popcount(words[i]);
+        }
+        if (count == litPixels) return;
+        account();
+        litPixels = count;
+    }
+
+    bool isAsleep() const { return asleep; }
+    bool isFaceDown() const { return faceDown; }
+    uint8_t getContrast() const { return contrast; }
+    uint16_t getLightLevel() const { return lightLevel >> DISPLAY_LIGHT_SMOOTHING; }
+    uint16_t getLitPixels() const { return litPixels; }
+    uint32_t getSleepCount() const { return sleepCount; }
+
+    // Model estimate right now
+    uint32_t getCurrentMicroamps() const {
+        if (asleep) return DISPLAY_SLEEP_UA;
+        const uint8_t level = OLED_GRAYSCALE ? OLED_MONO_LEVEL : 15;
+        uint64_t lit = (uint64_t)DISPLAY_FULL_WHITE_UA * litPixels * level * contrast;
+        return DISPLAY_ON_BASE_UA + (uint32_t)(lit / ((uint32_t)FRAME_PIXELS * 15 * 255));
+    }
+
+    // Since boot
+    uint32_t getAverageMicroamps() {
+        account();
+        uint32_t elapsed = lastAccountMs - startMs;
+        return elapsed ? (uint32_t)(chargeUaMs / elapsed) : getCurrentMicroamps();
+    }
+
+    uint8_t getAsleepPercent() {
+        account();
+        uint32_t elapsed = lastAccountMs - startMs;
+        return elapsed ? (uint8_t)((uint64_t)asleepMs * 100 / elapsed) : 0;
+    }
+
+private:
+    static const uint16_t FRAME_PIXELS = 128 * 128;
+    static const uint16_t FRAME_BYTES = FRAME_PIXELS / 8;
+
+    // round(255 * (i / 16) ^ 2.2), i = 0..16 over the 12-bit ADC range
+    static constexpr uint8_t GAMMA_LUT[17] = {
+        0, 1, 3, 6, 12, 20, 29, 41, 55, 72, 91, 112, 135, 161, 190, 221, 255
+    };
+
+    U8G2& u8g2;
+    DisplayRenderer& display;
+
+    int32_t lightLevel = 0;
+    uint8_t contrast = DISPLAY_CONTRAST_FIXED;
+    bool asleep = false;
+    bool faceDown = false;
+    uint32_t faceDownSinceMs = 0;
+    uint32_t lastActivityMs = 0;
+    uint16_t litPixels = 0;
+    uint32_t sleepCount = 0;
+
+    uint32_t startMs = 0;
+    uint32_t lastAccountMs = 0;
+    uint64_t chargeUaMs = 0;
+    uint32_t asleepMs = 0;
+
+    static uint8_t contrastFor(int32_t ldr) {
+        ldr = constrain(ldr, 0, 4095);
+        uint8_t i = ldr >> 8;
+        uint16_t frac = ldr & 0xFF;
+        uint16_t v = GAMMA_LUT[i] + (((GAMMA_LUT[i + 1] - GAMMA_LUT[i]) * frac) >> 8);
+        return DISPLAY_CONTRAST_MIN + (DISPLAY_CONTRAST_MAX - DISPLAY_CONTRAST_MIN) * v / 255;
+    }
+
+    // Charge at the old draw up to now; call before anything that changes it
+    void account() {
+        uint32_t now = millis();
+        uint32_t dt = now - lastAccountMs;
+        chargeUaMs += (uint64_t)getCurrentMicroamps() * dt;
+        if (asleep) asleepMs += dt;
+        lastAccountMs = now;
+    }
+};
+
+extern Subsystem<Features::oled, DisplayPowerManager> displayPower;
+
+#endif // DISPLAY_POWER_MANAGER_H
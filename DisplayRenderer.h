@@ -18,17 +18,39 @@
 #include <Arduino.h>
 #include <U8g2lib.h>
 #include <math.h>
+#include <functional>
 #include "SystemState.h"
 #include "QRCodeGenerator.h"
+#include "GrayFramebuffer.h"
+#include "FixedMath.h"
+#include "TimedScreenManager.h"
 
 // Forward declaration for Analytics time
 class Analytics;
 extern Analytics analytics;
 
+// Everything that decides what a timer screen looks like. Two frames
+// with equal keys are pixel-identical.
+struct FrameKey {
+    SystemMode mode;
+    uint32_t taskId;
+    uint32_t timeLeft;
+    uint32_t totalTime;
+    int16_t minuteOfDay;  // Clock in the corner
+    bool rotated;         // U8G2_R2 (face up)
+
+    bool operator==(const FrameKey& o) const {
+        return mode == o.mode && taskId == o.taskId && timeLeft == o.timeLeft &&
+               totalTime == o.totalTime && minuteOfDay == o.minuteOfDay && rotated == o.rotated;
+    }
+};
+
 class DisplayRenderer {
 public:
     // Inject display reference
-    DisplayRenderer(U8G2& display) : u8g2(display) {}
+    DisplayRenderer(U8G2& display) : u8g2(display) {
+        buildGlowMask();
+    }
     
     // ============================================
     // High-level screen drawing
@@ -75,24 +97,36 @@ public:
         centerText("to revive", 108);
     }
     
-    void drawCongratsScreen() {
+    // progressQ16: how far the overlay has run (Q16_ONE = the still frame)
+    void drawCongratsScreen(uint32_t progressQ16 = FixedMath::Q16_ONE) {
         u8g2.setFont(u8g2_font_ncenB12_tr);
         centerText("Congrats!", 35);
         
-        // Flower icon
-        drawFlowerIcon(64, 55);
+        // Flower icon, petals bounce open in the first 30%
+        uint32_t t = FixedMath::ratioQ16(progressQ16, FixedMath::Q16_ONE * 3 / 10);
+        drawFlowerIcon(64, 55, (int16_t)((Animation::bounceQ16(t) * 10) >> 16));
         
         u8g2.setFont(u8g2_font_6x12_tr);
         centerText("All tasks done!", 85);
         centerText("Plant fully grown!", 100);
     }
     
-    void drawReviveScreen() {
+    void drawReviveScreen(uint32_t progressQ16 = FixedMath::Q16_ONE) {
         u8g2.setFont(u8g2_font_ncenB12_tr);
         centerText("Revived!", 30);
         
-        // Bloom flower
-        drawFlowerIcon(64, 60, 12, 8);
+        // Bloom flower: opens in the first 40%, then breathes +-1 px
+        const uint32_t OPEN = FixedMath::Q16_ONE * 4 / 10;
+        int16_t petalDist;
+        if (progressQ16 < OPEN) {
+            uint32_t t = FixedMath::ratioQ16(progressQ16, OPEN);
+            petalDist = 4 + (int16_t)((Animation::easeInOutQ16(t) * 8) >> 16);
+        } else {
+            uint32_t t = FixedMath::ratioQ16(progressQ16 - OPEN, FixedMath::Q16_ONE - OPEN);
+            int32_t breath = (int32_t)Animation::oscillateQ16(t, 2) - FixedMath::Q15_ONE;
+            petalDist = 12 + FixedMath::mulQ15(breath, 1);
+        }
+        drawFlowerIcon(64, 60, petalDist, 8);
         
         u8g2.setFont(u8g2_font_6x12_tr);
         centerText("Your plant lives!", 95);
@@ -280,14 +314,16 @@ public:
     }
     
     void drawFlowerIcon(int16_t cx, int16_t cy, int16_t petalDist = 10, int numPetals = 6) {
+        queueGlow(cx, cy);
+
         // Center
         u8g2.drawDisc(cx, cy, 5, U8G2_DRAW_ALL);
         
         // Petals
         for (int i = 0; i < numPetals; i++) {
-            float angle = i * 3.14159f * 2.0f / numPetals;
-            int16_t px = cx + cos(angle) * petalDist;
-            int16_t py = cy + sin(angle) * petalDist;
+            uint16_t phase = (uint16_t)(i * FixedMath::Q16_ONE / numPetals);
+            int16_t px = cx + FixedMath::mulQ15(FixedMath::cosQ15(phase), petalDist);
+            int16_t py = cy + FixedMath::mulQ15(FixedMath::sinQ15(phase), petalDist);
             u8g2.drawDisc(px, py, 4, U8G2_DRAW_ALL);
         }
         
@@ -353,6 +389,7 @@ public:
     
     // Prepare buffer (call before drawing)
     void beginFrame() {
+        glowCount = 0;
         u8g2.clearBuffer();
         u8g2.setDrawColor(1);
         u8g2.setFont(u8g2_font_6x12_tr);
@@ -360,11 +397,140 @@ public:
     
     // Send buffer to display (call after drawing)
     void endFrame() {
-        u8g2.sendBuffer();
+        if (panelOutput) {
+#if OLED_GRAYSCALE
+            // Glows first (lighten), then U8g2 content on top, then one
+            // straight 4bpp stream - no per-pixel expansion on the way out
+            gray.clear(0);
+            for (uint8_t i = 0; i < glowCount; i++) {
+                gray.blendMask(glows[i].x, glows[i].y, GLOW_SIZE, GLOW_SIZE, glowMask, OLED_GLOW_LEVEL);
+            }
+            gray.blitMonoTiles(u8g2.getBufferPtr(), OLED_MONO_LEVEL);
+            gray.flush(u8g2);
+#else
+            u8g2.sendBuffer();
+#endif
+        }
+        glowCount = 0;
+
+        if (frameCallback) {
+            frameCallback(u8g2.getBufferPtr(), isRotated());
+        }
+    }
+
+    // Called after every frame reaches the panel (native tile layout)
+    typedef std::function<void(const uint8_t* tiles, bool rotated)> FrameCallback;
+    void onFrameCommitted(FrameCallback callback) { frameCallback = callback; }
+
+    GrayFramebuffer& grayBuffer() { return gray; }
+
+    // Off while the panel sleeps: frames still reach the callback, not the SPI bus
+    void setPanelOutput(bool on) { panelOutput = on; }
+
+    bool isRotated() { return u8g2.getU8g2()->cb == U8G2_R2; }
+
+    // ============================================
+    // Speculative frames
+    // ============================================
+    // Draw a likely next frame into a spare tile buffer ahead of time.
+    // `draw` issues the usual draw calls; the live buffer is untouched.
+    template<typename DrawFn>
+    void prerender(const FrameKey& key, DrawFn draw) {
+        u8g2_t* u = u8g2.getU8g2();
+        uint8_t* liveTiles = u->tile_buf_ptr;
+        const u8g2_cb_t* liveRotation = u->cb;
+        bool rotationChanges = (liveRotation == U8G2_R2) != key.rotated;
+
+        u->tile_buf_ptr = spareTiles;
+        if (rotationChanges) u8g2.setDisplayRotation(key.rotated ? U8G2_R2 : U8G2_R0);
+
+        beginFrame();
+        draw();
+        memcpy(spareGlows, glows, sizeof(glows));
+        spareGlowCount = glowCount;
+        glowCount = 0;
+
+        if (rotationChanges) u8g2.setDisplayRotation(liveRotation);
+        u->tile_buf_ptr = liveTiles;
+
+        predictedKey = key;
+        hasPrediction = true;
+    }
+
+    bool isPredicted(const FrameKey& key) const {
+        return hasPrediction && predictedKey == key;
+    }
+
+    // Send the pre-rendered frame if it matches what should be on screen
+    bool commitPrediction(const FrameKey& key) {
+        if (!isPredicted(key)) return false;
+        memcpy(u8g2.getBufferPtr(), spareTiles, sizeof(spareTiles));
+        memcpy(glows, spareGlows, sizeof(glows));
+        glowCount = spareGlowCount;
+        endFrame();
+        hasPrediction = false;
+        return true;
     }
 
+    void dropPrediction() { hasPrediction = false; }
+
 private:
+    static const uint8_t GLOW_SIZE = 32;
+    static const uint8_t MAX_GLOWS = 4;
+
+    struct Glow {
+        int16_t x;  // Native (unrotated) top-left, multiple of 8
+        int16_t y;
+    };
+
     U8G2& u8g2;
+    FrameCallback frameCallback;
+    GrayFramebuffer gray;
+    uint32_t glowMask[GLOW_SIZE * GLOW_SIZE / 8];
+    Glow glows[MAX_GLOWS];
+    uint8_t glowCount = 0;
+    bool panelOutput = true;
+
+    uint8_t spareTiles[OLED_WIDTH * OLED_HEIGHT / 8];
+    Glow spareGlows[MAX_GLOWS];
+    uint8_t spareGlowCount = 0;
+    FrameKey predictedKey = {};
+    bool hasPrediction = false;
+
+    // Radial falloff, 4bpp coverage packed like the framebuffer
+    void buildGlowMask() {
+        const float radius = GLOW_SIZE / 2;
+        for (uint8_t y = 0; y < GLOW_SIZE; y++) {
+            for (uint8_t w = 0; w < GLOW_SIZE / 8; w++) {
+                uint32_t word = 0;
+                for (uint8_t p = 0; p < 8; p++) {
+                    float dx = (w * 8 + p) - radius + 0.5f;
+                    float dy = y - radius + 0.5f;
+                    float falloff = 1.0f - sqrtf(dx * dx + dy * dy) / radius;
+                    if (falloff <= 0) continue;
+                    uint32_t cov = (uint32_t)(falloff * falloff * 15 + 0.5f);
+                    // Left pixel of each byte in the high nibble
+                    word |= cov << ((p >> 1) * 8 + ((p & 1) ? 0 : 4));
+                }
+                glowMask[y * (GLOW_SIZE / 8) + w] = word;
+            }
+        }
+    }
+
+    // Glow centered on a logical (rotated) point. The mask is symmetric,
+    // so only its position needs mapping into native coordinates.
+    void queueGlow(int16_t cx, int16_t cy) {
+        if (glowCount >= MAX_GLOWS) return;
+        int16_t x = cx - GLOW_SIZE / 2;
+        int16_t y = cy - GLOW_SIZE / 2;
+        if (isRotated()) {
+            x = OLED_WIDTH - GLOW_SIZE - x;
+            y = OLED_HEIGHT - GLOW_SIZE - y;
+        }
+        glows[glowCount].x = (x + 4) & ~7;  // blendMask needs word alignment
+        glows[glowCount].y = y;
+        glowCount++;
+    }
 };
 
 #endif // DISPLAY_RENDERER_H
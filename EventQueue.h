@@ -56,6 +56,7 @@ enum class Event : uint8_t {
     // UI events
     OLED_REFRESH,       // Screen needs redraw
     WEB_BROADCAST,      // Send update to web clients
+    STATS_CHANGED,      // Analytics recorded something (push stats)
     
     // Sensor events
     LIGHT_DETECTED,     // LDR threshold crossed
@@ -67,6 +68,7 @@ enum class Event : uint8_t {
     // System events
     SAVE_STATE,         // Persist to NVS
     DAY_RESET,          // Reset for new day
+    STATE_RESTORED,     // Backup replaced the state (session in progress is void)
     
     _EVENT_COUNT        // For array sizing
 };
@@ -233,10 +235,12 @@ inline const char* eventName(Event e) {
         case Event::PLANT_BLOOMED: return "PLANT_BLOOMED";
         case Event::OLED_REFRESH: return "OLED_REFRESH";
         case Event::WEB_BROADCAST: return "WEB_BROADCAST";
+        case Event::STATS_CHANGED: return "STATS_CHANGED";
         case Event::LIGHT_DETECTED: return "LIGHT_DETECTED";
         case Event::FLIP_DETECTED: return "FLIP_DETECTED";
         case Event::SAVE_STATE: return "SAVE_STATE";
         case Event::DAY_RESET: return "DAY_RESET";
+        case Event::STATE_RESTORED: return "STATE_RESTORED";
         default: return "UNKNOWN";
     }
 }
@@ -0,0 +1,155 @@
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+/**
+ * ============================================
+ * EventStream - Server-Sent Events on /api/events
+ * ============================================
+ *
+ * Read-only displays (wall tablet, status widget) follow the cube with
+ * one EventSource instead of a WebSocket session or /api/status polling.
+ * They get the same messages as WebSocket clients:
+ *
+ *   id: 1207
+ *   event: status
+ *   data: {"type":"status","ver":81,"state":"focusing",...}
+ *
+ * Each message is framed once and the same bytes go to every stream.
+ * The latest status / plant / tasks / stats frames are kept, so a new
+ * stream starts with the full picture and a reconnect with Last-Event-ID
+ * only gets the topics that changed since (all of them after a reboot:
+ * ids start at a random value, like SystemState versions).
+ *
+ * The socket is taken over from the synchronous WebServer after the
+ * request is parsed. Writes never wait on the client: a frame goes out
+ * with one non-blocking send(), and a stream whose socket buffer can't
+ * take all of it is dropped (EventSource reconnects and resumes).
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include "config.h"
+
+class EventStream {
+public:
+    // Topics whose latest message is kept for new and resuming streams
+    enum Topic : uint8_t { STATUS, PLANT, TASKS, STATS, TOPIC_COUNT, TRANSIENT = TOPIC_COUNT };
+
+    void begin() {
+        lastId = esp_random();
+        for (uint8_t t = 0; t < TOPIC_COUNT; t++) topicIds[t] = lastId;
+    }
+
+    // Takes over the request's socket; false when all slots are in use
+    bool accept(WiFiClient& client, uint32_t lastEventId, bool resume) {
+        int8_t slot = -1;
+        for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++) {
+            if (!clients[i].connected()) {
+                clients[i].stop();
+                slot = i;
+                break;
+            }
+        }
+        if (slot < 0) return false;
+
+        clients[slot] = client;
+        static const char header[] = "HTTP/1.1 200 OK\r\n"
+                                     "Content-Type: text/event-stream\r\n"
+                                     "Cache-Control: no-cache\r\n"
+                                     "Connection: keep-alive\r\n"
+                                     "Access-Control-Allow-Origin: *\r\n"
+                                     "\r\n"
+                                     "retry: 2000\n\n";
+        if (!writeRaw(slot, header, sizeof(header) - 1)) return true;  // Gone already
+
+        // Same order as a new WebSocket client: tasks, plant, status, stats
+        static const Topic order[TOPIC_COUNT] = { TASKS, PLANT, STATUS, STATS };
+        uint32_t behind = lastId - lastEventId;
+        for (uint8_t i = 0; i < TOPIC_COUNT; i++) {
+            Topic t = order[i];
+            if (latest[t].length() == 0) continue;
+            if (resume && lastId - topicIds[t] >= behind) continue;  // Already has it
+            if (!write(slot, latest[t])) return true;
+        }
+        DEBUG_PRINTF("EventStream: Client in slot %d (%s)\n", slot, resume ? "resumed" : "new");
+        return true;
+    }
+
+    void publish(Topic topic, const char* event, const char* json, size_t length) {
+        String frame;
+        frame.reserve(length + 40);
+        frame += "id: ";
+        frame += ++lastId;
+        frame += "\nevent: ";
+        frame += event;
+        frame += "\ndata: ";
+        frame.concat(json, length);
+        frame += "\n\n";
+
+        if (topic != TRANSIENT) {
+            latest[topic] = frame;
+            topicIds[topic] = lastId;
+        }
+        for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++) {
+            if (clients[i]) write(i, frame);
+        }
+    }
+
+    // Comment lines keep idle streams open through proxies and find dead ones
+    void loop() {
+        if (millis() - lastKeepAlive < SSE_KEEPALIVE_MS) return;
+        lastKeepAlive = millis();
+        static const String ping = ":\n\n";
+        for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++) {
+            if (clients[i]) write(i, ping);
+        }
+    }
+
+    // False until every kept topic has been published once
+    bool hasAllTopics() const {
+        for (uint8_t t = 0; t < TOPIC_COUNT; t++) {
+            if (latest[t].length() == 0) return false;
+        }
+        return true;
+    }
+
+    uint8_t getClientCount() {
+        uint8_t count = 0;
+        for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++) {
+            if (clients[i].connected()) count++;
+        }
+        return count;
+    }
+
+    uint32_t getFramesSent() const { return framesSent; }
+
+private:
+    WiFiClient clients[SSE_MAX_CLIENTS];
+    String latest[TOPIC_COUNT];
+    uint32_t topicIds[TOPIC_COUNT] = {};
+    uint32_t lastId = 0;
+    uint32_t lastKeepAlive = 0;
+    uint32_t framesSent = 0;
+
+    bool write(uint8_t slot, const String& frame) {
+        if (!writeRaw(slot, frame.c_str(), frame.length())) return false;
+        framesSent++;
+        return true;
+    }
+
+    // All of it or drop the stream. Not WiFiClient::write(): that retries
+    // a 1 s select() up to 10 times, so one stalled display would hold up
+    // loop() for 10 s. EAGAIN or a partial send means the client is behind.
+    bool writeRaw(uint8_t slot, const char* data, size_t length) {
+        WiFiClient& client = clients[slot];
+        int fd = client.connected() ? client.fd() : -1;
+        if (fd >= 0 && lwip_send(fd, data, length, MSG_DONTWAIT) == (ssize_t)length) return true;
+
+        DEBUG_PRINTF("EventStream: Dropped client in slot %u\n", slot);
+        client.stop();
+        return false;
+    }
+};
+
+#endif // EVENT_STREAM_H
@@ -0,0 +1,79 @@
+#ifndef FEATURE_PROFILE_H
+#define FEATURE_PROFILE_H
+
+/**
+ * ============================================
+ * FeatureProfile - Compile-time subsystem selection
+ * ============================================
+ *
+ * One build, one cube: BLOOM_PROFILE in config.h (or -DBLOOM_PROFILE=...)
+ * picks a profile, and `Features` is that profile's type. Code that
+ * belongs to an optional subsystem sits under `if constexpr (Features::x)`
+ * and its global objects are Subsystem<Features::x, T>.
+ *
+ * A disabled Subsystem has no storage and its accessors are declared but
+ * never defined, so a use that is not compiled out fails at link time
+ * instead of costing flash. Functions only reachable from discarded
+ * branches are dropped by --gc-sections (the ESP32 core default).
+ *
+ * Footprints: GET /api/profile on the device, profile_footprint.py for
+ * a flash/RAM table of every profile.
+ */
+
+#include <utility>
+#include "config.h"
+
+template <bool Oled, bool Mpu, bool Buzzer, bool StationWifi, bool CaptivePortal>
+struct FeatureProfile {
+    static constexpr bool oled = Oled;                    // SSD1327 + renderer + power manager
+    static constexpr bool mpu = Mpu;                      // Flip detection
+    static constexpr bool buzzer = Buzzer;                // Countdown beeps
+    static constexpr bool stationWifi = StationWifi;      // Join WIFI_SSID + NTP (else AP only)
+    static constexpr bool captivePortal = CaptivePortal;  // DNS + OS probe routes in AP mode
+};
+
+// Flip-controlled cube on a desk: everything
+struct DeskCubeProfile : FeatureProfile<true, true, true, true, true> {
+    static constexpr const char* name = "desk-cube";
+};
+
+// Web dashboard on the home network, no hardware besides the LDR
+struct DashboardProfile : FeatureProfile<false, false, false, true, false> {
+    static constexpr const char* name = "dashboard";
+};
+
+// Screen + own access point, driven from the phone that joins it
+struct KioskProfile : FeatureProfile<true, false, false, false, true> {
+    static constexpr const char* name = "kiosk";
+};
+
+using Features = BLOOM_PROFILE;
+
+// Global object of an optional subsystem: `x->method()` as for a pointer
+template <bool Enabled, typename T>
+class Subsystem {
+public:
+    template <typename... Args>
+    explicit Subsystem(Args&&... args) : object(std::forward<Args>(args)...) {}
+
+    T* operator->() { return &object; }
+    T& operator*() { return object; }
+    operator T&() { return object; }
+
+private:
+    T object;
+};
+
+template <typename T>
+class Subsystem<false, T> {
+public:
+    template <typename... Args>
+    explicit Subsystem(Args&&...) {}
+
+    // Not defined: only discarded branches may name them
+    T* operator->();
+    T& operator*();
+    operator T&();
+};
+
+#endif // FEATURE_PROFILE_H
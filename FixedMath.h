@@ -0,0 +1,167 @@
+#ifndef FIXED_MATH_H
+#define FIXED_MATH_H
+
+/**
+ * ============================================
+ * FixedMath - Integer animation math
+ * ============================================
+ *
+ * Table-driven replacements for the float math used while rendering.
+ * All tables are built by the compiler (constexpr) and live in flash.
+ *
+ * Formats:
+ * - Phase:    uint16_t, 65536 = one full turn (wraps for free)
+ * - Progress: Q16 uint32_t, 0 .. 65536 (= 0.0 .. 1.0)
+ * - Sine:     Q15 int32_t, -32767 .. 32767
+ *
+ * Accuracy against the double reference is checked at compile time
+ * by the static_asserts at the end of this file.
+ */
+
+#include <stdint.h>
+
+namespace FixedMath {
+
+static constexpr uint32_t Q16_ONE = 65536;
+static constexpr int32_t Q15_ONE = 32768;
+
+static constexpr uint8_t LUT_BITS = 8;
+static constexpr uint16_t LUT_SIZE = 1 << LUT_BITS;
+
+// ============================================
+// Compile-time reference curves (double)
+// ============================================
+namespace ref {
+    // Arduino.h defines PI / TWO_PI as macros - keep distinct names
+    constexpr double PI_REF = 3.14159265358979323846;
+
+    constexpr double sine(double x) {
+        while (x > PI_REF) x -= 2 * PI_REF;
+        while (x < -PI_REF) x += 2 * PI_REF;
+        double term = x, sum = x;
+        for (int n = 1; n < 10; n++) {
+            term *= -x * x / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // Same curves as Animation::easeInOut / Animation::bounce
+    constexpr double easeInOut(double t) {
+        return t < 0.5 ? 2 * t * t : 1 - (-2 * t + 2) * (-2 * t + 2) / 2;
+    }
+
+    constexpr double bounce(double t) {
+        const double n1 = 7.5625;
+        const double d1 = 2.75;
+        if (t < 1 / d1) return n1 * t * t;
+        if (t < 2 / d1) { t -= 1.5 / d1; return n1 * t * t + 0.75; }
+        if (t < 2.5 / d1) { t -= 2.25 / d1; return n1 * t * t + 0.9375; }
+        t -= 2.625 / d1;
+        return n1 * t * t + 0.984375;
+    }
+
+    constexpr int32_t roundToInt(double v) {
+        return v < 0 ? (int32_t)(v - 0.5) : (int32_t)(v + 0.5);
+    }
+}
+
+// ============================================
+// Lookup tables (LUT_SIZE segments + end point)
+// ============================================
+enum class Curve : uint8_t { SINE, EASE_IN_OUT, BOUNCE };
+
+struct Table {
+    int32_t v[LUT_SIZE + 1];
+
+    constexpr Table(Curve curve) : v() {
+        for (uint16_t i = 0; i <= LUT_SIZE; i++) {
+            double t = (double)i / LUT_SIZE;
+            switch (curve) {
+                case Curve::SINE:
+                    v[i] = ref::roundToInt(ref::sine(t * 2 * ref::PI_REF) * (Q15_ONE - 1));
+                    break;
+                case Curve::EASE_IN_OUT:
+                    v[i] = ref::roundToInt(ref::easeInOut(t) * Q16_ONE);
+                    break;
+                case Curve::BOUNCE:
+                    v[i] = ref::roundToInt(ref::bounce(t) * Q16_ONE);
+                    break;
+            }
+        }
+    }
+
+    // Linear interpolation, x in 0 .. 65536 (Q16 of the table range)
+    constexpr int32_t lookup(uint32_t x) const {
+        if (x >= Q16_ONE) return v[LUT_SIZE];
+        uint32_t idx = x >> (16 - LUT_BITS);
+        int32_t frac = x & ((1 << (16 - LUT_BITS)) - 1);
+        return v[idx] + (((v[idx + 1] - v[idx]) * frac) >> (16 - LUT_BITS));
+    }
+};
+
+static constexpr Table SINE_TABLE(Curve::SINE);
+static constexpr Table EASE_IN_OUT_TABLE(Curve::EASE_IN_OUT);
+static constexpr Table BOUNCE_TABLE(Curve::BOUNCE);
+
+// ============================================
+// Public API
+// ============================================
+
+constexpr int32_t sinQ15(uint16_t phase) {
+    return SINE_TABLE.lookup(phase);
+}
+
+constexpr int32_t cosQ15(uint16_t phase) {
+    return SINE_TABLE.lookup((uint16_t)(phase + Q16_ONE / 4));
+}
+
+// Q15 value * integer, rounded to nearest (for pixel offsets)
+constexpr int16_t mulQ15(int32_t q15, int32_t value) {
+    return (int16_t)((q15 * value + Q15_ONE / 2) >> 15);
+}
+
+// Q16 fraction a / b, clamped to 0 .. Q16_ONE
+constexpr uint32_t ratioQ16(uint32_t a, uint32_t b) {
+    if (b == 0 || a >= b) return b == 0 ? 0 : Q16_ONE;
+    return (uint32_t)(((uint64_t)a << 16) / b);
+}
+
+// ============================================
+// Compile-time accuracy checks vs double
+// ============================================
+namespace check {
+    constexpr int32_t absDiff(int32_t a, int32_t b) { return a > b ? a - b : b - a; }
+
+    constexpr int32_t maxSineError() {
+        int32_t worst = 0;
+        for (uint32_t p = 0; p < Q16_ONE; p += 7) {
+            int32_t expect = ref::roundToInt(ref::sine(p * 2 * ref::PI_REF / Q16_ONE) * (Q15_ONE - 1));
+            int32_t err = absDiff(sinQ15((uint16_t)p), expect);
+            if (err > worst) worst = err;
+        }
+        return worst;
+    }
+
+    constexpr int32_t maxCurveError(const Table& table, Curve curve) {
+        int32_t worst = 0;
+        for (uint32_t t = 0; t <= Q16_ONE; t += 13) {
+            double x = (double)t / Q16_ONE;
+            double y = curve == Curve::BOUNCE ? ref::bounce(x) : ref::easeInOut(x);
+            int32_t err = absDiff(table.lookup(t), ref::roundToInt(y * Q16_ONE));
+            if (err > worst) worst = err;
+        }
+        return worst;
+    }
+}
+
+// Sine: within 4 LSB (~0.01% of full scale)
+static_assert(check::maxSineError() <= 4, "sine table too coarse");
+static_assert(sinQ15(0) == 0 && sinQ15(16384) == Q15_ONE - 1, "sine end points");
+// Easing: < 0.1%; bounce has kinks between segments, < 0.5% there
+static_assert(check::maxCurveError(EASE_IN_OUT_TABLE, Curve::EASE_IN_OUT) <= 64, "easeInOut table too coarse");
+static_assert(check::maxCurveError(BOUNCE_TABLE, Curve::BOUNCE) <= 320, "bounce table too coarse");
+
+} // namespace FixedMath
+
+#endif // FIXED_MATH_H
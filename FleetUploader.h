@@ -0,0 +1,230 @@
+#ifndef FLEET_UPLOADER_H
+#define FLEET_UPLOADER_H
+
+/**
+ * ============================================
+ * FleetUploader - Push session/day records to fleet_server.py
+ * ============================================
+ *
+ * Completed sessions and end-of-day summaries are queued as 16-byte
+ * records and POSTed in batches to FLEET_SERVER/upload:
+ *
+ *   "BLMF" [version u8][count u8][mac 6] then count x FleetRecord
+ *
+ * Every record has a sequence number, increasing across reboots
+ * (boot counter in NVS << 16 | record number). The server answers with
+ * the highest sequence it has stored - the upload cursor - and the cube
+ * drops everything up to it. A batch that fails or is cut off is simply
+ * re-sent: the server skips what it already has.
+ *
+ * Unacknowledged records survive a reboot: the upload task writes the
+ * queue to NVS (blob "fleet"/"queue") within a second of a change, and
+ * begin() loads it back ahead of the new boot's records.
+ *
+ * Uploads run in their own task like MqttPublisher, so an unreachable
+ * server never stalls the main loop.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <HTTPClient.h>
+#include <ArduinoJson.h>
+#include "config.h"
+#include "Analytics.h"
+#include "NvsWriteLog.h"
+
+enum FleetRecordKind : uint8_t {
+    FLEET_FOCUS = 1,    // b = minutes
+    FLEET_BREAK = 2,    // b = minutes
+    FLEET_DAY   = 3     // a = tasks, b = focus min, c = break min, d = sessions | goalMet << 15
+};
+
+struct __attribute__((packed)) FleetRecord {
+    uint32_t seq;
+    uint32_t ts;        // Unix time, 0 if the clock was not set
+    uint8_t kind;
+    uint8_t a;
+    uint16_t b;
+    uint16_t c;
+    uint16_t d;
+};
+
+class FleetUploader {
+public:
+    static const uint8_t VERSION = 1;
+
+    void begin() {
+        if (!FLEET_ENABLED || strlen(FLEET_SERVER) == 0) {
+            DEBUG_PRINTLN("Fleet: No server configured");
+            return;
+        }
+
+        prefs.begin("fleet", false);
+        uint32_t boots = prefs.getUInt("boots", 0) + 1;
+        prefs.putUInt("boots", boots);
+        size_t saved = prefs.getBytesLength("queue");
+        if (saved % sizeof(FleetRecord) == 0 && saved <= sizeof(queue)) {
+            count = prefs.getBytes("queue", queue, saved) / sizeof(FleetRecord);
+        }
+        prefs.end();
+        head = 0;
+        nextSeq = boots << 16;
+        if (count > 0) oldestQueuedMs = millis();
+
+        xTaskCreatePinnedToCore(taskEntry, "fleet", FLEET_TASK_STACK, this, 1, nullptr, xPortGetCoreID());
+        DEBUG_PRINTF("Fleet: Uploading to %s (boot %lu, %u records carried over)\n",
+                     FLEET_SERVER, (unsigned long)boots, count);
+        enabled = true;
+    }
+
+    void recordSession(bool focus, uint16_t minutes) {
+        FleetRecord r = {};
+        r.kind = focus ? FLEET_FOCUS : FLEET_BREAK;
+        r.b = minutes;
+        add(r);
+    }
+
+    void recordDay(const DailyStats& stats, bool goalMet) {
+        FleetRecord r = {};
+        r.kind = FLEET_DAY;
+        r.a = stats.tasksCompleted;
+        r.b = stats.focusMinutes;
+        r.c = stats.breakMinutes;
+        r.d = stats.sessionsCount | (goalMet ? 0x8000 : 0);
+        add(r);
+    }
+
+    uint32_t getPending() const { return count; }
+    uint32_t getDropped() const { return dropped; }
+
+private:
+    TracedPreferences prefs;
+    bool enabled = false;
+
+    // Shared between the loop (producer) and the upload task. The ring
+    // holds the unacknowledged records in seq order, oldest at head
+    // (records carried over from earlier boots have lower seqs).
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    FleetRecord queue[FLEET_QUEUE_SIZE];
+    uint16_t head = 0;
+    uint16_t count = 0;
+    uint32_t nextSeq = 0;
+    uint32_t oldestQueuedMs = 0;
+    uint32_t dropped = 0;
+    bool unsaved = false;       // Queue changed since the last NVS write
+
+    void add(FleetRecord& r) {
+        if (!enabled) return;
+        time_t now = time(nullptr);
+        r.ts = now > 1577836800 ? (uint32_t)now : 0;
+
+        portENTER_CRITICAL(&lock);
+        if (count == FLEET_QUEUE_SIZE) {
+            head = (head + 1) % FLEET_QUEUE_SIZE;  // Full: give up on the oldest
+            count--;
+            dropped++;
+        }
+        if (count == 0) oldestQueuedMs = millis();
+        r.seq = nextSeq++;
+        queue[(head + count) % FLEET_QUEUE_SIZE] = r;
+        count++;
+        unsaved = true;
+        portEXIT_CRITICAL(&lock);
+    }
+
+    // Write the unacknowledged records to NVS (upload task only)
+    void saveQueue() {
+        static FleetRecord snapshot[FLEET_QUEUE_SIZE];
+        portENTER_CRITICAL(&lock);
+        uint16_t n = count;
+        for (uint16_t i = 0; i < n; i++) {
+            snapshot[i] = queue[(head + i) % FLEET_QUEUE_SIZE];
+        }
+        unsaved = false;
+        portEXIT_CRITICAL(&lock);
+
+        prefs.begin("fleet", false);
+        if (n > 0) prefs.putBytes("queue", snapshot, n * sizeof(FleetRecord));
+        else prefs.remove("queue");
+        prefs.end();
+    }
+
+    // ============================================
+    // Upload task
+    // ============================================
+
+    static void taskEntry(void* arg) {
+        ((FleetUploader*)arg)->run();
+    }
+
+    void run() {
+        uint32_t backoffMs = FLEET_UPLOAD_INTERVAL_MS;
+        for (;;) {
+            vTaskDelay(pdMS_TO_TICKS(1000));
+
+            portENTER_CRITICAL(&lock);
+            bool save = unsaved;
+            uint32_t pending = count;
+            bool due = pending >= FLEET_BATCH_MAX ||
+                       (pending > 0 && millis() - oldestQueuedMs >= backoffMs);
+            portEXIT_CRITICAL(&lock);
+            if (save) saveQueue();
+            if (!due || WiFi.status() != WL_CONNECTED) continue;
+
+            if (upload()) {
+                backoffMs = FLEET_UPLOAD_INTERVAL_MS;
+                saveQueue();
+            } else {
+                backoffMs = backoffMs * 2 > FLEET_BACKOFF_MAX_MS ? FLEET_BACKOFF_MAX_MS : backoffMs * 2;
+            }
+            portENTER_CRITICAL(&lock);
+            oldestQueuedMs = millis();   // Next attempt one interval (or backoff) from now
+            portEXIT_CRITICAL(&lock);
+        }
+    }
+
+    bool upload() {
+        static uint8_t body[12 + FLEET_BATCH_MAX * sizeof(FleetRecord)];
+        memcpy(body, "BLMF", 4);
+        body[4] = VERSION;
+        WiFi.macAddress(body + 6);
+
+        uint8_t batch = 0;
+        portENTER_CRITICAL(&lock);
+        for (; batch < count && batch < FLEET_BATCH_MAX; batch++) {
+            memcpy(body + 12 + batch * sizeof(FleetRecord), &queue[(head + batch) % FLEET_QUEUE_SIZE], sizeof(FleetRecord));
+        }
+        portEXIT_CRITICAL(&lock);
+        body[5] = batch;
+
+        HTTPClient http;
+        http.setTimeout(FLEET_TIMEOUT_MS);
+        http.begin(String(FLEET_SERVER) + "/upload");
+        http.addHeader("Content-Type", "application/octet-stream");
+        int code = http.POST(body, 12 + batch * sizeof(FleetRecord));
+        String response = code == 200 ? http.getString() : String();
+        http.end();
+        if (code != 200) {
+            DEBUG_PRINTF("Fleet: Upload failed (%d)\n", code);
+            return false;
+        }
+
+        StaticJsonDocument<64> doc;
+        if (deserializeJson(doc, response) || doc["cursor"].isNull()) return false;
+        uint32_t cursor = doc["cursor"];
+
+        portENTER_CRITICAL(&lock);
+        if (cursor < nextSeq) {
+            while (count > 0 && queue[head].seq <= cursor) {
+                head = (head + 1) % FLEET_QUEUE_SIZE;
+                count--;
+            }
+        }
+        portEXIT_CRITICAL(&lock);
+        return true;
+    }
+};
+
+extern FleetUploader fleetUploader;
+
+#endif // FLEET_UPLOADER_H
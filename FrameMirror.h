@@ -0,0 +1,101 @@
+#ifndef FRAME_MIRROR_H
+#define FRAME_MIRROR_H
+
+/**
+ * ============================================
+ * FrameMirror - Compressed OLED frame stream
+ * ============================================
+ *
+ * Encodes committed U8g2 frames (native tile layout: 16 pages x 128
+ * bytes, vertical bytes, LSB on top) for remote viewers.
+ *
+ * Packet layout:
+ *   [0]    FRAME_KEY (full frame) or FRAME_DELTA (XOR vs previous)
+ *   [1]    flags: bit 0 = rotated (U8G2_R2)
+ *   [2-3]  sequence number, little endian
+ *   [4..]  zero-run RLE of the 2048 payload bytes:
+ *          0x80 | (n-1)  -> n zero bytes      (n = 1..128)
+ *          0x00 | (n-1)  -> n literal bytes   (n = 1..128)
+ *
+ * XOR deltas of an unchanged screen are all zeros, so a timer tick
+ * costs only the bytes under the changed digits.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+class FrameMirror {
+public:
+    static const uint16_t FRAME_BYTES = 128 * 128 / 8;
+    static const uint8_t HEADER_BYTES = 4;
+    // Worst case: all literals, one token per 128 bytes
+    static const uint16_t MAX_PACKET = HEADER_BYTES + FRAME_BYTES + FRAME_BYTES / 128;
+
+    static const uint8_t FRAME_KEY = 0;
+    static const uint8_t FRAME_DELTA = 1;
+
+    FrameMirror() : sequence(0), lastRotated(false) {
+        memset(last, 0, sizeof(last));
+    }
+
+    // Full frame; also becomes the reference for the next delta.
+    // Returns packet length.
+    uint16_t encodeKey(const uint8_t* tiles, bool rotated) {
+        memcpy(last, tiles, FRAME_BYTES);
+        lastRotated = rotated;
+        return encode(FRAME_KEY, rotated, last, nullptr);
+    }
+
+    // XOR delta vs the previous frame. Returns 0 if nothing changed.
+    uint16_t encodeDelta(const uint8_t* tiles, bool rotated) {
+        if (rotated == lastRotated && memcmp(tiles, last, FRAME_BYTES) == 0) return 0;
+        uint16_t len = encode(FRAME_DELTA, rotated, tiles, last);
+        memcpy(last, tiles, FRAME_BYTES);
+        lastRotated = rotated;
+        return len;
+    }
+
+    const uint8_t* packet() const { return out; }
+
+private:
+    uint8_t last[FRAME_BYTES];
+    uint8_t out[MAX_PACKET];
+    uint16_t sequence;
+    bool lastRotated;
+
+    uint16_t encode(uint8_t kind, bool rotated, const uint8_t* frame, const uint8_t* ref) {
+        sequence++;
+        out[0] = kind;
+        out[1] = rotated ? 1 : 0;
+        out[2] = sequence & 0xFF;
+        out[3] = sequence >> 8;
+
+        uint16_t o = HEADER_BYTES;
+        uint16_t i = 0;
+        while (i < FRAME_BYTES) {
+            uint8_t n = 0;
+            if (byteAt(frame, ref, i) == 0) {
+                while (i + n < FRAME_BYTES && n < 128 && byteAt(frame, ref, i + n) == 0) n++;
+                out[o++] = 0x80 | (n - 1);
+            } else {
+                // Literal run ends at the next pair of zeros (a single
+                // zero is cheaper to carry than a token switch)
+                while (i + n < FRAME_BYTES && n < 128) {
+                    if (byteAt(frame, ref, i + n) == 0 &&
+                        (i + n + 1 >= FRAME_BYTES || byteAt(frame, ref, i + n + 1) == 0)) break;
+                    n++;
+                }
+                out[o++] = n - 1;
+                for (uint8_t k = 0; k < n; k++) out[o++] = byteAt(frame, ref, i + k);
+            }
+            i += n;
+        }
+        return o;
+    }
+
+    static inline uint8_t byteAt(const uint8_t* frame, const uint8_t* ref, uint16_t i) {
+        return ref ? (frame[i] ^ ref[i]) : frame[i];
+    }
+};
+
+#endif // FRAME_MIRROR_H
@@ -0,0 +1,277 @@
+#ifndef GRAY_FRAMEBUFFER_H
+#define GRAY_FRAMEBUFFER_H
+
+/**
+ * ============================================
+ * GrayFramebuffer - Native 4bpp SSD1327 buffer
+ * ============================================
+ *
+ * 128x128 pixels, 16 gray levels, packed exactly like the SSD1327 GDDRAM
+ * (two pixels per byte, left pixel in the high nibble). On the little-endian
+ * ESP32 one uint32_t therefore holds 8 horizontal pixels, so every kernel
+ * below works on whole words instead of single pixels.
+ *
+ * The buffer is streamed to the panel as-is - no 1bpp -> 4bpp expansion
+ * in the transfer path. Text and lines drawn by U8g2 are merged in with
+ * blitMonoTiles(), which expands a full 8x8 tile with a bit transpose and
+ * a branch-free bit spread.
+ *
+ * Alignment rules (keep the kernels word-parallel):
+ * - fillRect: any rectangle (edges are masked)
+ * - blitGray / blendMask: x and w must be multiples of 8
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <U8g2lib.h>
+#include "config.h"
+#endif
+
+class GrayFramebuffer {
+public:
+    static const uint8_t WIDTH = 128;
+    static const uint8_t HEIGHT = 128;
+    static const uint8_t WORDS_PER_ROW = WIDTH / 8;
+    static const uint16_t BYTES = WIDTH * HEIGHT / 2;
+
+    GrayFramebuffer() { clear(0); }
+
+    // ============================================
+    // Word helpers
+    // ============================================
+
+    // Spread the 8 bits of a row byte into 8 nibbles (bit x -> pixel x).
+    // Result has 0x1 in every lit nibble; multiply by a level to color it.
+    static inline uint32_t expandBits(uint8_t bits) {
+        // Left pixel lives in the high nibble -> swap neighbouring bits first
+        uint32_t x = ((bits & 0x55) << 1) | ((bits >> 1) & 0x55);
+        x = (x | (x << 12)) & 0x000F000F;
+        x = (x | (x << 6)) & 0x03030303;
+        x = (x | (x << 3)) & 0x11111111;
+        return x;
+    }
+
+    // Level (0-15) replicated in all 8 nibbles
+    static inline uint32_t solid(uint8_t level) {
+        return (uint32_t)(level & 0x0F) * 0x11111111UL;
+    }
+
+    // Nibble mask covering pixels [first, first + count) of one word
+    static inline uint32_t spanMask(uint8_t first, uint8_t count) {
+        uint8_t bits = (uint8_t)(((1u << count) - 1) << first);
+        return expandBits(bits) * 0x0F;
+    }
+
+    // ============================================
+    // Kernels
+    // ============================================
+
+    void clear(uint8_t level) {
+        uint32_t v = solid(level);
+        for (uint16_t i = 0; i < WORDS_PER_ROW * HEIGHT; i++) {
+            words[i] = v;
+        }
+    }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t level) {
+        if (!clip(x, y, w, h)) return;
+
+        uint32_t v = solid(level);
+        uint8_t firstWord = x >> 3;
+        uint8_t lastWord = (x + w - 1) >> 3;
+        uint32_t headMask = spanMask(x & 7, (firstWord == lastWord) ? w : 8 - (x & 7));
+        uint32_t tailMask = spanMask(0, ((x + w - 1) & 7) + 1);
+
+        for (int16_t row = y; row < y + h; row++) {
+            uint32_t* line = &words[row * WORDS_PER_ROW];
+            line[firstWord] = (line[firstWord] & ~headMask) | (v & headMask);
+            if (firstWord == lastWord) continue;
+            for (uint8_t i = firstWord + 1; i < lastWord; i++) {
+                line[i] = v;
+            }
+            line[lastWord] = (line[lastWord] & ~tailMask) | (v & tailMask);
+        }
+    }
+
+    // Copy a packed 4bpp sprite (w/8 words per row)
+    void blitGray(int16_t x, int16_t y, int16_t w, int16_t h, const uint32_t* src) {
+        int16_t srcStride = w >> 3;
+        int16_t cx = x, cy = y, cw = w, ch = h;
+        if ((x & 7) || (w & 7) || !clip(cx, cy, cw, ch)) return;
+
+        const uint32_t* s = src + (cy - y) * srcStride + ((cx - x) >> 3);
+        for (int16_t row = 0; row < ch; row++) {
+            memcpy(&words[(cy + row) * WORDS_PER_ROW + (cx >> 3)], s, (cw >> 3) * sizeof(uint32_t));
+            s += srcStride;
+        }
+    }
+
+    // Draw `level` through a 4bpp coverage mask, lighten-composited.
+    // Coverage is scaled per nibble (cov * level / 15) and kept only where it
+    // is brighter than the destination, so anti-aliased edges sit cleanly
+    // on top of (or behind) monochrome U8g2 content.
+    void blendMask(int16_t x, int16_t y, int16_t w, int16_t h, const uint32_t* mask, uint8_t level) {
+        int16_t srcStride = w >> 3;
+        int16_t cx = x, cy = y, cw = w, ch = h;
+        if ((x & 7) || (w & 7) || !clip(cx, cy, cw, ch)) return;
+
+        const uint32_t* m = mask + (cy - y) * srcStride + ((cx - x) >> 3);
+        for (int16_t row = 0; row < ch; row++) {
+            uint32_t* d = &words[(cy + row) * WORDS_PER_ROW + (cx >> 3)];
+            for (int16_t i = 0; i < (cw >> 3); i++) {
+                uint32_t cov = m[i];
+                if (cov == 0) continue;
+                // Even and odd nibbles in separate 8-bit lanes: no carries
+                uint32_t lo = scaleLanes(cov & 0x0F0F0F0F, level);
+                uint32_t hi = scaleLanes((cov >> 4) & 0x0F0F0F0F, level);
+                uint32_t dst = d[i];
+                lo = maxLanes(lo, dst & 0x0F0F0F0F);
+                hi = maxLanes(hi, (dst >> 4) & 0x0F0F0F0F);
+                d[i] = lo | (hi << 4);
+            }
+            m += srcStride;
+        }
+    }
+
+    // Merge a full U8g2 tile buffer (16 tile rows x 128 bytes, vertical
+    // bytes, LSB on top) into the framebuffer: set pixels become `level`,
+    // clear pixels keep whatever is underneath.
+    void blitMonoTiles(const uint8_t* tiles, uint8_t level) {
+        uint32_t color = level & 0x0F;
+        for (uint8_t tileRow = 0; tileRow < HEIGHT / 8; tileRow++) {
+            for (uint8_t tileCol = 0; tileCol < WIDTH / 8; tileCol++) {
+                const uint8_t* t = tiles + tileRow * WIDTH + tileCol * 8;
+                uint64_t bits;
+                memcpy(&bits, t, sizeof(bits));
+                if (bits == 0) continue;
+                bits = transpose8x8(bits);
+
+                uint32_t* d = &words[(tileRow * 8) * WORDS_PER_ROW + tileCol];
+                for (uint8_t r = 0; r < 8; r++) {
+                    uint8_t rowBits = (uint8_t)(bits >> (r * 8));
+                    if (rowBits) {
+                        uint32_t set = expandBits(rowBits);
+                        *d = (*d & ~(set * 0x0F)) | (set * color);
+                    }
+                    d += WORDS_PER_ROW;
+                }
+            }
+        }
+    }
+
+    // ============================================
+    // Streaming
+    // ============================================
+
+#ifdef ARDUINO
+    // Send the whole buffer through U8g2's byte/cad layer (same SPI bus,
+    // same pins), already in GDDRAM format.
+    void flush(U8G2& display) {
+        u8x8_t* u8x8 = display.getU8x8();
+        uint8_t xOffset = u8x8->x_offset;
+
+        u8x8_cad_StartTransfer(u8x8);
+        u8x8_cad_SendCmd(u8x8, 0x15);  // Column window (2 px per column)
+        u8x8_cad_SendArg(u8x8, xOffset);
+        u8x8_cad_SendArg(u8x8, xOffset + WIDTH / 2 - 1);
+        u8x8_cad_SendCmd(u8x8, 0x75);  // Row window
+        u8x8_cad_SendArg(u8x8, 0);
+        u8x8_cad_SendArg(u8x8, HEIGHT - 1);
+
+        // cad layer takes at most 255 bytes per call -> one row at a time
+        uint8_t* rowPtr = (uint8_t*)words;
+        for (uint8_t row = 0; row < HEIGHT; row++) {
+            u8x8_cad_SendData(u8x8, WIDTH / 2, rowPtr);
+            rowPtr += WIDTH / 2;
+        }
+        u8x8_cad_EndTransfer(u8x8);
+    }
+#endif
+
+    // Raw access (GDDRAM byte order)
+    const uint8_t* data() const { return (const uint8_t*)words; }
+    uint32_t* rowWords(uint8_t row) { return &words[row * WORDS_PER_ROW]; }
+
+private:
+    uint32_t words[WORDS_PER_ROW * HEIGHT];
+
+    bool clip(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const {
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
+        if (x + w > WIDTH) w = WIDTH - x;
+        if (y + h > HEIGHT) h = HEIGHT - y;
+        return w > 0 && h > 0;
+    }
+
+    // 8x8 bit-matrix transpose: byte c bit r -> byte r bit c
+    static inline uint64_t transpose8x8(uint64_t x) {
+        uint64_t t;
+        t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+        x = x ^ t ^ (t << 7);
+        t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+        x = x ^ t ^ (t << 14);
+        t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+        x = x ^ t ^ (t << 28);
+        return x;
+    }
+
+    // lanes (0-15 each, one per byte) * level / 15, rounded
+    static inline uint32_t scaleLanes(uint32_t lanes, uint8_t level) {
+        uint32_t v = lanes * level + 0x08080808;  // <= 233 per lane
+        v = v + ((v >> 4) & 0x0F0F0F0F);           // <= 247, exact for v/15
+        return (v >> 4) & 0x0F0F0F0F;
+    }
+
+    // Per-lane max of two 4-bit-per-byte vectors
+    static inline uint32_t maxLanes(uint32_t a, uint32_t b) {
+        uint32_t ge = ((a | 0x10101010) - b) & 0x10101010;  // 0x10 where a >= b
+        uint32_t sel = (ge >> 4) * 0x0F;
+        return (a & sel) | (b & ~sel);
+    }
+};
+
+// ============================================
+// Kernel benchmark (device, via Serial)
+// ============================================
+#ifdef ARDUINO
+inline void benchmarkGrayFramebuffer(GrayFramebuffer& fb, U8G2& display, uint16_t iterations = 200) {
+    static uint32_t mask[32 * 32 / 8];
+    for (uint16_t i = 0; i < sizeof(mask) / sizeof(mask[0]); i++) {
+        mask[i] = 0x12345678UL * (i + 1);
+    }
+    const uint8_t* tiles = display.getBufferPtr();
+    uint32_t start;
+
+    start = micros();
+    for (uint16_t i = 0; i < iterations; i++) fb.clear(i & 0x0F);
+    uint32_t clearUs = (micros() - start) / iterations;
+
+    start = micros();
+    for (uint16_t i = 0; i < iterations; i++) fb.fillRect(3, 5, 101, 90, i & 0x0F);
+    uint32_t fillUs = (micros() - start) / iterations;
+
+    start = micros();
+    for (uint16_t i = 0; i < iterations; i++) fb.blitGray(48, 48, 32, 32, mask);
+    uint32_t blitUs = (micros() - start) / iterations;
+
+    start = micros();
+    for (uint16_t i = 0; i < iterations; i++) fb.blendMask(48, 48, 32, 32, mask, 9);
+    uint32_t blendUs = (micros() - start) / iterations;
+
+    start = micros();
+    for (uint16_t i = 0; i < iterations; i++) fb.blitMonoTiles(tiles, 15);
+    uint32_t monoUs = (micros() - start) / iterations;
+
+    start = micros();
+    fb.flush(display);
+    uint32_t flushUs = micros() - start;
+
+    DEBUG_PRINTF("GrayFB bench (us): clear=%lu fill=%lu blit32=%lu blend32=%lu mono=%lu flush=%lu\n",
+                 clearUs, fillUs, blitUs, blendUs, monoUs, flushUs);
+}
+#endif
+
+#endif // GRAY_FRAMEBUFFER_H
@@ -0,0 +1,177 @@
+#ifndef HEAP_TRACKER_H
+#define HEAP_TRACKER_H
+
+/**
+ * ============================================
+ * HeapTracker - Allocation sites + fragmentation
+ * ============================================
+ *
+ * With HEAP_TRACKER, global operator new/delete put an 8-byte header in
+ * front of each block and count allocations per call site (the return
+ * address of operator new: std::function, std::map nodes, our own new).
+ * Arduino String allocates with malloc/realloc directly, so it only
+ * shows up in the heap-wide numbers:
+ *
+ *   fragmentation = 1 - largest free block / free bytes   (permille)
+ *
+ * Sites are served on /api/heap; soak_test.py samples them over a
+ * simulated year. Resolve addresses with xtensa-esp32-elf-addr2line.
+ * host/soak_host.cpp builds the same tracker into the host build
+ * (soak_test.py --host-build).
+ */
+
+#include <Arduino.h>
+#include <new>
+#include <esp_heap_caps.h>
+#include "config.h"
+
+struct HeapSite {
+    uint32_t addr;          // Caller of operator new, 0 = overflow bucket
+    uint32_t allocs;
+    uint32_t frees;
+    int32_t liveBytes;
+    int32_t peakLiveBytes;
+};
+
+struct HeapSnapshot {
+    uint32_t freeBytes;
+    uint32_t largestBlock;
+    uint32_t minFreeBytes;
+    uint16_t fragPermille;
+};
+
+// No constructor on purpose: zero-initialized statics are valid before
+// any other global constructor calls operator new.
+class HeapTracker {
+public:
+    static const uint8_t MAX_SITES = 64;
+
+    uint8_t siteFor(uint32_t addr) {
+        uint8_t slot = (addr >> 2) % (MAX_SITES - 1);
+        for (uint8_t i = 0; i < MAX_SITES - 1; i++) {
+            HeapSite& site = sites[slot];
+            if (site.addr == addr) return slot;
+            if (site.addr == 0) {
+                site.addr = addr;
+                siteCount++;
+                return slot;
+            }
+            slot = (slot + 1) % (MAX_SITES - 1);
+        }
+        return MAX_SITES - 1;  // Table full: overflow bucket
+    }
+
+    void onAlloc(uint8_t index, size_t size) {
+        HeapSite& site = sites[index];
+        site.allocs++;
+        site.liveBytes += size;
+        if (site.liveBytes > site.peakLiveBytes) site.peakLiveBytes = site.liveBytes;
+        liveBytes += size;
+        liveCount++;
+        totalAllocs++;
+    }
+
+    void onFree(uint8_t index, size_t size) {
+        HeapSite& site = sites[index];
+        site.frees++;
+        site.liveBytes -= size;
+        liveBytes -= size;
+        liveCount--;
+    }
+
+    // Zero the counters but keep live bytes, so growth after a warm-up is visible
+    void resetCounters() {
+        for (uint8_t i = 0; i < MAX_SITES; i++) {
+            sites[i].allocs = 0;
+            sites[i].frees = 0;
+            sites[i].peakLiveBytes = sites[i].liveBytes;
+        }
+        totalAllocs = 0;
+    }
+
+    static HeapSnapshot snapshot() {
+        HeapSnapshot s;
+        s.freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+        s.largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+        s.minFreeBytes = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+        s.fragPermille = s.freeBytes ? 1000 - (uint32_t)((uint64_t)s.largestBlock * 1000 / s.freeBytes) : 0;
+        return s;
+    }
+
+    const HeapSite& site(uint8_t index) const { return sites[index]; }
+    uint8_t getSiteCount() const { return siteCount; }
+    int32_t getLiveBytes() const { return liveBytes; }
+    int32_t getLiveCount() const { return liveCount; }
+    uint32_t getTotalAllocs() const { return totalAllocs; }
+
+private:
+    HeapSite sites[MAX_SITES];
+    uint8_t siteCount;
+    int32_t liveBytes;
+    int32_t liveCount;
+    uint32_t totalAllocs;
+};
+
+extern HeapTracker heapTracker;
+
+#if HEAP_TRACKER
+// ============================================
+// Tracking operator new/delete
+// ============================================
+namespace HeapTrackerDetail {
+    struct Header {
+        uint32_t size;
+        uint8_t site;
+        uint8_t pad[3];     // Keeps the payload 8-byte aligned
+    };
+
+    static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+    static void* allocate(size_t size, void* caller) {
+        Header* h = (Header*)malloc(sizeof(Header) + size);
+        if (!h) return nullptr;
+        h->size = size;
+        portENTER_CRITICAL(&lock);
+        h->site = heapTracker.siteFor((uint32_t)(uintptr_t)caller);
+        heapTracker.onAlloc(h->site, size);
+        portEXIT_CRITICAL(&lock);
+        return h + 1;
+    }
+
+    static void release(void* ptr) {
+        if (!ptr) return;
+        Header* h = (Header*)ptr - 1;
+        portENTER_CRITICAL(&lock);
+        heapTracker.onFree(h->site, h->size);
+        portEXIT_CRITICAL(&lock);
+        free(h);
+    }
+}
+
+void* operator new(size_t size) {
+    void* p = HeapTrackerDetail::allocate(size, __builtin_return_address(0));
+    if (!p) abort();  // Built without exceptions
+    return p;
+}
+
+void* operator new[](size_t size) {
+    void* p = HeapTrackerDetail::allocate(size, __builtin_return_address(0));
+    if (!p) abort();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return HeapTrackerDetail::allocate(size, __builtin_return_address(0));
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return HeapTrackerDetail::allocate(size, __builtin_return_address(0));
+}
+
+void operator delete(void* ptr) noexcept { HeapTrackerDetail::release(ptr); }
+void operator delete[](void* ptr) noexcept { HeapTrackerDetail::release(ptr); }
+void operator delete(void* ptr, size_t) noexcept { HeapTrackerDetail::release(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { HeapTrackerDetail::release(ptr); }
+#endif // HEAP_TRACKER
+
+#endif // HEAP_TRACKER_H
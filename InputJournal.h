@@ -0,0 +1,333 @@
+#ifndef INPUT_JOURNAL_H
+#define INPUT_JOURNAL_H
+
+/**
+ * ============================================
+ * InputJournal - Every external input, in flash
+ * ============================================
+ *
+ * Flips, LDR threshold crossings, web actions, time syncs and boots are
+ * appended to a ring of flash sectors on the data partition (unused:
+ * web content is embedded). With the state snapshot written at boot,
+ * that is enough to replay a user's day: journal_replay.py turns the
+ * journal into a scenario script for a test cube (see ScenarioRunner.h).
+ *
+ * Sector:  [magic u32][seq u32] records... (0xFF = erased, end of sector)
+ * Record:  [len u8][type u8][dt varint][payload]
+ *          len counts the bytes after itself, dt = ms since the previous
+ *          record (since boot for the first one)
+ *
+ * Light only matters while the plant is withered, so readings are
+ * journaled only then: the first one, then crossings of the same
+ * hysteresis band handleLightSensor() uses. Replay sees what the revive
+ * logic saw, and ADC noise near the threshold writes nothing.
+ *
+ * A flip costs 3 bytes, a web action 4-5, so 64 KB holds months.
+ * Records are written on the input path (a flip is journaled before it
+ * reaches the display), so the 4 KB erase that frees the next sector
+ * runs from loop() while nothing is pending, once the current sector is
+ * nearly full - never inside a record write unless loop() fell behind.
+ * Inputs made by a scenario run are not journaled; a SCENARIO record
+ * marks where the state stopped following the journal.
+ */
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include <esp_system.h>
+#include "config.h"
+#include "SystemState.h"
+#include "Analytics.h"
+
+enum JournalRecord : uint8_t {
+    JR_BOOT      = 1,   // reset reason u8, wall clock varint (0 = not set)
+    JR_FLIP_DOWN = 2,
+    JR_FLIP_UP   = 3,
+    JR_LIGHT     = 4,   // LDR reading varint (withered: first reading, then revive edges)
+    JR_ACTION    = 5,   // JournalAction u8 + arguments
+    JR_TIME_SYNC = 6,   // source u8 (0 NTP, 1 phone), wall clock varint
+    JR_PLANT     = 7,   // stage, withered, pending, watered, goal, session goal
+    JR_TASK      = 8,   // focus varint, break varint, flags u8, name
+    JR_STATS     = 9,   // tasks u8, focus varint, break varint, sessions u8
+    JR_SCENARIO  = 10   // A scenario run took over the state
+};
+
+// Stable codes: the journal outlives firmware versions
+enum JournalAction : uint8_t {
+    JA_WATER,
+    JA_KILL,
+    JA_PAUSE,
+    JA_RESUME,
+    JA_ADD_TASK,         // focus varint, break varint, name
+    JA_START_TASK,       // task index u8 (0xFF = unknown id)
+    JA_DELETE_TASK,      // task index u8
+    JA_TOGGLE_TASK,      // task index u8
+    JA_SET_GOAL,         // goal u8
+    JA_RESTART_DAY,
+    JA_REVIVE,
+    JA_SELECT_TASK,      // task index u8
+    JA_CONFIRM_COMPLETE,
+    JA_CANCEL_COMPLETE,
+    JA_COUNT
+};
+
+class InputJournal {
+public:
+    static const uint32_t SECTOR_SIZE = 4096;
+    static const uint32_t MAGIC = 0x4C4E524A;  // "JRNL"
+    static const uint8_t MAX_RECORD = 48;
+    static const uint32_t ERASE_AHEAD = 1024;  // Free bytes left when the next sector is erased
+
+    InputJournal(SystemState& state) : state(state) {}
+
+    // Finds the newest sector and the end of its records
+    void begin() {
+#if INPUT_JOURNAL
+        partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                             JOURNAL_PARTITION_LABEL);
+        if (!partition || partition->size < SECTOR_SIZE * JOURNAL_SECTORS) {
+            DEBUG_PRINTLN("InputJournal: No '" JOURNAL_PARTITION_LABEL "' partition, journal off");
+            partition = nullptr;
+            return;
+        }
+
+        bool found = false;
+        for (uint8_t i = 0; i < JOURNAL_SECTORS; i++) {
+            uint32_t header[2];
+            esp_partition_read(partition, i * SECTOR_SIZE, header, sizeof(header));
+            if (header[0] == MAGIC && (!found || header[1] > sectorSeq)) {
+                found = true;
+                sector = i;
+                sectorSeq = header[1];
+            }
+        }
+
+        if (!found) {
+            openSector(0, 0);
+        } else {
+            writeOffset = sector * SECTOR_SIZE + 8;
+            uint32_t end = (sector + 1) * SECTOR_SIZE;
+            uint8_t len;
+            while (writeOffset < end) {
+                esp_partition_read(partition, writeOffset, &len, 1);
+                if (len == 0xFF) break;
+                writeOffset += 1 + len;
+            }
+        }
+        DEBUG_PRINTF("InputJournal: Sector %u (seq %lu), %lu bytes used\n",
+                     sector, (unsigned long)sectorSeq,
+                     (unsigned long)(writeOffset - sector * SECTOR_SIZE));
+#endif
+    }
+
+    // Idle time only: erases the next sector ahead of the record that needs it
+    void loop() {
+        if (!partition || nextErased) return;
+        if ((sector + 1) * SECTOR_SIZE - writeOffset > ERASE_AHEAD) return;
+        esp_partition_erase_range(partition, nextSector() * SECTOR_SIZE, SECTOR_SIZE);
+        nextErased = true;
+    }
+
+    bool isAvailable() const { return partition != nullptr; }
+    uint32_t size() const { return SECTOR_SIZE * JOURNAL_SECTORS; }
+    uint32_t getRecordCount() const { return recordCount; }
+
+    // Raw journal bytes (sectors in partition order, the reader sorts by seq)
+    bool read(uint32_t offset, void* out, size_t len) const {
+        return partition && esp_partition_read(partition, offset, out, len) == ESP_OK;
+    }
+
+    // ============================================
+    // Inputs
+    // ============================================
+
+    void recordBoot(time_t wallClock) {
+        start(JR_BOOT);
+        put(esp_reset_reason());
+        putVarint(wallClock > 0 ? (uint32_t)wallClock : 0);
+        finish();
+    }
+
+    // Everything a replay needs to start from where the cube booted
+    void recordSnapshot(Analytics& analytics) {
+        start(JR_PLANT);
+        put(state.getPlantInfo().stage);
+        put(state.getPlantInfo().isWithered);
+        put(state.getPendingWaterCount());
+        put(state.getPlantInfo().wateredCount);
+        put(state.getDailyGoal());
+        put(state.getSessionGoal());
+        finish();
+
+        TaskInfo* tasks = state.getTasks();
+        for (uint8_t i = 0; i < state.getTaskCount(); i++) {
+            start(JR_TASK);
+            putVarint(tasks[i].focusDuration);
+            putVarint(tasks[i].breakDuration);
+            put((tasks[i].completed ? 1 : 0) | (tasks[i].started ? 2 : 0));
+            putName(tasks[i].name);
+            finish();
+        }
+
+        DailyStats stats = analytics.getTodayStats();
+        start(JR_STATS);
+        put(stats.tasksCompleted);
+        putVarint(stats.focusMinutes);
+        putVarint(stats.breakMinutes);
+        put(stats.sessionsCount);
+        finish();
+    }
+
+    void recordFlip(bool isFlipped) {
+        start(isFlipped ? JR_FLIP_DOWN : JR_FLIP_UP);
+        finish();
+    }
+
+    // Call with every reading, before handleLightSensor() sees it
+    void recordLight(int ldrValue) {
+        if (!state.getPlantInfo().isWithered) {
+            lightWatched = false;
+            lightAbove = false;
+            return;
+        }
+        int threshold = lightAbove ? LDR_REVIVE_THRESHOLD - LDR_REVIVE_HYSTERESIS : LDR_REVIVE_THRESHOLD;
+        bool above = ldrValue >= threshold;
+        if (lightWatched && above == lightAbove) return;
+        lightWatched = true;
+        lightAbove = above;
+        start(JR_LIGHT);
+        putVarint(ldrValue);
+        finish();
+    }
+
+    void recordTimeSync(bool fromPhone, time_t wallClock) {
+        start(JR_TIME_SYNC);
+        put(fromPhone ? 1 : 0);
+        putVarint((uint32_t)wallClock);
+        finish();
+    }
+
+    // A web action, before it is applied (task indexes refer to the list it saw)
+    void recordAction(const char* action, uint32_t taskId, uint8_t goal) {
+        int8_t code = actionCode(action);
+        if (code < 0 || code == JA_ADD_TASK) return;  // Read-only, or see recordAddTask()
+
+        start(JR_ACTION);
+        put(code);
+        switch (code) {
+            case JA_START_TASK:
+            case JA_DELETE_TASK:
+            case JA_TOGGLE_TASK:
+            case JA_SELECT_TASK:
+                put(taskIndex(taskId));
+                break;
+            case JA_SET_GOAL:
+                put(goal);
+                break;
+        }
+        finish();
+    }
+
+    void recordAddTask(const char* name, uint16_t focusMins, uint16_t breakMins) {
+        start(JR_ACTION);
+        put(JA_ADD_TASK);
+        putVarint(focusMins);
+        putVarint(breakMins);
+        putName(name);
+        finish();
+    }
+
+    void recordScenario() {
+        start(JR_SCENARIO);
+        finish();
+    }
+
+private:
+    SystemState& state;
+    const esp_partition_t* partition = nullptr;
+    uint8_t sector = 0;
+    uint32_t sectorSeq = 0;
+    uint32_t writeOffset = 0;
+    uint32_t lastRecordMs = 0;
+    uint32_t recordCount = 0;
+    bool lightAbove = false;
+    bool lightWatched = false;  // A reading was journaled since the plant withered
+    bool nextErased = false;   // loop() already erased nextSector()
+
+    uint8_t record[MAX_RECORD];
+    uint8_t recordLen = 0;
+
+    void start(uint8_t type) {
+        uint32_t now = millis();
+        recordLen = 1;  // Length byte, filled in by finish()
+        put(type);
+        putVarint(now - lastRecordMs);
+        lastRecordMs = now;
+    }
+
+    void put(uint8_t value) {
+        if (recordLen < MAX_RECORD) record[recordLen++] = value;
+    }
+
+    void putVarint(uint32_t value) {
+        while (value >= 0x80) {
+            put((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        put(value);
+    }
+
+    void putName(const char* name) {
+        for (const char* c = name; *c && recordLen < MAX_RECORD; c++) put(*c);
+    }
+
+    void finish() {
+        recordCount++;
+        if (!partition) return;
+
+        record[0] = recordLen - 1;
+        if (writeOffset + recordLen > (sector + 1) * SECTOR_SIZE) {
+            openSector(nextSector(), sectorSeq + 1);
+        }
+        esp_partition_write(partition, writeOffset, record, recordLen);
+        writeOffset += recordLen;
+    }
+
+    uint8_t nextSector() const { return (sector + 1) % JOURNAL_SECTORS; }
+
+    // Start writing into the oldest sector (erased here only if loop() has not)
+    void openSector(uint8_t index, uint32_t seq) {
+        if (!nextErased || index != nextSector()) {
+            esp_partition_erase_range(partition, index * SECTOR_SIZE, SECTOR_SIZE);
+        }
+        nextErased = false;
+        sector = index;
+        sectorSeq = seq;
+        uint32_t header[2] = { MAGIC, seq };
+        esp_partition_write(partition, index * SECTOR_SIZE, header, sizeof(header));
+        writeOffset = index * SECTOR_SIZE + sizeof(header);
+    }
+
+    uint8_t taskIndex(uint32_t taskId) {
+        TaskInfo* tasks = state.getTasks();
+        for (uint8_t i = 0; i < state.getTaskCount(); i++) {
+            if (tasks[i].id == taskId) return i;
+        }
+        return 0xFF;
+    }
+
+    static int8_t actionCode(const char* action) {
+        static const char* const names[JA_COUNT] = {
+            "water", "kill", "pause", "resume", "addTask", "startTask", "deleteTask",
+            "toggleTask", "setGoal", "restartDay", "revive", "selectTask",
+            "confirmComplete", "cancelComplete"
+        };
+        for (uint8_t i = 0; i < JA_COUNT; i++) {
+            if (strcmp(action, names[i]) == 0) return i;
+        }
+        return -1;
+    }
+};
+
+extern InputJournal inputJournal;
+
+#endif // INPUT_JOURNAL_H
@@ -17,6 +17,8 @@
  */
 
 #include <Arduino.h>
+#include "FixedMath.h"
+#include "SimClock.h"
 
 class IntervalTimer {
 public:
@@ -28,7 +30,7 @@ public:
     bool elapsed() {
         if (!enabled) return false;
         
-        uint32_t now = millis();
+        uint32_t now = clockMillis();
         if (now - lastTime >= interval) {
             lastTime = now;
             return true;
@@ -39,12 +41,12 @@ public:
     // Check without auto-reset
     bool check() const {
         if (!enabled) return false;
-        return (millis() - lastTime >= interval);
+        return (clockMillis() - lastTime >= interval);
     }
     
     // Manual reset
     void reset() {
-        lastTime = millis();
+        lastTime = clockMillis();
     }
     
     // Force trigger on next check
@@ -62,14 +64,14 @@ public:
     
     // Get time remaining until next trigger
     uint32_t remaining() const {
-        uint32_t elapsed = millis() - lastTime;
+        uint32_t elapsed = clockMillis() - lastTime;
         if (elapsed >= interval) return 0;
         return interval - elapsed;
     }
     
     // Get elapsed time since last trigger
     uint32_t elapsedTime() const {
-        return millis() - lastTime;
+        return clockMillis() - lastTime;
     }
 
 private:
@@ -88,7 +90,7 @@ public:
     // Start the timer
     void start(uint32_t durationMs) {
         duration = durationMs;
-        startTime = millis();
+        startTime = clockMillis();
         active = true;
         triggered = false;
     }
@@ -97,7 +99,7 @@ public:
     bool expired() {
         if (!active || triggered) return false;
         
-        if (millis() - startTime >= duration) {
+        if (clockMillis() - startTime >= duration) {
             triggered = true;
             active = false;
             return true;
@@ -107,7 +109,7 @@ public:
     
     // Check if currently running
     bool isRunning() const {
-        return active && !triggered && (millis() - startTime < duration);
+        return active && !triggered && (clockMillis() - startTime < duration);
     }
     
     // Cancel the timer
@@ -120,15 +122,21 @@ public:
     float progress() const {
         if (!active || duration == 0) return triggered ? 1.0f : 0.0f;
         
-        uint32_t elapsed = millis() - startTime;
+        uint32_t elapsed = clockMillis() - startTime;
         if (elapsed >= duration) return 1.0f;
         return (float)elapsed / (float)duration;
     }
+
+    // Get progress as Q16 (0 .. 65536), no float math
+    uint32_t progressQ16() const {
+        if (!active || duration == 0) return triggered ? FixedMath::Q16_ONE : 0;
+        return FixedMath::ratioQ16(clockMillis() - startTime, duration);
+    }
     
     // Get remaining time
     uint32_t remaining() const {
         if (!active) return 0;
-        uint32_t elapsed = millis() - startTime;
+        uint32_t elapsed = clockMillis() - startTime;
         if (elapsed >= duration) return 0;
         return duration - elapsed;
     }
@@ -150,7 +158,7 @@ public:
     
     // Update with new reading, returns true if stable state changed
     bool update(bool currentState) {
-        uint32_t now = millis();
+        uint32_t now = clockMillis();
         
         if (currentState != lastState) {
             lastChangeTime = now;
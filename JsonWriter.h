@@ -0,0 +1,132 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+/**
+ * ============================================
+ * JsonWriter - Append-only JSON into a caller buffer
+ * ============================================
+ *
+ * Backend of the serializers generated into Messages.h: values go
+ * straight into the buffer, with no JsonDocument tree in between.
+ * Keys are compile-time literals that already carry their quotes
+ * and colon ("\"ver\":"), so writing one is a single memcpy.
+ *
+ * A message that does not fit leaves the writer in overflow, which
+ * callers check before sending. The buffer is always NUL-terminated.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+class JsonWriter {
+public:
+    JsonWriter(char* buffer, size_t capacity)
+        : buf(buffer), cap(capacity), len(0), comma(false), overflow(capacity == 0) {
+        if (cap) buf[0] = '\0';
+    }
+
+    void beginObject() { separate(); put('{'); comma = false; }
+    void endObject()   { put('}'); comma = true; }
+    void beginArray()  { separate(); put('['); comma = false; }
+    void endArray()    { put(']'); comma = true; }
+
+    // Key literal including quotes and colon, e.g. "\"ver\":"
+    template <size_t N>
+    void key(const char (&literal)[N]) {
+        separate();
+        raw(literal, N - 1);
+        comma = false;
+    }
+
+    // Whole member known at compile time, e.g. "\"type\":\"status\""
+    template <size_t N>
+    void member(const char (&literal)[N]) {
+        separate();
+        raw(literal, N - 1);
+        comma = true;
+    }
+
+    void u32(uint32_t value) {
+        char digits[10];
+        uint8_t n = 0;
+        do {
+            digits[n++] = '0' + value % 10;
+            value /= 10;
+        } while (value);
+        separate();
+        while (n) put(digits[--n]);
+        comma = true;
+    }
+
+    void boolean(bool value) {
+        separate();
+        if (value) raw("true", 4);
+        else raw("false", 5);
+        comma = true;
+    }
+
+    // nullptr is written as null
+    void str(const char* value) {
+        separate();
+        if (!value) {
+            raw("null", 4);
+            comma = true;
+            return;
+        }
+        put('"');
+        for (const char* p = value; *p; p++) {
+            char c = *p;
+            if (c == '"' || c == '\\') {
+                put('\\');
+                put(c);
+            } else if ((uint8_t)c < 0x20) {
+                static const char hex[] = "0123456789abcdef";
+                char esc[6] = { '\\', 'u', '0', '0', hex[(c >> 4) & 0xF], hex[c & 0xF] };
+                if (c == '\n') raw("\\n", 2);
+                else if (c == '\t') raw("\\t", 2);
+                else raw(esc, 6);
+            } else {
+                put(c);
+            }
+        }
+        put('"');
+        comma = true;
+    }
+
+    bool ok() const { return !overflow; }
+    size_t length() const { return len; }
+    const char* c_str() const { return buf; }
+
+private:
+    char* buf;
+    size_t cap;
+    size_t len;
+    bool comma;     // A value precedes: the next key or element needs ','
+    bool overflow;
+
+    void separate() {
+        if (comma) put(',');
+    }
+
+    void put(char c) {
+        if (len + 1 >= cap) {
+            overflow = true;
+            return;
+        }
+        buf[len++] = c;
+        buf[len] = '\0';
+    }
+
+    void raw(const char* data, size_t n) {
+        if (len + n >= cap) {
+            overflow = true;
+            return;
+        }
+        memcpy(buf + len, data, n);
+        len += n;
+        buf[len] = '\0';
+    }
+};
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,184 @@
+#ifndef KEEP_ALIVE_WEB_SERVER_H
+#define KEEP_ALIVE_WEB_SERVER_H
+
+/**
+ * ============================================
+ * KeepAliveWebServer - WebServer with persistent connections
+ * ============================================
+ *
+ * The stock WebServer answers every request with "Connection: close",
+ * so each fetch from the web app costs a TCP handshake (tens of ms on
+ * the AP link) and an lwIP socket that lingers in TIME_WAIT.
+ *
+ * This subclass keeps up to HTTP_KEEPALIVE_SLOTS connections open
+ * between requests. Each handleClient() call serves at most one request,
+ * taking the connections in turn, so a busy browser can't starve the
+ * main loop. Requests pipelined on one connection stay in its receive
+ * buffer and are answered in order on the following calls.
+ *
+ * A connection is kept if the client asked for it (HTTP/1.1 default,
+ * or "Connection: keep-alive" on 1.0), the response is framed
+ * (Content-Length or chunked) and the request cap is not reached. It is
+ * closed after HTTP_KEEPALIVE_TIMEOUT_MS without a request, or when a
+ * new connection needs its slot (the oldest idle one goes).
+ *
+ * Handlers that take the socket over (EventStream) write no response
+ * through the server: the slot is released without closing it.
+ * The server must collect the "Connection" request header.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WebServer.h>
+#include "config.h"
+
+class KeepAliveWebServer : public WebServer {
+public:
+    explicit KeepAliveWebServer(int port) : WebServer(port) {}
+
+    void handleClient() override {
+        acceptNew();
+        expireIdle();
+
+        // Next connection with a request waiting, round robin
+        for (uint8_t n = 0; n < HTTP_KEEPALIVE_SLOTS; n++) {
+            uint8_t i = (nextSlot + n) % HTTP_KEEPALIVE_SLOTS;
+            if (slots[i].client && slots[i].client.available()) {
+                nextSlot = (i + 1) % HTTP_KEEPALIVE_SLOTS;
+                serve(slots[i]);
+                return;
+            }
+        }
+    }
+
+    // The request body went to a raw handler (not a form or multipart upload)
+    bool hasRawBody() const { return _currentRaw != nullptr; }
+
+    uint32_t getRequestCount() const { return requests; }
+    uint32_t getReusedCount() const { return reused; }     // Requests on an already used connection
+
+    uint8_t getOpenConnections() {
+        uint8_t count = 0;
+        for (uint8_t i = 0; i < HTTP_KEEPALIVE_SLOTS; i++) {
+            if (slots[i].client.connected()) count++;
+        }
+        return count;
+    }
+
+protected:
+    // send() and friends write the whole response header in one call:
+    // that is where "Connection: close" becomes keep-alive
+    size_t _currentClientWrite(const char* data, size_t length) override {
+        if (!awaitingHeader || length < 9 || strncmp(data, "HTTP/1.", 7) != 0) {
+            return _currentClient.write(data, length);
+        }
+        awaitingHeader = false;
+
+        String response(data);  // Built by _prepareHeader: NUL-terminated, no body
+        bool framed = response.indexOf("\r\nContent-Length:") >= 0 ||
+                      response.indexOf("\r\nTransfer-Encoding: chunked") >= 0;
+        keepAlive = wantsKeepAlive && framed && current->requests < HTTP_KEEPALIVE_MAX_REQUESTS;
+        if (keepAlive) {
+            char keep[64];
+            snprintf(keep, sizeof(keep), "Connection: keep-alive\r\nKeep-Alive: timeout=%u, max=%u\r\n",
+                     (unsigned)(HTTP_KEEPALIVE_TIMEOUT_MS / 1000),
+                     (unsigned)(HTTP_KEEPALIVE_MAX_REQUESTS - current->requests));
+            response.replace("Connection: close\r\n", keep);
+        }
+        _currentClient.write(response.c_str(), response.length());
+        return length;
+    }
+
+private:
+    struct Slot {
+        WiFiClient client;
+        uint32_t lastActive = 0;
+        uint16_t requests = 0;
+    };
+
+    Slot slots[HTTP_KEEPALIVE_SLOTS];
+    Slot* current = nullptr;
+    uint8_t nextSlot = 0;
+    bool awaitingHeader = false;
+    bool wantsKeepAlive = false;
+    bool keepAlive = false;
+    uint32_t requests = 0;
+    uint32_t reused = 0;
+
+    void acceptNew() {
+        WiFiClient client = _server.accept();
+        if (!client) return;
+
+        Slot* slot = nullptr;
+        for (uint8_t i = 0; i < HTTP_KEEPALIVE_SLOTS; i++) {
+            if (!slots[i].client.connected()) {
+                slot = &slots[i];
+                break;
+            }
+            if (!slot || (int32_t)(slots[i].lastActive - slot->lastActive) < 0) {
+                slot = &slots[i];  // Oldest so far
+            }
+        }
+        if (slot->client.connected()) {
+            DEBUG_PRINTLN("HTTP: All keep-alive slots busy, closing the oldest");
+            slot->client.stop();
+        }
+        slot->client = client;
+        slot->lastActive = millis();
+        slot->requests = 0;
+    }
+
+    void expireIdle() {
+        uint32_t now = millis();
+        for (uint8_t i = 0; i < HTTP_KEEPALIVE_SLOTS; i++) {
+            Slot& slot = slots[i];
+            if (!slot.client || slot.client.available()) continue;
+            if (!slot.client.connected() || now - slot.lastActive >= HTTP_KEEPALIVE_TIMEOUT_MS) {
+                slot.client.stop();
+                slot.client = WiFiClient();
+            }
+        }
+    }
+
+    // One request, same steps as WebServer::handleClient()
+    void serve(Slot& slot) {
+        current = &slot;
+        _currentClient = slot.client;
+        _currentStatus = HC_WAIT_READ;
+        _statusChange = millis();
+        awaitingHeader = true;
+        keepAlive = false;
+
+        bool handled = false;
+        if (_parseRequest(_currentClient)) {
+            String connection = header("Connection");
+            connection.toLowerCase();
+            wantsKeepAlive = _currentVersion >= 1 ? connection.indexOf("close") < 0
+                                                  : connection.indexOf("keep-alive") >= 0;
+            if (slot.requests > 0) reused++;
+            requests++;
+            slot.requests++;
+
+            _currentClient.setTimeout(HTTP_MAX_SEND_WAIT / 1000);
+            _contentLength = CONTENT_LENGTH_NOT_SET;
+            _handleRequest();
+            handled = true;
+        }
+
+        if (handled && keepAlive && _currentClient.connected()) {
+            slot.lastActive = millis();
+        } else {
+            // Dropping our reference closes the socket unless a handler took it over
+            slot.client = WiFiClient();
+        }
+
+        awaitingHeader = false;
+        current = nullptr;
+        _currentClient = WiFiClient();
+        _currentStatus = HC_NONE;
+        _currentUpload.reset();
+        _currentRaw.reset();
+    }
+};
+
+#endif // KEEP_ALIVE_WEB_SERVER_H
@@ -0,0 +1,134 @@
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+/**
+ * ============================================
+ * LatencyTrace - Input-to-pixels stage timing
+ * ============================================
+ *
+ * Timestamps one interaction as it moves through the system:
+ *
+ *   RECEIVED -> DETECTED -> APPLIED -> PERSISTED -> FRAME -> BROADCAST -> CLIENT
+ *
+ * Flip:  MPU poll that saw it -> debounced callback -> handleFlip() ->
+ *        NVS write -> OLED frame sent -> status broadcast -> client render
+ * Web:   WebSocket message in -> parsed -> action applied -> ... same
+ *
+ * Stages that never happen (e.g. no NVS write) are reported as -1.
+ * A trace finishes when a client acknowledges rendering it, or after
+ * LATENCY_TRACE_TIMEOUT_MS without one.
+ */
+
+#include <Arduino.h>
+#include "config.h"
+
+enum class LatencyStage : uint8_t {
+    RECEIVED,   // Not INPUT: that is an Arduino pinMode macro
+    DETECTED,
+    APPLIED,
+    PERSISTED,
+    FRAME,
+    BROADCAST,
+    CLIENT,
+    COUNT
+};
+
+class LatencyTrace {
+public:
+    enum Kind : uint8_t { FLIP = 0, WEB = 1, KIND_COUNT };
+
+    struct Result {
+        uint16_t id = 0;
+        int32_t stageUs[(uint8_t)LatencyStage::COUNT];  // Offset from RECEIVED, -1 = missing
+        uint32_t totalUs = 0;                           // RECEIVED -> last stage seen
+
+        Result() {
+            for (uint8_t s = 0; s < (uint8_t)LatencyStage::COUNT; s++) stageUs[s] = -1;
+        }
+    };
+
+    static const char* stageName(uint8_t stage) {
+        static const char* NAMES[] = {"input", "detected", "applied", "persisted", "frame", "broadcast", "client"};
+        return stage < (uint8_t)LatencyStage::COUNT ? NAMES[stage] : "?";
+    }
+
+    static const char* kindName(Kind kind) {
+        return kind == FLIP ? "flip" : "web";
+    }
+
+    // Start a trace; inputUs lets the caller backdate RECEIVED (e.g. MPU poll start)
+    void begin(Kind kind, uint32_t inputUs) {
+#if LATENCY_TRACE
+        if (active) finish();
+        active = true;
+        currentKind = kind;
+        currentId++;
+        memset(stamps, 0, sizeof(stamps));
+        seen = 0;
+        stamps[(uint8_t)LatencyStage::RECEIVED] = inputUs;
+        seen |= 1 << (uint8_t)LatencyStage::RECEIVED;
+#endif
+    }
+
+    void begin(Kind kind) { begin(kind, micros()); }
+
+    // First occurrence of each stage wins
+    void mark(LatencyStage stage) {
+#if LATENCY_TRACE
+        uint8_t s = (uint8_t)stage;
+        if (!active || (seen & (1 << s))) return;
+        stamps[s] = micros();
+        seen |= 1 << s;
+        if (stage == LatencyStage::CLIENT) finish();
+#endif
+    }
+
+    void acknowledge(uint16_t id) {
+        if (active && id == currentId) mark(LatencyStage::CLIENT);
+    }
+
+    void loop() {
+        if (active && micros() - stamps[(uint8_t)LatencyStage::RECEIVED] > LATENCY_TRACE_TIMEOUT_MS * 1000UL) {
+            finish();
+        }
+    }
+
+    bool isActive() const { return active; }
+    uint16_t id() const { return currentId; }
+    const Result& last(Kind kind) const { return results[kind]; }
+
+private:
+    bool active = false;
+    Kind currentKind = FLIP;
+    uint16_t currentId = 0;
+    uint32_t stamps[(uint8_t)LatencyStage::COUNT];
+    uint8_t seen = 0;
+    Result results[KIND_COUNT];
+
+    void finish() {
+        active = false;
+        Result& r = results[currentKind];
+        r.id = currentId;
+        r.totalUs = 0;
+
+        uint32_t start = stamps[(uint8_t)LatencyStage::RECEIVED];
+        for (uint8_t s = 0; s < (uint8_t)LatencyStage::COUNT; s++) {
+            if (seen & (1 << s)) {
+                r.stageUs[s] = (int32_t)(stamps[s] - start);
+                if ((uint32_t)r.stageUs[s] > r.totalUs) r.totalUs = r.stageUs[s];
+            } else {
+                r.stageUs[s] = -1;
+            }
+        }
+
+        DEBUG_PRINTF("Latency %s #%u:", kindName(currentKind), r.id);
+        for (uint8_t s = 1; s < (uint8_t)LatencyStage::COUNT; s++) {
+            if (r.stageUs[s] >= 0) DEBUG_PRINTF(" %s=%ldus", stageName(s), r.stageUs[s]);
+        }
+        DEBUG_PRINTF(" | total=%luus\n", r.totalUs);
+    }
+};
+
+extern LatencyTrace latencyTrace;
+
+#endif // LATENCY_TRACE_H
@@ -0,0 +1,28 @@
+#ifndef LOOP_STATS_H
+#define LOOP_STATS_H
+
+/**
+ * ============================================
+ * LoopStats - Main loop timing snapshot
+ * ============================================
+ *
+ * Filled by loop() once per second, served on /api/perf so load tests
+ * can see whether the web stack is starving the sensor loop.
+ */
+
+#include <stdint.h>
+
+struct LoopStats {
+    uint32_t loopsPerSec = 0;
+    uint32_t avgSystemUs = 0;
+    uint32_t avgWebUs = 0;
+    uint32_t avgAnalyticsUs = 0;
+    uint32_t avgOledUs = 0;
+    uint32_t maxWebUs = 0;         // Worst single webServer->loop()
+    uint32_t maxSensorGapMs = 0;   // Worst gap between sensor reads (nominal SENSOR_READ_INTERVAL)
+    uint32_t wsMessagesPerSec = 0; // Outgoing WebSocket messages (all clients)
+};
+
+extern LoopStats loopStats;
+
+#endif // LOOP_STATS_H
@@ -0,0 +1,608 @@
+#ifndef MESSAGES_H
+#define MESSAGES_H
+
+// Generated by build_messages.py from messages.json - do not edit
+
+#include <stdint.h>
+#include "JsonWriter.h"
+
+namespace MsgKey {
+constexpr char action[] = "\"action\":";
+constexpr char avgFocusPerDay[] = "\"avgFocusPerDay\":";
+constexpr char avgTasksPerDay[] = "\"avgTasksPerDay\":";
+constexpr char breakDuration[] = "\"breakDuration\":";
+constexpr char breakSeconds[] = "\"breakSeconds\":";
+constexpr char canWater[] = "\"canWater\":";
+constexpr char completed[] = "\"completed\":";
+constexpr char count[] = "\"count\":";
+constexpr char dailyGoal[] = "\"dailyGoal\":";
+constexpr char days[] = "\"days\":";
+constexpr char daysAgo[] = "\"daysAgo\":";
+constexpr char daysRecorded[] = "\"daysRecorded\":";
+constexpr char focus[] = "\"focus\":";
+constexpr char focusDuration[] = "\"focusDuration\":";
+constexpr char focusSeconds[] = "\"focusSeconds\":";
+constexpr char hasFullWeek[] = "\"hasFullWeek\":";
+constexpr char id[] = "\"id\":";
+constexpr char isWithered[] = "\"isWithered\":";
+constexpr char max[] = "\"max\":";
+constexpr char message[] = "\"message\":";
+constexpr char min[] = "\"min\":";
+constexpr char mostProductiveDay[] = "\"mostProductiveDay\":";
+constexpr char mostProductiveDayName[] = "\"mostProductiveDayName\":";
+constexpr char mostProductiveTasks[] = "\"mostProductiveTasks\":";
+constexpr char name[] = "\"name\":";
+constexpr char ok[] = "\"ok\":";
+constexpr char p50[] = "\"p50\":";
+constexpr char p90[] = "\"p90\":";
+constexpr char pauseTenths[] = "\"pauseTenths\":";
+constexpr char pendingWater[] = "\"pendingWater\":";
+constexpr char plant[] = "\"plant\":";
+constexpr char stage[] = "\"stage\":";
+constexpr char started[] = "\"started\":";
+constexpr char state[] = "\"state\":";
+constexpr char stats[] = "\"stats\":";
+constexpr char status[] = "\"status\":";
+constexpr char success[] = "\"success\":";
+constexpr char taskName[] = "\"taskName\":";
+constexpr char tasks[] = "\"tasks\":";
+constexpr char timeLeft[] = "\"timeLeft\":";
+constexpr char todayBreak[] = "\"todayBreak\":";
+constexpr char todayFocus[] = "\"todayFocus\":";
+constexpr char todaySessions[] = "\"todaySessions\":";
+constexpr char todayTasks[] = "\"todayTasks\":";
+constexpr char total[] = "\"total\":";
+constexpr char totalBreak[] = "\"totalBreak\":";
+constexpr char totalFocus[] = "\"totalFocus\":";
+constexpr char totalGoal[] = "\"totalGoal\":";
+constexpr char totalSessions[] = "\"totalSessions\":";
+constexpr char totalTasks[] = "\"totalTasks\":";
+constexpr char totalTime[] = "\"totalTime\":";
+constexpr char trace[] = "\"trace\":";
+constexpr char valid[] = "\"valid\":";
+constexpr char ver[] = "\"ver\":";
+constexpr char waitingForConfirmation[] = "\"waitingForConfirmation\":";
+constexpr char wateredCount[] = "\"wateredCount\":";
+constexpr char weekly[] = "\"weekly\":";
+}
+
+namespace MsgTag {
+constexpr char status[] = "\"type\":\"status\"";
+constexpr char plant[] = "\"type\":\"plant\"";
+constexpr char tasks[] = "\"type\":\"tasks\"";
+constexpr char stats[] = "\"type\":\"stats\"";
+constexpr char revive[] = "\"type\":\"revive\"";
+constexpr char ack[] = "\"type\":\"ack\"";
+}
+
+struct TaskMsg {
+    uint32_t id = 0;
+    const char* name = nullptr;
+    uint16_t focusDuration = 0;
+    uint16_t breakDuration = 0;
+    bool completed = false;
+    bool started = false;
+};
+
+inline void writeFields(JsonWriter& w, const TaskMsg& m) {
+    w.key(MsgKey::id);
+    w.u32(m.id);
+    w.key(MsgKey::name);
+    w.str(m.name ? m.name : "");
+    w.key(MsgKey::focusDuration);
+    w.u32(m.focusDuration);
+    w.key(MsgKey::breakDuration);
+    w.u32(m.breakDuration);
+    w.key(MsgKey::completed);
+    w.boolean(m.completed);
+    w.key(MsgKey::started);
+    w.boolean(m.started);
+}
+
+inline void writeObject(JsonWriter& w, const TaskMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct WeeklyMsg {
+    uint16_t totalTasks = 0;
+    uint16_t totalFocus = 0;
+    uint16_t totalBreak = 0;
+    uint16_t totalSessions = 0;
+    uint8_t avgTasksPerDay = 0;
+    uint16_t avgFocusPerDay = 0;
+    uint8_t mostProductiveDay = 0;
+    uint8_t mostProductiveTasks = 0;
+    uint8_t daysRecorded = 0;
+    bool hasFullWeek = false;
+    const char* mostProductiveDayName = nullptr;
+};
+
+inline void writeFields(JsonWriter& w, const WeeklyMsg& m) {
+    w.key(MsgKey::totalTasks);
+    w.u32(m.totalTasks);
+    w.key(MsgKey::totalFocus);
+    w.u32(m.totalFocus);
+    w.key(MsgKey::totalBreak);
+    w.u32(m.totalBreak);
+    w.key(MsgKey::totalSessions);
+    w.u32(m.totalSessions);
+    w.key(MsgKey::avgTasksPerDay);
+    w.u32(m.avgTasksPerDay);
+    w.key(MsgKey::avgFocusPerDay);
+    w.u32(m.avgFocusPerDay);
+    w.key(MsgKey::mostProductiveDay);
+    w.u32(m.mostProductiveDay);
+    w.key(MsgKey::mostProductiveTasks);
+    w.u32(m.mostProductiveTasks);
+    w.key(MsgKey::daysRecorded);
+    w.u32(m.daysRecorded);
+    w.key(MsgKey::hasFullWeek);
+    w.boolean(m.hasFullWeek);
+    w.key(MsgKey::mostProductiveDayName);
+    w.str(m.mostProductiveDayName ? m.mostProductiveDayName : "");
+}
+
+inline void writeObject(JsonWriter& w, const WeeklyMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct DayMsg {
+    uint8_t daysAgo = 0;
+    uint8_t tasks = 0;
+    uint16_t focus = 0;
+    bool valid = false;
+};
+
+inline void writeFields(JsonWriter& w, const DayMsg& m) {
+    w.key(MsgKey::daysAgo);
+    w.u32(m.daysAgo);
+    w.key(MsgKey::tasks);
+    w.u32(m.tasks);
+    w.key(MsgKey::focus);
+    w.u32(m.focus);
+    w.key(MsgKey::valid);
+    w.boolean(m.valid);
+}
+
+inline void writeObject(JsonWriter& w, const DayMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct QuantilesMsg {
+    uint16_t count = 0;
+    uint16_t min = 0;
+    uint16_t p50 = 0;
+    uint16_t p90 = 0;
+    uint16_t max = 0;
+};
+
+inline void writeFields(JsonWriter& w, const QuantilesMsg& m) {
+    w.key(MsgKey::count);
+    w.u32(m.count);
+    w.key(MsgKey::min);
+    w.u32(m.min);
+    w.key(MsgKey::p50);
+    w.u32(m.p50);
+    w.key(MsgKey::p90);
+    w.u32(m.p90);
+    w.key(MsgKey::max);
+    w.u32(m.max);
+}
+
+inline void writeObject(JsonWriter& w, const QuantilesMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct PlantSummaryMsg {
+    uint8_t stage = 0;
+    bool isWithered = false;
+    bool canWater = false;
+    uint8_t wateredCount = 0;
+    uint8_t totalGoal = 0;
+    uint8_t pendingWater = 0;
+    uint8_t dailyGoal = 0;
+};
+
+inline void writeFields(JsonWriter& w, const PlantSummaryMsg& m) {
+    w.key(MsgKey::stage);
+    w.u32(m.stage);
+    w.key(MsgKey::isWithered);
+    w.boolean(m.isWithered);
+    w.key(MsgKey::canWater);
+    w.boolean(m.canWater);
+    w.key(MsgKey::wateredCount);
+    w.u32(m.wateredCount);
+    w.key(MsgKey::totalGoal);
+    w.u32(m.totalGoal);
+    w.key(MsgKey::pendingWater);
+    w.u32(m.pendingWater);
+    w.key(MsgKey::dailyGoal);
+    w.u32(m.dailyGoal);
+}
+
+inline void writeObject(JsonWriter& w, const PlantSummaryMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct TaskCountsMsg {
+    uint8_t completed = 0;
+    uint8_t total = 0;
+};
+
+inline void writeFields(JsonWriter& w, const TaskCountsMsg& m) {
+    w.key(MsgKey::completed);
+    w.u32(m.completed);
+    w.key(MsgKey::total);
+    w.u32(m.total);
+}
+
+inline void writeObject(JsonWriter& w, const TaskCountsMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct StatusMsg {
+    uint32_t ver = 0;
+    const char* state = nullptr;
+    uint32_t timeLeft = 0;
+    uint32_t totalTime = 0;
+    bool waitingForConfirmation = false;
+    const char* taskName = nullptr;
+    bool hasTrace = false;
+    uint32_t trace = 0;
+};
+
+inline void writeFields(JsonWriter& w, const StatusMsg& m) {
+    w.key(MsgKey::ver);
+    w.u32(m.ver);
+    w.key(MsgKey::state);
+    w.str(m.state ? m.state : "");
+    w.key(MsgKey::timeLeft);
+    w.u32(m.timeLeft);
+    w.key(MsgKey::totalTime);
+    w.u32(m.totalTime);
+    w.key(MsgKey::waitingForConfirmation);
+    w.boolean(m.waitingForConfirmation);
+    w.key(MsgKey::taskName);
+    w.str(m.taskName);
+    if (m.hasTrace) {
+        w.key(MsgKey::trace);
+        w.u32(m.trace);
+    }
+}
+
+inline void writeObject(JsonWriter& w, const StatusMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct PlantMsg {
+    uint32_t ver = 0;
+    uint8_t stage = 0;
+    bool isWithered = false;
+    uint8_t wateredCount = 0;
+    uint8_t totalGoal = 0;
+    uint8_t pendingWater = 0;
+    uint8_t dailyGoal = 0;
+};
+
+inline void writeFields(JsonWriter& w, const PlantMsg& m) {
+    w.key(MsgKey::ver);
+    w.u32(m.ver);
+    w.key(MsgKey::stage);
+    w.u32(m.stage);
+    w.key(MsgKey::isWithered);
+    w.boolean(m.isWithered);
+    w.key(MsgKey::wateredCount);
+    w.u32(m.wateredCount);
+    w.key(MsgKey::totalGoal);
+    w.u32(m.totalGoal);
+    w.key(MsgKey::pendingWater);
+    w.u32(m.pendingWater);
+    w.key(MsgKey::dailyGoal);
+    w.u32(m.dailyGoal);
+}
+
+inline void writeObject(JsonWriter& w, const PlantMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct TasksMsg {
+    uint32_t ver = 0;
+    const TaskMsg* tasks = nullptr;
+    uint8_t tasksCount = 0;
+};
+
+inline void writeFields(JsonWriter& w, const TasksMsg& m) {
+    w.key(MsgKey::ver);
+    w.u32(m.ver);
+    w.key(MsgKey::tasks);
+    w.beginArray();
+    for (uint8_t i = 0; i < m.tasksCount; i++) writeObject(w, m.tasks[i]);
+    w.endArray();
+}
+
+inline void writeObject(JsonWriter& w, const TasksMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct StatsMsg {
+    uint8_t todayTasks = 0;
+    uint16_t todayFocus = 0;
+    uint16_t todayBreak = 0;
+    uint8_t todaySessions = 0;
+    WeeklyMsg weekly;
+    const DayMsg* days = nullptr;
+    uint8_t daysCount = 0;
+    QuantilesMsg focusSeconds;
+    QuantilesMsg pauseTenths;
+    QuantilesMsg breakSeconds;
+};
+
+inline void writeFields(JsonWriter& w, const StatsMsg& m) {
+    w.key(MsgKey::todayTasks);
+    w.u32(m.todayTasks);
+    w.key(MsgKey::todayFocus);
+    w.u32(m.todayFocus);
+    w.key(MsgKey::todayBreak);
+    w.u32(m.todayBreak);
+    w.key(MsgKey::todaySessions);
+    w.u32(m.todaySessions);
+    w.key(MsgKey::weekly);
+    writeObject(w, m.weekly);
+    w.key(MsgKey::days);
+    w.beginArray();
+    for (uint8_t i = 0; i < m.daysCount; i++) writeObject(w, m.days[i]);
+    w.endArray();
+    w.key(MsgKey::focusSeconds);
+    writeObject(w, m.focusSeconds);
+    w.key(MsgKey::pauseTenths);
+    writeObject(w, m.pauseTenths);
+    w.key(MsgKey::breakSeconds);
+    writeObject(w, m.breakSeconds);
+}
+
+inline void writeObject(JsonWriter& w, const StatsMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct ReviveMsg {
+    const char* message = nullptr;
+};
+
+inline void writeFields(JsonWriter& w, const ReviveMsg& m) {
+    w.key(MsgKey::message);
+    w.str(m.message ? m.message : "");
+}
+
+inline void writeObject(JsonWriter& w, const ReviveMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct AckMsg {
+    uint32_t id = 0;
+    bool ok = false;
+    uint32_t ver = 0;
+    const StatusMsg* status = nullptr;      // nullptr: left out
+    const PlantMsg* plant = nullptr;      // nullptr: left out
+    bool hasTasks = false;
+    const TaskMsg* tasks = nullptr;
+    uint8_t tasksCount = 0;
+};
+
+inline void writeFields(JsonWriter& w, const AckMsg& m) {
+    w.key(MsgKey::id);
+    w.u32(m.id);
+    w.key(MsgKey::ok);
+    w.boolean(m.ok);
+    w.key(MsgKey::ver);
+    w.u32(m.ver);
+    if (m.status) {
+        w.key(MsgKey::status);
+        writeObject(w, *m.status);
+    }
+    if (m.plant) {
+        w.key(MsgKey::plant);
+        writeObject(w, *m.plant);
+    }
+    if (m.hasTasks) {
+        w.key(MsgKey::tasks);
+        w.beginArray();
+        for (uint8_t i = 0; i < m.tasksCount; i++) writeObject(w, m.tasks[i]);
+        w.endArray();
+    }
+}
+
+inline void writeObject(JsonWriter& w, const AckMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct ActionReplyMsg {
+    bool success = false;
+    bool hasAction = false;
+    const char* action = nullptr;
+    bool hasOk = false;
+    bool ok = false;
+    bool hasVer = false;
+    uint32_t ver = 0;
+    const StatusMsg* status = nullptr;      // nullptr: left out
+    const PlantMsg* plant = nullptr;      // nullptr: left out
+    bool hasTasks = false;
+    const TaskMsg* tasks = nullptr;
+    uint8_t tasksCount = 0;
+};
+
+inline void writeFields(JsonWriter& w, const ActionReplyMsg& m) {
+    w.key(MsgKey::success);
+    w.boolean(m.success);
+    if (m.hasAction) {
+        w.key(MsgKey::action);
+        w.str(m.action ? m.action : "");
+    }
+    if (m.hasOk) {
+        w.key(MsgKey::ok);
+        w.boolean(m.ok);
+    }
+    if (m.hasVer) {
+        w.key(MsgKey::ver);
+        w.u32(m.ver);
+    }
+    if (m.status) {
+        w.key(MsgKey::status);
+        writeObject(w, *m.status);
+    }
+    if (m.plant) {
+        w.key(MsgKey::plant);
+        writeObject(w, *m.plant);
+    }
+    if (m.hasTasks) {
+        w.key(MsgKey::tasks);
+        w.beginArray();
+        for (uint8_t i = 0; i < m.tasksCount; i++) writeObject(w, m.tasks[i]);
+        w.endArray();
+    }
+}
+
+inline void writeObject(JsonWriter& w, const ActionReplyMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct ApiStatusMsg {
+    const char* state = nullptr;
+    uint32_t timeLeft = 0;
+    uint32_t totalTime = 0;
+    const char* taskName = nullptr;
+    PlantSummaryMsg plant;
+    TaskCountsMsg stats;
+    uint32_t ver = 0;
+};
+
+inline void writeFields(JsonWriter& w, const ApiStatusMsg& m) {
+    w.key(MsgKey::state);
+    w.str(m.state ? m.state : "");
+    w.key(MsgKey::timeLeft);
+    w.u32(m.timeLeft);
+    w.key(MsgKey::totalTime);
+    w.u32(m.totalTime);
+    w.key(MsgKey::taskName);
+    w.str(m.taskName);
+    w.key(MsgKey::plant);
+    writeObject(w, m.plant);
+    w.key(MsgKey::stats);
+    writeObject(w, m.stats);
+    w.key(MsgKey::ver);
+    w.u32(m.ver);
+}
+
+inline void writeObject(JsonWriter& w, const ApiStatusMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+struct ApiTasksMsg {
+    const TaskMsg* tasks = nullptr;
+    uint8_t tasksCount = 0;
+    uint32_t ver = 0;
+};
+
+inline void writeFields(JsonWriter& w, const ApiTasksMsg& m) {
+    w.key(MsgKey::tasks);
+    w.beginArray();
+    for (uint8_t i = 0; i < m.tasksCount; i++) writeObject(w, m.tasks[i]);
+    w.endArray();
+    w.key(MsgKey::ver);
+    w.u32(m.ver);
+}
+
+inline void writeObject(JsonWriter& w, const ApiTasksMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+inline void writeJson(JsonWriter& w, const StatusMsg& m) {
+    w.beginObject();
+    w.member(MsgTag::status);
+    writeFields(w, m);
+    w.endObject();
+}
+
+inline void writeJson(JsonWriter& w, const PlantMsg& m) {
+    w.beginObject();
+    w.member(MsgTag::plant);
+    writeFields(w, m);
+    w.endObject();
+}
+
+inline void writeJson(JsonWriter& w, const TasksMsg& m) {
+    w.beginObject();
+    w.member(MsgTag::tasks);
+    writeFields(w, m);
+    w.endObject();
+}
+
+inline void writeJson(JsonWriter& w, const StatsMsg& m) {
+    w.beginObject();
+    w.member(MsgTag::stats);
+    writeFields(w, m);
+    w.endObject();
+}
+
+inline void writeJson(JsonWriter& w, const ReviveMsg& m) {
+    w.beginObject();
+    w.member(MsgTag::revive);
+    writeFields(w, m);
+    w.endObject();
+}
+
+inline void writeJson(JsonWriter& w, const AckMsg& m) {
+    w.beginObject();
+    w.member(MsgTag::ack);
+    writeFields(w, m);
+    w.endObject();
+}
+
+inline void writeJson(JsonWriter& w, const ActionReplyMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+inline void writeJson(JsonWriter& w, const ApiStatusMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+inline void writeJson(JsonWriter& w, const ApiTasksMsg& m) {
+    w.beginObject();
+    writeFields(w, m);
+    w.endObject();
+}
+
+#endif // MESSAGES_H
@@ -0,0 +1,309 @@
+#ifndef MQTT_PUBLISHER_H
+#define MQTT_PUBLISHER_H
+
+/**
+ * ============================================
+ * MqttPublisher - State and events to a local broker
+ * ============================================
+ *
+ * Topics under MQTT_TOPIC_PREFIX/<cube id>/:
+ *
+ *   state    retained  {"mode","task","timeLeft","totalTime"}
+ *   plant    retained  {"stage","withered","watered","goal","pending"}
+ *   stats    retained  today: {"tasks","focus","break","sessions"}
+ *   online   retained  "1", broker sets "0" (last will) when we vanish
+ *   events             batched JSON array of {"type":"session"|"day",...}
+ *
+ * Retained topics hold only the latest value and go out when it changes.
+ * Events queue in a RAM outbox and are sent as one message per
+ * MQTT_BATCH_MS (or when MQTT_BATCH_MAX are waiting); while the broker is
+ * unreachable they wait there, the oldest dropped when it is full.
+ *
+ * The client runs in its own task on the loop's core, so a broker that
+ * is down (TCP connect timeouts, backoff) never stalls the main loop;
+ * the loop only copies strings into the outbox.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <PubSubClient.h>
+#include <ArduinoJson.h>
+#include "config.h"
+#include "SystemState.h"
+#include "Analytics.h"
+
+class MqttPublisher {
+public:
+    enum Retained : uint8_t { STATE, PLANT, STATS, RETAINED_COUNT };
+
+    static const uint8_t PAYLOAD_MAX = 160;
+
+    MqttPublisher(SystemState& state, Analytics& analytics)
+        : state(state), analytics(analytics) {}
+
+    void begin() {
+        if (!MQTT_ENABLED || strlen(MQTT_BROKER) == 0) {
+            DEBUG_PRINTLN("MQTT: No broker configured");
+            return;
+        }
+        uint8_t mac[6];
+        WiFi.macAddress(mac);
+        snprintf(clientId, sizeof(clientId), "bloom-%02x%02x%02x", mac[3], mac[4], mac[5]);
+        snprintf(topicBase, sizeof(topicBase), "%s/%s/", MQTT_TOPIC_PREFIX, clientId);
+
+        xTaskCreatePinnedToCore(taskEntry, "mqtt", MQTT_TASK_STACK, this, 1, nullptr, xPortGetCoreID());
+        DEBUG_PRINTF("MQTT: Publishing to %s:%d as %s\n", MQTT_BROKER, MQTT_PORT, topicBase);
+    }
+
+    // ============================================
+    // Producers (main loop)
+    // ============================================
+
+    // Refresh the retained topics; unchanged values are not re-sent
+    void stateChanged() {
+        StaticJsonDocument<192> doc;
+        char payload[PAYLOAD_MAX];
+
+        doc["mode"] = state.getModeString();
+        const char* task = state.getCurrentTaskName();
+        doc["task"] = task ? task : (char*)nullptr;
+        doc["timeLeft"] = state.getTimeLeft();
+        doc["totalTime"] = state.getTotalTime();
+        serializeJson(doc, payload, sizeof(payload));
+        setRetained(STATE, payload);
+
+        doc.clear();
+        PlantInfo plant = state.getPlantInfo();
+        doc["stage"] = plant.stage;
+        doc["withered"] = plant.isWithered;
+        doc["watered"] = plant.wateredCount;
+        doc["goal"] = plant.totalGoal;
+        doc["pending"] = state.getPendingWaterCount();
+        serializeJson(doc, payload, sizeof(payload));
+        setRetained(PLANT, payload);
+
+        doc.clear();
+        DailyStats stats = analytics.getTodayStats();
+        doc["tasks"] = stats.tasksCompleted;
+        doc["focus"] = stats.focusMinutes;
+        doc["break"] = stats.breakMinutes;
+        doc["sessions"] = stats.sessionsCount;
+        serializeJson(doc, payload, sizeof(payload));
+        setRetained(STATS, payload);
+    }
+
+    void sessionCompleted(const char* kind, uint32_t minutes, const char* task) {
+        StaticJsonDocument<192> doc;
+        doc["type"] = "session";
+        doc["ts"] = timestamp();
+        doc["kind"] = kind;
+        doc["minutes"] = minutes;
+        doc["task"] = task ? task : (char*)nullptr;
+        addEvent(doc);
+    }
+
+    // Called before Analytics resets today's stats
+    void dayEnded(bool goalMet) {
+        StaticJsonDocument<192> doc;
+        DailyStats stats = analytics.getTodayStats();
+        PlantInfo plant = state.getPlantInfo();
+        doc["type"] = "day";
+        doc["ts"] = timestamp();
+        doc["tasks"] = stats.tasksCompleted;
+        doc["focus"] = stats.focusMinutes;
+        doc["break"] = stats.breakMinutes;
+        doc["sessions"] = stats.sessionsCount;
+        doc["watered"] = plant.wateredCount;
+        doc["goal"] = plant.totalGoal;
+        doc["goalMet"] = goalMet;
+        addEvent(doc);
+    }
+
+    bool isConnected() const { return connected; }
+    uint32_t getPublished() const { return published; }
+    uint32_t getDropped() const { return dropped; }
+
+private:
+    SystemState& state;
+    Analytics& analytics;
+
+    char clientId[16] = "";
+    char topicBase[48] = "";
+
+    // Shared between the loop (producer) and the MQTT task (consumer)
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    char retained[RETAINED_COUNT][PAYLOAD_MAX] = {};
+    bool retainedDirty[RETAINED_COUNT] = {};
+    char outbox[MQTT_OUTBOX_SIZE][PAYLOAD_MAX];
+    uint32_t outboxHead = 0;       // Sequence number of the oldest event
+    uint32_t outboxTail = 0;       // Sequence number of the next event
+    uint32_t oldestQueuedMs = 0;
+
+    volatile bool connected = false;
+    uint32_t published = 0;
+    uint32_t dropped = 0;
+
+    static uint32_t timestamp() {
+        time_t now = time(nullptr);
+        return now > 1577836800 ? (uint32_t)now : 0;  // 0 until the clock is set
+    }
+
+    void setRetained(Retained topic, const char* payload) {
+        portENTER_CRITICAL(&lock);
+        if (strcmp(retained[topic], payload) != 0) {
+            strcpy(retained[topic], payload);
+            retainedDirty[topic] = true;
+        }
+        portEXIT_CRITICAL(&lock);
+    }
+
+    void addEvent(JsonDocument& doc) {
+        char payload[PAYLOAD_MAX];
+        serializeJson(doc, payload, sizeof(payload));
+
+        portENTER_CRITICAL(&lock);
+        if (outboxTail - outboxHead == MQTT_OUTBOX_SIZE) {
+            outboxHead++;  // Full: drop the oldest
+            dropped++;
+        }
+        if (outboxTail == outboxHead) oldestQueuedMs = millis();
+        strcpy(outbox[outboxTail % MQTT_OUTBOX_SIZE], payload);
+        outboxTail++;
+        portEXIT_CRITICAL(&lock);
+    }
+
+    // ============================================
+    // MQTT task
+    // ============================================
+
+    static void taskEntry(void* arg) {
+        ((MqttPublisher*)arg)->run();
+    }
+
+    void run() {
+        WiFiClient net;
+        PubSubClient client(net);
+        client.setServer(MQTT_BROKER, MQTT_PORT);
+        client.setBufferSize(MQTT_BUFFER_SIZE);
+        client.setSocketTimeout(MQTT_SOCKET_TIMEOUT_S);
+
+        char willTopic[64];
+        topic(willTopic, sizeof(willTopic), "online");
+        uint32_t backoffMs = MQTT_BACKOFF_MIN_MS;
+        uint32_t nextAttemptMs = 0;
+
+        for (;;) {
+            if (!client.connected()) {
+                connected = false;
+                if (WiFi.status() == WL_CONNECTED && (int32_t)(millis() - nextAttemptMs) >= 0) {
+                    bool ok = client.connect(clientId,
+                                             strlen(MQTT_USER) ? MQTT_USER : nullptr,
+                                             strlen(MQTT_PASSWORD) ? MQTT_PASSWORD : nullptr,
+                                             willTopic, 0, true, "0");
+                    if (ok) {
+                        DEBUG_PRINTLN("MQTT: Connected");
+                        client.publish(willTopic, "1", true);
+                        markRetainedDirty();   // The broker may have lost them
+                        backoffMs = MQTT_BACKOFF_MIN_MS;
+                        connected = true;
+                    } else {
+                        DEBUG_PRINTF("MQTT: Connect failed (%d), retry in %lu ms\n",
+                                     client.state(), (unsigned long)backoffMs);
+                        nextAttemptMs = millis() + backoffMs;
+                        backoffMs = backoffMs * 2 > MQTT_BACKOFF_MAX_MS ? MQTT_BACKOFF_MAX_MS : backoffMs * 2;
+                    }
+                }
+                vTaskDelay(pdMS_TO_TICKS(200));
+                continue;
+            }
+
+            client.loop();
+            flushRetained(client);
+            flushEvents(client);
+            vTaskDelay(pdMS_TO_TICKS(50));
+        }
+    }
+
+    void topic(char* out, size_t size, const char* name) {
+        snprintf(out, size, "%s%s", topicBase, name);
+    }
+
+    void markRetainedDirty() {
+        portENTER_CRITICAL(&lock);
+        for (uint8_t i = 0; i < RETAINED_COUNT; i++) {
+            retainedDirty[i] = retained[i][0] != '\0';
+        }
+        portEXIT_CRITICAL(&lock);
+    }
+
+    void flushRetained(PubSubClient& client) {
+        static const char* const names[RETAINED_COUNT] = { "state", "plant", "stats" };
+        for (uint8_t i = 0; i < RETAINED_COUNT; i++) {
+            char payload[PAYLOAD_MAX];
+            portENTER_CRITICAL(&lock);
+            bool dirty = retainedDirty[i];
+            if (dirty) {
+                strcpy(payload, retained[i]);
+                retainedDirty[i] = false;
+            }
+            portEXIT_CRITICAL(&lock);
+            if (!dirty) continue;
+
+            char name[64];
+            topic(name, sizeof(name), names[i]);
+            if (client.publish(name, payload, true)) {
+                published++;
+            } else {
+                portENTER_CRITICAL(&lock);
+                retainedDirty[i] = true;  // Unless a newer value already replaced it
+                portEXIT_CRITICAL(&lock);
+            }
+        }
+    }
+
+    // One message with every queued event that fits, once the batch is due
+    void flushEvents(PubSubClient& client) {
+        static char batch[MQTT_BUFFER_SIZE - 64];
+
+        portENTER_CRITICAL(&lock);
+        uint32_t head = outboxHead;
+        uint32_t tail = outboxTail;
+        bool due = tail - head >= MQTT_BATCH_MAX ||
+                   (tail != head && millis() - oldestQueuedMs >= MQTT_BATCH_MS);
+        portEXIT_CRITICAL(&lock);
+        if (!due) return;
+
+        size_t len = 0;
+        uint32_t seq = head;
+        batch[len++] = '[';
+        for (; seq != tail; seq++) {
+            char event[PAYLOAD_MAX];
+            portENTER_CRITICAL(&lock);
+            bool overwritten = seq < outboxHead;   // Dropped while we were building
+            if (!overwritten) strcpy(event, outbox[seq % MQTT_OUTBOX_SIZE]);
+            portEXIT_CRITICAL(&lock);
+            if (overwritten) continue;
+
+            size_t eventLen = strlen(event);
+            if (len + eventLen + 2 > sizeof(batch)) break;  // Rest goes in the next batch
+            if (len > 1) batch[len++] = ',';
+            memcpy(batch + len, event, eventLen);
+            len += eventLen;
+        }
+        batch[len++] = ']';
+
+        char name[64];
+        topic(name, sizeof(name), "events");
+        if (!client.publish(name, (const uint8_t*)batch, len, false)) return;  // Retry next pass
+        published++;
+
+        portENTER_CRITICAL(&lock);
+        if (outboxHead < seq) outboxHead = seq;
+        oldestQueuedMs = millis();
+        portEXIT_CRITICAL(&lock);
+    }
+};
+
+extern MqttPublisher mqttPublisher;
+
+#endif // MQTT_PUBLISHER_H
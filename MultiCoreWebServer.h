@@ -22,6 +22,7 @@
 #include "SystemState.h"
 #include "WebContent.h"
 #include "Analytics.h"
+#include "StateMessages.h"
 
 // Forward declaration
 extern Analytics analytics;
@@ -94,6 +95,7 @@ public:
     void broadcastStatus();
     void broadcastPlant();
     void broadcastTasks();
+    void broadcastRevive();
     
 private:
     // Servers
@@ -125,6 +127,19 @@ private:
     // Queue for broadcasts from other cores
     QueueHandle_t broadcastQueue;
     
+    // Outgoing JSON (written on Core 0 only)
+    char messageBuffer[MESSAGE_BUFFER_SIZE];
+    TaskMsg taskMsgs[MAX_TASKS];
+    template <typename Msg> size_t serialize(const Msg& msg);
+    void sendMessage(size_t length);
+    
+    // Run on Core 0; each takes the state lock itself
+    void broadcastStatusInternal();
+    void broadcastPlantInternal();
+    void broadcastTasksInternal();
+    void broadcastReviveInternal();
+    void sendStats(uint8_t num);
+    
     // Private methods
     void setupActionHandlers();
     void setupRoutes();
@@ -162,7 +177,8 @@ private:
 enum BroadcastType {
     BROADCAST_STATUS = 1,
     BROADCAST_PLANT = 2,
-    BROADCAST_TASKS = 3
+    BROADCAST_TASKS = 3,
+    BROADCAST_REVIVE = 4
 };
 
 // ============================================
@@ -278,6 +294,9 @@ void MultiCoreWebServer::webLoop() {
                 case BROADCAST_TASKS:
                     broadcastTasksInternal();
                     break;
+                case BROADCAST_REVIVE:
+                    broadcastReviveInternal();
+                    break;
             }
         }
         
@@ -417,12 +436,11 @@ void MultiCoreWebServer::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t* p
             // Debounce: wait 100ms for TCP to stabilize before sending data
             vTaskDelay(pdMS_TO_TICKS(100));
             
-            // Send initial state (thread-safe)
-            safeState->withLockVoid([this]() {
-                broadcastTasksInternal();
-                broadcastPlantInternal();
-                broadcastStatusInternal();
-            });
+            // Send initial state (each broadcast locks the state itself)
+            broadcastTasksInternal();
+            broadcastPlantInternal();
+            broadcastStatusInternal();
+            sendStats(num);
             break;
         }
         
@@ -451,64 +469,73 @@ void MultiCoreWebServer::broadcastTasks() {
     xQueueSend(broadcastQueue, &msg, 0);
 }
 
+void MultiCoreWebServer::broadcastRevive() {
+    BroadcastType msg = BROADCAST_REVIVE;
+    xQueueSend(broadcastQueue, &msg, 0);
+}
+
+// Serializes into messageBuffer; 0 if the message did not fit
+template <typename Msg>
+size_t MultiCoreWebServer::serialize(const Msg& msg) {
+    JsonWriter writer(messageBuffer, sizeof(messageBuffer));
+    writeJson(writer, msg);
+    if (writer.ok()) return writer.length();
+    DEBUG_PRINTLN("MultiCoreWebServer: Message too large (MESSAGE_BUFFER_SIZE)");
+    return 0;
+}
+
+void MultiCoreWebServer::sendMessage(size_t length) {
+    if (length == 0) {
+        server.send(500, "application/json", "{\"error\":\"Reply too large\"}");
+        return;
+    }
+    server.send(200, "application/json", messageBuffer);
+}
+
 // Internal broadcast methods (run on Core 0)
+// Serialized under the lock: the messages point into SystemState
 void MultiCoreWebServer::broadcastStatusInternal() {
-    StaticJsonDocument<256> doc;
-    doc["type"] = "status";
-    
-    safeState->withLockVoid([this, &doc]() {
-        doc["state"] = systemState->getModeString();
-        doc["timeLeft"] = systemState->getTimeLeft();
-        doc["totalTime"] = systemState->getTotalTime();
-        const char* taskName = systemState->getCurrentTaskName();
-        doc["taskName"] = taskName ? taskName : (char*)nullptr;
+    size_t length = safeState->withLock([this]() {
+        StatusMsg msg;
+        fillStatus(msg, systemState);
+        return serialize(msg);
     });
-    
-    String message;
-    serializeJson(doc, message);
-    webSocket.broadcastTXT(message);
+    if (length) webSocket.broadcastTXT(messageBuffer, length);
 }
 
 void MultiCoreWebServer::broadcastPlantInternal() {
-    StaticJsonDocument<192> doc;
-    doc["type"] = "plant";
-    
-    safeState->withLockVoid([this, &doc]() {
-        PlantInfo plant = systemState->getPlantInfo();
-        doc["stage"] = plant.stage;
-        doc["isWithered"] = plant.isWithered;
-        doc["wateredCount"] = plant.wateredCount;
-        doc["totalGoal"] = plant.totalGoal;
-        doc["pendingWater"] = systemState->getPendingWaterCount();
-        doc["dailyGoal"] = systemState->getDailyGoal();
+    size_t length = safeState->withLock([this]() {
+        PlantMsg msg;
+        fillPlant(msg, systemState);
+        return serialize(msg);
     });
-    
-    String message;
-    serializeJson(doc, message);
-    webSocket.broadcastTXT(message);
+    if (length) webSocket.broadcastTXT(messageBuffer, length);
 }
 
 void MultiCoreWebServer::broadcastTasksInternal() {
-    StaticJsonDocument<1024> doc;
-    doc["type"] = "tasks";
-    JsonArray tasksArray = doc.createNestedArray("tasks");
-    
-    safeState->withLockVoid([this, &tasksArray]() {
-        TaskInfo* tasks = systemState->getTasks();
-        for (int i = 0; i < systemState->getTaskCount(); i++) {
-            JsonObject task = tasksArray.createNestedObject();
-            task["id"] = tasks[i].id;
-            task["name"] = tasks[i].name;
-            task["focusDuration"] = tasks[i].focusDuration;
-            task["breakDuration"] = tasks[i].breakDuration;
-            task["completed"] = tasks[i].completed;
-            task["started"] = tasks[i].started;
-        }
+    size_t length = safeState->withLock([this]() {
+        TasksMsg msg;
+        msg.ver = systemState->getVersion();
+        msg.tasks = taskMsgs;
+        msg.tasksCount = fillTasks(taskMsgs, systemState);
+        return serialize(msg);
     });
-    
-    String message;
-    serializeJson(doc, message);
-    webSocket.broadcastTXT(message);
+    if (length) webSocket.broadcastTXT(messageBuffer, length);
+}
+
+void MultiCoreWebServer::broadcastReviveInternal() {
+    ReviveMsg msg;
+    msg.message = "Plant Revived! You can plant again!";
+    size_t length = serialize(msg);
+    if (length) webSocket.broadcastTXT(messageBuffer, length);
+}
+
+void MultiCoreWebServer::sendStats(uint8_t num) {
+    StatsMsg msg;
+    DayMsg days[7];
+    fillStats(msg, days, analytics);
+    size_t length = serialize(msg);
+    if (length) webSocket.sendTXT(num, messageBuffer, length);
 }
 
 bool MultiCoreWebServer::connectWiFi() {
@@ -670,55 +697,23 @@ void MultiCoreWebServer::handleApiStatus() {
     DEBUG_PRINTLN("API: /api/status called");
     server.sendHeader("Access-Control-Allow-Origin", "*");
     
-    StaticJsonDocument<512> doc;
-    JsonObject root = doc.to<JsonObject>();
-    
-    safeState->withLockVoid([this, &root]() {
-        root["state"] = systemState->getModeString();
-        root["timeLeft"] = systemState->getTimeLeft();
-        root["totalTime"] = systemState->getTotalTime();
-        
-        const char* taskName = systemState->getCurrentTaskName();
-        root["taskName"] = taskName ? taskName : (char*)nullptr;
-        
-        JsonObject plantObj = root.createNestedObject("plant");
-        PlantInfo plant = systemState->getPlantInfo();
-        plantObj["stage"] = plant.stage;
-        plantObj["isWithered"] = plant.isWithered;
-        plantObj["canWater"] = plant.canWater;
-        
-        JsonObject statsObj = root.createNestedObject("stats");
-        statsObj["completed"] = systemState->getCompletedCount();
-        statsObj["total"] = systemState->getTaskCount();
-    });
-    
-    String response;
-    serializeJson(doc, response);
-    server.send(200, "application/json", response);
+    sendMessage(safeState->withLock([this]() {
+        ApiStatusMsg msg;
+        fillApiStatus(msg, systemState);
+        return serialize(msg);
+    }));
 }
 
 void MultiCoreWebServer::handleApiTasks() {
     server.sendHeader("Access-Control-Allow-Origin", "*");
     
-    StaticJsonDocument<1024> doc;
-    JsonArray tasksArray = doc.createNestedArray("tasks");
-    
-    safeState->withLockVoid([this, &tasksArray]() {
-        TaskInfo* tasks = systemState->getTasks();
-        for (int i = 0; i < systemState->getTaskCount(); i++) {
-            JsonObject task = tasksArray.createNestedObject();
-            task["id"] = tasks[i].id;
-            task["name"] = tasks[i].name;
-            task["focusDuration"] = tasks[i].focusDuration;
-            task["breakDuration"] = tasks[i].breakDuration;
-            task["completed"] = tasks[i].completed;
-            task["started"] = tasks[i].started;
-        }
-    });
-    
-    String response;
-    serializeJson(doc, response);
-    server.send(200, "application/json", response);
+    sendMessage(safeState->withLock([this]() {
+        ApiTasksMsg msg;
+        msg.tasks = taskMsgs;
+        msg.tasksCount = fillTasks(taskMsgs, systemState);
+        msg.ver = systemState->getVersion();
+        return serialize(msg);
+    }));
 }
 
 void MultiCoreWebServer::handleApiAddTask() {
@@ -777,9 +772,10 @@ void MultiCoreWebServer::handleApiAction() {
     if (it != actionHandlers.end()) {
         it->second(doc);
         
-        char response[64];
-        snprintf(response, sizeof(response), "{\"success\":true,\"action\":\"%s\"}", action);
-        server.send(200, "application/json", response);
+        ActionReplyMsg reply;
+        reply.success = true;
+        reply.action = action;
+        sendMessage(serialize(reply));
     } else {
         server.send(400, "application/json", "{\"error\":\"Unknown action\"}");
     }
@@ -788,24 +784,10 @@ void MultiCoreWebServer::handleApiAction() {
 void MultiCoreWebServer::handleApiStats() {
     server.sendHeader("Access-Control-Allow-Origin", "*");
     
-    StaticJsonDocument<512> doc;
-    
-    DailyStats today = analytics.getTodayStats();
-    doc["todayTasks"] = today.tasksCompleted;
-    doc["todayFocus"] = today.focusMinutes;
-    doc["todayBreak"] = today.breakMinutes;
-    doc["todaySessions"] = today.sessionsCount;
-    
-    WeeklyReport week = analytics.getWeeklyReport();
-    JsonObject weekly = doc.createNestedObject("weekly");
-    weekly["totalTasks"] = week.totalTasks;
-    weekly["totalFocus"] = week.totalFocusMinutes;
-    weekly["avgTasksPerDay"] = week.avgTasksPerDay;
-    weekly["daysRecorded"] = week.daysRecorded;
-    
-    String response;
-    serializeJson(doc, response);
-    server.send(200, "application/json", response);
+    StatsMsg msg;
+    DayMsg days[7];
+    fillStats(msg, days, analytics);
+    sendMessage(serialize(msg));
 }
 
 void MultiCoreWebServer::handleNotFound() {
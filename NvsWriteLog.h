@@ -0,0 +1,159 @@
+#ifndef NVS_WRITE_LOG_H
+#define NVS_WRITE_LOG_H
+
+/**
+ * ============================================
+ * NvsWriteLog - Record every NVS write
+ * ============================================
+ *
+ * TracedPreferences is a drop-in for Preferences that logs each put*()
+ * (namespace, key, NVS type, size, value hash) into a small ring.
+ * /api/flash serves the ring so nvs_model.py can collect a real usage
+ * trace and replay it against a model of the ESP-IDF NVS page layout.
+ *
+ * The value hash matters: ESP-IDF skips a write whose value is already
+ * stored, so most of saveTasks()' keys cost nothing in flash.
+ */
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+
+// ESP-IDF nvs_type_t codes (as used by the NVS item header)
+enum NvsItemType : uint8_t {
+    NVS_ITEM_U8   = 0x01,
+    NVS_ITEM_U16  = 0x02,
+    NVS_ITEM_U32  = 0x04,
+    NVS_ITEM_STR  = 0x21,
+    NVS_ITEM_BLOB = 0x42
+};
+
+struct NvsWrite {
+    uint32_t seq;
+    uint32_t ms;
+    uint8_t ns;        // Index into NvsWriteLog namespace table
+    uint8_t type;      // NvsItemType
+    uint16_t size;     // Value bytes (strings include the terminator)
+    uint16_t hash;     // FNV-1a of the value, folded to 16 bits
+    char key[16];
+};
+
+class NvsWriteLog {
+public:
+    static const uint8_t MAX_NAMESPACES = 8;
+
+    void record(const char* ns, const char* key, uint8_t type, const void* value, uint16_t size) {
+#if NVS_TRACE
+        NvsWrite& w = ring[nextSeq % NVS_TRACE_DEPTH];
+        w.seq = nextSeq++;
+        w.ms = millis();
+        w.ns = namespaceIndex(ns);
+        w.type = type;
+        w.size = size;
+        w.hash = hash(value, size);
+        strncpy(w.key, key, sizeof(w.key) - 1);
+        w.key[sizeof(w.key) - 1] = '\0';
+
+        totalWrites++;
+        totalBytes += size;
+#endif
+    }
+
+    // Oldest retained write with seq >= since, nullptr if none
+    const NvsWrite* find(uint32_t since) const {
+        uint32_t oldest = nextSeq > NVS_TRACE_DEPTH ? nextSeq - NVS_TRACE_DEPTH : 0;
+        if (since < oldest) since = oldest;
+        return since < nextSeq ? &ring[since % NVS_TRACE_DEPTH] : nullptr;
+    }
+
+    uint32_t nextSequence() const { return nextSeq; }
+    uint32_t getTotalWrites() const { return totalWrites; }
+    uint32_t getTotalBytes() const { return totalBytes; }
+    const char* namespaceName(uint8_t index) const {
+        return index < namespaceCount ? namespaces[index] : "?";
+    }
+
+private:
+    NvsWrite ring[NVS_TRACE_DEPTH];
+    uint32_t nextSeq = 0;
+    uint32_t totalWrites = 0;
+    uint32_t totalBytes = 0;
+
+    // Namespace names are string literals owned by the callers
+    const char* namespaces[MAX_NAMESPACES];
+    uint8_t namespaceCount = 0;
+
+    uint8_t namespaceIndex(const char* ns) {
+        for (uint8_t i = 0; i < namespaceCount; i++) {
+            if (strcmp(namespaces[i], ns) == 0) return i;
+        }
+        if (namespaceCount == MAX_NAMESPACES) return MAX_NAMESPACES - 1;
+        namespaces[namespaceCount] = ns;
+        return namespaceCount++;
+    }
+
+    static uint16_t hash(const void* value, uint16_t size) {
+        const uint8_t* p = (const uint8_t*)value;
+        uint32_t h = 2166136261UL;
+        for (uint16_t i = 0; i < size; i++) {
+            h = (h ^ p[i]) * 16777619UL;
+        }
+        return (h >> 16) ^ (h & 0xFFFF);
+    }
+};
+
+extern NvsWriteLog nvsWriteLog;
+
+// ============================================
+// Preferences with write logging
+// ============================================
+class TracedPreferences : public Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = NULL) {
+        ns = name;
+        return Preferences::begin(name, readOnly, partitionLabel);
+    }
+
+    size_t putBool(const char* key, bool value) {
+        return putUChar(key, value ? 1 : 0);
+    }
+
+    size_t putUChar(const char* key, uint8_t value) {
+        size_t written = Preferences::putUChar(key, value);
+        if (written) nvsWriteLog.record(ns, key, NVS_ITEM_U8, &value, sizeof(value));
+        return written;
+    }
+
+    size_t putUShort(const char* key, uint16_t value) {
+        size_t written = Preferences::putUShort(key, value);
+        if (written) nvsWriteLog.record(ns, key, NVS_ITEM_U16, &value, sizeof(value));
+        return written;
+    }
+
+    size_t putUInt(const char* key, uint32_t value) {
+        size_t written = Preferences::putUInt(key, value);
+        if (written) nvsWriteLog.record(ns, key, NVS_ITEM_U32, &value, sizeof(value));
+        return written;
+    }
+
+    size_t putString(const char* key, const char* value) {
+        size_t written = Preferences::putString(key, value);
+        if (written) nvsWriteLog.record(ns, key, NVS_ITEM_STR, value, strlen(value) + 1);
+        return written;
+    }
+
+    size_t putString(const char* key, const String& value) {
+        return putString(key, value.c_str());
+    }
+
+    size_t putBytes(const char* key, const void* value, size_t len) {
+        size_t written = Preferences::putBytes(key, value, len);
+        if (written) nvsWriteLog.record(ns, key, NVS_ITEM_BLOB, value, len);
+        return written;
+    }
+
+private:
+    const char* ns = "";
+};
+
+#endif // NVS_WRITE_LOG_H
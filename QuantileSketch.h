@@ -0,0 +1,146 @@
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+/**
+ * ============================================
+ * QuantileSketch - Median and p90 of a stream in 44 bytes
+ * ============================================
+ *
+ * P² (Jain & Chlamtac) with the marker set extended to two quantiles:
+ * seven markers at 0, p50/2, p50, (p50+p90)/2, p90, (1+p90)/2 and 1 of
+ * the distribution. Each add() moves the markers by at most one position
+ * and adjusts their heights with a parabola through the neighbours, so
+ * the cost is constant and no sample is kept. The first seven samples
+ * are exact (sorted in the marker heights).
+ *
+ * Min and max are exact, p50 and p90 estimates; with a few dozen
+ * samples they are typically within a few percent of the true quantile.
+ * The count saturates at 65535 (samples after that are ignored).
+ */
+
+#include <Arduino.h>
+
+class QuantileSketch {
+public:
+    static const uint8_t MARKERS = 7;
+    static const uint8_t SERIALIZED_SIZE = 2 + MARKERS * 4 + MARKERS * 2;  // count, heights, positions
+
+    void reset() {
+        count = 0;
+        for (uint8_t i = 0; i < MARKERS; i++) {
+            height[i] = 0;
+            position[i] = i + 1;
+        }
+    }
+
+    void add(float x) {
+        if (count == UINT16_MAX) return;
+
+        // Warm-up: insertion sort into the markers
+        if (count < MARKERS) {
+            uint8_t i = count++;
+            while (i > 0 && height[i - 1] > x) {
+                height[i] = height[i - 1];
+                i--;
+            }
+            height[i] = x;
+            return;
+        }
+
+        // Cell k holding x; the extreme markers take new extremes
+        uint8_t k;
+        if (x < height[0]) {
+            height[0] = x;
+            k = 0;
+        } else if (x >= height[MARKERS - 1]) {
+            height[MARKERS - 1] = x;
+            k = MARKERS - 2;
+        } else {
+            k = 0;
+            while (x >= height[k + 1]) k++;
+        }
+        for (uint8_t i = k + 1; i < MARKERS; i++) position[i]++;
+        count++;
+
+        // Middle markers one step towards their desired positions
+        for (uint8_t i = 1; i < MARKERS - 1; i++) {
+            float desired = 1 + (count - 1) * FRACTION[i];
+            float diff = desired - position[i];
+            if ((diff >= 1 && position[i + 1] - position[i] > 1) ||
+                (diff <= -1 && position[i - 1] - position[i] < -1)) {
+                int8_t step = diff > 0 ? 1 : -1;
+                float h = parabolic(i, step);
+                if (height[i - 1] < h && h < height[i + 1]) {
+                    height[i] = h;
+                } else {
+                    height[i] = linear(i, step);
+                }
+                position[i] += step;
+            }
+        }
+    }
+
+    uint16_t getCount() const { return count; }
+    float getMin() const { return quantile(0); }
+    float getMedian() const { return quantile(2); }
+    float getP90() const { return quantile(4); }
+    float getMax() const { return quantile(MARKERS - 1); }
+
+    // Little-endian, SERIALIZED_SIZE bytes (NVS blob, backup archive)
+    void save(uint8_t* out) const {
+        out[0] = count & 0xFF;
+        out[1] = count >> 8;
+        memcpy(out + 2, height, MARKERS * 4);
+        for (uint8_t i = 0; i < MARKERS; i++) {
+            out[2 + MARKERS * 4 + i * 2] = position[i] & 0xFF;
+            out[3 + MARKERS * 4 + i * 2] = position[i] >> 8;
+        }
+    }
+
+    // False (and empty) if the positions do not make a sketch
+    bool load(const uint8_t* in) {
+        count = in[0] | (in[1] << 8);
+        memcpy(height, in + 2, MARKERS * 4);
+        for (uint8_t i = 0; i < MARKERS; i++) {
+            position[i] = in[2 + MARKERS * 4 + i * 2] | (in[3 + MARKERS * 4 + i * 2] << 8);
+        }
+        bool valid = true;
+        if (count < MARKERS) {
+            for (uint8_t i = 1; valid && i < count; i++) valid = height[i] >= height[i - 1];
+        } else {
+            valid = position[0] == 1 && position[MARKERS - 1] == count;
+            for (uint8_t i = 1; valid && i < MARKERS; i++) {
+                valid = position[i] > position[i - 1] && height[i] >= height[i - 1];
+            }
+        }
+        if (!valid) reset();
+        return valid;
+    }
+
+private:
+    static constexpr float FRACTION[MARKERS] = {0.0f, 0.25f, 0.5f, 0.7f, 0.9f, 0.95f, 1.0f};
+
+    float height[MARKERS] = {0};
+    uint16_t position[MARKERS] = {1, 2, 3, 4, 5, 6, 7};
+    uint16_t count = 0;
+
+    // Marker i's fraction; exact sample while warming up
+    float quantile(uint8_t i) const {
+        if (count == 0) return 0;
+        if (count <= MARKERS) return height[(uint8_t)((count - 1) * FRACTION[i] + 0.5f)];
+        return height[i];
+    }
+
+    float parabolic(uint8_t i, int8_t d) const {
+        float n0 = position[i - 1], n1 = position[i], n2 = position[i + 1];
+        return height[i] + d / (n2 - n0) *
+               ((n1 - n0 + d) * (height[i + 1] - height[i]) / (n2 - n1) +
+                (n2 - n1 - d) * (height[i] - height[i - 1]) / (n1 - n0));
+    }
+
+    float linear(uint8_t i, int8_t d) const {
+        return height[i] + d * (height[i + d] - height[i]) / ((int)position[i + d] - (int)position[i]);
+    }
+};
+
+#endif // QUANTILE_SKETCH_H
@@ -0,0 +1,138 @@
+#ifndef RENDER_SELF_TEST_H
+#define RENDER_SELF_TEST_H
+
+/**
+ * ============================================
+ * RenderSelfTest - Reference screens + render cost
+ * ============================================
+ *
+ * Every DisplayRenderer screen drawn with fixed inputs (same chrome as
+ * refreshOLED), and what each one costs:
+ * - draw time (U8g2 calls only, into the buffer)
+ * - transfer time and SPI bytes (counted at the U8g2 byte layer)
+ *
+ * The host build checks these screens pixel by pixel against the
+ * golden PBMs in host/golden/ on every change (make -C host test).
+ * On the cube, RENDER_SELFTEST in config.h prints the cost table and a
+ * CRC32 per frame once at boot - the real fonts differ from the host's
+ * stand-ins, so the device frames are measured, not compared.
+ */
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+#include "config.h"
+#include "DisplayRenderer.h"
+
+static const char* const RENDER_SCREENS[] = {
+    "idle-seed", "idle-sprout", "idle-growing", "idle-bloom", "idle-wither",
+    "focus", "break", "paused", "withered", "congrats", "revive", "qr",
+    "congrats-in", "revive-in",
+};
+
+static const uint8_t RENDER_SCREEN_COUNT = sizeof(RENDER_SCREENS) / sizeof(RENDER_SCREENS[0]);
+
+struct RenderCost {
+    uint32_t drawUs;
+    uint32_t sendUs;
+    uint32_t spiBytes;
+};
+
+// ============================================
+// SPI byte counter (wraps the U8g2 byte callback)
+// ============================================
+namespace RenderSelfTestDetail {
+    static u8x8_msg_cb originalByteCb = nullptr;
+    static uint32_t spiBytes = 0;
+
+    static uint8_t countingByteCb(u8x8_t* u8x8, uint8_t msg, uint8_t argInt, void* argPtr) {
+        if (msg == U8X8_MSG_BYTE_SEND) spiBytes += argInt;
+        return originalByteCb(u8x8, msg, argInt, argPtr);
+    }
+
+    static uint32_t crc32(const uint8_t* data, size_t len) {
+        uint32_t crc = 0xFFFFFFFF;
+        for (size_t i = 0; i < len; i++) {
+            crc ^= data[i];
+            for (uint8_t b = 0; b < 8; b++) {
+                crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+            }
+        }
+        return ~crc;
+    }
+}
+
+// Fixed inputs for each screen (same chrome as refreshOLED)
+inline void drawSelfTestScreen(DisplayRenderer& display, uint8_t index) {
+    static const char* TASK = "Read chapter 4";
+    PlantInfo plant = {0, false, false, 0, 3};
+
+    display.drawBorder();
+    display.drawClock(12, 34);
+
+    switch (index) {
+        case 0: case 1: case 2: case 3:
+            plant.stage = index;
+            plant.wateredCount = index;
+            display.drawIdleScreen(plant, false, true, false);
+            break;
+        case 4:
+            plant.isWithered = true;
+            display.drawIdleScreen(plant, false, true, false);
+            break;
+        case 5: display.drawFocusScreen(TASK, 1234, 1500); break;
+        case 6: display.drawBreakScreen(TASK, 200, 300); break;
+        case 7: display.drawPausedScreen(TASK, 900, 1500); break;
+        case 8: display.drawWitheredScreen(); break;
+        case 9: display.drawCongratsScreen(); break;
+        case 10: display.drawReviveScreen(); break;
+        case 11: display.drawQRScreen(); break;
+        // Overlays mid-animation (the still frames are 9 and 10)
+        case 12: display.drawCongratsScreen(FixedMath::Q16_ONE / 10); break;
+        case 13: display.drawReviveScreen(FixedMath::Q16_ONE / 5); break;
+    }
+}
+
+// Draw screen `index` face up (U8G2_R2) and send it. The frame stays in
+// the tile buffer until the next beginFrame(). `nowUs` is the clock:
+// micros() on the cube, a real one on the host.
+template <typename NowUs>
+inline RenderCost renderSelfTestScreen(DisplayRenderer& display, U8G2& u8g2, uint8_t index, NowUs nowUs) {
+    using namespace RenderSelfTestDetail;
+
+    u8x8_t* u8x8 = u8g2.getU8x8();
+    const u8g2_cb_t* liveRotation = u8g2.getU8g2()->cb;
+    u8g2.setDisplayRotation(U8G2_R2);
+    originalByteCb = u8x8->byte_cb;
+    u8x8->byte_cb = countingByteCb;
+
+    RenderCost cost;
+    uint32_t start = nowUs();
+    display.beginFrame();
+    drawSelfTestScreen(display, index);
+    cost.drawUs = nowUs() - start;
+
+    spiBytes = 0;
+    start = nowUs();
+    display.endFrame();
+    cost.sendUs = nowUs() - start;
+    cost.spiBytes = spiBytes;
+
+    u8x8->byte_cb = originalByteCb;
+    u8g2.setDisplayRotation(liveRotation);
+    return cost;
+}
+
+// Cost table over the serial port (device, RENDER_SELFTEST)
+inline void runRenderSelfTest(DisplayRenderer& display, U8G2& u8g2) {
+    DEBUG_PRINTLN("Render self-test:");
+    DEBUG_PRINTLN("  screen        draw_us  send_us  spi_bytes  crc32");
+
+    for (uint8_t i = 0; i < RENDER_SCREEN_COUNT; i++) {
+        RenderCost cost = renderSelfTestScreen(display, u8g2, i, micros);
+        uint32_t crc = RenderSelfTestDetail::crc32(u8g2.getBufferPtr(), OLED_WIDTH * OLED_HEIGHT / 8);
+        DEBUG_PRINTF("  %-12s  %7lu  %7lu  %9lu  %08lx\n",
+                     RENDER_SCREENS[i], cost.drawUs, cost.sendUs, cost.spiBytes, crc);
+    }
+}
+
+#endif // RENDER_SELF_TEST_H
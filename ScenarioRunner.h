@@ -0,0 +1,508 @@
+#ifndef SCENARIO_RUNNER_H
+#define SCENARIO_RUNNER_H
+
+/**
+ * ============================================
+ * ScenarioRunner - Scripted runs on virtual time
+ * ============================================
+ *
+ * Drives SystemState, Analytics and the sketch's event handling from a
+ * small text script, with the clock fast-forwarded (see SimClock.h):
+ * a 25 minute focus session runs in a few milliseconds.
+ *
+ * One command per line, '#' starts a comment:
+ *
+ *   reset                       restartDay() + fresh analytics day
+ *   task "Read" [focus] [break] add a task (minutes), optionally
+ *        [done] [started]       with its flags already set
+ *   select "Read"               select it for flip start
+ *   flip down | flip up         cube flip, same path as the MPU
+ *   ldr 3500                    light level fed to the sensor handler
+ *   web <action> [k=v ...]      WebSocket action, task="Read" -> taskId
+ *                               (task="#2" = third task in the list)
+ *   wait 90s | 25m | 2h | 250ms advance virtual time
+ *   at [2026-01-05] 12:03       set the wall clock (date unchanged
+ *                               unless given), at @<epoch> in UTC
+ *   plant stage=2 withered=0    restore plant fields (also pending=,
+ *                               watered=, goal=, session=)
+ *   stats tasks=1 focus=25      restore today's analytics (also
+ *                               break=, sessions=)
+ *   midnight                    run past the next midnight
+ *   expect <what> <value>       mode, screen, timeLeft, tasks,
+ *                               plant.stage/withered/watered/goal/pending,
+ *                               stats.tasks/focus/break/sessions,
+ *                               task.done "Read" 1
+ *
+ * Example:
+ *   reset
+ *   web setGoal goal=1
+ *   task "Read" 25 5
+ *   select "Read"
+ *   flip down
+ *   expect mode focusing
+ *   wait 12m
+ *   flip up
+ *   web confirmComplete
+ *   web water
+ *   expect plant.stage 3
+ *
+ * journal_replay.py writes scripts like this from an InputJournal.
+ *
+ * Runs change the cube's real state and NVS - use a test cube, built
+ * with SCENARIO_RUNNER, or the host build (host/scenario_host.cpp). While one runs, the sketch holds back its
+ * outputs (broadcasts, MQTT, beeps, prerenders) and the finish hook
+ * resyncs them once with the end state.
+ */
+
+#include <Arduino.h>
+#include <functional>
+#include <ArduinoJson.h>
+#include <stdarg.h>
+#include <sys/time.h>
+#include "config.h"
+#include "SimClock.h"
+#include "SystemState.h"
+#include "Analytics.h"
+
+struct ScenarioFailure {
+    uint16_t line;
+    char message[72];
+};
+
+class ScenarioRunner {
+public:
+    static const uint8_t MAX_FAILURES = 8;
+    static const uint8_t MAX_LINE = 128;
+
+    typedef std::function<void(bool)> FlipHook;               // isFlipped (OLED down)
+    typedef std::function<void()> StepHook;                   // One main-loop pass, no I/O
+    typedef std::function<void(const char*)> WebActionHook;   // JSON, as from a client
+    typedef std::function<const char*()> ScreenHook;          // What refreshOLED() would draw
+    typedef std::function<void()> FinishHook;                 // Run over, outputs live again
+
+    ScenarioRunner(SystemState& state, Analytics& analytics)
+        : state(state), analytics(analytics) {}
+
+    void onFlip(FlipHook hook) { flipHook = hook; }
+    void onStep(StepHook hook) { stepHook = hook; }
+    void onWebAction(WebActionHook hook) { webActionHook = hook; }
+    void onScreen(ScreenHook hook) { screenHook = hook; }
+    void onFinish(FinishHook hook) { finishHook = hook; }
+
+    // Returns true if every command ran and every expectation held
+    bool run(const char* script) {
+        steps = 0;
+        simulatedMs = 0;
+        wallCarryMs = 0;
+        failureCount = 0;
+        totalFailures = 0;
+        ldrLevel = -1;
+        wallStartS = time(nullptr);
+        wallStartMs = millis();
+        wallMoved = false;
+        running = true;
+
+        uint16_t lineNumber = 0;
+        const char* p = script;
+        while (*p) {
+            const char* end = strchr(p, '\n');
+            size_t len = end ? (size_t)(end - p) : strlen(p);
+            lineNumber++;
+
+            char line[MAX_LINE];
+            if (len >= sizeof(line)) {
+                fail(lineNumber, "line too long");
+            } else {
+                memcpy(line, p, len);
+                line[len] = '\0';
+                runLine(lineNumber, line);
+            }
+            p += len;
+            if (*p == '\n') p++;
+        }
+
+        restoreWallClock();
+        running = false;
+        if (finishHook) finishHook();
+        return totalFailures == 0;
+    }
+
+    bool isRunning() const { return running; }
+
+    uint16_t getSteps() const { return steps; }
+    uint32_t getSimulatedSeconds() const { return simulatedMs / 1000; }
+    uint16_t getTotalFailures() const { return totalFailures; }
+    uint8_t getFailureCount() const { return failureCount; }  // Kept details (max MAX_FAILURES)
+    const ScenarioFailure& getFailure(uint8_t index) const { return failures[index]; }
+
+private:
+    SystemState& state;
+    Analytics& analytics;
+
+    FlipHook flipHook;
+    StepHook stepHook;
+    WebActionHook webActionHook;
+    ScreenHook screenHook;
+    FinishHook finishHook;
+
+    bool running = false;
+    uint16_t steps = 0;
+    uint32_t simulatedMs = 0;
+    uint32_t wallCarryMs = 0;   // Virtual ms not yet added to the wall clock
+    ScenarioFailure failures[MAX_FAILURES];
+    uint8_t failureCount = 0;
+    uint16_t totalFailures = 0;
+
+    int ldrLevel = -1;       // -1 = not driven by the scenario
+    bool cubeDown = false;
+    time_t wallStartS = 0;
+    uint32_t wallStartMs = 0;
+    bool wallMoved = false;
+
+    // ============================================
+    // Commands
+    // ============================================
+
+    void runLine(uint16_t n, char* line) {
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char* p = line;
+        char cmd[16];
+        if (!nextToken(p, cmd, sizeof(cmd))) return;  // Blank line
+        steps++;
+
+        char arg[40];
+        if (strcmp(cmd, "reset") == 0) {
+            if (cubeDown && flipHook) flipHook(false);
+            cubeDown = false;
+            ldrLevel = -1;
+            state.restartDay();
+            analytics.forceDailyReset();
+            for (uint8_t i = 0; i < 10; i++) tick();  // Let overlays expire
+        }
+        else if (strcmp(cmd, "task") == 0) {
+            if (!nextToken(p, arg, sizeof(arg))) return fail(n, "task needs a name");
+            char num[8];
+            uint16_t focus = nextToken(p, num, sizeof(num)) ? atoi(num) : 25;
+            uint16_t breakTime = nextToken(p, num, sizeof(num)) ? atoi(num) : 5;
+            bool done = false, started = false;
+            while (nextToken(p, num, sizeof(num))) {
+                if (strcmp(num, "done") == 0) done = true;
+                else if (strcmp(num, "started") == 0) started = true;
+                else return fail(n, "task flag %s?", num);
+            }
+            if (!state.restoreTask(arg, focus, breakTime, done, started)) return fail(n, "task list full");
+        }
+        else if (strcmp(cmd, "select") == 0) {
+            if (!nextToken(p, arg, sizeof(arg))) return fail(n, "select needs a task name");
+            uint32_t id = taskIdFor(arg);
+            if (!id) return fail(n, "no task \"%s\"", arg);
+            state.selectTaskForFlip(id);
+        }
+        else if (strcmp(cmd, "flip") == 0) {
+            if (!nextToken(p, arg, sizeof(arg))) return fail(n, "flip needs up/down");
+            cubeDown = strcmp(arg, "down") == 0;
+            if (!cubeDown && strcmp(arg, "up") != 0) return fail(n, "flip %s?", arg);
+            if (flipHook) flipHook(cubeDown);
+        }
+        else if (strcmp(cmd, "ldr") == 0) {
+            if (!nextToken(p, arg, sizeof(arg))) return fail(n, "ldr needs a level");
+            ldrLevel = atoi(arg);
+            state.handleLightSensor(ldrLevel);
+        }
+        else if (strcmp(cmd, "web") == 0) {
+            if (!webAction(n, p)) return;
+        }
+        else if (strcmp(cmd, "wait") == 0) {
+            if (!nextToken(p, arg, sizeof(arg))) return fail(n, "wait needs a duration");
+            uint32_t ms = parseDuration(arg);
+            if (!ms) return fail(n, "bad duration %s", arg);
+            for (; ms >= 1000; ms -= 1000) tick(1000);
+            if (ms) tick(ms);
+            return;
+        }
+        else if (strcmp(cmd, "at") == 0) {
+            if (!nextToken(p, arg, sizeof(arg))) return fail(n, "at needs HH:MM");
+            if (arg[0] == '@') {
+                if (!isNumber(arg + 1)) return fail(n, "bad epoch %s", arg);
+                struct timeval tv = { .tv_sec = (time_t)atol(arg + 1), .tv_usec = 0 };
+                settimeofday(&tv, nullptr);
+                wallMoved = true;
+            } else {
+                int year = 0, month = 0, day = 0;
+                if (strchr(arg, '-')) {
+                    if (sscanf(arg, "%d-%d-%d", &year, &month, &day) != 3) return fail(n, "bad date %s", arg);
+                    if (!nextToken(p, arg, sizeof(arg))) return fail(n, "at needs HH:MM");
+                }
+                int h = 0, m = 0, s = 0;
+                if (sscanf(arg, "%d:%d:%d", &h, &m, &s) < 2) return fail(n, "bad time %s", arg);
+                setWallClock(h, m, s, year, month, day);
+            }
+        }
+        else if (strcmp(cmd, "plant") == 0) {
+            static const char* const keys[] = { "stage", "withered", "pending", "watered", "goal", "session" };
+            long v[6];
+            PlantInfo plant = state.getPlantInfo();
+            v[0] = plant.stage;
+            v[1] = plant.isWithered;
+            v[2] = state.getPendingWaterCount();
+            v[3] = plant.wateredCount;
+            v[4] = state.getDailyGoal();
+            v[5] = state.getSessionGoal();
+            if (!keyValues(n, p, keys, v, 6)) return;
+            state.restorePlant(v[0], v[1], v[2], v[3], v[4], v[5]);
+        }
+        else if (strcmp(cmd, "stats") == 0) {
+            static const char* const keys[] = { "tasks", "focus", "break", "sessions" };
+            DailyStats stats = analytics.getTodayStats();
+            long v[4] = { stats.tasksCompleted, stats.focusMinutes, stats.breakMinutes, stats.sessionsCount };
+            if (!keyValues(n, p, keys, v, 4)) return;
+            analytics.restoreToday(v[0], v[1], v[2], v[3]);
+        }
+        else if (strcmp(cmd, "midnight") == 0) {
+            setWallClock(23, 59, 30);
+            for (uint8_t s = 0; s < 90; s++) tick();  // Midnight check runs every 60 s
+            return;
+        }
+        else if (strcmp(cmd, "expect") == 0) {
+            expect(n, p);
+            return;
+        }
+        else {
+            return fail(n, "unknown command %s", cmd);
+        }
+
+        if (stepHook) stepHook();  // Process the events the command queued
+    }
+
+    bool webAction(uint16_t n, char*& p) {
+        char action[24];
+        if (!nextToken(p, action, sizeof(action))) {
+            fail(n, "web needs an action");
+            return false;
+        }
+
+        StaticJsonDocument<256> doc;
+        doc["action"] = action;
+
+        // key=value pairs; quoted values stay strings, task="name" -> taskId
+        char pair[48];
+        while (nextToken(p, pair, sizeof(pair))) {
+            char* eq = strchr(pair, '=');
+            if (!eq) {
+                fail(n, "expected key=value, got %s", pair);
+                return false;
+            }
+            *eq = '\0';
+            char* key = pair;      // char* (not const): ArduinoJson copies it
+            char* value = eq + 1;
+
+            if (strcmp(key, "task") == 0) {
+                uint32_t id = taskIdFor(value);
+                if (!id) {
+                    fail(n, "no task \"%s\"", value);
+                    return false;
+                }
+                doc["taskId"] = id;
+            } else if (isNumber(value)) {
+                doc[key] = atol(value);
+            } else {
+                doc[key] = value;
+            }
+        }
+
+        String json;
+        serializeJson(doc, json);
+        if (webActionHook) webActionHook(json.c_str());
+        return true;
+    }
+
+    void expect(uint16_t n, char*& p) {
+        char what[20];
+        char want[40];
+        if (!nextToken(p, what, sizeof(what))) return fail(n, "expect what?");
+
+        char got[40];
+        if (strcmp(what, "task.done") == 0) {
+            char name[40];
+            if (!nextToken(p, name, sizeof(name))) return fail(n, "task.done needs a name");
+            TaskInfo* task = state.getTask(taskIdFor(name));
+            if (!task) return fail(n, "no task \"%s\"", name);
+            snprintf(got, sizeof(got), "%d", task->completed);
+        } else if (!currentValue(what, got, sizeof(got))) {
+            return fail(n, "unknown value %s", what);
+        }
+
+        if (!nextToken(p, want, sizeof(want))) return fail(n, "expect %s needs a value", what);
+        if (strcmp(got, want) != 0) {
+            fail(n, "%s: expected %s, got %s", what, want, got);
+        }
+    }
+
+    bool currentValue(const char* what, char* out, size_t size) {
+        PlantInfo plant = state.getPlantInfo();
+        DailyStats stats = analytics.getTodayStats();
+
+        if (strcmp(what, "mode") == 0) snprintf(out, size, "%s", state.getModeString());
+        else if (strcmp(what, "screen") == 0) snprintf(out, size, "%s", screenHook ? screenHook() : "?");
+        else if (strcmp(what, "timeLeft") == 0) snprintf(out, size, "%lu", (unsigned long)state.getTimeLeft());
+        else if (strcmp(what, "tasks") == 0) snprintf(out, size, "%u", state.getTaskCount());
+        else if (strcmp(what, "plant.stage") == 0) snprintf(out, size, "%u", plant.stage);
+        else if (strcmp(what, "plant.withered") == 0) snprintf(out, size, "%d", plant.isWithered);
+        else if (strcmp(what, "plant.watered") == 0) snprintf(out, size, "%u", plant.wateredCount);
+        else if (strcmp(what, "plant.goal") == 0) snprintf(out, size, "%u", plant.totalGoal);
+        else if (strcmp(what, "plant.pending") == 0) snprintf(out, size, "%u", state.getPendingWaterCount());
+        else if (strcmp(what, "stats.tasks") == 0) snprintf(out, size, "%u", stats.tasksCompleted);
+        else if (strcmp(what, "stats.focus") == 0) snprintf(out, size, "%u", stats.focusMinutes);
+        else if (strcmp(what, "stats.break") == 0) snprintf(out, size, "%u", stats.breakMinutes);
+        else if (strcmp(what, "stats.sessions") == 0) snprintf(out, size, "%u", stats.sessionsCount);
+        else return false;
+        return true;
+    }
+
+    // ============================================
+    // Virtual time
+    // ============================================
+
+    // One simulated step (a second unless a wait ends mid-second), as the main loop would see it
+    void tick(uint32_t ms = 1000) {
+        advanceClock(ms);
+        simulatedMs += ms;
+
+        wallCarryMs += ms;
+        if (wallCarryMs >= 1000 && (wallMoved || analytics.isTimeValid())) {
+            struct timeval tv;
+            gettimeofday(&tv, nullptr);
+            tv.tv_sec += wallCarryMs / 1000;
+            settimeofday(&tv, nullptr);
+            wallMoved = true;
+        }
+        wallCarryMs %= 1000;
+
+        if (ldrLevel >= 0) state.handleLightSensor(ldrLevel);
+        if (stepHook) stepHook();
+    }
+
+    void setWallClock(int hour, int minute, int second, int year = 0, int month = 0, int day = 0) {
+        time_t now = time(nullptr);
+        struct tm t;
+        localtime_r(&now, &t);
+        if (year) {
+            t.tm_year = year - 1900;
+            t.tm_mon = month - 1;
+            t.tm_mday = day;
+        } else if (t.tm_year < 2020 - 1900) {
+            // Never synced: pick a fixed Monday
+            t.tm_year = 2026 - 1900;
+            t.tm_mon = 0;
+            t.tm_mday = 5;
+        }
+        t.tm_hour = hour;
+        t.tm_min = minute;
+        t.tm_sec = second;
+        t.tm_isdst = -1;
+
+        struct timeval tv = { .tv_sec = mktime(&t), .tv_usec = 0 };
+        settimeofday(&tv, nullptr);
+        wallMoved = true;
+    }
+
+    // Put the wall clock back to real time (a moved date triggers a rollover)
+    void restoreWallClock() {
+        if (!wallMoved) return;
+        struct timeval tv = { .tv_sec = wallStartS + (time_t)((millis() - wallStartMs) / 1000), .tv_usec = 0 };
+        settimeofday(&tv, nullptr);
+    }
+
+    // ============================================
+    // Parsing helpers
+    // ============================================
+
+    // Whitespace-separated token; "double quotes" group words
+    static bool nextToken(char*& p, char* out, size_t size) {
+        while (*p == ' ' || *p == '\t' || *p == '\r') p++;
+        if (!*p) return false;
+
+        size_t n = 0;
+        bool quoted = false;
+        while (*p && (quoted || (*p != ' ' && *p != '\t' && *p != '\r'))) {
+            if (*p == '"') {
+                quoted = !quoted;
+            } else if (n + 1 < size) {
+                out[n++] = *p;
+            }
+            p++;
+        }
+        out[n] = '\0';
+        return true;
+    }
+
+    static bool isNumber(const char* s) {
+        if (*s == '-') s++;
+        if (!*s) return false;
+        for (; *s; s++) {
+            if (*s < '0' || *s > '9') return false;
+        }
+        return true;
+    }
+
+    // Milliseconds
+    static uint32_t parseDuration(const char* s) {
+        char* unit;
+        uint32_t value = strtoul(s, &unit, 10);
+        if (strcmp(unit, "ms") == 0) return value;
+        switch (*unit) {
+            case '\0':
+            case 's': return value * 1000;
+            case 'm': return value * 60000;
+            case 'h': return value * 3600000;
+            default: return 0;
+        }
+    }
+
+    // key=number pairs into values[] (which hold the defaults)
+    bool keyValues(uint16_t n, char*& p, const char* const* keys, long* values, uint8_t count) {
+        char pair[24];
+        while (nextToken(p, pair, sizeof(pair))) {
+            char* eq = strchr(pair, '=');
+            if (eq) *eq = '\0';
+            uint8_t i = 0;
+            while (i < count && strcmp(keys[i], pair) != 0) i++;
+            if (!eq || i == count || !isNumber(eq + 1)) {
+                fail(n, "bad value %s", pair);
+                return false;
+            }
+            values[i] = atol(eq + 1);
+        }
+        return true;
+    }
+
+    // By name, or "#<index>" into the task list
+    uint32_t taskIdFor(const char* name) {
+        TaskInfo* tasks = state.getTasks();
+        for (uint8_t i = 0; i < state.getTaskCount(); i++) {
+            if (strcmp(tasks[i].name, name) == 0) return tasks[i].id;
+        }
+        if (name[0] == '#' && isNumber(name + 1)) {
+            int index = atoi(name + 1);
+            if (index < state.getTaskCount()) return tasks[index].id;
+        }
+        return 0;
+    }
+
+    void fail(uint16_t line, const char* format, ...) {
+        totalFailures++;
+        if (failureCount == MAX_FAILURES) return;
+
+        ScenarioFailure& f = failures[failureCount++];
+        f.line = line;
+        va_list args;
+        va_start(args, format);
+        vsnprintf(f.message, sizeof(f.message), format, args);
+        va_end(args);
+        DEBUG_PRINTF("Scenario line %u: %s\n", line, f.message);
+    }
+};
+
+#endif // SCENARIO_RUNNER_H
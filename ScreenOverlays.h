@@ -0,0 +1,87 @@
+#ifndef SCREEN_OVERLAYS_H
+#define SCREEN_OVERLAYS_H
+
+/**
+ * ============================================
+ * ScreenOverlays - Timed congrats / revive screens
+ * ============================================
+ *
+ * A bloom shows the congrats screen for 5 s, a revive the revive
+ * screen for 4 s, over whatever the mode would draw. screenName() is
+ * the screen refreshOLED() draws right now, with the same precedence;
+ * scenarios expect on it. progressQ16() drives the overlay's animation.
+ */
+
+#include <Arduino.h>
+#include "EventQueue.h"
+#include "IntervalTimer.h"
+#include "SystemState.h"
+
+class ScreenOverlays {
+public:
+    static const uint32_t CONGRATS_MS = 5000;
+    static const uint32_t REVIVE_MS = 4000;
+
+    // Call with every event popped from the queue; true if an overlay started
+    bool handle(Event event) {
+        if (event == Event::PLANT_BLOOMED && !congrats) {
+            congrats = true;
+            congratsTimer.start(CONGRATS_MS);
+            DEBUG_PRINTLN("Event: PLANT_BLOOMED - showing congrats!");
+            return true;
+        }
+        if (event == Event::PLANT_REVIVED && !revive) {
+            revive = true;
+            reviveTimer.start(REVIVE_MS);
+            DEBUG_PRINTLN("Event: PLANT_REVIVED - showing celebration!");
+            return true;
+        }
+        return false;
+    }
+
+    // True if an overlay just ended (the screen needs a redraw)
+    bool update() {
+        bool ended = false;
+        if (congrats && congratsTimer.expired()) {
+            congrats = false;
+            ended = true;
+        }
+        if (revive && reviveTimer.expired()) {
+            revive = false;
+            ended = true;
+        }
+        return ended;
+    }
+
+    bool showingCongrats() const { return congrats; }
+    bool showingRevive() const { return revive; }
+    bool active() const { return congrats || revive; }
+
+    // How far the overlay on screen has run (Q16), for its animation
+    uint32_t progressQ16() const {
+        if (revive) return reviveTimer.progressQ16();
+        if (congrats) return congratsTimer.progressQ16();
+        return FixedMath::Q16_ONE;
+    }
+
+    const char* screenName(SystemMode mode) const {
+        if (revive) return "revive";
+        if (congrats) return "congrats";
+
+        switch (mode) {
+            case MODE_FOCUSING: return "focus";
+            case MODE_BREAK: return "break";
+            case MODE_PAUSED: return "paused";
+            case MODE_WITHERED: return "withered";
+            default: return "idle";
+        }
+    }
+
+private:
+    OneShotTimer congratsTimer;
+    OneShotTimer reviveTimer;
+    bool congrats = false;
+    bool revive = false;
+};
+
+#endif // SCREEN_OVERLAYS_H
@@ -0,0 +1,162 @@
+#ifndef SESSION_TRACKER_H
+#define SESSION_TRACKER_H
+
+/**
+ * ============================================
+ * SessionTracker - Focus/break sessions from mode changes
+ * ============================================
+ *
+ * Follows SystemState's mode on every STATE_CHANGED and records the
+ * sessions it sees into Analytics: a focus session ends when the break
+ * starts or the cube goes idle, pauses are summed, and a PLANT_WATERED
+ * counts a completed task. A STATE_RESTORED (POST /api/restore) drops
+ * the session in progress unrecorded: it belonged to the replaced
+ * state. Times are clockMillis(), so a scenario's virtual time produces
+ * the same sessions as a real day.
+ *
+ * Finished sessions also go to the report hook (MQTT, fleet server).
+ */
+
+#include <Arduino.h>
+#include <functional>
+#include "EventQueue.h"
+#include "SystemState.h"
+#include "Analytics.h"
+#include "SimClock.h"
+
+class SessionTracker {
+public:
+    typedef std::function<void(bool focus, uint32_t minutes)> ReportHook;
+
+    explicit SessionTracker(Analytics& analytics) : analytics(analytics) {}
+
+    void onReport(ReportHook hook) { reportHook = hook; }
+
+    // Call with every event popped from the queue
+    void handle(Event event, SystemMode mode) {
+        if (event == Event::STATE_CHANGED) {
+            modeChanged(mode);
+        } else if (event == Event::PLANT_WATERED) {
+            analytics.recordTaskCompleted();
+        } else if (event == Event::STATE_RESTORED) {
+            reset(mode);
+        }
+    }
+
+    // Forget the session in progress (state replaced from outside)
+    void reset(SystemMode mode) {
+        previousMode = mode;
+        sessionStartTime = 0;
+        accumulatedFocusMs = 0;
+        accumulatedBreakMs = 0;
+        sessionPauses = 0;
+    }
+
+private:
+    Analytics& analytics;
+    ReportHook reportHook;
+
+    SystemMode previousMode = MODE_IDLE;
+    uint32_t sessionStartTime = 0;
+    uint32_t accumulatedFocusMs = 0;  // Accumulated focus time in ms (for pause handling)
+    uint32_t accumulatedBreakMs = 0;  // Accumulated break time in ms
+    uint8_t sessionPauses = 0;        // Pauses in the current focus session
+
+    // Round milliseconds to minutes (round up if >= 30 seconds)
+    static uint32_t msToMins(uint32_t ms) {
+        uint32_t totalSeconds = ms / 1000;
+        uint32_t mins = totalSeconds / 60;
+        uint32_t remainingSeconds = totalSeconds % 60;
+        if (remainingSeconds >= 30) mins++;
+        return mins;
+    }
+
+    static uint16_t msToSecs(uint32_t ms) {
+        return min(ms / 1000, (uint32_t)UINT16_MAX);
+    }
+
+    void recordFocus(uint32_t focusMs) {
+        uint32_t focusMins = msToMins(focusMs);
+        if (focusMins == 0) return;
+        analytics.recordFocusSession(focusMins, msToSecs(focusMs), sessionPauses);
+        if (reportHook) reportHook(true, focusMins);
+        DEBUG_PRINTF("Analytics: Recorded focus session: %lu min\n", focusMins);
+    }
+
+    void recordBreak(uint32_t breakMs) {
+        uint32_t breakMins = msToMins(breakMs);
+        if (breakMins == 0) return;
+        analytics.recordBreakSession(breakMins, msToSecs(breakMs));
+        if (reportHook) reportHook(false, breakMins);
+        DEBUG_PRINTF("Analytics: Recorded break session: %lu min\n", breakMins);
+    }
+
+    void modeChanged(SystemMode currentMode) {
+        // When entering FOCUSING mode (fresh start, not resume from pause)
+        if (currentMode == MODE_FOCUSING && previousMode != MODE_FOCUSING && previousMode != MODE_PAUSED) {
+            sessionStartTime = clockMillis();
+            accumulatedFocusMs = 0;
+            sessionPauses = 0;
+            DEBUG_PRINTLN("Analytics: Starting new focus session");
+        }
+
+        // When entering BREAK mode (focus just completed)
+        if (currentMode == MODE_BREAK && previousMode != MODE_BREAK) {
+            // If coming from focusing, record the focus session first
+            if (previousMode == MODE_FOCUSING || accumulatedFocusMs > 0) {
+                uint32_t focusMs = accumulatedFocusMs;
+                if (previousMode == MODE_FOCUSING && sessionStartTime > 0) {
+                    focusMs += (clockMillis() - sessionStartTime);
+                }
+                recordFocus(focusMs);
+                accumulatedFocusMs = 0;
+            }
+            // Start break timer
+            sessionStartTime = clockMillis();
+            accumulatedBreakMs = 0;
+            DEBUG_PRINTLN("Analytics: Starting break session");
+        }
+
+        // When leaving FOCUSING to PAUSED (flip detected)
+        if (previousMode == MODE_FOCUSING && currentMode == MODE_PAUSED) {
+            // Accumulate the focus time so far
+            if (sessionStartTime > 0) {
+                accumulatedFocusMs += (clockMillis() - sessionStartTime);
+                DEBUG_PRINTF("Analytics: Paused focus, accumulated: %lu ms\n", accumulatedFocusMs);
+            }
+            sessionStartTime = 0;
+            if (sessionPauses < UINT8_MAX) sessionPauses++;
+        }
+
+        // When resuming from PAUSED to FOCUSING
+        if (previousMode == MODE_PAUSED && currentMode == MODE_FOCUSING) {
+            sessionStartTime = clockMillis();
+            DEBUG_PRINTLN("Analytics: Resumed focus session");
+        }
+
+        // When going IDLE from anywhere (task completed or cancelled)
+        if (currentMode == MODE_IDLE && previousMode != MODE_IDLE) {
+            // Record any accumulated focus time
+            if (previousMode == MODE_FOCUSING || previousMode == MODE_PAUSED) {
+                uint32_t focusMs = accumulatedFocusMs;
+                if (previousMode == MODE_FOCUSING && sessionStartTime > 0) {
+                    focusMs += (clockMillis() - sessionStartTime);
+                }
+                recordFocus(focusMs);
+            }
+            // Record any accumulated break time
+            if (previousMode == MODE_BREAK && sessionStartTime > 0) {
+                recordBreak(accumulatedBreakMs + (clockMillis() - sessionStartTime));
+            }
+
+            // Reset everything
+            accumulatedFocusMs = 0;
+            accumulatedBreakMs = 0;
+            sessionStartTime = 0;
+        }
+
+        previousMode = currentMode;
+    }
+};
+
+#endif // SESSION_TRACKER_H
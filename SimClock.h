@@ -0,0 +1,31 @@
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+/**
+ * ============================================
+ * SimClock - Virtual millisecond clock
+ * ============================================
+ *
+ * clockMillis() is millis() plus an offset that only ScenarioRunner
+ * moves. Everything that times user-visible behaviour (focus/break
+ * timers, overlays, LDR revive, analytics autosave, session lengths)
+ * reads it, so a scenario can skip 25 minutes of focus in a few ms.
+ * That includes every IntervalTimer.h class, Debouncer too.
+ *
+ * Still on millis(): the MPU flip debounce (a scenario flip bypasses
+ * it), TimedScreenManager, SPI and event timestamps.
+ */
+
+#include <Arduino.h>
+
+extern uint32_t simClockOffsetMs;
+
+inline uint32_t clockMillis() {
+    return millis() + simClockOffsetMs;
+}
+
+inline void advanceClock(uint32_t ms) {
+    simClockOffsetMs += ms;
+}
+
+#endif // SIM_CLOCK_H
@@ -0,0 +1,124 @@
+#ifndef STATE_MESSAGES_H
+#define STATE_MESSAGES_H
+
+/**
+ * ============================================
+ * StateMessages - Fill the generated messages from the live state
+ * ============================================
+ *
+ * The one place that maps SystemState / Analytics onto the wire
+ * structs of Messages.h, shared by both web servers. Strings point
+ * into SystemState: write the message before the state changes.
+ */
+
+#include "config.h"
+#include "SystemState.h"
+#include "Analytics.h"
+#include "Messages.h"
+
+inline void fillStatus(StatusMsg& m, SystemState* state) {
+    m.ver = state->getVersion();
+    m.state = state->getModeString();
+    m.timeLeft = state->getTimeLeft();
+    m.totalTime = state->getTotalTime();
+    m.waitingForConfirmation = state->isWaitingForConfirmation();
+    m.taskName = state->getCurrentTaskName();
+}
+
+inline void fillPlant(PlantMsg& m, SystemState* state) {
+    PlantInfo plant = state->getPlantInfo();
+    m.ver = state->getVersion();
+    m.stage = plant.stage;
+    m.isWithered = plant.isWithered;
+    m.wateredCount = plant.wateredCount;
+    m.totalGoal = plant.totalGoal;
+    m.pendingWater = state->getPendingWaterCount();
+    m.dailyGoal = state->getDailyGoal();
+}
+
+// Returns the number of tasks written to out
+inline uint8_t fillTasks(TaskMsg (&out)[MAX_TASKS], SystemState* state) {
+    TaskInfo* tasks = state->getTasks();
+    uint8_t count = state->getTaskCount();
+    for (uint8_t i = 0; i < count; i++) {
+        out[i].id = tasks[i].id;
+        out[i].name = tasks[i].name;
+        out[i].focusDuration = tasks[i].focusDuration;
+        out[i].breakDuration = tasks[i].breakDuration;
+        out[i].completed = tasks[i].completed;
+        out[i].started = tasks[i].started;
+    }
+    return count;
+}
+
+inline void fillApiStatus(ApiStatusMsg& m, SystemState* state) {
+    PlantInfo plant = state->getPlantInfo();
+    m.state = state->getModeString();
+    m.timeLeft = state->getTimeLeft();
+    m.totalTime = state->getTotalTime();
+    m.taskName = state->getCurrentTaskName();
+    m.plant.stage = plant.stage;
+    m.plant.isWithered = plant.isWithered;
+    m.plant.canWater = plant.canWater;
+    m.plant.wateredCount = plant.wateredCount;
+    m.plant.totalGoal = plant.totalGoal;
+    m.plant.pendingWater = state->getPendingWaterCount();
+    m.plant.dailyGoal = state->getDailyGoal();
+    m.stats.completed = state->getCompletedCount();
+    m.stats.total = state->getTaskCount();
+    m.ver = state->getVersion();
+}
+
+// Sketch values times scale, rounded
+inline void fillQuantiles(QuantilesMsg& m, const QuantileSketch& sketch, float scale) {
+    auto scaled = [scale](float v) -> uint16_t {
+        float x = v * scale + 0.5f;
+        return x <= 0 ? 0 : x >= UINT16_MAX ? UINT16_MAX : (uint16_t)x;
+    };
+    m.count = sketch.getCount();
+    m.min = scaled(sketch.getMin());
+    m.p50 = scaled(sketch.getMedian());
+    m.p90 = scaled(sketch.getP90());
+    m.max = scaled(sketch.getMax());
+}
+
+// Today, the weekly report, the last 7 days and the session distributions
+inline void fillStats(StatsMsg& m, DayMsg (&days)[7], Analytics& analytics) {
+    static const char* const dayNames[] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
+
+    DailyStats today = analytics.getTodayStats();
+    m.todayTasks = today.tasksCompleted;
+    m.todayFocus = today.focusMinutes;
+    m.todayBreak = today.breakMinutes;
+    m.todaySessions = today.sessionsCount;
+
+    WeeklyReport week = analytics.getWeeklyReport();
+    m.weekly.totalTasks = week.totalTasks;
+    m.weekly.totalFocus = week.totalFocusMinutes;
+    m.weekly.totalBreak = week.totalBreakMinutes;
+    m.weekly.totalSessions = week.totalSessions;
+    m.weekly.avgTasksPerDay = week.avgTasksPerDay;
+    m.weekly.avgFocusPerDay = week.avgFocusPerDay;
+    m.weekly.mostProductiveDay = week.mostProductiveDay;
+    m.weekly.mostProductiveTasks = week.mostProductiveTasks;
+    m.weekly.daysRecorded = week.daysRecorded;
+    m.weekly.hasFullWeek = week.hasFullWeek;
+    m.weekly.mostProductiveDayName = dayNames[week.mostProductiveDay % 7];
+
+    for (uint8_t i = 0; i < 7; i++) {
+        DailyStats day = analytics.getDayStats(i);
+        days[i].daysAgo = i;
+        days[i].tasks = day.tasksCompleted;
+        days[i].focus = day.focusMinutes;
+        days[i].valid = day.valid;
+    }
+    m.days = days;
+    m.daysCount = 7;
+
+    // Pauses are small counts: tenths keep the estimate between integers
+    fillQuantiles(m.focusSeconds, analytics.getSketch(SKETCH_FOCUS), 1);
+    fillQuantiles(m.pauseTenths, analytics.getSketch(SKETCH_PAUSES), 10);
+    fillQuantiles(m.breakSeconds, analytics.getSketch(SKETCH_BREAK), 1);
+}
+
+#endif // STATE_MESSAGES_H
@@ -3,10 +3,12 @@
 
 #include <Arduino.h>
 #include <functional>
-#include <Preferences.h>
 #include "config.h"
 #include "EventQueue.h"
 #include "IntervalTimer.h"
+#include "LatencyTrace.h"
+#include "NvsWriteLog.h"
+#include "SimClock.h"
 
 // Global event queue declaration
 EventQueue<32> eventQueue;
@@ -62,6 +64,7 @@ public:
     uint32_t getTimeLeft() const { return timeLeftSeconds; }
     uint32_t getTotalTime() const { return totalTimeSeconds; }
     const char* getCurrentTaskName() const;
+    uint32_t getActiveTaskId() const { return activeTaskId; }
     PlantInfo getPlantInfo() const;
 
     // Task management
@@ -95,6 +98,7 @@ public:
     void killPlant();     // Demo mode
     void revivePlant();   // LDR trigger
     void resetForNewDay(); // Midnight reset
+    bool endDay();         // Midnight: wither if the goal was missed, then reset; true if met
     void restartDay();     // Manual restart for testing
 
     // Event-based notifications (push to EventQueue)
@@ -116,6 +120,23 @@ public:
     uint8_t getDailyGoal() const { return dailyGoal; }
     uint8_t getCompletedCount() const;
     uint8_t getPendingWaterCount() const { return pendingWater; }
+    uint8_t getSessionGoal() const { return currentSessionGoal; }
+
+    // Journal replay: put back plant/task state from a boot snapshot
+    void restorePlant(uint8_t stage, bool withered, uint8_t pending, uint8_t watered,
+                      uint8_t goal, uint8_t sessionGoal);
+    bool restoreTask(const char* name, uint16_t focusMins, uint16_t breakMins,
+                     bool completed, bool started);
+
+    // Backup restore: replace plant, goals and the task list (ids kept), idle
+    void restoreBackup(uint8_t stage, bool withered, uint8_t pending, uint8_t watered,
+                       uint8_t goal, uint8_t sessionGoal, const TaskInfo* restoredTasks, uint8_t count);
+
+    // State version for optimistic concurrency on web actions: bumped by
+    // every change the clients are told about (timer ticks excluded)
+    uint32_t getVersion() const { return version; }
+    uint32_t getStateChangedAt() const { return stateChangedAt; }  // Status and tasks
+    uint32_t getPlantChangedAt() const { return plantChangedAt; }
 
 private:
     // Core state
@@ -143,6 +164,11 @@ private:
     uint8_t dailyGoal;
     uint8_t currentSessionGoal;
 
+    // Versions (see getVersion)
+    uint32_t version;
+    uint32_t stateChangedAt;
+    uint32_t plantChangedAt;
+
     // Observer callbacks (legacy, prefer EventQueue)
     StateCallback stateChangedCallback;
     StateCallback timerTickCallback;
@@ -158,7 +184,7 @@ private:
     bool congratsShown;
 
     // Persistence
-    Preferences prefs;
+    TracedPreferences prefs;
     void saveState();
     void loadState();
     void saveTasks();
@@ -200,6 +226,10 @@ SystemState::SystemState() {
     dailyGoal = 0;
     currentSessionGoal = 0;
 
+    version = 0;
+    stateChangedAt = 0;
+    plantChangedAt = 0;
+
     // Initialize tasks
     for (int i = 0; i < MAX_TASKS; i++) {
         tasks[i].id = 0;
@@ -237,15 +267,20 @@ void SystemState::begin() {
     // Initialize tracking variables
     lastWateredCount = wateredCount;
     wasWithered = plantWithered;
+
+    // Random start: a version a client kept from before a reboot won't match
+    version = esp_random();
+    stateChangedAt = version;
+    plantChangedAt = version;
     
-    lastTickMillis = millis();
+    lastTickMillis = clockMillis();
     DEBUG_PRINTLN("SystemState: Ready (state restored from NVS)");
 }
 
 void SystemState::loop() {
     // Timer update (every second)
     if (currentMode == MODE_FOCUSING || currentMode == MODE_BREAK) {
-        uint32_t now = millis();
+        uint32_t now = clockMillis();
         if (now - lastTickMillis >= 1000) {
             lastTickMillis = now;
             updateTimer();
@@ -291,7 +326,11 @@ bool SystemState::addTask(const char* name, uint16_t focusMins, uint16_t breakMi
         return false;
     }
 
-    tasks[taskCount].id = millis();
+    // Ids are creation times; tasks added within the same ms still need distinct ids.
+    // 0 means "no task" (selectedTaskId, activeTaskId), never hand it out.
+    uint32_t id = clockMillis();
+    while (id == 0 || getTask(id)) id++;
+    tasks[taskCount].id = id;
     strncpy(tasks[taskCount].name, name, TASK_NAME_MAX_LENGTH - 1);
     tasks[taskCount].name[TASK_NAME_MAX_LENGTH - 1] = '\0';
     tasks[taskCount].focusDuration = focusMins;
@@ -367,8 +406,8 @@ bool SystemState::startTask(uint32_t id) {
     setMode(MODE_FOCUSING);
     totalTimeSeconds = tasks[index].focusDuration * 60;
     timeLeftSeconds = totalTimeSeconds;
-    timerStartMillis = millis();
-    lastTickMillis = millis();
+    timerStartMillis = clockMillis();
+    lastTickMillis = clockMillis();
 
     DEBUG_PRINTF("SystemState: Started task - %s (%d sec)\n", tasks[index].name, totalTimeSeconds);
     notifyStateChanged();
@@ -435,8 +474,8 @@ void SystemState::pauseTimer() {
 void SystemState::resumeTimer() {
     if (currentMode == MODE_PAUSED && pausedTimeLeft > 0) {
         timeLeftSeconds = pausedTimeLeft;
-        timerStartMillis = millis();
-        lastTickMillis = millis();
+        timerStartMillis = clockMillis();
+        lastTickMillis = clockMillis();
         setMode(MODE_FOCUSING);
         DEBUG_PRINTLN("SystemState: Timer resumed");
     }
@@ -496,8 +535,8 @@ void SystemState::handleFlip(bool isFlipped) {
             setMode(MODE_FOCUSING);
             totalTimeSeconds = tasks[index].focusDuration * 60;
             timeLeftSeconds = totalTimeSeconds;
-            timerStartMillis = millis();
-            lastTickMillis = millis();
+            timerStartMillis = clockMillis();
+            lastTickMillis = clockMillis();
             
             DEBUG_PRINTF("SystemState: FLIP START - Task '%s' timer started (%d sec)\n", 
                         tasks[index].name, totalTimeSeconds);
@@ -561,7 +600,6 @@ void SystemState::confirmTaskComplete() {
         pendingWater++;
         
         // Stop timer
-        uint32_t completedTaskId = activeTaskId;
         activeTaskId = 0;
         timeLeftSeconds = 0;
         totalTimeSeconds = 0;
@@ -686,6 +724,88 @@ void SystemState::resetForNewDay() {
     notifyStateChanged();
 }
 
+bool SystemState::endDay() {
+    PlantInfo plant = getPlantInfo();
+    bool goalMet = checkDailyGoalsMet();
+
+    if (!goalMet) {
+        DEBUG_PRINTF("Goals NOT met! (%d/%d) - Plant withers!\n",
+                     plant.wateredCount, plant.totalGoal);
+        killPlant();
+    } else if (plant.totalGoal > 0) {
+        DEBUG_PRINTF("Goals met! (%d/%d) - Great job!\n",
+                     plant.wateredCount, plant.totalGoal);
+    }
+
+    resetForNewDay();
+    return goalMet;
+}
+
+void SystemState::restorePlant(uint8_t stage, bool withered, uint8_t pending, uint8_t watered,
+                               uint8_t goal, uint8_t sessionGoal) {
+    plantStage = stage;
+    plantWithered = withered;
+    pendingWater = pending;
+    wateredCount = watered;
+    dailyGoal = goal;
+    currentSessionGoal = sessionGoal;
+
+    // Same as begin() after loading from NVS
+    if (plantWithered) {
+        currentMode = MODE_WITHERED;
+    }
+    lastWateredCount = wateredCount;
+    wasWithered = plantWithered;
+
+    saveState();
+    notifyStateChanged();
+    notifyPlantChanged();
+}
+
+bool SystemState::restoreTask(const char* name, uint16_t focusMins, uint16_t breakMins,
+                              bool completed, bool started) {
+    if (!addTask(name, focusMins, breakMins)) return false;
+    tasks[taskCount - 1].completed = completed;
+    tasks[taskCount - 1].started = started;
+    saveTasks();
+    return true;
+}
+
+void SystemState::restoreBackup(uint8_t stage, bool withered, uint8_t pending, uint8_t watered,
+                                uint8_t goal, uint8_t sessionGoal, const TaskInfo* restoredTasks, uint8_t count) {
+    plantStage = stage;
+    plantWithered = withered;
+    pendingWater = pending;
+    wateredCount = watered;
+    dailyGoal = goal;
+    currentSessionGoal = sessionGoal;
+
+    taskCount = min(count, (uint8_t)MAX_TASKS);
+    for (int i = 0; i < MAX_TASKS; i++) {
+        tasks[i] = i < taskCount ? restoredTasks[i] : TaskInfo();
+    }
+
+    // A running session belonged to the old task list
+    currentMode = plantWithered ? MODE_WITHERED : MODE_IDLE;
+    activeTaskId = 0;
+    selectedTaskId = 0;
+    timeLeftSeconds = 0;
+    totalTimeSeconds = 0;
+    pausedTimeLeft = 0;
+    waitingForConfirmation = false;
+    lastWateredCount = wateredCount;
+    wasWithered = plantWithered;
+
+    saveState();
+    saveTasks();
+
+    DEBUG_PRINTF("SystemState: Backup restored - stage:%d, goal:%d, tasks:%d\n",
+                 plantStage, dailyGoal, taskCount);
+    eventQueue.push(Event::STATE_RESTORED);  // Ahead of STATE_CHANGED: not a session end
+    notifyStateChanged();
+    notifyPlantChanged();
+}
+
 void SystemState::restartDay() {
     // Full reset - plant, tasks, and goals
     plantWithered = false;
@@ -777,8 +897,8 @@ void SystemState::handleTimerComplete() {
         setMode(MODE_BREAK);
         totalTimeSeconds = activeTask->breakDuration * 60;
         timeLeftSeconds = totalTimeSeconds;
-        timerStartMillis = millis();
-        lastTickMillis = millis();
+        timerStartMillis = clockMillis();
+        lastTickMillis = clockMillis();
 
     } else if (currentMode == MODE_BREAK && activeTask != nullptr) {
         // Break complete -> restart focus
@@ -787,8 +907,8 @@ void SystemState::handleTimerComplete() {
         setMode(MODE_FOCUSING);
         totalTimeSeconds = activeTask->focusDuration * 60;
         timeLeftSeconds = totalTimeSeconds;
-        timerStartMillis = millis();
-        lastTickMillis = millis();
+        timerStartMillis = clockMillis();
+        lastTickMillis = clockMillis();
 
     } else {
         // No active task, go idle
@@ -826,6 +946,7 @@ void SystemState::saveState() {
     prefs.putUChar("taskCount", taskCount);
     
     prefs.end();
+    latencyTrace.mark(LatencyStage::PERSISTED);
     DEBUG_PRINTLN("SystemState: State saved to NVS");
 }
 
@@ -874,6 +995,7 @@ void SystemState::saveTasks() {
     }
     
     prefs.end();
+    latencyTrace.mark(LatencyStage::PERSISTED);
     DEBUG_PRINTF("SystemState: Saved %d tasks to NVS\n", taskCount);
 }
 
@@ -932,12 +1054,14 @@ void SystemState::handleLightSensor(int ldrValue) {
         return;
     }
     
-    if (ldrValue >= LDR_REVIVE_THRESHOLD) {
+    // Hysteresis: ADC noise around the threshold must not restart the revive
+    int threshold = reviving ? LDR_REVIVE_THRESHOLD - LDR_REVIVE_HYSTERESIS : LDR_REVIVE_THRESHOLD;
+    if (ldrValue >= threshold) {
         if (!reviving) {
             reviving = true;
-            reviveStartTime = millis();
+            reviveStartTime = clockMillis();
             DEBUG_PRINTLN("Light detected, starting revive...");
-        } else if (millis() - reviveStartTime >= LDR_REVIVE_DURATION) {
+        } else if (clockMillis() - reviveStartTime >= LDR_REVIVE_DURATION) {
             // Revive successful!
             revivePlant();  // This calls notifyPlantChanged which pushes PLANT_REVIVED
             reviving = false;
@@ -954,6 +1078,8 @@ void SystemState::handleLightSensor(int ldrValue) {
 // ============================================
 
 void SystemState::notifyStateChanged() {
+    stateChangedAt = ++version;
+
     // Push to event queue
     eventQueue.push(Event::STATE_CHANGED);
     eventQueue.push(Event::OLED_REFRESH);
@@ -976,6 +1102,7 @@ void SystemState::notifyTimerTick() {
 }
 
 void SystemState::notifyPlantChanged() {
+    plantChangedAt = ++version;
     PlantInfo plant = getPlantInfo();
     
     // Detect revive (was withered, now alive)
@@ -12,6 +12,7 @@
 
 #include <Arduino.h>
 #include <functional>
+#include "FixedMath.h"
 
 // ============================================
 // Screen Types Enum
@@ -141,6 +142,12 @@ public:
         return progress > 1.0f ? 1.0f : progress;
     }
 
+    // Get progress as Q16 (0 .. 65536) - use this in render code
+    uint32_t getProgressQ16() const {
+        if (screenDuration == 0) return 0;
+        return FixedMath::ratioQ16(millis() - screenStartTime, screenDuration);
+    }
+
 private:
     static const int MAX_SCREENS = 8;
     
@@ -189,6 +196,23 @@ namespace Animation {
     inline float oscillate(float t, float frequency = 1.0f) {
         return (sin(t * frequency * 6.28318f) + 1.0f) / 2.0f;
     }
+
+    // ----------------------------------------
+    // Fixed-point versions (table lookups, no float)
+    // t and results are Q16: 0 .. 65536 = 0.0 .. 1.0
+    // ----------------------------------------
+    inline uint32_t easeInOutQ16(uint32_t t) {
+        return FixedMath::EASE_IN_OUT_TABLE.lookup(t);
+    }
+
+    inline uint32_t bounceQ16(uint32_t t) {
+        return FixedMath::BOUNCE_TABLE.lookup(t);
+    }
+
+    // Whole cycles per unit t
+    inline uint32_t oscillateQ16(uint32_t t, uint16_t cycles = 1) {
+        return (uint32_t)(FixedMath::sinQ15((uint16_t)(t * cycles)) + FixedMath::Q15_ONE);
+    }
 }
 
 // ============================================
@@ -0,0 +1,93 @@
+#ifndef WEB_ACTIONS_H
+#define WEB_ACTIONS_H
+
+/**
+ * ============================================
+ * WebActions - State changes requested by web clients
+ * ============================================
+ *
+ * One dispatch for WebSocket messages, POST /api/action and scenario
+ * "web" steps. An action counts as applied only if the state version
+ * moved: adding to a full task list, deleting an unknown task or
+ * watering with nothing pending changes nothing, and a client that
+ * drew the change optimistically must hear so (ack ok:false + delta).
+ *
+ * Transport-only actions (getStatus, subscribeScreen, setTime, ...)
+ * come back as UNKNOWN for the caller to handle.
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "SystemState.h"
+#include "Analytics.h"
+
+enum class ActionResult : uint8_t {
+    APPLIED,    // State changed (new version)
+    UNCHANGED,  // A state action, but nothing to do
+    UNKNOWN     // Not a state action
+};
+
+inline ActionResult applyWebAction(SystemState& state, Analytics& analytics, JsonDocument& doc) {
+    const char* action = doc["action"] | "";
+    uint32_t taskId = doc["taskId"] | 0;
+    uint32_t before = state.getVersion();
+
+    if (strcmp(action, "water") == 0) {
+        state.waterPlant();
+    }
+    else if (strcmp(action, "kill") == 0) {
+        state.killPlant();
+        state.clearAllTasks();       // Clear tasks on demo kill
+        analytics.forceDailyReset(); // Reset today's stats
+    }
+    else if (strcmp(action, "pause") == 0) {
+        state.pauseTimer();
+    }
+    else if (strcmp(action, "resume") == 0) {
+        state.resumeTimer();
+    }
+    else if (strcmp(action, "addTask") == 0) {
+        const char* name = doc["task"]["name"] | "Untitled";
+        uint16_t focus = doc["task"]["focusDuration"] | 25;
+        uint16_t breakTime = doc["task"]["breakDuration"] | 5;
+        state.addTask(name, focus, breakTime);
+    }
+    else if (strcmp(action, "startTask") == 0) {
+        state.startTask(taskId);
+    }
+    else if (strcmp(action, "deleteTask") == 0) {
+        state.deleteTask(taskId);
+    }
+    else if (strcmp(action, "toggleTask") == 0) {
+        state.toggleTaskComplete(taskId);
+    }
+    else if (strcmp(action, "setGoal") == 0) {
+        state.setDailyGoal(doc["goal"] | 0);
+    }
+    else if (strcmp(action, "restartDay") == 0) {
+        state.restartDay();
+        analytics.forceDailyReset();  // Reset today's statistics too
+    }
+    else if (strcmp(action, "revive") == 0) {
+        state.revivePlant();
+    }
+    else if (strcmp(action, "selectTask") == 0) {
+        // Select task for flip control (prepare to start with MPU flip)
+        state.selectTaskForFlip(taskId);
+    }
+    else if (strcmp(action, "confirmComplete") == 0) {
+        // User confirms task completion after flip
+        state.confirmTaskComplete();
+    }
+    else if (strcmp(action, "cancelComplete") == 0) {
+        // User says flip was accidental
+        state.cancelTaskComplete();
+    }
+    else {
+        return ActionResult::UNKNOWN;
+    }
+
+    return state.getVersion() != before ? ActionResult::APPLIED : ActionResult::UNCHANGED;
+}
+
+#endif // WEB_ACTIONS_H
@@ -3,6 +3,14 @@
 
 #include <pgmspace.h>
 
-const char INDEX_HTML[] PROGMEM = "<!DOCTYPE html>\n<html lang=\"ro\">\n<head>\n    <meta charset=\"UTF-8\">\n    <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0, maximum-scale=1.0, user-scalable=no\">\n    <title>Productivity Bloom</title>\n    <style>:root{--primary:#2ecc71;--primary-dark:#27ae60;--primary-light:#a8e6cf;--secondary:#3498db;--secondary-dark:#2980b9;--danger:#e74c3c;--danger-dark:#c0392b;--warning:#f39c12;--warning-dark:#d68910;--bg-dark:#1a1a2e;--bg-card:#16213e;--bg-input:#0f3460;--text-primary:#ffffff;--text-secondary:#b8c5d6;--text-muted:#6c7a89;--border-color:#2d4a6f;--shadow:0 4px 15px rgba(0,0,0,0.3);--spacing-xs:0.25rem;--spacing-sm:0.5rem;--spacing-md:1rem;--spacing-lg:1.5rem;--spacing-xl:2rem;--radius-sm:8px;--radius-md:12px;--radius-lg:16px;--radius-full:50%;--transition:all 0.3s ease;}*{margin:0;padding:0;box-sizing:border-box;}html{font-size:16px;}body{font-family:-apple-system,BlinkMacSystemFont,'Segoe UI',Roboto,Oxygen,Ubuntu,sans-serif;background:var(--bg-dark);color:var(--text-primary);min-height:100vh;line-height:1.5;-webkit-font-smoothing:antialiased;}.app-container{max-width:480px;margin:0 auto;padding:var(--spacing-md);padding-bottom:calc(var(--spacing-xl) + 60px);}.header{display:flex;justify-content:space-between;align-items:center;padding:var(--spacing-md) 0;margin-bottom:var(--spacing-md);}.logo{display:flex;align-items:center;gap:var(--spacing-sm);}.logo-icon{font-size:1.2rem;font-weight:700;color:var(--primary);background:var(--bg-input);padding:0.3rem 0.5rem;border-radius:var(--radius-sm);}@keyframes pulse{0%,100%{transform:scale(1);}50%{transform:scale(1.05);}}.logo h1{font-size:1.2rem;font-weight:600;background:linear-gradient(135deg,var(--primary),var(--secondary));-webkit-background-clip:text;-webkit-text-fill-color:transparent;background-clip:text;}.connection-status{display:flex;align-items:center;gap:var(--spacing-xs);font-size:0.75rem;color:var(--text-muted);}.status-dot{width:8px;height:8px;border-radius:var(--radius-full);background:var(--warning);animation:blink 1s infinite;}.status-dot.connected{background:var(--primary);animation:none;}.status-dot.disconnected{background:var(--danger);}@keyframes blink{0%,100%{opacity:1;}50%{opacity:0.3;}}.card{background:var(--bg-card);border-radius:var(--radius-lg);padding:var(--spacing-lg);margin-bottom:var(--spacing-md);box-shadow:var(--shadow);border:1px solid var(--border-color);}.card h2{font-size:1rem;font-weight:600;margin-bottom:var(--spacing-md);color:var(--text-primary);}.status-card{background:linear-gradient(135deg,var(--bg-card) 0%,rgba(46,204,113,0.1) 100%);}.status-display{display:flex;align-items:center;justify-content:center;gap:var(--spacing-md);margin-bottom:var(--spacing-md);}.status-info{display:flex;flex-direction:column;}.status-info.centered{align-items:center;text-align:center;}.status-label{font-size:0.75rem;font-weight:700;letter-spacing:1px;color:var(--primary);text-transform:uppercase;}.status-label.focusing{color:var(--danger);}.status-label.break{color:var(--secondary);}.status-label.withered{color:var(--warning);}.current-task{font-size:1.1rem;font-weight:500;color:var(--text-secondary);}.timer-display{text-align:center;}.timer-value{font-size:3rem;font-weight:700;font-family:'Courier New',monospace;letter-spacing:2px;}.timer-progress{height:6px;background:var(--bg-input);border-radius:var(--radius-sm);margin-top:var(--spacing-sm);overflow:hidden;}.timer-bar{height:100%;background:linear-gradient(90deg,var(--primary),var(--secondary));border-radius:var(--radius-sm);width:0%;transition:width 1s linear;}.plant-card{text-align:center;}.plant-display{display:flex;flex-direction:column;align-items:center;margin-bottom:var(--spacing-lg);}.plant-visual{position:relative;margin-bottom:var(--spacing-md);}.plant-stage{font-size:4rem;animation:sway 3s ease-in-out infinite;transition:var(--transition);}.plant-stage.withered{filter:grayscale(100%);animation:shake 0.5s ease-in-out;}.plant-pot{font-size:2rem;margin-top:-10px;}@keyframes sway{0%,100%{transform:rotate(-3deg);}50%{transform:rotate(3deg);}}@keyframes shake{0%,100%{transform:translateX(0);}25%{transform:translateX(-5px);}75%{transform:translateX(5px);}}.plant-pot{font-size:2rem;margin-top:-10px;}.plant-info{display:flex;flex-direction:column;gap:var(--spacing-xs);}.plant-stage-text{color:var(--text-secondary);font-size:0.9rem;}.stage-number{color:var(--primary);font-weight:600;}.plant-health{display:flex;align-items:center;justify-content:center;gap:var(--spacing-xs);font-size:0.85rem;}.plant-health.withered .health-icon{content:'💔';}.plant-health.withered .health-text{color:var(--danger);}.water-hint{margin-top:var(--spacing-sm);font-size:0.75rem;color:var(--text-muted);font-style:italic;transition:var(--transition);}.water-hint.ready{color:var(--secondary);font-style:normal;font-weight:500;}.water-hint.complete{color:var(--primary);}.plant-actions{display:flex;gap:var(--spacing-md);}.btn{display:flex;align-items:center;justify-content:center;gap:var(--spacing-sm);padding:var(--spacing-sm) var(--spacing-lg);border:none;border-radius:var(--radius-md);font-size:0.9rem;font-weight:600;cursor:pointer;transition:var(--transition);flex:1;}.btn:active{transform:scale(0.96);}.btn:disabled{opacity:0.4;cursor:not-allowed;transform:none;background:var(--bg-input) !important;color:var(--text-muted) !important;box-shadow:none !important;pointer-events:none;}.btn-icon{font-size:1.1rem;}.btn-primary{background:linear-gradient(135deg,var(--primary),var(--primary-dark));color:white;}.btn-primary:hover:not(:disabled){box-shadow:0 4px 15px rgba(46,204,113,0.4);}.btn-secondary{background:var(--bg-input);color:var(--text-secondary);border:1px solid var(--border-color);}.btn-water{background:linear-gradient(135deg,var(--secondary),var(--secondary-dark));color:white;}.btn-water:hover:not(:disabled){box-shadow:0 4px 15px rgba(52,152,219,0.4);}.btn-danger{background:linear-gradient(135deg,var(--danger),var(--danger-dark));color:white;}.btn-danger:hover:not(:disabled){box-shadow:0 4px 15px rgba(231,76,60,0.4);}.btn-success{background:linear-gradient(135deg,var(--primary),var(--primary-dark));color:white;}.btn-full{width:100%;}.btn-sm{padding:var(--spacing-xs) var(--spacing-sm);font-size:0.8rem;}.goal-section{background:var(--bg-input);padding:var(--spacing-md);border-radius:var(--radius-md);margin-bottom:var(--spacing-md);border:2px dashed var(--border-color);transition:var(--transition);}.goal-section.locked{border-style:solid;border-color:var(--primary);background:rgba(46,204,113,0.1);}.goal-setter{display:flex;flex-direction:column;gap:var(--spacing-sm);}.goal-section.locked .goal-setter{display:none;}.goal-setter label{font-size:0.9rem;font-weight:500;color:var(--text-secondary);}.goal-input-row{display:flex;gap:var(--spacing-sm);}.goal-input-row input{flex:1;padding:var(--spacing-sm) var(--spacing-md);background:var(--bg-card);border:1px solid var(--border-color);border-radius:var(--radius-sm);color:var(--text-primary);font-size:1rem;text-align:center;}.goal-input-row input:focus{outline:none;border-color:var(--primary);}.goal-display{margin-top:var(--spacing-sm);}.goal-info{display:flex;justify-content:space-between;align-items:center;}.goal-target{font-weight:600;color:var(--primary);}.task-form{background:var(--bg-input);padding:var(--spacing-md);border-radius:var(--radius-md);margin-bottom:var(--spacing-lg);}.form-group{margin-bottom:var(--spacing-md);}.form-group:last-of-type{margin-bottom:var(--spacing-md);}.form-group label{display:block;font-size:0.8rem;color:var(--text-muted);margin-bottom:var(--spacing-xs);}.form-group input{width:100%;padding:var(--spacing-sm) var(--spacing-md);background:var(--bg-card);border:1px solid var(--border-color);border-radius:var(--radius-sm);color:var(--text-primary);font-size:1rem;transition:var(--transition);}.form-group input:focus{outline:none;border-color:var(--primary);box-shadow:0 0 0 3px rgba(46,204,113,0.2);}.form-group input::placeholder{color:var(--text-muted);}.form-row{display:flex;gap:var(--spacing-md);}.form-row .form-group{flex:1;}.task-list-header{display:flex;justify-content:space-between;align-items:center;padding-bottom:var(--spacing-sm);border-bottom:1px solid var(--border-color);margin-bottom:var(--spacing-md);font-size:0.85rem;color:var(--text-muted);}.task-count{color:var(--primary);font-weight:600;}.task-items{max-height:300px;overflow-y:auto;}.empty-state{display:flex;flex-direction:column;align-items:center;padding:var(--spacing-xl);color:var(--text-muted);}.empty-icon{font-size:2rem;margin-bottom:var(--spacing-sm);opacity:0.5;}.task-item{display:flex;align-items:center;gap:var(--spacing-sm);padding:var(--spacing-md);background:var(--bg-input);border-radius:var(--radius-md);margin-bottom:var(--spacing-sm);transition:var(--transition);animation:slideIn 0.3s ease;}@keyframes slideIn{from{opacity:0;transform:translateY(-10px);}to{opacity:1;transform:translateY(0);}}.task-item.completed{opacity:0.6;background:rgba(46,204,113,0.1);}.task-item.active{border:2px solid var(--primary);background:rgba(46,204,113,0.1);}.task-item.selected{border:2px solid var(--warning);background:rgba(243,156,18,0.15);animation:pulse-border 2s infinite;}@keyframes pulse-border{0%,100%{border-color:var(--warning);}50%{border-color:var(--warning-dark);box-shadow:0 0 10px rgba(243,156,18,0.5);}}.task-hint{font-size:0.75rem;color:var(--warning);margin-top:4px;animation:blink 1.5s infinite;}.task-hint.active{color:var(--primary);}@keyframes blink{0%,100%{opacity:1;}50%{opacity:0.5;}}.task-checkbox{width:22px;height:22px;border:2px solid var(--border-color);border-radius:var(--radius-sm);display:flex;align-items:center;justify-content:center;cursor:pointer;transition:var(--transition);flex-shrink:0;}.task-checkbox.disabled{opacity:0.4;cursor:not-allowed;pointer-events:none;background:var(--bg-input);}.task-checkbox.checked{background:var(--primary);border-color:var(--primary);}.task-checkbox.checked::after{content:'✓';color:white;font-size:0.8rem;}.task-info{flex:1;min-width:0;}.task-name{font-weight:500;white-space:nowrap;overflow:hidden;text-overflow:ellipsis;}.task-duration{font-size:0.75rem;color:var(--text-muted);}.task-actions{display:flex;gap:var(--spacing-xs);}.task-btn{width:32px;height:32px;border:none;border-radius:var(--radius-sm);background:var(--bg-card);color:var(--text-primary);font-size:1rem;font-weight:bold;cursor:pointer;transition:var(--transition);display:flex;align-items:center;justify-content:center;}.task-btn:hover{background:var(--primary);color:white;}.task-btn.delete:hover{background:var(--danger);color:white;}.task-btn.select{background:rgba(243,156,18,0.2);border-color:var(--warning);}.task-btn.select:hover{background:var(--warning);color:white;}.task-btn.cancel{background:rgba(231,76,60,0.2);border-color:var(--danger);}.task-btn.cancel:hover{background:var(--danger);color:white;}.stats-grid{display:grid;grid-template-columns:repeat(3,1fr);gap:var(--spacing-md);margin-bottom:var(--spacing-lg);}.stat-item{text-align:center;padding:var(--spacing-md);background:var(--bg-input);border-radius:var(--radius-md);}.stat-value{display:block;font-size:1.8rem;font-weight:700;color:var(--primary);}.stat-label{font-size:0.7rem;color:var(--text-muted);text-transform:uppercase;letter-spacing:0.5px;}.progress-section{margin-bottom:var(--spacing-md);}.progress-header{display:flex;justify-content:space-between;font-size:0.85rem;margin-bottom:var(--spacing-xs);}.progress-bar{height:12px;background:var(--bg-input);border-radius:var(--radius-sm);overflow:hidden;}.progress-fill{height:100%;background:linear-gradient(90deg,var(--primary),var(--secondary));border-radius:var(--radius-sm);width:0%;transition:width 0.5s ease;}.time-info{display:flex;align-items:center;justify-content:center;gap:var(--spacing-sm);padding-top:var(--spacing-md);border-top:1px solid var(--border-color);font-size:0.85rem;color:var(--text-muted);}.clock-icon{font-size:1.2rem;}#currentTime{font-weight:600;color:var(--text-primary);}.footer{position:fixed;bottom:0;left:0;right:0;background:var(--bg-card);padding:var(--spacing-md);display:flex;justify-content:space-between;font-size:0.75rem;color:var(--text-muted);border-top:1px solid var(--border-color);}.toast{position:fixed;bottom:80px;left:50%;transform:translateX(-50%) translateY(100px);background:var(--bg-card);padding:var(--spacing-sm) var(--spacing-lg);border-radius:var(--radius-md);display:flex;align-items:center;gap:var(--spacing-sm);box-shadow:0 4px 20px rgba(0,0,0,0.4);z-index:1000;opacity:0;transition:all 0.3s ease;border:1px solid var(--border-color);}.toast.show{transform:translateX(-50%) translateY(0);opacity:1;}.toast.success{border-color:var(--primary);}.toast.error{border-color:var(--danger);}.modal-overlay{position:fixed;top:0;left:0;right:0;bottom:0;background:rgba(0,0,0,0.7);display:flex;align-items:center;justify-content:center;z-index:1001;opacity:0;visibility:hidden;transition:var(--transition);}.modal-overlay.show{opacity:1;visibility:visible;}.modal{background:var(--bg-card);padding:var(--spacing-xl);border-radius:var(--radius-lg);text-align:center;max-width:320px;width:90%;transform:scale(0.9);transition:var(--transition);}.modal-overlay.show .modal{transform:scale(1);}.modal-icon{font-size:3rem;margin-bottom:var(--spacing-md);}.modal h3{margin-bottom:var(--spacing-sm);}.modal p{color:var(--text-secondary);margin-bottom:var(--spacing-lg);}.modal-actions{display:flex;gap:var(--spacing-md);}::-webkit-scrollbar{width:6px;}::-webkit-scrollbar-track{background:var(--bg-input);border-radius:3px;}::-webkit-scrollbar-thumb{background:var(--border-color);border-radius:3px;}::-webkit-scrollbar-thumb:hover{background:var(--primary);}@media (min-width:768px){.app-container{padding:var(--spacing-xl);}.logo h1{font-size:1.4rem;}.timer-value{font-size:4rem;}.plant-stage{font-size:5rem;}}@media (prefers-color-scheme:light){}@media (prefers-reduced-motion:reduce){*{animation:none !important;transition:none !important;}}.weekly-card{background:linear-gradient(135deg,var(--bg-card) 0%,rgba(52,152,219,0.1) 100%);}.weekly-summary{display:grid;grid-template-columns:repeat(3,1fr);gap:var(--spacing-md);margin-bottom:var(--spacing-md);}.weekly-chart{display:flex;align-items:flex-end;justify-content:space-between;height:80px;padding:var(--spacing-sm);background:var(--bg-input);border-radius:var(--radius-md);margin-bottom:var(--spacing-sm);}.chart-bar{flex:1;margin:0 2px;background:linear-gradient(to top,var(--primary),var(--secondary));border-radius:var(--radius-sm) var(--radius-sm) 0 0;min-height:4px;transition:height 0.3s ease;position:relative;}.chart-bar::after{content:attr(data-day);position:absolute;bottom:-18px;left:50%;transform:translateX(-50%);font-size:0.6rem;color:var(--text-muted);}.chart-bar.today{background:linear-gradient(to top,var(--warning),var(--warning-dark));}.weekly-best{text-align:center;color:var(--text-muted);padding-top:var(--spacing-sm);border-top:1px solid var(--border-color);}.weekly-best span{color:var(--primary);font-weight:600;}.stats-actions{display:flex;justify-content:center;margin-top:var(--spacing-md);padding-top:var(--spacing-md);border-top:1px solid var(--border-color);}.time-info{display:flex;align-items:center;justify-content:center;gap:var(--spacing-sm);padding-top:var(--spacing-md);border-top:1px solid var(--border-color);font-size:0.85rem;color:var(--text-muted);}.time-info .btn-sm{padding:0.2rem 0.5rem;font-size:0.7rem;}</style>\n</head>\n<body>\n    <div class=\"app-container\">\n        <!-- Header -->\n        <header class=\"header\">\n            <div class=\"logo\">\n                <span class=\"logo-icon\">PB</span>\n                <h1>Productivity Bloom</h1>\n            </div>\n            <div class=\"connection-status\" id=\"connectionStatus\">\n                <span class=\"status-dot\"></span>\n                <span class=\"status-text\">Conectare...</span>\n            </div>\n        </header>\n\n        <!-- Status Card -->\n        <section class=\"card status-card\">\n            <div class=\"status-display\">\n                <div class=\"status-info centered\">\n                    <span class=\"status-label\" id=\"statusLabel\">IDLE</span>\n                    <span class=\"current-task\" id=\"currentTask\">Niciun task activ</span>\n                </div>\n            </div>\n            <div class=\"timer-display\" id=\"timerDisplay\">\n                <span class=\"timer-value\" id=\"timerValue\">00:00</span>\n                <div class=\"timer-progress\">\n                    <div class=\"timer-bar\" id=\"timerBar\"></div>\n                </div>\n            </div>\n        </section>\n\n        <!-- Plant Section -->\n        <section class=\"card plant-card\">\n            <h2>Planta Ta</h2>\n            <div class=\"plant-display\">\n                <div class=\"plant-visual\" id=\"plantVisual\">\n                    <div class=\"plant-stage\" id=\"plantStage\"></div>\n                    <div class=\"plant-pot\"></div>\n                </div>\n                <div class=\"plant-info\">\n                    <div class=\"plant-stage-text\">\n                        Stadiu: <span id=\"plantStageText\">Samanta</span>\n                        <span class=\"stage-number\" id=\"stageNumber\">(0/0)</span>\n                    </div>\n                    <div class=\"plant-health\" id=\"plantHealth\">\n                        <span class=\"health-icon\"></span>\n                        <span class=\"health-text\">Sanatoasa</span>\n                    </div>\n                    <div class=\"water-hint\" id=\"waterHint\">\n                        <small>Completeaza un task pentru a putea uda planta</small>\n                    </div>\n                </div>\n            </div>\n            <div class=\"plant-actions\">\n                <button class=\"btn btn-water\" id=\"btnWater\" disabled>\n                    <span class=\"btn-icon\"></span>\n                    <span class=\"btn-text\">Uda Planta</span>\n                </button>\n                <button class=\"btn btn-danger\" id=\"btnKill\">\n                    <span class=\"btn-icon\"></span>\n                    <span class=\"btn-text\">Demo Kill</span>\n                </button>\n            </div>\n        </section>\n\n        <!-- Task Manager -->\n        <section class=\"card task-card\">\n            <h2>Task Manager</h2>\n            \n            <!-- Daily Goal Section -->\n            <div class=\"goal-section\" id=\"goalSection\">\n                <div class=\"goal-setter\">\n                    <label for=\"dailyGoalInput\">Obiectiv zilnic:</label>\n                    <div class=\"goal-input-row\">\n                        <input type=\"number\" id=\"dailyGoalInput\" value=\"3\" min=\"1\" max=\"20\" placeholder=\"Nr. task-uri\">\n                        <button class=\"btn btn-success btn-sm\" id=\"btnSetGoal\">Seteaza</button>\n                    </div>\n                </div>\n                <div class=\"goal-display\" id=\"goalDisplay\"></div>\n            </div>\n            \n            <!-- Add Task Form -->\n            <div class=\"task-form\">\n                <div class=\"form-group\">\n                    <label for=\"taskName\">Nume Task</label>\n                    <input type=\"text\" id=\"taskName\" placeholder=\"ex: Invata pentru examen\" maxlength=\"30\">\n                </div>\n                <div class=\"form-row\">\n                    <div class=\"form-group\">\n                        <label for=\"focusTime\">Focus (min)</label>\n                        <input type=\"number\" id=\"focusTime\" value=\"25\" min=\"1\" max=\"120\">\n                    </div>\n                    <div class=\"form-group\">\n                        <label for=\"breakTime\">Pauza (min)</label>\n                        <input type=\"number\" id=\"breakTime\" value=\"5\" min=\"1\" max=\"30\">\n                    </div>\n                </div>\n                <button class=\"btn btn-primary btn-full\" id=\"btnAddTask\">\n                    <span class=\"btn-icon\">+</span>\n                    <span class=\"btn-text\">Adauga Task</span>\n                </button>\n            </div>\n\n            <!-- Task List -->\n            <div class=\"task-list\" id=\"taskList\">\n                <div class=\"task-list-header\">\n                    <span>Task-uri pentru azi</span>\n                    <span class=\"task-count\" id=\"taskCount\">0 task-uri</span>\n                </div>\n                <div class=\"task-items\" id=\"taskItems\">\n                    <div class=\"empty-state\" id=\"emptyState\">\n                        <span class=\"empty-icon\">--</span>\n                        <span class=\"empty-text\">Niciun task adaugat</span>\n                    </div>\n                </div>\n            </div>\n        </section>\n\n        <!-- Statistics -->\n        <section class=\"card stats-card\">\n            <h2>Statistici Azi</h2>\n            <div class=\"stats-grid\">\n                <div class=\"stat-item\">\n                    <span class=\"stat-value\" id=\"tasksCompleted\">0</span>\n                    <span class=\"stat-label\">Completate</span>\n                </div>\n                <div class=\"stat-item\">\n                    <span class=\"stat-value\" id=\"tasksTotal\">0</span>\n                    <span class=\"stat-label\">Total</span>\n                </div>\n                <div class=\"stat-item\">\n                    <span class=\"stat-value\" id=\"focusTotal\">0</span>\n                    <span class=\"stat-label\">Min Focus</span>\n                </div>\n            </div>\n            <div class=\"progress-section\">\n                <div class=\"progress-header\">\n                    <span>Progres zilnic</span>\n                    <span id=\"progressPercent\">0%</span>\n                </div>\n                <div class=\"progress-bar\">\n                    <div class=\"progress-fill\" id=\"progressFill\"></div>\n                </div>\n            </div>\n            <div class=\"time-info\">\n                <span class=\"clock-icon\">Ora:</span>\n                <span id=\"currentTime\">--:--</span>\n                <button class=\"btn btn-sm btn-secondary\" id=\"btnSyncTime\" title=\"Sincronizeaza ora de pe telefon\">Sync</button>\n            </div>\n            <div class=\"stats-actions\">\n                <button class=\"btn btn-danger btn-sm\" id=\"btnResetDay\">Reset Ziua</button>\n            </div>\n        </section>\n\n        <!-- Weekly Statistics -->\n        <section class=\"card weekly-card\">\n            <h2>Statistici Saptamanale</h2>\n            <div class=\"weekly-stats\" id=\"weeklyStats\">\n                <div class=\"weekly-summary\">\n                    <div class=\"stat-item\">\n                        <span class=\"stat-value\" id=\"weeklyTasks\">0</span>\n                        <span class=\"stat-label\">Task-uri</span>\n                    </div>\n                    <div class=\"stat-item\">\n                        <span class=\"stat-value\" id=\"weeklyFocus\">0</span>\n                        <span class=\"stat-label\">Min Focus</span>\n                    </div>\n                    <div class=\"stat-item\">\n                        <span class=\"stat-value\" id=\"weeklyAvg\">0</span>\n                        <span class=\"stat-label\">Media/zi</span>\n                    </div>\n                </div>\n                <div class=\"weekly-chart\" id=\"weeklyChart\"></div>\n                <div class=\"weekly-best\" id=\"weeklyBest\">\n                    <small>Cea mai productiva zi: <span id=\"bestDay\">-</span></small>\n                </div>\n            </div>\n        </section>\n\n        <!-- Footer -->\n        <footer class=\"footer\">\n            <span>Productivity Bloom v1.0</span>\n            <span id=\"espIP\">ESP32</span>\n        </footer>\n    </div>\n\n    <!-- Toast Notification -->\n    <div class=\"toast\" id=\"toast\">\n        <span class=\"toast-icon\" id=\"toastIcon\"></span>\n        <span class=\"toast-message\" id=\"toastMessage\">Mesaj</span>\n    </div>\n\n    <!-- Confirmation Modal -->\n    <div class=\"modal-overlay\" id=\"modalOverlay\">\n        <div class=\"modal\">\n            <div class=\"modal-icon\" id=\"modalIcon\">!</div>\n            <h3 id=\"modalTitle\">Confirmare</h3>\n            <p id=\"modalMessage\">Esti sigur?</p>\n            <div class=\"modal-actions\">\n                <button class=\"btn btn-secondary\" id=\"modalCancel\">Anuleaza</button>\n                <button class=\"btn btn-danger\" id=\"modalConfirm\">Confirma</button>\n            </div>\n        </div>\n    </div>\n\n    <script>/**\n* Productivity Bloom - Web Interface\n* Comunicare cu ESP32 prin API REST și WebSocket\n*/\n// ============================================\n// Configuration & State\n// ============================================\n// Use current page hostname (works for both AP mode and WiFi mode)\nconst ESP32_IP = window.location.hostname || '192.168.4.1';\nconst CONFIG = {\nAPI_BASE: `http://${ESP32_IP}`,\nWS_URL: `ws://${ESP32_IP}:81`,\nRECONNECT_INTERVAL: 2000,\nUPDATE_INTERVAL: 1000\n};\n// Debug log\nconsole.log('Productivity Bloom loading, ESP32 IP:', ESP32_IP);\n// Application State\nconst state = {\nconnected: false,\nwsConnected: false,  // Track WebSocket specifically\nstatus: 'idle', // idle, focusing, break, withered\ncurrentTask: null,\ntimeLeft: 0,\ntotalTime: 0,\nplant: {\nstage: 0,\nisWithered: false\n},\ntasks: [],\nstats: {\ncompleted: 0,\ntotal: 0,\nfocusMinutes: 0\n},\nws: null,\npendingWater: 0,  // Câte \"udări\" sunt disponibile (task-uri completate neapoi udate)\nwateredCount: 0,  // Câte task-uri au fost \"confirmate\" prin udare (pentru afișare)\ndailyGoal: 0,     // Obiectivul zilnic setat de utilizator\ncurrentSessionGoal: 0, // Câte task-uri noi trebuie făcute în sesiunea curentă\ngoalLocked: false, // Dacă obiectivul a fost confirmat\nselectedTaskId: 0,  // Task pregătit pentru pornire cu flip MPU\nshowingConfirmModal: false,  // Modal de confirmare flip\nflipCancelledWaitingFlipBack: false  // Waiting for user to flip back after cancel\n};\n// Plant stages configuration\nconst PLANT_STAGES = [\n{ emoji: '🌰', name: 'Samanta' },\n{ emoji: '🌱', name: 'Lastar' },\n{ emoji: '🌿', name: 'Crestere' },\n{ emoji: '🌸', name: 'Inflorit' }\n];\n// ============================================\n// DOM Elements\n// ============================================\nconst elements = {\n// Connection\nconnectionStatus: document.getElementById('connectionStatus'),\n// Status\nstatusLabel: document.getElementById('statusLabel'),\ncurrentTask: document.getElementById('currentTask'),\ntimerValue: document.getElementById('timerValue'),\ntimerBar: document.getElementById('timerBar'),\n// Plant\nplantStage: document.getElementById('plantStage'),\nplantStageText: document.getElementById('plantStageText'),\nstageNumber: document.getElementById('stageNumber'),\nplantHealth: document.getElementById('plantHealth'),\nplantVisual: document.getElementById('plantVisual'),\nwaterHint: document.getElementById('waterHint'),\nbtnWater: document.getElementById('btnWater'),\nbtnKill: document.getElementById('btnKill'),\n// Task Form\ntaskName: document.getElementById('taskName'),\nfocusTime: document.getElementById('focusTime'),\nbreakTime: document.getElementById('breakTime'),\nbtnAddTask: document.getElementById('btnAddTask'),\n// Daily Goal\ndailyGoalInput: document.getElementById('dailyGoalInput'),\nbtnSetGoal: document.getElementById('btnSetGoal'),\nbtnResetGoal: document.getElementById('btnResetGoal'),\ngoalDisplay: document.getElementById('goalDisplay'),\ngoalSection: document.getElementById('goalSection'),\n// Task List\ntaskItems: document.getElementById('taskItems'),\ntaskCount: document.getElementById('taskCount'),\nemptyState: document.getElementById('emptyState'),\n// Stats\ntasksCompleted: document.getElementById('tasksCompleted'),\ntasksTotal: document.getElementById('tasksTotal'),\nfocusTotal: document.getElementById('focusTotal'),\nprogressPercent: document.getElementById('progressPercent'),\nprogressFill: document.getElementById('progressFill'),\ncurrentTime: document.getElementById('currentTime'),\nbtnSyncTime: document.getElementById('btnSyncTime'),\nbtnResetDay: document.getElementById('btnResetDay'),\n// Weekly Stats\nweeklyTasks: document.getElementById('weeklyTasks'),\nweeklyFocus: document.getElementById('weeklyFocus'),\nweeklyAvg: document.getElementById('weeklyAvg'),\nweeklyChart: document.getElementById('weeklyChart'),\nbestDay: document.getElementById('bestDay'),\n// Footer\nespIP: document.getElementById('espIP'),\n// Toast\ntoast: document.getElementById('toast'),\ntoastIcon: document.getElementById('toastIcon'),\ntoastMessage: document.getElementById('toastMessage'),\n// Modal\nmodalOverlay: document.getElementById('modalOverlay'),\nmodalIcon: document.getElementById('modalIcon'),\nmodalTitle: document.getElementById('modalTitle'),\nmodalMessage: document.getElementById('modalMessage'),\nmodalCancel: document.getElementById('modalCancel'),\nmodalConfirm: document.getElementById('modalConfirm')\n};\n// ============================================\n// WebSocket Connection\n// ============================================\n// Helper to check if we're in development mode (only localhost)\nfunction isDevMode() {\nconst hostname = window.location.hostname;\n// Only treat as dev mode if literally on localhost\nreturn hostname === '127.0.0.1' || hostname === 'localhost';\n}\nfunction connectWebSocket() {\nconsole.log('connectWebSocket called, isDevMode:', isDevMode());\n// Pentru dezvoltare fără ESP32, folosim mock\nif (isDevMode()) {\nconsole.log('Development mode - using mock data');\nsetConnectionStatus(true);\nloadMockData();\nreturn;\n}\n// Close existing connection if any\nif (state.ws) {\ntry {\nstate.ws.close();\n} catch (e) {}\nstate.ws = null;\n}\ntry {\nconsole.log('Attempting WebSocket connection to:', CONFIG.WS_URL);\nstate.ws = new WebSocket(CONFIG.WS_URL);\nstate.ws.onopen = () => {\nconsole.log('WebSocket connected successfully');\nstate.wsConnected = true;\nsetConnectionStatus(true);\nshowToast('Conectat la ESP32!', 'success');\n// Refresh stats on reconnect\nfetchWeeklyStats();\n};\nstate.ws.onmessage = (event) => {\ntry {\nconst data = JSON.parse(event.data);\nhandleWebSocketMessage(data);\n} catch (e) {\nconsole.error('Failed to parse WS message:', e);\n}\n};\nstate.ws.onclose = () => {\nconsole.log('WebSocket disconnected');\nstate.wsConnected = false;\nsetConnectionStatus(false);\n// Reconnect after delay\nsetTimeout(connectWebSocket, CONFIG.RECONNECT_INTERVAL);\n};\nstate.ws.onerror = (error) => {\nconsole.error('WebSocket error:', error, 'URL:', CONFIG.WS_URL);\nsetConnectionStatus(false);\n};\n} catch (e) {\nconsole.error('WebSocket connection failed:', e);\nsetConnectionStatus(false);\nsetTimeout(connectWebSocket, CONFIG.RECONNECT_INTERVAL);\n}\n}\nfunction handleWebSocketMessage(data) {\nswitch (data.type) {\ncase 'status':\nupdateStatus(data);\nbreak;\ncase 'plant':\nupdatePlant(data);\nbreak;\ncase 'tasks':\nstate.tasks = data.tasks || [];\nrenderTasks();\nbreak;\ncase 'stats':\nupdateStats(data);\nbreak;\ncase 'flip':\nshowToast('Cub întors! ' + (data.paused ? 'Pauză' : 'Continui'), 'success');\nbreak;\ncase 'revive':\nshowReviveAnimation();\nshowToast(data.message || 'Planta a reinviat!', 'success');\nbreak;\n}\n}\nfunction sendWebSocketMessage(data) {\nif (state.ws && state.ws.readyState === WebSocket.OPEN) {\nstate.ws.send(JSON.stringify(data));\n} else {\n// Fallback to REST API\nsendAPIRequest(data);\n}\n}\n// ============================================\n// API Communication\n// ============================================\nasync function sendAPIRequest(action) {\n// Pentru dezvoltare, simulăm răspunsuri\nif (isDevMode()) {\nreturn handleMockAction(action);\n}\ntry {\nconst response = await fetch(`${CONFIG.API_BASE}/api/action`, {\nmethod: 'POST',\nheaders: { 'Content-Type': 'application/json' },\nbody: JSON.stringify(action)\n});\nreturn await response.json();\n} catch (e) {\nconsole.error('API request failed:', e);\nshowToast('Eroare de conexiune', 'error');\nreturn null;\n}\n}\nasync function fetchTasks() {\nif (isDevMode()) {\nreturn; // Mock data already loaded\n}\ntry {\nconst response = await fetch(`${CONFIG.API_BASE}/api/tasks`);\nconst data = await response.json();\nstate.tasks = data.tasks || [];\nrenderTasks();\n} catch (e) {\nconsole.error('Failed to fetch tasks:', e);\n}\n}\nasync function fetchStatus() {\nconsole.log('fetchStatus called, isDevMode:', isDevMode());\nif (isDevMode()) {\nreturn;\n}\nconst url = `${CONFIG.API_BASE}/api/status`;\nconsole.log('Fetching status from:', url);\ntry {\nconst response = await fetch(url);\nconsole.log('fetchStatus response:', response.status);\nconst data = await response.json();\nconsole.log('fetchStatus data:', data);\nupdateStatus(data);\nupdatePlant(data.plant);\nupdateStats(data.stats);\n// If we got here, we have connectivity (even if WebSocket failed)\nif (!state.connected) {\nsetConnectionStatus(true);\nconsole.log('Connected via API polling (WebSocket unavailable)');\n}\n} catch (e) {\nconsole.error('Failed to fetch status:', e);\nsetConnectionStatus(false);\n}\n}\n// ============================================\n// UI Update Functions\n// ============================================\nfunction setConnectionStatus(connected) {\nstate.connected = connected;\nconst statusDot = elements.connectionStatus.querySelector('.status-dot');\nconst statusText = elements.connectionStatus.querySelector('.status-text');\nstatusDot.className = 'status-dot ' + (connected ? 'connected' : 'disconnected');\nstatusText.textContent = connected ? 'Conectat' : 'Deconectat';\n}\nfunction updateStatus(data) {\nconst prevStatus = state.status;\nconst prevTask = state.currentTask;\nstate.status = data.state || 'idle';\nstate.timeLeft = data.timeLeft || 0;\nstate.totalTime = data.totalTime || 0;\nstate.currentTask = data.taskName || null;\n// Check if ESP32 is waiting for flip confirmation\n// But NOT if we're already showing the \"flip back\" message\nif (data.waitingForConfirmation && !state.showingConfirmModal && !state.flipCancelledWaitingFlipBack) {\nshowFlipConfirmModal();\n}\n// If no longer waiting and we were waiting for flip back, hide modal and resume\nif (!data.waitingForConfirmation && state.flipCancelledWaitingFlipBack) {\nhideModal();\nstate.flipCancelledWaitingFlipBack = false;\nshowToast('Timer resumed!', 'success');\n}\n// Update status display\nconst statusConfig = {\nidle: { icon: '||', label: 'IDLE', class: '' },\nfocusing: { icon: '>>', label: 'FOCUSING', class: 'focusing' },\npaused: { icon: '||', label: 'PAUSED', class: 'paused' },\nbreak: { icon: '..', label: 'ON BREAK', class: 'break' },\nwithered: { icon: 'X', label: 'PLANT WITHERED', class: 'withered' }\n};\nconst config = statusConfig[state.status] || statusConfig.idle;\nelements.statusLabel.textContent = config.label;\nelements.statusLabel.className = 'status-label ' + config.class;\nelements.currentTask.textContent = state.currentTask || 'Niciun task activ';\n// Update timer\nupdateTimerDisplay();\n// Enable/disable water button\nelements.btnWater.disabled = state.status !== 'idle' || state.plant.isWithered;\n// Only re-render tasks if status or current task changed (avoid flickering)\nif (prevStatus !== state.status || prevTask !== state.currentTask) {\nrenderTasks();\n// Refresh stats when transitioning to idle or break (session ended)\nif (state.status === 'idle' || state.status === 'break') {\nfetchWeeklyStats();\n}\n}\n}\nfunction updateTimerDisplay() {\nconst minutes = Math.floor(state.timeLeft / 60);\nconst seconds = state.timeLeft % 60;\nelements.timerValue.textContent =\n`${String(minutes).padStart(2, '0')}:${String(seconds).padStart(2, '0')}`;\n// Update progress bar\nif (state.totalTime > 0) {\nconst progress = ((state.totalTime - state.timeLeft) / state.totalTime) * 100;\nelements.timerBar.style.width = `${progress}%`;\n} else {\nelements.timerBar.style.width = '0%';\n}\n}\nfunction updatePlant(data) {\nif (data) {\nstate.plant.stage = data.stage !== undefined ? data.stage : state.plant.stage;\nstate.plant.isWithered = data.isWithered || false;\n// Update these from ESP32 data if available\nif (data.pendingWater !== undefined) state.pendingWater = data.pendingWater;\nif (data.wateredCount !== undefined) state.wateredCount = data.wateredCount;\nif (data.dailyGoal !== undefined) {\nstate.dailyGoal = data.dailyGoal;\nstate.goalLocked = data.dailyGoal > 0;\n}\nif (data.totalGoal !== undefined) state.currentSessionGoal = data.totalGoal;\n}\n// Calculează stadiul bazat pe task-uri completate vs obiectiv\nconst completedTasks = state.tasks.filter(t => t.completed).length;\nconst targetTasks = state.dailyGoal > 0 ? state.dailyGoal : state.tasks.length;\n// Folosește stage-ul din state (care e actualizat la water)\nconst displayStage = state.plant.isWithered ? 0 : state.plant.stage;\nconst stageInfo = PLANT_STAGES[displayStage] || PLANT_STAGES[0];\n// Update plant visual\nif (state.plant.isWithered) {\nelements.plantStage.textContent = '🥀';\nelements.plantStage.classList.add('withered');\nelements.plantStageText.textContent = 'Ofilita';\nelements.plantHealth.innerHTML = '<span class=\"health-icon\"></span><span class=\"health-text\" style=\"color: var(--danger);\">Ofilita</span>';\n} else {\n// Afișează emoji-ul stadiului\nelements.plantStage.textContent = stageInfo.emoji;\nelements.plantStage.classList.remove('withered');\nelements.plantStageText.textContent = stageInfo.name;\nelements.plantHealth.innerHTML = '<span class=\"health-icon\"></span><span class=\"health-text\">Sanatoasa</span>';\n}\n// Afișează progresul: (task-uri udate/confirmate / task-uri noi necesare)\nconst displayGoal = state.currentSessionGoal > 0 ? state.currentSessionGoal : state.tasks.length;\nif (state.tasks.length === 0) {\nelements.stageNumber.textContent = `(0/0)`;\n} else {\nelements.stageNumber.textContent = `(${state.wateredCount}/${displayGoal})`;\n}\n// Water button: activ doar dacă există task-uri completate care nu au fost încă udate\n// și planta nu e ofilită și nu suntem în focus mode\nconst canWater = state.pendingWater > 0 &&\n!state.plant.isWithered &&\nstate.status !== 'focusing' &&\nstate.plant.stage < 3;\nelements.btnWater.disabled = !canWater;\n// Actualizează hint-ul\nif (elements.waterHint) {\nconst totalTasks = state.tasks.length;\nconst goalSet = state.dailyGoal > 0;\nif (state.plant.stage >= 3 || (totalTasks > 0 && state.tasks.filter(t => t.completed).length >= totalTasks && state.pendingWater === 0)) {\nelements.waterHint.innerHTML = '<small>Planta a inflorit complet! Felicitari!</small>';\nelements.waterHint.className = 'water-hint complete';\n} else if (state.pendingWater > 0) {\nelements.waterHint.innerHTML = `<small>Poti uda planta! (${state.pendingWater} udari disponibile)</small>`;\nelements.waterHint.className = 'water-hint ready';\n} else if (totalTasks === 0) {\nelements.waterHint.innerHTML = '<small>Adauga task-uri pentru a incepe</small>';\nelements.waterHint.className = 'water-hint';\n} else if (!goalSet) {\nelements.waterHint.innerHTML = '<small>Seteaza obiectivul zilnic pentru a incepe</small>';\nelements.waterHint.className = 'water-hint';\n} else {\nelements.waterHint.innerHTML = '<small>Completeaza un task pentru a putea uda planta</small>';\nelements.waterHint.className = 'water-hint';\n}\n}\n// Actualizează afișarea obiectivului\nupdateGoalDisplay();\n}\n// Funcție pentru afișarea și gestionarea obiectivului zilnic\nfunction updateGoalDisplay() {\nif (!elements.goalDisplay) return;\nconst completedTasks = state.tasks.filter(t => t.completed).length;\nif (state.goalLocked && state.dailyGoal > 0) {\nelements.goalDisplay.innerHTML = `\n<div class=\"goal-info\">\n<span class=\"goal-target\">Obiectiv: ${completedTasks}/${state.dailyGoal} task-uri</span>\n<button class=\"btn btn-sm btn-secondary\" id=\"btnChangeGoal\">Modifica</button>\n</div>\n`;\nelements.goalSection.classList.add('locked');\n// Adaugă event listener pentru butonul de modificare\nconst btnChange = document.getElementById('btnChangeGoal');\nif (btnChange) {\nbtnChange.onclick = resetGoal;\n}\n} else {\nelements.goalDisplay.innerHTML = '';\nelements.goalSection.classList.remove('locked');\n}\n}\n// Setează obiectivul zilnic\nfunction setDailyGoal() {\nconst goalValue = parseInt(elements.dailyGoalInput.value) || 0;\nconsole.log('setDailyGoal called:', { goalValue, currentDailyGoal: state.dailyGoal, goalLocked: state.goalLocked });\nif (goalValue < 1) {\nshowToast('Introdu un obiectiv valid (minim 1 task)', 'error');\nreturn;\n}\nif (goalValue > 20) {\nshowToast('Obiectivul maxim este 20 de task-uri', 'error');\nreturn;\n}\n// Dacă există un goal anterior (și e locked sau nu), noul goal trebuie să fie strict mai mare\nif (state.dailyGoal > 0 && goalValue <= state.dailyGoal) {\nshowToast(`Noul obiectiv trebuie sa fie mai mare decat ${state.dailyGoal}!`, 'error');\nconsole.log('Validation failed: goalValue <= state.dailyGoal');\nreturn;\n}\n// Calculează câte task-uri NOI trebuie făcute\nconst previousGoal = state.dailyGoal;\nconst newTasksNeeded = previousGoal > 0 ? (goalValue - previousGoal) : goalValue;\nstate.dailyGoal = goalValue;\nstate.currentSessionGoal = newTasksNeeded; // Task-uri noi de făcut\nstate.goalLocked = true;\n// Resetează planta complet pentru noul obiectiv\nstate.plant.stage = 0;\nstate.pendingWater = 0;\nstate.wateredCount = 0;  // Reset complet\n// NU recalcula pendingWater - utilizatorul trebuie să completeze task-uri noi\nupdatePlant();\nshowToast(`Obiectiv setat: ${goalValue} task-uri! Planta a fost resetata.`, 'success');\nsendWebSocketMessage({\naction: 'setGoal',\ngoal: goalValue\n});\n}\n// Resetează obiectivul\nfunction resetGoal() {\nshowModal(\n'?',\n'Modifica Obiectivul',\n`Vrei sa modifici obiectivul zilnic? Noul obiectiv trebuie sa fie mai mare decat ${state.dailyGoal}. Planta va fi resetata.`,\n() => {\n// Salvează goal-ul vechi pentru validare\nconst oldGoal = state.dailyGoal;\nstate.goalLocked = false;\n// Nu reseta dailyGoal la 0, păstrează-l pentru validare\nif (elements.dailyGoalInput) {\n// Setează valoarea minimă la goal-ul curent + 1\nelements.dailyGoalInput.value = oldGoal + 1;\nelements.dailyGoalInput.min = oldGoal + 1;\n}\nupdatePlant();\nshowToast(`Seteaza un obiectiv mai mare decat ${oldGoal}!`, 'success');\n}\n);\n}\nfunction updateStats(data) {\nif (!data) return;\nstate.stats.completed = data.completed || 0;\nstate.stats.total = data.total || 0;\nstate.stats.focusMinutes = data.focusMinutes || 0;\nelements.tasksCompleted.textContent = state.stats.completed;\nelements.tasksTotal.textContent = state.stats.total;\nelements.focusTotal.textContent = state.stats.focusMinutes;\nconst percent = state.stats.total > 0\n? Math.round((state.stats.completed / state.stats.total) * 100)\n: 0;\nelements.progressPercent.textContent = `${percent}%`;\nelements.progressFill.style.width = `${percent}%`;\n}\n// ============================================\n// Task Management\n// ============================================\nfunction renderTasks() {\nconst container = elements.taskItems;\nif (state.tasks.length === 0) {\ncontainer.innerHTML = `\n<div class=\"empty-state\">\n<span class=\"empty-icon\">--</span>\n<span class=\"empty-text\">Niciun task adaugat</span>\n</div>\n`;\nelements.taskCount.textContent = '0 task-uri';\nreturn;\n}\ncontainer.innerHTML = state.tasks.map(task => {\nconst isSelected = state.selectedTaskId === task.id;\nconst isActive = task.active || (state.status === 'focusing' && state.currentTask === task.name);\n// Determine hint text based on state\nlet hintText = '';\nif (isSelected && !isActive) {\nhintText = '<div class=\"task-hint\">Flip the cube to start!</div>';\n} else if (isActive && state.status === 'focusing') {\nhintText = '<div class=\"task-hint active\">Flip back when done</div>';\n}\n// No hint for completed tasks or idle state\nreturn `\n<div class=\"task-item ${task.completed ? 'completed' : ''} ${isActive ? 'active' : ''} ${isSelected ? 'selected' : ''}\" data-id=\"${task.id}\">\n<div class=\"task-checkbox ${task.completed ? 'checked' : ''} ${!task.started ? 'disabled' : ''}\"\n${task.started ? `onclick=\"toggleTaskComplete(${task.id})\"` : `onclick=\"showToast('Trebuie sa pornesti task-ul inainte!', 'error')\"`}>\n</div>\n<div class=\"task-info\">\n<div class=\"task-name\">${escapeHtml(task.name)}</div>\n<div class=\"task-duration\">Focus: ${task.focusDuration}min / Pauza: ${task.breakDuration}min</div>\n${hintText}\n</div>\n<div class=\"task-actions\">\n${!task.completed && !isActive ? `\n${!isSelected ? `<button class=\"task-btn select\" onclick=\"selectTask(${task.id})\" title=\"Select\">&#10003;</button>` : ''}\n${isSelected ? `<button class=\"task-btn cancel\" onclick=\"cancelSelection()\" title=\"Cancel\">&#10007;</button>` : ''}\n<button class=\"task-btn delete\" onclick=\"deleteTask(${task.id})\" title=\"Delete\">&#10005;</button>\n` : ''}\n</div>\n</div>\n`}).join('');\nelements.taskCount.textContent = `${state.tasks.length} task-uri`;\nupdateStats({\ncompleted: state.tasks.filter(t => t.completed).length,\ntotal: state.tasks.length,\nfocusMinutes: state.stats.focusMinutes\n});\n}\nfunction addTask() {\nconst name = elements.taskName.value.trim();\nconst focusDuration = parseInt(elements.focusTime.value) || 25;\nconst breakDuration = parseInt(elements.breakTime.value) || 5;\nif (!name) {\nshowToast('Introdu un nume pentru task!', 'error');\nelements.taskName.focus();\nreturn;\n}\n// Verifică dacă s-a atins limita de task-uri\nif (state.goalLocked && state.tasks.length >= state.dailyGoal) {\nshowToast('Ai atins limita de task-uri pentru obiectivul zilnic!', 'error');\nreturn;\n}\nconst newTask = {\nid: Date.now(),\nname: name,\nfocusDuration: focusDuration,\nbreakDuration: breakDuration,\ncompleted: false,\nactive: false,\nstarted: false  // Flag pentru a ști dacă task-ul a fost pornit\n};\n// Send to ESP32\nsendWebSocketMessage({\naction: 'addTask',\ntask: newTask\n});\n// Update local state\nstate.tasks.push(newTask);\nrenderTasks();\n// Actualizează afișarea plantei (pentru a reflecta noul total de task-uri)\nupdatePlant();\n// Clear form\nelements.taskName.value = '';\nelements.taskName.focus();\nshowToast('Task adăugat!', 'success');\n}\nfunction startTask(id) {\nconst task = state.tasks.find(t => t.id === id);\nif (!task) return;\nsendWebSocketMessage({\naction: 'startTask',\ntaskId: id\n});\n// Update local state\nstate.tasks.forEach(t => t.active = false);\ntask.active = true;\ntask.started = true;  // Marchează ca pornit\nstate.status = 'focusing';\nstate.currentTask = task.name;\nstate.timeLeft = task.focusDuration * 60;\nstate.totalTime = task.focusDuration * 60;\nstate.selectedTaskId = 0;  // Clear selection\nupdateStatus({\nstate: 'focusing',\ntaskName: task.name,\ntimeLeft: state.timeLeft,\ntotalTime: state.totalTime\n});\nrenderTasks();\nshowToast(`Incepi: ${task.name}`, 'success');\n}\n// Selectează un task pentru a fi pornit cu flip MPU\nfunction selectTask(id) {\nconst task = state.tasks.find(t => t.id === id);\nif (!task) return;\nif (task.completed) {\nshowToast('Task-ul e deja completat!', 'error');\nreturn;\n}\nif (state.status === 'focusing') {\nshowToast('Oprește mai întâi task-ul curent!', 'error');\nreturn;\n}\nsendWebSocketMessage({\naction: 'selectTask',\ntaskId: id\n});\n// Update local state\nstate.selectedTaskId = id;\ntask.started = true;\nrenderTasks();\nshowToast(`Task \"${task.name}\" selectat. Întoarce cubul pentru a începe!`, 'success');\n}\n// Anulează selecția task-ului\nfunction cancelSelection() {\nstate.selectedTaskId = 0;\nrenderTasks();\nshowToast('Selecție anulată', 'info');\n}\nfunction toggleTaskComplete(id) {\nconst task = state.tasks.find(t => t.id === id);\nif (!task) return;\n// Nu poți bifa un task dacă nu a fost pornit\nif (!task.started) {\nshowToast('Trebuie sa pornesti task-ul inainte sa il completezi!', 'error');\nreturn;\n}\nconst wasCompleted = task.completed;\nconst wasActive = task.active;\ntask.completed = !task.completed;\n// Calculează timpul efectiv petrecut (dacă task-ul era activ)\nlet actualMinutesSpent = 0;\nif (task.completed && wasActive) {\n// Timpul petrecut = totalTime - timeLeft (în secunde), convertit în minute\nconst secondsSpent = state.totalTime - state.timeLeft;\nactualMinutesSpent = Math.ceil(secondsSpent / 60); // Rotunjește în sus\ntask.active = false;\nstate.status = 'idle';\nstate.timeLeft = 0;\nstate.totalTime = 0;\nstate.currentTask = null;\nupdateStatus({ state: 'idle', taskName: '' });\n} else if (task.completed && !wasActive) {\n// Dacă task-ul nu era activ dar e completat, folosește timpul setat\nactualMinutesSpent = task.focusDuration;\n}\nsendWebSocketMessage({\naction: 'toggleTask',\ntaskId: id,\ncompleted: task.completed\n});\n// Actualizează pendingWater\nif (task.completed && !wasCompleted) {\n// Task nou completat - adaugă o \"udare\" disponibilă\nstate.pendingWater++;\nstate.stats.focusMinutes += actualMinutesSpent;\nshowToast('Task completat! Poti uda planta!', 'success');\n} else if (!task.completed && wasCompleted) {\n// Task debifat - scade pendingWater dacă e posibil\nstate.pendingWater = Math.max(0, state.pendingWater - 1);\n// Scade și minutele (folosește focusDuration ca estimare)\nstate.stats.focusMinutes = Math.max(0, state.stats.focusMinutes - task.focusDuration);\n}\nrenderTasks();\nupdatePlant();\n}\nfunction deleteTask(id) {\nshowModal(\n'X',\n'Sterge Task',\n'Esti sigur ca vrei sa stergi acest task?',\n() => {\nconst task = state.tasks.find(t => t.id === id);\n// Dacă task-ul era activ (countdown în desfășurare), resetează timer-ul\nif (task && task.active) {\nstate.status = 'idle';\nstate.timeLeft = 0;\nstate.totalTime = 0;\nstate.currentTask = null;\nupdateStatus({ state: 'idle', taskName: '' });\n}\n// Dacă task-ul era completat, scade pendingWater\nif (task && task.completed && state.pendingWater > 0) {\nstate.pendingWater--;\n}\nstate.tasks = state.tasks.filter(t => t.id !== id);\nsendWebSocketMessage({\naction: 'deleteTask',\ntaskId: id\n});\nrenderTasks();\nupdatePlant();  // Actualizează afișarea plantei\nshowToast('Task sters', 'success');\n}\n);\n}\n// ============================================\n// Plant Actions\n// ============================================\nfunction waterPlant() {\nif (state.plant.isWithered) {\nshowToast('Planta este ofilită! Folosește lumina pentru a o reînvia.', 'error');\nreturn;\n}\nif (!state.goalLocked || state.dailyGoal <= 0) {\nshowToast('Setează mai întâi obiectivul zilnic!', 'error');\nreturn;\n}\nif (state.pendingWater <= 0) {\nshowToast('Completează un task pentru a putea uda planta!', 'error');\nreturn;\n}\nif (state.plant.stage >= 3) {\nshowToast('Planta a crescut complet! 🌸', 'success');\nreturn;\n}\nsendWebSocketMessage({ action: 'water' });\n// Folosește currentSessionGoal dacă există, altfel totalTasks\nconst goalsToComplete = state.currentSessionGoal > 0 ? state.currentSessionGoal : state.tasks.length;\n// Consumă o \"udare\" și incrementează wateredCount\nstate.pendingWater--;\nstate.wateredCount++;\n// Stadiile sunt FIX 4: 0 (Semință), 1 (Lăstar), 2 (Creștere), 3 (Înflorit)\n// Logica bazată pe wateredCount (task-uri confirmate prin udare):\n// - 0 udate = Sămânță (0)\n// - 1 udată = Lăstar (1)\n// - 2+ udate, dar NU toate = Creștere (2)\n// - TOATE udate = Înflorit (3)\nlet targetStage;\nif (state.wateredCount >= goalsToComplete) {\ntargetStage = 3; // Toate udate = Înflorit\n} else if (state.wateredCount >= 2) {\ntargetStage = 2; // 2+ dar nu toate = Creștere\n} else if (state.wateredCount >= 1) {\ntargetStage = 1; // 1 udată = Lăstar\n} else {\ntargetStage = 0; // Nimic udat = Sămânță\n}\nconst oldStage = state.plant.stage;\nstate.plant.stage = targetStage;\nconst stageInfo = PLANT_STAGES[state.plant.stage];\nupdatePlant();\nif (state.plant.stage >= 3) {\nshowToast('Planta a inflorit complet! Felicitari!', 'success');\n} else if (state.plant.stage > oldStage) {\nshowToast(`Planta a crescut! Acum e ${stageInfo.name}!`, 'success');\n} else {\nshowToast(`Planta a fost udata! Mai completeaza task-uri pentru a creste!`, 'success');\n}\n// Trigger heart animation\ntriggerHeartAnimation();\n}\nfunction killPlant() {\nshowModal(\n'X',\n'Demo Mode',\n'Aceasta va omori planta pentru demonstratie. Poti sa o reinvii cu senzorul de lumina.',\n() => {\nsendWebSocketMessage({ action: 'kill' });\nstate.plant.isWithered = true;\nupdatePlant({ stage: state.plant.stage, isWithered: true });\nupdateStatus({ state: 'withered', taskName: 'Planta a murit!' });\nshowToast('Planta a fost ofilita', 'error');\n}\n);\n}\nfunction triggerHeartAnimation() {\n// Visual feedback for water animation\nconst heart = document.createElement('div');\nheart.innerHTML = '+';\nheart.style.cssText = `\nposition: fixed;\ntop: 50%;\nleft: 50%;\nfont-size: 4rem;\ncolor: var(--primary);\nfont-weight: bold;\ntransform: translate(-50%, -50%) scale(0);\nanimation: heartPop 0.6s ease forwards;\nz-index: 1000;\npointer-events: none;\n`;\ndocument.body.appendChild(heart);\nsetTimeout(() => heart.remove(), 600);\n}\nfunction showReviveAnimation() {\n// Special animation for plant revival\nconst reviveOverlay = document.createElement('div');\nreviveOverlay.style.cssText = `\nposition: fixed;\ntop: 0;\nleft: 0;\nwidth: 100%;\nheight: 100%;\nbackground: rgba(0,0,0,0.9);\ndisplay: flex;\nflex-direction: column;\nalign-items: center;\njustify-content: center;\nz-index: 2000;\nanimation: fadeIn 0.5s ease;\n`;\nreviveOverlay.innerHTML = `\n<div style=\"font-size: 6rem; animation: bounce 1s ease infinite; text-shadow: 0 0 30px rgba(46,204,113,0.8);\">🌱</div>\n<div style=\"color: #2ecc71; font-size: 2rem; font-weight: bold; margin-top: 1.5rem; text-align: center; text-shadow: 0 2px 10px rgba(0,0,0,0.5);\">\nPlant Revived!\n</div>\n<div style=\"color: white; font-size: 1.2rem; margin-top: 0.8rem; text-align: center; padding: 0 2rem;\">\nYou can plant again and start a new journey!\n</div>\n`;\ndocument.body.appendChild(reviveOverlay);\n// Refresh plant display\nstate.plant.stage = 0;\nstate.plant.isWithered = false;\nupdatePlant();\n// Remove after 3 seconds\nsetTimeout(() => {\nreviveOverlay.style.animation = 'fadeOut 0.5s ease forwards';\nsetTimeout(() => reviveOverlay.remove(), 500);\n}, 3000);\n}\n// Add heart animation keyframes\nconst style = document.createElement('style');\nstyle.textContent = `\n@keyframes heartPop {\n0% { transform: translate(-50%, -50%) scale(0); opacity: 1; }\n50% { transform: translate(-50%, -50%) scale(1.5); opacity: 1; }\n100% { transform: translate(-50%, -50%) scale(1); opacity: 0; }\n}\n@keyframes fadeIn {\nfrom { opacity: 0; }\nto { opacity: 1; }\n}\n@keyframes fadeOut {\nfrom { opacity: 1; }\nto { opacity: 0; }\n}\n@keyframes bounce {\n0%, 100% { transform: translateY(0); }\n50% { transform: translateY(-20px); }\n}\n`;\ndocument.head.appendChild(style);\n// ============================================\n// UI Helpers\n// ============================================\nfunction showToast(message, type = 'success') {\nelements.toastIcon.textContent = type === 'success' ? '+' : '!';\nelements.toastMessage.textContent = message;\nelements.toast.className = `toast ${type} show`;\nsetTimeout(() => {\nelements.toast.classList.remove('show');\n}, 3000);\n}\nfunction showModal(icon, title, message, onConfirm) {\nelements.modalIcon.textContent = icon;\nelements.modalTitle.textContent = title;\nelements.modalMessage.textContent = message;\nelements.modalOverlay.classList.add('show');\n// Set up confirm handler\nelements.modalConfirm.onclick = () => {\nhideModal();\nif (onConfirm) onConfirm();\n};\n}\nfunction hideModal() {\nelements.modalOverlay.classList.remove('show');\nstate.showingConfirmModal = false;\n// Reset modal buttons\nelements.modalConfirm.style.display = '';\nelements.modalCancel.style.display = '';\nelements.modalConfirm.textContent = 'Confirma';\nelements.modalCancel.textContent = 'Anuleaza';\n}\n// Special modal for flip confirmation\nfunction showFlipConfirmModal() {\nstate.showingConfirmModal = true;\nstate.flipCancelledWaitingFlipBack = false;\nelements.modalIcon.textContent = '?';\nelements.modalTitle.textContent = 'Task Complete?';\nelements.modalMessage.textContent = 'Did you finish the task, or was the flip accidental?';\nelements.modalConfirm.textContent = 'Yes, I finished!';\nelements.modalCancel.textContent = 'Accidental flip';\nelements.modalConfirm.style.display = 'inline-block';\nelements.modalCancel.style.display = 'inline-block';\nelements.modalOverlay.classList.add('show');\n// Confirm = task completed\nelements.modalConfirm.onclick = () => {\nhideModal();\nsendWebSocketMessage({ action: 'confirmComplete' });\nshowToast('Congratulations! Task completed!', 'success');\nstate.selectedTaskId = 0;\nrenderTasks();\n};\n// Cancel = accidental flip, need to flip back\nelements.modalCancel.onclick = () => {\nstate.flipCancelledWaitingFlipBack = true;\nelements.modalIcon.textContent = '↻';\nelements.modalTitle.textContent = 'Flip back to resume';\nelements.modalMessage.textContent = 'Flip the cube face-down to continue your focus session.';\nelements.modalConfirm.style.display = 'none';\nelements.modalCancel.style.display = 'none';\nsendWebSocketMessage({ action: 'cancelComplete' });\n};\n}\nfunction escapeHtml(text) {\nconst div = document.createElement('div');\ndiv.textContent = text;\nreturn div.innerHTML;\n}\nfunction updateClock() {\nconst now = new Date();\nconst hours = String(now.getHours()).padStart(2, '0');\nconst minutes = String(now.getMinutes()).padStart(2, '0');\nelements.currentTime.textContent = `${hours}:${minutes}`;\n}\n// ============================================\n// Timer Logic (local countdown for smooth UI)\n// Only runs when WebSocket is disconnected\n// ============================================\nfunction startLocalTimer() {\nsetInterval(() => {\n// Only run local timer if WebSocket is NOT connected\n// When connected, ESP32 sends updates and we use those\nif (!state.wsConnected && state.timeLeft > 0 && (state.status === 'focusing' || state.status === 'break')) {\nstate.timeLeft--;\nupdateTimerDisplay();\nif (state.timeLeft === 0) {\nhandleTimerComplete();\n}\n}\n}, 1000);\n}\nfunction handleTimerComplete() {\nif (state.status === 'focusing') {\n// Găsește task-ul activ pentru a lua durata de pauză\nconst activeTask = state.tasks.find(t => t.active);\nconst breakDuration = activeTask ? activeTask.breakDuration : 5;\nshowToast('Focus terminat! Ia o pauza!', 'success');\n// Treci la starea de break cu countdown\nstate.status = 'break';\nstate.timeLeft = breakDuration * 60;\nstate.totalTime = breakDuration * 60;\nupdateStatus({\nstate: 'break',\ntaskName: 'Pauza',\ntimeLeft: state.timeLeft,\ntotalTime: state.totalTime\n});\n} else if (state.status === 'break') {\n// Pauza terminată - reîncepe ciclul de focus\nconst activeTask = state.tasks.find(t => t.active);\nif (activeTask) {\n// Continuă cu focus pentru același task\nstate.status = 'focusing';\nstate.timeLeft = activeTask.focusDuration * 60;\nstate.totalTime = activeTask.focusDuration * 60;\nstate.currentTask = activeTask.name;\nupdateStatus({\nstate: 'focusing',\ntaskName: activeTask.name,\ntimeLeft: state.timeLeft,\ntotalTime: state.totalTime\n});\nshowToast('Pauza terminata! Continua cu focus!', 'success');\n} else {\n// Dacă nu mai există task activ, revino la idle\nstate.status = 'idle';\nstate.timeLeft = 0;\nstate.currentTask = null;\nupdateStatus({ state: 'idle', taskName: '' });\nrenderTasks();\n}\n}\n}\n// ============================================\n// Weekly Statistics\n// ============================================\nasync function fetchWeeklyStats() {\nif (isDevMode()) {\nupdateWeeklyStats({\nweekly: { totalTasks: 0, totalFocus: 0, avgTasksPerDay: 0, mostProductiveDayName: '-' },\ndays: []\n});\nreturn;\n}\ntry {\nconst response = await fetch(`${CONFIG.API_BASE}/api/stats`);\nconst data = await response.json();\nupdateWeeklyStats(data);\n} catch (e) {\nconsole.error('Failed to fetch weekly stats:', e);\n}\n}\nfunction updateWeeklyStats(data) {\nif (!data) return;\n// Update TODAY's stats from Analytics (accurate from ESP32)\nif (data.todayTasks !== undefined || data.todayFocus !== undefined) {\nstate.stats.completed = data.todayTasks || 0;\nstate.stats.focusMinutes = data.todayFocus || 0;\n// Update the display\nelements.tasksCompleted.textContent = state.stats.completed;\nelements.focusTotal.textContent = state.stats.focusMinutes;\n// Update progress bar based on tasks\nconst total = state.tasks.length || state.stats.total || 1;\nconst percent = Math.round((state.stats.completed / total) * 100);\nelements.progressPercent.textContent = `${percent}%`;\nelements.progressFill.style.width = `${percent}%`;\n}\nif (!data.weekly) return;\nconst weekly = data.weekly;\n// Update weekly summary numbers\nif (elements.weeklyTasks) elements.weeklyTasks.textContent = weekly.totalTasks || 0;\nif (elements.weeklyFocus) elements.weeklyFocus.textContent = weekly.totalFocus || 0;\nif (elements.weeklyAvg) elements.weeklyAvg.textContent = (weekly.avgTasksPerDay || 0).toFixed(1);\nif (elements.bestDay) elements.bestDay.textContent = weekly.mostProductiveDayName || '-';\n// Render weekly chart\nif (elements.weeklyChart && data.days) {\nrenderWeeklyChart(data.days);\n}\n}\nfunction renderWeeklyChart(days) {\nif (!elements.weeklyChart) return;\nconst dayNames = ['Dum', 'Lun', 'Mar', 'Mie', 'Joi', 'Vin', 'Sam'];\nconst today = new Date().getDay();\n// Find max value for scaling\nconst maxTasks = Math.max(...days.map(d => d.tasks || 0), 1);\nlet html = '';\nfor (let i = 6; i >= 0; i--) {\nconst dayData = days.find(d => d.daysAgo === i) || { tasks: 0, focus: 0, valid: false };\nconst height = dayData.valid ? Math.max((dayData.tasks / maxTasks) * 100, 8) : 8;\nconst dayIndex = (today - i + 7) % 7;\nconst isToday = i === 0;\nhtml += `<div class=\"chart-bar ${isToday ? 'today' : ''} ${dayData.valid ? 'has-data' : ''}\"\nstyle=\"height: ${height}%\"\ndata-day=\"${dayNames[dayIndex]}\"\nonclick=\"showDayDetails(${i}, ${dayData.tasks || 0}, ${dayData.focus || 0}, '${dayNames[dayIndex]}')\"\ntitle=\"${dayData.tasks || 0} task-uri, ${dayData.focus || 0} min focus\"></div>`;\n}\nelements.weeklyChart.innerHTML = html;\n}\nfunction showDayDetails(daysAgo, tasks, focus, dayName) {\nconst label = daysAgo === 0 ? 'Azi' : (daysAgo === 1 ? 'Ieri' : dayName);\nconst hours = Math.floor(focus / 60);\nconst mins = focus % 60;\nconst focusStr = hours > 0 ? `${hours}h ${mins}m` : `${mins} min`;\nshowToast(`${label}: ${tasks} task-uri, ${focusStr} focus`, 'success');\n}\n// ============================================\n// Sync Time from Phone\n// ============================================\nfunction syncTimeFromPhone() {\nconst now = new Date();\nconst hours = now.getHours();\nconst minutes = now.getMinutes();\nconst seconds = now.getSeconds();\nconst day = now.getDate();\nconst month = now.getMonth() + 1; // 0-indexed\nconst year = now.getFullYear();\nsendWebSocketMessage({\naction: 'setTime',\nhours: hours,\nminutes: minutes,\nseconds: seconds,\nday: day,\nmonth: month,\nyear: year\n});\nshowToast(`Ora sincronizata: ${String(hours).padStart(2, '0')}:${String(minutes).padStart(2, '0')}`, 'success');\n}\n// ============================================\n// Reset Day\n// ============================================\nfunction resetDay() {\nshowModal(\n'⚠️',\n'Resetare Zi',\n'Aceasta va reseta toate task-urile si planta pentru o zi noua. Esti sigur?',\n() => {\nsendWebSocketMessage({ action: 'restartDay' });\n// Reset local state\nstate.tasks = [];\nstate.plant.stage = 0;\nstate.pendingWater = 0;\nstate.wateredCount = 0;\nstate.dailyGoal = 0;\nstate.goalLocked = false;\nstate.status = 'idle';\nstate.timeLeft = 0;\nrenderTasks();\nupdatePlant();\nupdateStatus({ state: 'idle', taskName: '' });\nshowToast('Zi resetata! Incepe o zi noua!', 'success');\n}\n);\n}\n// ============================================\n// Mock Data (pentru dezvoltare fără ESP32)\n// ============================================\nfunction loadMockData() {\n// Start fresh - no predefined tasks\nstate.tasks = [];\nstate.plant.stage = 0;\nstate.plant.isWithered = false;\nstate.pendingWater = 0;\nstate.wateredCount = 0;\nstate.dailyGoal = 0;\nstate.currentSessionGoal = 0;\nstate.goalLocked = false;\nstate.status = 'idle';\nstate.timeLeft = 0;\nstate.totalTime = 0;\nstate.currentTask = null;\nstate.stats = {\ncompleted: 0,\ntotal: 0,\nfocusMinutes: 0\n};\n// Set default goal value in input\nif (elements.dailyGoalInput) {\nelements.dailyGoalInput.value = 3;\n}\n// Dezactivează explicit butonul de udare\nif (elements.btnWater) {\nelements.btnWater.disabled = true;\n}\nrenderTasks();\nupdatePlant();\nupdateStats(state.stats);\nupdateStatus({ state: 'idle', taskName: null, timeLeft: 0, totalTime: 0 });\nelements.espIP.textContent = 'Dev Mode';\n}\nfunction handleMockAction(action) {\nconsole.log('Mock action:', action);\n// Simulate responses locally\nreturn { success: true };\n}\n// ============================================\n// Event Listeners\n// ============================================\nfunction initEventListeners() {\n// Add task\nelements.btnAddTask.addEventListener('click', addTask);\nelements.taskName.addEventListener('keypress', (e) => {\nif (e.key === 'Enter') addTask();\n});\n// Daily goal\nif (elements.btnSetGoal) {\nelements.btnSetGoal.addEventListener('click', setDailyGoal);\n}\nif (elements.dailyGoalInput) {\nelements.dailyGoalInput.addEventListener('keypress', (e) => {\nif (e.key === 'Enter') setDailyGoal();\n});\n}\n// Plant actions\nelements.btnWater.addEventListener('click', waterPlant);\nelements.btnKill.addEventListener('click', killPlant);\n// Sync time button\nif (elements.btnSyncTime) {\nelements.btnSyncTime.addEventListener('click', syncTimeFromPhone);\n}\n// Reset day button\nif (elements.btnResetDay) {\nelements.btnResetDay.addEventListener('click', resetDay);\n}\n// Modal - only allow closing by clicking overlay if NOT waiting for flip back\n// Note: modalCancel behavior is set dynamically in showModal/showFlipConfirmModal\nelements.modalOverlay.addEventListener('click', (e) => {\n// Only close if clicking directly on overlay AND not waiting for flip back\nif (e.target === elements.modalOverlay && !state.flipCancelledWaitingFlipBack) {\nhideModal();\n}\n});\n// Prevent zoom on double-tap (mobile)\ndocument.addEventListener('touchend', (e) => {\nconst now = Date.now();\nif (now - (window.lastTouchEnd || 0) < 300) {\ne.preventDefault();\n}\nwindow.lastTouchEnd = now;\n}, false);\n}\n// ============================================\n// Initialization\n// ============================================\nfunction init() {\nconsole.log('🌱 Productivity Bloom initializing...');\n// Initialize event listeners\ninitEventListeners();\n// Start clock update\nupdateClock();\nsetInterval(updateClock, 1000);\n// Try WebSocket first\nconnectWebSocket();\n// Start local timer (only runs when WebSocket disconnected)\nstartLocalTimer();\n// Initial data fetch - do this immediately!\nconsole.log('Fetching initial status...');\nfetchStatus();\nfetchTasks();\nfetchWeeklyStats();\n// Refresh weekly stats every 30 seconds\nsetInterval(fetchWeeklyStats, 30000);\n// API polling only when WebSocket is not connected\n// Reduces load when already getting updates via WebSocket\nsetInterval(() => {\nif (!state.wsConnected) {\nfetchStatus();\nconsole.log('Polling for status (WS disconnected)...');\n}\n}, 2000);  // Poll every 2 seconds instead of 1\nconsole.log('🌱 Productivity Bloom ready!');\n}\n// Start app when DOM is ready\nif (document.readyState === 'loading') {\ndocument.addEventListener('DOMContentLoaded', init);\n} else {\ninit();\n}</script>\n</body>\n</html>\n";
+#define WEB_CONTENT_VERSION "a630a33ed355"
+
+const char INDEX_HTML[] PROGMEM = "<!DOCTYPE html>\n<html lang=\"ro\">\n<head>\n<meta charset=\"UTF-8\">\n<meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0, maximum-scale=1.0, user-scalable=no\">\n<title>Productivity Bloom</title>\n<meta name=\"theme-color\" content=\"#2ecc71\">\n<link rel=\"manifest\" href=\"/manifest.json\">\n<link rel=\"icon\" href=\"/icon.svg\" type=\"image/svg+xml\">\n<style>:root{--primary:#2ecc71;--primary-dark:#27ae60;--primary-light:#a8e6cf;--secondary:#3498db;--secondary-dark:#2980b9;--danger:#e74c3c;--danger-dark:#c0392b;--warning:#f39c12;--warning-dark:#d68910;--bg-dark:#1a1a2e;--bg-card:#16213e;--bg-input:#0f3460;--text-primary:#ffffff;--text-secondary:#b8c5d6;--text-muted:#6c7a89;--border-color:#2d4a6f;--shadow:0 4px 15px rgba(0,0,0,0.3);--spacing-xs:0.25rem;--spacing-sm:0.5rem;--spacing-md:1rem;--spacing-lg:1.5rem;--spacing-xl:2rem;--radius-sm:8px;--radius-md:12px;--radius-lg:16px;--radius-full:50%;--transition:all 0.3s ease}*{margin:0;padding:0;box-sizing:border-box}html{font-size:16px}body{font-family:-apple-system,BlinkMacSystemFont,'Segoe UI',Roboto,Oxygen,Ubuntu,sans-serif;background:var(--bg-dark);color:var(--text-primary);min-height:100vh;line-height:1.5;-webkit-font-smoothing:antialiased}.app-container{max-width:480px;margin:0 auto;padding:var(--spacing-md);padding-bottom:calc(var(--spacing-xl) + 60px)}.header{display:flex;justify-content:space-between;align-items:center;padding:var(--spacing-md) 0;margin-bottom:var(--spacing-md)}.logo{display:flex;align-items:center;gap:var(--spacing-sm)}.logo-icon{font-size:1.2rem;font-weight:700;color:var(--primary);background:var(--bg-input);padding:0.3rem 0.5rem;border-radius:var(--radius-sm)}.logo h1{font-size:1.2rem;font-weight:600;background:linear-gradient(135deg,var(--primary),var(--secondary));-webkit-background-clip:text;-webkit-text-fill-color:transparent;background-clip:text}.connection-status{display:flex;align-items:center;gap:var(--spacing-xs);font-size:0.75rem;color:var(--text-muted)}.status-dot{width:8px;height:8px;border-radius:var(--radius-full);background:var(--warning);animation:blink 1s infinite}.status-dot.connected{background:var(--primary);animation:none}.status-dot.disconnected{background:var(--danger)}@keyframes blink{0%,100%{opacity:1;}50%{opacity:0.3;}}.card{background:var(--bg-card);border-radius:var(--radius-lg);padding:var(--spacing-lg);margin-bottom:var(--spacing-md);box-shadow:var(--shadow);border:1px solid var(--border-color)}.card h2{font-size:1rem;font-weight:600;margin-bottom:var(--spacing-md);color:var(--text-primary)}.status-card{background:linear-gradient(135deg,var(--bg-card) 0%,rgba(46,204,113,0.1) 100%)}.status-display{display:flex;align-items:center;justify-content:center;gap:var(--spacing-md);margin-bottom:var(--spacing-md)}.status-info{display:flex;flex-direction:column}.status-info.centered{align-items:center;text-align:center}.status-label{font-size:0.75rem;font-weight:700;letter-spacing:1px;color:var(--primary);text-transform:uppercase}.status-label.focusing{color:var(--danger)}.status-label.break{color:var(--secondary)}.status-label.withered{color:var(--warning)}.current-task{font-size:1.1rem;font-weight:500;color:var(--text-secondary)}.timer-display{text-align:center}.timer-value{font-size:3rem;font-weight:700;font-family:'Courier New',monospace;letter-spacing:2px}.timer-progress{height:6px;background:var(--bg-input);border-radius:var(--radius-sm);margin-top:var(--spacing-sm);overflow:hidden}.timer-bar{height:100%;background:linear-gradient(90deg,var(--primary),var(--secondary));border-radius:var(--radius-sm);width:0%;transition:width 1s linear}.plant-card{text-align:center}.plant-display{display:flex;flex-direction:column;align-items:center;margin-bottom:var(--spacing-lg)}.plant-visual{position:relative;margin-bottom:var(--spacing-md)}.plant-stage{font-size:4rem;animation:sway 3s ease-in-out infinite;transition:var(--transition)}.plant-stage.withered{filter:grayscale(100%);animation:shake 0.5s ease-in-out}.plant-pot{font-size:2rem;margin-top:-10px}@keyframes sway{0%,100%{transform:rotate(-3deg);}50%{transform:rotate(3deg);}}@keyframes shake{0%,100%{transform:translateX(0);}25%{transform:translateX(-5px);}75%{transform:translateX(5px);}}.plant-pot{font-size:2rem;margin-top:-10px}.plant-info{display:flex;flex-direction:column;gap:var(--spacing-xs)}.plant-stage-text{color:var(--text-secondary);font-size:0.9rem}.stage-number{color:var(--primary);font-weight:600}.plant-health{display:flex;align-items:center;justify-content:center;gap:var(--spacing-xs);font-size:0.85rem}.plant-health.withered .health-icon{content:'💔'}.plant-health.withered .health-text{color:var(--danger)}.water-hint{margin-top:var(--spacing-sm);font-size:0.75rem;color:var(--text-muted);font-style:italic;transition:var(--transition)}.water-hint.ready{color:var(--secondary);font-style:normal;font-weight:500}.water-hint.complete{color:var(--primary)}.plant-actions{display:flex;gap:var(--spacing-md)}.btn{display:flex;align-items:center;justify-content:center;gap:var(--spacing-sm);padding:var(--spacing-sm) var(--spacing-lg);border:none;border-radius:var(--radius-md);font-size:0.9rem;font-weight:600;cursor:pointer;transition:var(--transition);flex:1}.btn:active{transform:scale(0.96)}.btn:disabled{opacity:0.4;cursor:not-allowed;transform:none;background:var(--bg-input) !important;color:var(--text-muted) !important;box-shadow:none !important;pointer-events:none}.btn-icon{font-size:1.1rem}.btn-primary{background:linear-gradient(135deg,var(--primary),var(--primary-dark));color:white}.btn-primary:hover:not(:disabled){box-shadow:0 4px 15px rgba(46,204,113,0.4)}.btn-secondary{background:var(--bg-input);color:var(--text-secondary);border:1px solid var(--border-color)}.btn-water{background:linear-gradient(135deg,var(--secondary),var(--secondary-dark));color:white}.btn-water:hover:not(:disabled){box-shadow:0 4px 15px rgba(52,152,219,0.4)}.btn-danger{background:linear-gradient(135deg,var(--danger),var(--danger-dark));color:white}.btn-danger:hover:not(:disabled){box-shadow:0 4px 15px rgba(231,76,60,0.4)}.btn-success{background:linear-gradient(135deg,var(--primary),var(--primary-dark));color:white}.btn-full{width:100%}.btn-sm{padding:var(--spacing-xs) var(--spacing-sm);font-size:0.8rem}.goal-section{background:var(--bg-input);padding:var(--spacing-md);border-radius:var(--radius-md);margin-bottom:var(--spacing-md);border:2px dashed var(--border-color);transition:var(--transition)}.goal-section.locked{border-style:solid;border-color:var(--primary);background:rgba(46,204,113,0.1)}.goal-setter{display:flex;flex-direction:column;gap:var(--spacing-sm)}.goal-section.locked .goal-setter{display:none}.goal-setter label{font-size:0.9rem;font-weight:500;color:var(--text-secondary)}.goal-input-row{display:flex;gap:var(--spacing-sm)}.goal-input-row input{flex:1;padding:var(--spacing-sm) var(--spacing-md);background:var(--bg-card);border:1px solid var(--border-color);border-radius:var(--radius-sm);color:var(--text-primary);font-size:1rem;text-align:center}.goal-input-row input:focus{outline:none;border-color:var(--primary)}.goal-display{margin-top:var(--spacing-sm)}.goal-info{display:flex;justify-content:space-between;align-items:center}.goal-target{font-weight:600;color:var(--primary)}.task-form{background:var(--bg-input);padding:var(--spacing-md);border-radius:var(--radius-md);margin-bottom:var(--spacing-lg)}.form-group{margin-bottom:var(--spacing-md)}.form-group:last-of-type{margin-bottom:var(--spacing-md)}.form-group label{display:block;font-size:0.8rem;color:var(--text-muted);margin-bottom:var(--spacing-xs)}.form-group input{width:100%;padding:var(--spacing-sm) var(--spacing-md);background:var(--bg-card);border:1px solid var(--border-color);border-radius:var(--radius-sm);color:var(--text-primary);font-size:1rem;transition:var(--transition)}.form-group input:focus{outline:none;border-color:var(--primary);box-shadow:0 0 0 3px rgba(46,204,113,0.2)}.form-group input::placeholder{color:var(--text-muted)}.form-row{display:flex;gap:var(--spacing-md)}.form-row .form-group{flex:1}.task-list-header{display:flex;justify-content:space-between;align-items:center;padding-bottom:var(--spacing-sm);border-bottom:1px solid var(--border-color);margin-bottom:var(--spacing-md);font-size:0.85rem;color:var(--text-muted)}.task-count{color:var(--primary);font-weight:600}.task-items{max-height:300px;overflow-y:auto}.empty-state{display:flex;flex-direction:column;align-items:center;padding:var(--spacing-xl);color:var(--text-muted)}.empty-icon{font-size:2rem;margin-bottom:var(--spacing-sm);opacity:0.5}.task-item{display:flex;align-items:center;gap:var(--spacing-sm);padding:var(--spacing-md);background:var(--bg-input);border-radius:var(--radius-md);margin-bottom:var(--spacing-sm);transition:var(--transition);animation:slideIn 0.3s ease}@keyframes slideIn{from{opacity:0;transform:translateY(-10px);}to{opacity:1;transform:translateY(0);}}.task-item.completed{opacity:0.6;background:rgba(46,204,113,0.1)}.task-item.active{border:2px solid var(--primary);background:rgba(46,204,113,0.1)}.task-item.selected{border:2px solid var(--warning);background:rgba(243,156,18,0.15);animation:pulse-border 2s infinite}@keyframes pulse-border{0%,100%{border-color:var(--warning);}50%{border-color:var(--warning-dark);box-shadow:0 0 10px rgba(243,156,18,0.5);}}.task-hint{font-size:0.75rem;color:var(--warning);margin-top:4px;animation:blink 1.5s infinite}.task-hint.active{color:var(--primary)}@keyframes blink{0%,100%{opacity:1;}50%{opacity:0.5;}}.task-checkbox{width:22px;height:22px;border:2px solid var(--border-color);border-radius:var(--radius-sm);display:flex;align-items:center;justify-content:center;cursor:pointer;transition:var(--transition);flex-shrink:0}.task-checkbox.disabled{opacity:0.4;cursor:not-allowed;pointer-events:none;background:var(--bg-input)}.task-checkbox.checked{background:var(--primary);border-color:var(--primary)}.task-checkbox.checked::after{content:'✓';color:white;font-size:0.8rem}.task-info{flex:1;min-width:0}.task-name{font-weight:500;white-space:nowrap;overflow:hidden;text-overflow:ellipsis}.task-duration{font-size:0.75rem;color:var(--text-muted)}.task-actions{display:flex;gap:var(--spacing-xs)}.task-btn{width:32px;height:32px;border:none;border-radius:var(--radius-sm);background:var(--bg-card);color:var(--text-primary);font-size:1rem;font-weight:bold;cursor:pointer;transition:var(--transition);display:flex;align-items:center;justify-content:center}.task-btn:hover{background:var(--primary);color:white}.task-btn.delete:hover{background:var(--danger);color:white}.task-btn.select{background:rgba(243,156,18,0.2);border-color:var(--warning)}.task-btn.select:hover{background:var(--warning);color:white}.task-btn.cancel{background:rgba(231,76,60,0.2);border-color:var(--danger)}.task-btn.cancel:hover{background:var(--danger);color:white}.stats-grid{display:grid;grid-template-columns:repeat(3,1fr);gap:var(--spacing-md);margin-bottom:var(--spacing-lg)}.stat-item{text-align:center;padding:var(--spacing-md);background:var(--bg-input);border-radius:var(--radius-md)}.stat-value{display:block;font-size:1.8rem;font-weight:700;color:var(--primary)}.stat-label{font-size:0.7rem;color:var(--text-muted);text-transform:uppercase;letter-spacing:0.5px}.progress-section{margin-bottom:var(--spacing-md)}.progress-header{display:flex;justify-content:space-between;font-size:0.85rem;margin-bottom:var(--spacing-xs)}.progress-bar{height:12px;background:var(--bg-input);border-radius:var(--radius-sm);overflow:hidden}.progress-fill{height:100%;background:linear-gradient(90deg,var(--primary),var(--secondary));border-radius:var(--radius-sm);width:0%;transition:width 0.5s ease}.time-info{display:flex;align-items:center;justify-content:center;gap:var(--spacing-sm);padding-top:var(--spacing-md);border-top:1px solid var(--border-color);font-size:0.85rem;color:var(--text-muted)}.clock-icon{font-size:1.2rem}#currentTime{font-weight:600;color:var(--text-primary)}.footer{position:fixed;bottom:0;left:0;right:0;background:var(--bg-card);padding:var(--spacing-md);display:flex;justify-content:space-between;font-size:0.75rem;color:var(--text-muted);border-top:1px solid var(--border-color)}.toast{position:fixed;bottom:80px;left:50%;transform:translateX(-50%) translateY(100px);background:var(--bg-card);padding:var(--spacing-sm) var(--spacing-lg);border-radius:var(--radius-md);display:flex;align-items:center;gap:var(--spacing-sm);box-shadow:0 4px 20px rgba(0,0,0,0.4);z-index:1000;opacity:0;transition:all 0.3s ease;border:1px solid var(--border-color)}.toast.show{transform:translateX(-50%) translateY(0);opacity:1}.toast.success{border-color:var(--primary)}.toast.error{border-color:var(--danger)}.modal-overlay{position:fixed;top:0;left:0;right:0;bottom:0;background:rgba(0,0,0,0.7);display:flex;align-items:center;justify-content:center;z-index:1001;opacity:0;visibility:hidden;transition:var(--transition)}.modal-overlay.show{opacity:1;visibility:visible}.modal{background:var(--bg-card);padding:var(--spacing-xl);border-radius:var(--radius-lg);text-align:center;max-width:320px;width:90%;transform:scale(0.9);transition:var(--transition)}.modal-overlay.show .modal{transform:scale(1)}.modal-icon{font-size:3rem;margin-bottom:var(--spacing-md)}.modal h3{margin-bottom:var(--spacing-sm)}.modal p{color:var(--text-secondary);margin-bottom:var(--spacing-lg)}.modal-actions{display:flex;gap:var(--spacing-md)}::-webkit-scrollbar{width:6px}::-webkit-scrollbar-track{background:var(--bg-input);border-radius:3px}::-webkit-scrollbar-thumb{background:var(--border-color);border-radius:3px}::-webkit-scrollbar-thumb:hover{background:var(--primary)}@media (min-width:768px){.app-container{padding:var(--spacing-xl)}.logo h1{font-size:1.4rem}.timer-value{font-size:4rem}.plant-stage{font-size:5rem}}@media (prefers-reduced-motion:reduce){*{animation:none !important;transition:none !important}}.weekly-card{background:linear-gradient(135deg,var(--bg-card) 0%,rgba(52,152,219,0.1) 100%)}.weekly-summary{display:grid;grid-template-columns:repeat(3,1fr);gap:var(--spacing-md);margin-bottom:var(--spacing-md)}.weekly-chart{display:flex;align-items:flex-end;justify-content:space-between;height:80px;padding:var(--spacing-sm);background:var(--bg-input);border-radius:var(--radius-md);margin-bottom:var(--spacing-sm)}.chart-bar{flex:1;margin:0 2px;background:linear-gradient(to top,var(--primary),var(--secondary));border-radius:var(--radius-sm) var(--radius-sm) 0 0;min-height:4px;transition:height 0.3s ease;position:relative}.chart-bar::after{content:attr(data-day);position:absolute;bottom:-18px;left:50%;transform:translateX(-50%);font-size:0.6rem;color:var(--text-muted)}.chart-bar.today{background:linear-gradient(to top,var(--warning),var(--warning-dark))}.weekly-best{text-align:center;color:var(--text-muted);padding-top:var(--spacing-sm);border-top:1px solid var(--border-color)}.weekly-best span{color:var(--primary);font-weight:600}.stats-actions{display:flex;justify-content:center;margin-top:var(--spacing-md);padding-top:var(--spacing-md);border-top:1px solid var(--border-color)}.time-info{display:flex;align-items:center;justify-content:center;gap:var(--spacing-sm);padding-top:var(--spacing-md);border-top:1px solid var(--border-color);font-size:0.85rem;color:var(--text-muted)}.time-info .btn-sm{padding:0.2rem 0.5rem;font-size:0.7rem}.screen-mirror{display:flex;justify-content:center;padding:var(--spacing-sm);background:var(--bg-input);border-radius:var(--radius-md);margin-bottom:var(--spacing-sm)}.screen-mirror canvas{width:256px;height:256px;max-width:100%;background:#000;image-rendering:pixelated}.screen-actions{display:flex;justify-content:center;gap:var(--spacing-sm)}</style>\n</head>\n<body>\n<div class=\"app-container\">\n<header class=\"header\">\n<div class=\"logo\">\n<span class=\"logo-icon\">PB</span>\n<h1>Productivity Bloom</h1>\n</div>\n<div class=\"connection-status\" id=\"connectionStatus\">\n<span class=\"status-dot\"></span>\n<span class=\"status-text\">Conectare...</span>\n</div>\n</header>\n<section class=\"card status-card\">\n<div class=\"status-display\">\n<div class=\"status-info centered\">\n<span class=\"status-label\" id=\"statusLabel\">IDLE</span>\n<span class=\"current-task\" id=\"currentTask\">Niciun task activ</span>\n</div>\n</div>\n<div class=\"timer-display\" id=\"timerDisplay\">\n<span class=\"timer-value\" id=\"timerValue\">00:00</span>\n<div class=\"timer-progress\">\n<div class=\"timer-bar\" id=\"timerBar\"></div>\n</div>\n</div>\n</section>\n<section class=\"card plant-card\">\n<h2>Planta Ta</h2>\n<div class=\"plant-display\">\n<div class=\"plant-visual\" id=\"plantVisual\">\n<div class=\"plant-stage\" id=\"plantStage\"></div>\n<div class=\"plant-pot\"></div>\n</div>\n<div class=\"plant-info\">\n<div class=\"plant-stage-text\">\nStadiu: <span id=\"plantStageText\">Samanta</span>\n<span class=\"stage-number\" id=\"stageNumber\">(0/0)</span>\n</div>\n<div class=\"plant-health\" id=\"plantHealth\">\n<span class=\"health-icon\"></span>\n<span class=\"health-text\">Sanatoasa</span>\n</div>\n<div class=\"water-hint\" id=\"waterHint\">\n<small>Completeaza un task pentru a putea uda planta</small>\n</div>\n</div>\n</div>\n<div class=\"plant-actions\">\n<button class=\"btn btn-water\" id=\"btnWater\" disabled>\n<span class=\"btn-icon\"></span>\n<span class=\"btn-text\">Uda Planta</span>\n</button>\n<button class=\"btn btn-danger\" id=\"btnKill\">\n<span class=\"btn-icon\"></span>\n<span class=\"btn-text\">Demo Kill</span>\n</button>\n</div>\n</section>\n<section class=\"card task-card\">\n<h2>Task Manager</h2>\n<div class=\"goal-section\" id=\"goalSection\">\n<div class=\"goal-setter\">\n<label for=\"dailyGoalInput\">Obiectiv zilnic:</label>\n<div class=\"goal-input-row\">\n<input type=\"number\" id=\"dailyGoalInput\" value=\"3\" min=\"1\" max=\"20\" placeholder=\"Nr. task-uri\">\n<button class=\"btn btn-success btn-sm\" id=\"btnSetGoal\">Seteaza</button>\n</div>\n</div>\n<div class=\"goal-display\" id=\"goalDisplay\"></div>\n</div>\n<div class=\"task-form\">\n<div class=\"form-group\">\n<label for=\"taskName\">Nume Task</label>\n<input type=\"text\" id=\"taskName\" placeholder=\"ex: Invata pentru examen\" maxlength=\"30\">\n</div>\n<div class=\"form-row\">\n<div class=\"form-group\">\n<label for=\"focusTime\">Focus (min)</label>\n<input type=\"number\" id=\"focusTime\" value=\"25\" min=\"1\" max=\"120\">\n</div>\n<div class=\"form-group\">\n<label for=\"breakTime\">Pauza (min)</label>\n<input type=\"number\" id=\"breakTime\" value=\"5\" min=\"1\" max=\"30\">\n</div>\n</div>\n<button class=\"btn btn-primary btn-full\" id=\"btnAddTask\">\n<span class=\"btn-icon\">+</span>\n<span class=\"btn-text\">Adauga Task</span>\n</button>\n</div>\n<div class=\"task-list\" id=\"taskList\">\n<div class=\"task-list-header\">\n<span>Task-uri pentru azi</span>\n<span class=\"task-count\" id=\"taskCount\">0 task-uri</span>\n</div>\n<div class=\"task-items\" id=\"taskItems\">\n<div class=\"empty-state\" id=\"emptyState\">\n<span class=\"empty-icon\">--</span>\n<span class=\"empty-text\">Niciun task adaugat</span>\n</div>\n</div>\n</div>\n</section>\n<section class=\"card stats-card\">\n<h2>Statistici Azi</h2>\n<div class=\"stats-grid\">\n<div class=\"stat-item\">\n<span class=\"stat-value\" id=\"tasksCompleted\">0</span>\n<span class=\"stat-label\">Completate</span>\n</div>\n<div class=\"stat-item\">\n<span class=\"stat-value\" id=\"tasksTotal\">0</span>\n<span class=\"stat-label\">Total</span>\n</div>\n<div class=\"stat-item\">\n<span class=\"stat-value\" id=\"focusTotal\">0</span>\n<span class=\"stat-label\">Min Focus</span>\n</div>\n</div>\n<div class=\"progress-section\">\n<div class=\"progress-header\">\n<span>Progres zilnic</span>\n<span id=\"progressPercent\">0%</span>\n</div>\n<div class=\"progress-bar\">\n<div class=\"progress-fill\" id=\"progressFill\"></div>\n</div>\n</div>\n<div class=\"time-info\">\n<span class=\"clock-icon\">Ora:</span>\n<span id=\"currentTime\">--:--</span>\n<button class=\"btn btn-sm btn-secondary\" id=\"btnSyncTime\" title=\"Sincronizeaza ora de pe telefon\">Sync</button>\n</div>\n<div class=\"stats-actions\">\n<button class=\"btn btn-danger btn-sm\" id=\"btnResetDay\">Reset Ziua</button>\n</div>\n</section>\n<section class=\"card weekly-card\">\n<h2>Statistici Saptamanale</h2>\n<div class=\"weekly-stats\" id=\"weeklyStats\">\n<div class=\"weekly-summary\">\n<div class=\"stat-item\">\n<span class=\"stat-value\" id=\"weeklyTasks\">0</span>\n<span class=\"stat-label\">Task-uri</span>\n</div>\n<div class=\"stat-item\">\n<span class=\"stat-value\" id=\"weeklyFocus\">0</span>\n<span class=\"stat-label\">Min Focus</span>\n</div>\n<div class=\"stat-item\">\n<span class=\"stat-value\" id=\"weeklyAvg\">0</span>\n<span class=\"stat-label\">Media/zi</span>\n</div>\n</div>\n<div class=\"weekly-chart\" id=\"weeklyChart\"></div>\n<div class=\"weekly-best\" id=\"weeklyBest\">\n<small>Cea mai productiva zi: <span id=\"bestDay\">-</span></small>\n</div>\n</div>\n</section>\n<section class=\"card screen-card\">\n<h2>Ecranul Cubului</h2>\n<div class=\"screen-mirror\">\n<canvas id=\"screenCanvas\" width=\"128\" height=\"128\"></canvas>\n</div>\n<div class=\"screen-actions\">\n<button class=\"btn btn-sm btn-secondary\" id=\"btnScreenMirror\">Arata ecranul</button>\n<a class=\"btn btn-sm btn-secondary\" id=\"screenSnapshot\" href=\"/api/screen\" download=\"bloom-screen.pbm\">Captura</a>\n</div>\n</section>\n<footer class=\"footer\">\n<span>Productivity Bloom v1.0</span>\n<span id=\"espIP\">ESP32</span>\n</footer>\n</div>\n<div class=\"toast\" id=\"toast\">\n<span class=\"toast-icon\" id=\"toastIcon\"></span>\n<span class=\"toast-message\" id=\"toastMessage\">Mesaj</span>\n</div>\n<div class=\"modal-overlay\" id=\"modalOverlay\">\n<div class=\"modal\">\n<div class=\"modal-icon\" id=\"modalIcon\">!</div>\n<h3 id=\"modalTitle\">Confirmare</h3>\n<p id=\"modalMessage\">Esti sigur?</p>\n<div class=\"modal-actions\">\n<button class=\"btn btn-secondary\" id=\"modalCancel\">Anuleaza</button>\n<button class=\"btn btn-danger\" id=\"modalConfirm\">Confirma</button>\n</div>\n</div>\n</div>\n<script>const Messages=(()=>{const num=v=>(typeof v==='number'?v:0);const bool=v=>v===true;const str=v=>(typeof v==='string'?v:'');const strOrNull=v=>(typeof v==='string'?v:null);const list=(v,decode)=>(Array.isArray(v)?v.map(decode):[]);function decodeTask(d){d=d||{};const m={id:num(d.id),name:str(d.name),focusDuration:num(d.focusDuration),breakDuration:num(d.breakDuration),completed:bool(d.completed),started:bool(d.started),};return m;}\nfunction decodeWeekly(d){d=d||{};const m={totalTasks:num(d.totalTasks),totalFocus:num(d.totalFocus),totalBreak:num(d.totalBreak),totalSessions:num(d.totalSessions),avgTasksPerDay:num(d.avgTasksPerDay),avgFocusPerDay:num(d.avgFocusPerDay),mostProductiveDay:num(d.mostProductiveDay),mostProductiveTasks:num(d.mostProductiveTasks),daysRecorded:num(d.daysRecorded),hasFullWeek:bool(d.hasFullWeek),mostProductiveDayName:str(d.mostProductiveDayName),};return m;}\nfunction decodeDay(d){d=d||{};const m={daysAgo:num(d.daysAgo),tasks:num(d.tasks),focus:num(d.focus),valid:bool(d.valid),};return m;}\nfunction decodeQuantiles(d){d=d||{};const m={count:num(d.count),min:num(d.min),p50:num(d.p50),p90:num(d.p90),max:num(d.max),};return m;}\nfunction decodePlantSummary(d){d=d||{};const m={stage:num(d.stage),isWithered:bool(d.isWithered),canWater:bool(d.canWater),wateredCount:num(d.wateredCount),totalGoal:num(d.totalGoal),pendingWater:num(d.pendingWater),dailyGoal:num(d.dailyGoal),};return m;}\nfunction decodeTaskCounts(d){d=d||{};const m={completed:num(d.completed),total:num(d.total),};return m;}\nfunction decodeStatus(d){d=d||{};const m={ver:num(d.ver),state:str(d.state),timeLeft:num(d.timeLeft),totalTime:num(d.totalTime),waitingForConfirmation:bool(d.waitingForConfirmation),taskName:strOrNull(d.taskName),};if(d.trace!==undefined)m.trace=num(d.trace);return m;}\nfunction decodePlant(d){d=d||{};const m={ver:num(d.ver),stage:num(d.stage),isWithered:bool(d.isWithered),wateredCount:num(d.wateredCount),totalGoal:num(d.totalGoal),pendingWater:num(d.pendingWater),dailyGoal:num(d.dailyGoal),};return m;}\nfunction decodeTasks(d){d=d||{};const m={ver:num(d.ver),tasks:list(d.tasks,decodeTask),};return m;}\nfunction decodeStats(d){d=d||{};const m={todayTasks:num(d.todayTasks),todayFocus:num(d.todayFocus),todayBreak:num(d.todayBreak),todaySessions:num(d.todaySessions),weekly:decodeWeekly(d.weekly),days:list(d.days,decodeDay),focusSeconds:decodeQuantiles(d.focusSeconds),pauseTenths:decodeQuantiles(d.pauseTenths),breakSeconds:decodeQuantiles(d.breakSeconds),};return m;}\nfunction decodeRevive(d){d=d||{};const m={message:str(d.message),};return m;}\nfunction decodeAck(d){d=d||{};const m={id:num(d.id),ok:bool(d.ok),ver:num(d.ver),};if(d.status!==undefined)m.status=decodeStatus(d.status);if(d.plant!==undefined)m.plant=decodePlant(d.plant);if(d.tasks!==undefined)m.tasks=list(d.tasks,decodeTask);return m;}\nfunction decodeActionReply(d){d=d||{};const m={success:bool(d.success),};if(d.action!==undefined)m.action=str(d.action);if(d.ok!==undefined)m.ok=bool(d.ok);if(d.ver!==undefined)m.ver=num(d.ver);if(d.status!==undefined)m.status=decodeStatus(d.status);if(d.plant!==undefined)m.plant=decodePlant(d.plant);if(d.tasks!==undefined)m.tasks=list(d.tasks,decodeTask);return m;}\nfunction decodeApiStatus(d){d=d||{};const m={state:str(d.state),timeLeft:num(d.timeLeft),totalTime:num(d.totalTime),taskName:strOrNull(d.taskName),plant:decodePlantSummary(d.plant),stats:decodeTaskCounts(d.stats),ver:num(d.ver),};return m;}\nfunction decodeApiTasks(d){d=d||{};const m={tasks:list(d.tasks,decodeTask),ver:num(d.ver),};return m;}\nconst byType={status:decodeStatus,plant:decodePlant,tasks:decodeTasks,stats:decodeStats,revive:decodeRevive,ack:decodeAck,};function decode(d){const decoder=d&&byType[d.type];if(!decoder)return d;const m=decoder(d);m.type=d.type;return m;}\nreturn{decode,decodeStatus,decodePlant,decodeTasks,decodeStats,decodeRevive,decodeAck,decodeActionReply,decodeApiStatus,decodeApiTasks};})();</script>\n<script>const ESP32_IP=window.location.hostname||'192.168.4.1';const CONFIG={API_BASE:`http://${ESP32_IP}`,WS_URL:`ws://${ESP32_IP}:81`,RECONNECT_INTERVAL:2000,UPDATE_INTERVAL:1000};console.log('Productivity Bloom loading, ESP32 IP:',ESP32_IP);const state={connected:false,wsConnected:false,status:'idle',currentTask:null,timeLeft:0,totalTime:0,plant:{stage:0,isWithered:false},tasks:[],stats:{completed:0,total:0,focusMinutes:0},ws:null,pendingWater:0,wateredCount:0,dailyGoal:0,currentSessionGoal:0,goalLocked:false,selectedTaskId:0,showingConfirmModal:false,flipCancelledWaitingFlipBack:false,lastTraceAck:0,events:null,eventsConnected:false,statusPoll:null,version:null,server:{status:null,plant:null,tasks:null},actionQueue:[],actionInFlight:null,nextActionId:1};const PLANT_STAGES=[{emoji:'🌰',name:'Samanta'},{emoji:'🌱',name:'Lastar'},{emoji:'🌿',name:'Crestere'},{emoji:'🌸',name:'Inflorit'}];const elements={connectionStatus:document.getElementById('connectionStatus'),statusLabel:document.getElementById('statusLabel'),currentTask:document.getElementById('currentTask'),timerValue:document.getElementById('timerValue'),timerBar:document.getElementById('timerBar'),plantStage:document.getElementById('plantStage'),plantStageText:document.getElementById('plantStageText'),stageNumber:document.getElementById('stageNumber'),plantHealth:document.getElementById('plantHealth'),plantVisual:document.getElementById('plantVisual'),waterHint:document.getElementById('waterHint'),btnWater:document.getElementById('btnWater'),btnKill:document.getElementById('btnKill'),taskName:document.getElementById('taskName'),focusTime:document.getElementById('focusTime'),breakTime:document.getElementById('breakTime'),btnAddTask:document.getElementById('btnAddTask'),dailyGoalInput:document.getElementById('dailyGoalInput'),btnSetGoal:document.getElementById('btnSetGoal'),btnResetGoal:document.getElementById('btnResetGoal'),goalDisplay:document.getElementById('goalDisplay'),goalSection:document.getElementById('goalSection'),taskItems:document.getElementById('taskItems'),taskCount:document.getElementById('taskCount'),emptyState:document.getElementById('emptyState'),tasksCompleted:document.getElementById('tasksCompleted'),tasksTotal:document.getElementById('tasksTotal'),focusTotal:document.getElementById('focusTotal'),progressPercent:document.getElementById('progressPercent'),progressFill:document.getElementById('progressFill'),currentTime:document.getElementById('currentTime'),btnSyncTime:document.getElementById('btnSyncTime'),btnResetDay:document.getElementById('btnResetDay'),weeklyTasks:document.getElementById('weeklyTasks'),weeklyFocus:document.getElementById('weeklyFocus'),weeklyAvg:document.getElementById('weeklyAvg'),weeklyChart:document.getElementById('weeklyChart'),bestDay:document.getElementById('bestDay'),screenCanvas:document.getElementById('screenCanvas'),btnScreenMirror:document.getElementById('btnScreenMirror'),espIP:document.getElementById('espIP'),toast:document.getElementById('toast'),toastIcon:document.getElementById('toastIcon'),toastMessage:document.getElementById('toastMessage'),modalOverlay:document.getElementById('modalOverlay'),modalIcon:document.getElementById('modalIcon'),modalTitle:document.getElementById('modalTitle'),modalMessage:document.getElementById('modalMessage'),modalCancel:document.getElementById('modalCancel'),modalConfirm:document.getElementById('modalConfirm')};function isDevMode(){const hostname=window.location.hostname;return hostname==='127.0.0.1'||hostname==='localhost';}\nfunction connectWebSocket(){console.log('connectWebSocket called, isDevMode:',isDevMode());if(isDevMode()){console.log('Development mode - using mock data');setConnectionStatus(true);loadMockData();return;}\nif(state.ws){try{state.ws.close();}catch(e){}\nstate.ws=null;}\ntry{console.log('Attempting WebSocket connection to:',CONFIG.WS_URL);state.ws=new WebSocket(CONFIG.WS_URL);state.ws.binaryType='arraybuffer';state.ws.onopen=()=>{console.log('WebSocket connected successfully');state.wsConnected=true;setConnectionStatus(true);showToast('Conectat la ESP32!','success');stopEventStream();stopStatusPolling();if(screenMirror.subscribed){state.ws.send(JSON.stringify({action:'subscribeScreen'}));}};state.ws.onmessage=(event)=>{if(event.data instanceof ArrayBuffer){handleScreenFrame(event.data);return;}\ntry{const data=Messages.decode(JSON.parse(event.data));handleWebSocketMessage(data);}catch(e){console.error('Failed to parse WS message:',e);}};state.ws.onclose=()=>{console.log('WebSocket disconnected');state.wsConnected=false;setConnectionStatus(false);startEventStream();if(state.actionInFlight){state.actionInFlight=null;sendNextAction();}\nsetTimeout(connectWebSocket,CONFIG.RECONNECT_INTERVAL);};state.ws.onerror=(error)=>{console.error('WebSocket error:',error,'URL:',CONFIG.WS_URL);setConnectionStatus(false);};}catch(e){console.error('WebSocket connection failed:',e);setConnectionStatus(false);setTimeout(connectWebSocket,CONFIG.RECONNECT_INTERVAL);}}\nfunction startEventStream(){if(state.events||isDevMode()||typeof EventSource==='undefined')return;state.events=new EventSource(`${CONFIG.API_BASE}/api/events`);['status','plant','tasks','stats','revive'].forEach(type=>{state.events.addEventListener(type,(event)=>{handleWebSocketMessage(Messages.decode(JSON.parse(event.data)));});});state.events.onopen=()=>{state.eventsConnected=true;stopStatusPolling();setConnectionStatus(true);console.log('Following the cube via /api/events (WebSocket unavailable)');};state.events.onerror=()=>{state.eventsConnected=false;if(state.events&&state.events.readyState===EventSource.CLOSED){state.events=null;startStatusPolling();}};}\nfunction stopEventStream(){if(!state.events)return;state.events.close();state.events=null;state.eventsConnected=false;}\nfunction startStatusPolling(){if(state.statusPoll)return;console.log('Polling /api/status (WebSocket and /api/events unavailable)');state.statusPoll=setInterval(()=>{if(state.wsConnected){stopStatusPolling();return;}\nfetchStatus();},2000);}\nfunction stopStatusPolling(){if(!state.statusPoll)return;clearInterval(state.statusPoll);state.statusPoll=null;}\nfunction handleWebSocketMessage(data){if(data.ver!==undefined){state.version=data.ver;}\nswitch(data.type){case'status':noteServerState('status',data);updateStatus(data);if(data.trace&&data.trace!==state.lastTraceAck){acknowledgeTrace(data.trace);}\nbreak;case'plant':noteServerState('plant',data);updatePlant(data);break;case'tasks':noteServerState('tasks',data.tasks||[]);state.tasks=data.tasks||[];renderTasks();break;case'ack':handleActionAck(data);break;case'stats':updateWeeklyStats(data);break;case'flip':showToast('Cub întors! '+(data.paused?'Pauză':'Continui'),'success');break;case'revive':showReviveAnimation();showToast(data.message||'Planta a reinviat!','success');break;}}\nfunction acknowledgeTrace(id){state.lastTraceAck=id;requestAnimationFrame(()=>{if(state.ws&&state.ws.readyState===WebSocket.OPEN){state.ws.send(JSON.stringify({action:'traceAck',trace:id}));}});}\nfunction sendWebSocketMessage(data){if(state.ws&&state.ws.readyState===WebSocket.OPEN){state.ws.send(JSON.stringify(data));}else{sendAPIRequest(data);}}\nfunction sendAction(data){state.actionQueue.push(data);if(!state.actionInFlight){sendNextAction();}}\nfunction sendNextAction(){const action=state.actionQueue.shift()||null;state.actionInFlight=action;if(!action)return;action.id=state.nextActionId++;if(state.version!==null){action.ver=state.version;}\nif(state.ws&&state.ws.readyState===WebSocket.OPEN){state.ws.send(JSON.stringify(action));}else{sendAPIRequest(action).then(reply=>{if(!reply||(!reply.success&&reply.ok===undefined)){rejectAction(action,reply!==null);return;}\nhandleActionAck(Object.assign({},reply,{id:action.id}));});}}\nfunction rejectAction(action,refused){if(!state.actionInFlight||action.id!==state.actionInFlight.id)return;state.actionInFlight=null;state.actionQueue=[];restoreServerState();if(refused){showToast('Cubul a refuzat actiunea','error');}}\nfunction handleActionAck(ack){if(!state.actionInFlight||ack.id!==state.actionInFlight.id)return;const sentVer=state.actionInFlight.ver;state.actionInFlight=null;if(ack.ver!==undefined){state.version=ack.ver;}\nif(ack.ok===false){state.actionQueue=[];restoreServerState();if(ack.ver!==undefined&&ack.ver===sentVer){showToast('Cubul a refuzat actiunea','error');}else{showToast('Starea s-a schimbat intre timp, actiunea a fost anulata','error');}}\napplyServerDelta(ack);sendNextAction();}\nfunction noteServerState(kind,data){state.server[kind]=JSON.parse(JSON.stringify(data));}\nfunction restoreServerState(){const server=state.server;if(server.tasks){state.tasks=JSON.parse(JSON.stringify(server.tasks));renderTasks();}\nif(server.plant)updatePlant(server.plant);if(server.status)updateStatus(server.status);}\nfunction applyServerDelta(reply){if(reply.tasks){noteServerState('tasks',reply.tasks);state.tasks=reply.tasks;renderTasks();}\nif(reply.plant){noteServerState('plant',reply.plant);updatePlant(reply.plant);}\nif(reply.status){noteServerState('status',reply.status);updateStatus(reply.status);}}\nconst screenMirror={subscribed:false,frame:new Uint8Array(2048),rotated:false};function toggleScreenMirror(){if(!state.ws||state.ws.readyState!==WebSocket.OPEN){showToast('Necesita conexiune WebSocket','error');return;}\nscreenMirror.subscribed=!screenMirror.subscribed;state.ws.send(JSON.stringify({action:screenMirror.subscribed?'subscribeScreen':'unsubscribeScreen'}));elements.btnScreenMirror.textContent=screenMirror.subscribed?'Opreste':'Arata ecranul';}\nfunction handleScreenFrame(buffer){const packet=new Uint8Array(buffer);const isKey=packet[0]===0;const frame=screenMirror.frame;let out=0;let i=4;while(i<packet.length&&out<frame.length){const token=packet[i++];const count=(token&0x7F)+1;if(token&0x80){if(isKey)frame.fill(0,out,out+count);out+=count;}else{for(let k=0;k<count;k++,out++,i++){frame[out]=isKey?packet[i]:frame[out]^packet[i];}}}\nscreenMirror.rotated=(packet[1]&1)!==0;drawScreenFrame();}\nfunction drawScreenFrame(){const ctx=elements.screenCanvas.getContext('2d');const image=ctx.createImageData(128,128);const frame=screenMirror.frame;for(let y=0;y<128;y++){for(let x=0;x<128;x++){const nx=screenMirror.rotated?127-x:x;const ny=screenMirror.rotated?127-y:y;const lit=frame[(ny>>3)*128+nx]&(1<<(ny&7));const p=(y*128+x)*4;const v=lit?255:0;image.data[p]=image.data[p+1]=image.data[p+2]=v;image.data[p+3]=255;}}\nctx.putImageData(image,0,0);}\nasync function sendAPIRequest(action){if(isDevMode()){return handleMockAction(action);}\ntry{const response=await fetch(`${CONFIG.API_BASE}/api/action`,{method:'POST',headers:{'Content-Type':'application/json'},body:JSON.stringify(action)});return Messages.decodeActionReply(await response.json());}catch(e){console.error('API request failed:',e);showToast('Eroare de conexiune','error');return null;}}\nasync function fetchTasks(){if(isDevMode()){return;}\ntry{const response=await fetch(`${CONFIG.API_BASE}/api/tasks`);const data=Messages.decodeApiTasks(await response.json());if(data.ver!==undefined)state.version=data.ver;noteServerState('tasks',data.tasks||[]);state.tasks=data.tasks||[];renderTasks();}catch(e){console.error('Failed to fetch tasks:',e);}}\nasync function fetchStatus(){console.log('fetchStatus called, isDevMode:',isDevMode());if(isDevMode()){return;}\nconst url=`${CONFIG.API_BASE}/api/status`;console.log('Fetching status from:',url);try{const response=await fetch(url);console.log('fetchStatus response:',response.status);const data=Messages.decodeApiStatus(await response.json());console.log('fetchStatus data:',data);if(data.ver!==undefined)state.version=data.ver;noteServerState('status',data);noteServerState('plant',data.plant);updateStatus(data);updatePlant(data.plant);updateStats(data.stats);if(!state.connected){setConnectionStatus(true);console.log('Connected via API polling (WebSocket unavailable)');}}catch(e){console.error('Failed to fetch status:',e);setConnectionStatus(false);}}\nfunction setConnectionStatus(connected){state.connected=connected;const statusDot=elements.connectionStatus.querySelector('.status-dot');const statusText=elements.connectionStatus.querySelector('.status-text');statusDot.className='status-dot '+(connected?'connected':'disconnected');statusText.textContent=connected?'Conectat':'Deconectat';}\nfunction updateStatus(data){const prevStatus=state.status;const prevTask=state.currentTask;state.status=data.state||'idle';state.timeLeft=data.timeLeft||0;state.totalTime=data.totalTime||0;state.currentTask=data.taskName||null;if(data.waitingForConfirmation&&!state.showingConfirmModal&&!state.flipCancelledWaitingFlipBack){showFlipConfirmModal();}\nif(!data.waitingForConfirmation&&state.flipCancelledWaitingFlipBack){hideModal();state.flipCancelledWaitingFlipBack=false;showToast('Timer resumed!','success');}\nconst statusConfig={idle:{icon:'||',label:'IDLE',class:''},focusing:{icon:'>>',label:'FOCUSING',class:'focusing'},paused:{icon:'||',label:'PAUSED',class:'paused'},break:{icon:'..',label:'ON BREAK',class:'break'},withered:{icon:'X',label:'PLANT WITHERED',class:'withered'}};const config=statusConfig[state.status]||statusConfig.idle;elements.statusLabel.textContent=config.label;elements.statusLabel.className='status-label '+config.class;elements.currentTask.textContent=state.currentTask||'Niciun task activ';updateTimerDisplay();elements.btnWater.disabled=state.status!=='idle'||state.plant.isWithered;if(prevStatus!==state.status||prevTask!==state.currentTask){renderTasks();}}\nfunction updateTimerDisplay(){const minutes=Math.floor(state.timeLeft/60);const seconds=state.timeLeft%60;elements.timerValue.textContent=`${String(minutes).padStart(2, '0')}:${String(seconds).padStart(2, '0')}`;if(state.totalTime>0){const progress=((state.totalTime-state.timeLeft)/state.totalTime)*100;elements.timerBar.style.width=`${progress}%`;}else{elements.timerBar.style.width='0%';}}\nfunction updatePlant(data){if(data){state.plant.stage=data.stage!==undefined?data.stage:state.plant.stage;state.plant.isWithered=data.isWithered||false;if(data.pendingWater!==undefined)state.pendingWater=data.pendingWater;if(data.wateredCount!==undefined)state.wateredCount=data.wateredCount;if(data.dailyGoal!==undefined){state.dailyGoal=data.dailyGoal;state.goalLocked=data.dailyGoal>0;}\nif(data.totalGoal!==undefined)state.currentSessionGoal=data.totalGoal;}\nconst completedTasks=state.tasks.filter(t=>t.completed).length;const targetTasks=state.dailyGoal>0?state.dailyGoal:state.tasks.length;const displayStage=state.plant.isWithered?0:state.plant.stage;const stageInfo=PLANT_STAGES[displayStage]||PLANT_STAGES[0];if(state.plant.isWithered){elements.plantStage.textContent='🥀';elements.plantStage.classList.add('withered');elements.plantStageText.textContent='Ofilita';elements.plantHealth.innerHTML='<span class=\"health-icon\"></span><span class=\"health-text\" style=\"color: var(--danger);\">Ofilita</span>';}else{elements.plantStage.textContent=stageInfo.emoji;elements.plantStage.classList.remove('withered');elements.plantStageText.textContent=stageInfo.name;elements.plantHealth.innerHTML='<span class=\"health-icon\"></span><span class=\"health-text\">Sanatoasa</span>';}\nconst displayGoal=state.currentSessionGoal>0?state.currentSessionGoal:state.tasks.length;if(state.tasks.length===0){elements.stageNumber.textContent=`(0/0)`;}else{elements.stageNumber.textContent=`(${state.wateredCount}/${displayGoal})`;}\nconst canWater=state.pendingWater>0&&!state.plant.isWithered&&state.status!=='focusing'&&state.plant.stage<3;elements.btnWater.disabled=!canWater;if(elements.waterHint){const totalTasks=state.tasks.length;const goalSet=state.dailyGoal>0;if(state.plant.stage>=3||(totalTasks>0&&state.tasks.filter(t=>t.completed).length>=totalTasks&&state.pendingWater===0)){elements.waterHint.innerHTML='<small>Planta a inflorit complet! Felicitari!</small>';elements.waterHint.className='water-hint complete';}else if(state.pendingWater>0){elements.waterHint.innerHTML=`<small>Poti uda planta! (${state.pendingWater} udari disponibile)</small>`;elements.waterHint.className='water-hint ready';}else if(totalTasks===0){elements.waterHint.innerHTML='<small>Adauga task-uri pentru a incepe</small>';elements.waterHint.className='water-hint';}else if(!goalSet){elements.waterHint.innerHTML='<small>Seteaza obiectivul zilnic pentru a incepe</small>';elements.waterHint.className='water-hint';}else{elements.waterHint.innerHTML='<small>Completeaza un task pentru a putea uda planta</small>';elements.waterHint.className='water-hint';}}\nupdateGoalDisplay();}\nfunction updateGoalDisplay(){if(!elements.goalDisplay)return;const completedTasks=state.tasks.filter(t=>t.completed).length;if(state.goalLocked&&state.dailyGoal>0){elements.goalDisplay.innerHTML=`\n            <div class=\"goal-info\">\n                <span class=\"goal-target\">Obiectiv: ${completedTasks}/${state.dailyGoal} task-uri</span>\n                <button class=\"btn btn-sm btn-secondary\" id=\"btnChangeGoal\">Modifica</button>\n            </div>\n        `;elements.goalSection.classList.add('locked');const btnChange=document.getElementById('btnChangeGoal');if(btnChange){btnChange.onclick=resetGoal;}}else{elements.goalDisplay.innerHTML='';elements.goalSection.classList.remove('locked');}}\nfunction setDailyGoal(){const goalValue=parseInt(elements.dailyGoalInput.value)||0;console.log('setDailyGoal called:',{goalValue,currentDailyGoal:state.dailyGoal,goalLocked:state.goalLocked});if(goalValue<1){showToast('Introdu un obiectiv valid (minim 1 task)','error');return;}\nif(goalValue>20){showToast('Obiectivul maxim este 20 de task-uri','error');return;}\nif(state.dailyGoal>0&&goalValue<=state.dailyGoal){showToast(`Noul obiectiv trebuie sa fie mai mare decat ${state.dailyGoal}!`,'error');console.log('Validation failed: goalValue <= state.dailyGoal');return;}\nconst previousGoal=state.dailyGoal;const newTasksNeeded=previousGoal>0?(goalValue-previousGoal):goalValue;state.dailyGoal=goalValue;state.currentSessionGoal=newTasksNeeded;state.goalLocked=true;state.plant.stage=0;state.pendingWater=0;state.wateredCount=0;updatePlant();showToast(`Obiectiv setat: ${goalValue} task-uri! Planta a fost resetata.`,'success');sendAction({action:'setGoal',goal:goalValue});}\nfunction resetGoal(){showModal('?','Modifica Obiectivul',`Vrei sa modifici obiectivul zilnic? Noul obiectiv trebuie sa fie mai mare decat ${state.dailyGoal}. Planta va fi resetata.`,()=>{const oldGoal=state.dailyGoal;state.goalLocked=false;if(elements.dailyGoalInput){elements.dailyGoalInput.value=oldGoal+1;elements.dailyGoalInput.min=oldGoal+1;}\nupdatePlant();showToast(`Seteaza un obiectiv mai mare decat ${oldGoal}!`,'success');});}\nfunction updateStats(data){if(!data)return;state.stats.completed=data.completed||0;state.stats.total=data.total||0;state.stats.focusMinutes=data.focusMinutes||0;elements.tasksCompleted.textContent=state.stats.completed;elements.tasksTotal.textContent=state.stats.total;elements.focusTotal.textContent=state.stats.focusMinutes;const percent=state.stats.total>0?Math.round((state.stats.completed/state.stats.total)*100):0;elements.progressPercent.textContent=`${percent}%`;elements.progressFill.style.width=`${percent}%`;}\nconst taskRows=new Map();function renderTasks(){const container=elements.taskItems;const seen=new Set();let anchor=elements.emptyState;let completed=0;for(const task of state.tasks){if(task.completed)completed++;seen.add(task.id);let row=taskRows.get(task.id);if(!row){row=createTaskRow(task.id);taskRows.set(task.id,row);}\npatchTaskRow(row,taskView(task));if(anchor.nextSibling!==row.el){container.insertBefore(row.el,anchor.nextSibling);}\nanchor=row.el;}\nfor(const[id,row]of taskRows){if(!seen.has(id)){row.el.remove();taskRows.delete(id);}}\nelements.emptyState.style.display=state.tasks.length===0?'':'none';elements.taskCount.textContent=`${state.tasks.length} task-uri`;updateStats({completed:completed,total:state.tasks.length,focusMinutes:state.stats.focusMinutes});}\nfunction taskView(task){const selected=state.selectedTaskId===task.id;const active=!!(task.active||(state.status==='focusing'&&state.currentTask===task.name));let hint='';if(selected&&!active){hint='Flip the cube to start!';}else if(active&&state.status==='focusing'){hint='Flip back when done';}\nreturn{name:task.name,duration:`Focus: ${task.focusDuration}min / Pauza: ${task.breakDuration}min`,completed:!!task.completed,started:!!task.started,active:active,selected:selected,hint:hint,editable:!task.completed&&!active};}\nfunction createTaskRow(id){const el=document.createElement('div');el.className='task-item';el.dataset.id=id;el.innerHTML=`\n        <div class=\"task-checkbox\" data-action=\"toggle\"></div>\n        <div class=\"task-info\">\n            <div class=\"task-name\"></div>\n            <div class=\"task-duration\"></div>\n            <div class=\"task-hint\"></div>\n        </div>\n        <div class=\"task-actions\">\n            <button class=\"task-btn select\" data-action=\"select\" title=\"Select\">&#10003;</button>\n            <button class=\"task-btn cancel\" data-action=\"cancel\" title=\"Cancel\">&#10007;</button>\n            <button class=\"task-btn delete\" data-action=\"delete\" title=\"Delete\">&#10005;</button>\n        </div>\n    `;return{el:el,checkbox:el.querySelector('.task-checkbox'),name:el.querySelector('.task-name'),duration:el.querySelector('.task-duration'),hint:el.querySelector('.task-hint'),actions:el.querySelector('.task-actions'),select:el.querySelector('.task-btn.select'),cancel:el.querySelector('.task-btn.cancel'),view:{}};}\nfunction patchTaskRow(row,view){const old=row.view;if(view.name!==old.name)row.name.textContent=view.name;if(view.duration!==old.duration)row.duration.textContent=view.duration;if(view.completed!==old.completed||view.active!==old.active||view.selected!==old.selected){row.el.classList.toggle('completed',view.completed);row.el.classList.toggle('active',view.active);row.el.classList.toggle('selected',view.selected);}\nif(view.completed!==old.completed||view.started!==old.started){row.checkbox.classList.toggle('checked',view.completed);row.checkbox.classList.toggle('disabled',!view.started);}\nif(view.hint!==old.hint||view.active!==old.active){row.hint.textContent=view.hint;row.hint.classList.toggle('active',view.active);row.hint.style.display=view.hint?'':'none';}\nif(view.editable!==old.editable||view.selected!==old.selected){row.actions.style.display=view.editable?'':'none';row.select.style.display=view.selected?'none':'';row.cancel.style.display=view.selected?'':'none';}\nrow.view=view;}\nfunction handleTaskListClick(e){const target=e.target.closest('[data-action]');const row=target&&target.closest('.task-item');if(!row)return;const id=Number(row.dataset.id);switch(target.dataset.action){case'toggle':toggleTaskComplete(id);break;case'select':selectTask(id);break;case'cancel':cancelSelection();break;case'delete':deleteTask(id);break;}}\nfunction addTask(){const name=elements.taskName.value.trim();const focusDuration=parseInt(elements.focusTime.value)||25;const breakDuration=parseInt(elements.breakTime.value)||5;if(!name){showToast('Introdu un nume pentru task!','error');elements.taskName.focus();return;}\nif(state.goalLocked&&state.tasks.length>=state.dailyGoal){showToast('Ai atins limita de task-uri pentru obiectivul zilnic!','error');return;}\nconst newTask={id:Date.now(),name:name,focusDuration:focusDuration,breakDuration:breakDuration,completed:false,active:false,started:false};sendAction({action:'addTask',task:newTask});state.tasks.push(newTask);renderTasks();updatePlant();elements.taskName.value='';elements.taskName.focus();showToast('Task adăugat!','success');}\nfunction startTask(id){const task=state.tasks.find(t=>t.id===id);if(!task)return;sendAction({action:'startTask',taskId:id});state.tasks.forEach(t=>t.active=false);task.active=true;task.started=true;state.status='focusing';state.currentTask=task.name;state.timeLeft=task.focusDuration*60;state.totalTime=task.focusDuration*60;state.selectedTaskId=0;updateStatus({state:'focusing',taskName:task.name,timeLeft:state.timeLeft,totalTime:state.totalTime});renderTasks();showToast(`Incepi: ${task.name}`,'success');}\nfunction selectTask(id){const task=state.tasks.find(t=>t.id===id);if(!task)return;if(task.completed){showToast('Task-ul e deja completat!','error');return;}\nif(state.status==='focusing'){showToast('Oprește mai întâi task-ul curent!','error');return;}\nsendAction({action:'selectTask',taskId:id});state.selectedTaskId=id;task.started=true;renderTasks();showToast(`Task \"${task.name}\" selectat. Întoarce cubul pentru a începe!`,'success');}\nfunction cancelSelection(){state.selectedTaskId=0;renderTasks();showToast('Selecție anulată','info');}\nfunction toggleTaskComplete(id){const task=state.tasks.find(t=>t.id===id);if(!task)return;if(!task.started){showToast('Trebuie sa pornesti task-ul inainte sa il completezi!','error');return;}\nconst wasCompleted=task.completed;const wasActive=task.active;task.completed=!task.completed;let actualMinutesSpent=0;if(task.completed&&wasActive){const secondsSpent=state.totalTime-state.timeLeft;actualMinutesSpent=Math.ceil(secondsSpent/60);task.active=false;state.status='idle';state.timeLeft=0;state.totalTime=0;state.currentTask=null;updateStatus({state:'idle',taskName:''});}else if(task.completed&&!wasActive){actualMinutesSpent=task.focusDuration;}\nsendAction({action:'toggleTask',taskId:id,completed:task.completed});if(task.completed&&!wasCompleted){state.pendingWater++;state.stats.focusMinutes+=actualMinutesSpent;showToast('Task completat! Poti uda planta!','success');}else if(!task.completed&&wasCompleted){state.pendingWater=Math.max(0,state.pendingWater-1);state.stats.focusMinutes=Math.max(0,state.stats.focusMinutes-task.focusDuration);}\nrenderTasks();updatePlant();}\nfunction deleteTask(id){showModal('X','Sterge Task','Esti sigur ca vrei sa stergi acest task?',()=>{const task=state.tasks.find(t=>t.id===id);if(task&&task.active){state.status='idle';state.timeLeft=0;state.totalTime=0;state.currentTask=null;updateStatus({state:'idle',taskName:''});}\nif(task&&task.completed&&state.pendingWater>0){state.pendingWater--;}\nstate.tasks=state.tasks.filter(t=>t.id!==id);sendAction({action:'deleteTask',taskId:id});renderTasks();updatePlant();showToast('Task sters','success');});}\nfunction waterPlant(){if(state.plant.isWithered){showToast('Planta este ofilită! Folosește lumina pentru a o reînvia.','error');return;}\nif(!state.goalLocked||state.dailyGoal<=0){showToast('Setează mai întâi obiectivul zilnic!','error');return;}\nif(state.pendingWater<=0){showToast('Completează un task pentru a putea uda planta!','error');return;}\nif(state.plant.stage>=3){showToast('Planta a crescut complet! 🌸','success');return;}\nsendAction({action:'water'});const goalsToComplete=state.currentSessionGoal>0?state.currentSessionGoal:state.tasks.length;state.pendingWater--;state.wateredCount++;let targetStage;if(state.wateredCount>=goalsToComplete){targetStage=3;}else if(state.wateredCount>=2){targetStage=2;}else if(state.wateredCount>=1){targetStage=1;}else{targetStage=0;}\nconst oldStage=state.plant.stage;state.plant.stage=targetStage;const stageInfo=PLANT_STAGES[state.plant.stage];updatePlant();if(state.plant.stage>=3){showToast('Planta a inflorit complet! Felicitari!','success');}else if(state.plant.stage>oldStage){showToast(`Planta a crescut! Acum e ${stageInfo.name}!`,'success');}else{showToast(`Planta a fost udata! Mai completeaza task-uri pentru a creste!`,'success');}\ntriggerHeartAnimation();}\nfunction killPlant(){showModal('X','Demo Mode','Aceasta va omori planta pentru demonstratie. Poti sa o reinvii cu senzorul de lumina.',()=>{sendAction({action:'kill'});state.plant.isWithered=true;updatePlant({stage:state.plant.stage,isWithered:true});updateStatus({state:'withered',taskName:'Planta a murit!'});showToast('Planta a fost ofilita','error');});}\nfunction triggerHeartAnimation(){const heart=document.createElement('div');heart.innerHTML='+';heart.style.cssText=`\n        position: fixed;\n        top: 50%;\n        left: 50%;\n        font-size: 4rem;\n        color: var(--primary);\n        font-weight: bold;\n        transform: translate(-50%, -50%) scale(0);\n        animation: heartPop 0.6s ease forwards;\n        z-index: 1000;\n        pointer-events: none;\n    `;document.body.appendChild(heart);setTimeout(()=>heart.remove(),600);}\nfunction showReviveAnimation(){const reviveOverlay=document.createElement('div');reviveOverlay.style.cssText=`\n        position: fixed;\n        top: 0;\n        left: 0;\n        width: 100%;\n        height: 100%;\n        background: rgba(0,0,0,0.9);\n        display: flex;\n        flex-direction: column;\n        align-items: center;\n        justify-content: center;\n        z-index: 2000;\n        animation: fadeIn 0.5s ease;\n    `;reviveOverlay.innerHTML=`\n        <div style=\"font-size: 6rem; animation: bounce 1s ease infinite; text-shadow: 0 0 30px rgba(46,204,113,0.8);\">🌱</div>\n        <div style=\"color: #2ecc71; font-size: 2rem; font-weight: bold; margin-top: 1.5rem; text-align: center; text-shadow: 0 2px 10px rgba(0,0,0,0.5);\">\n            Plant Revived!\n        </div>\n        <div style=\"color: white; font-size: 1.2rem; margin-top: 0.8rem; text-align: center; padding: 0 2rem;\">\n            You can plant again and start a new journey!\n        </div>\n    `;document.body.appendChild(reviveOverlay);state.plant.stage=0;state.plant.isWithered=false;updatePlant();setTimeout(()=>{reviveOverlay.style.animation='fadeOut 0.5s ease forwards';setTimeout(()=>reviveOverlay.remove(),500);},3000);}\nconst style=document.createElement('style');style.textContent=`\n    @keyframes heartPop {\n        0% { transform: translate(-50%, -50%) scale(0); opacity: 1; }\n        50% { transform: translate(-50%, -50%) scale(1.5); opacity: 1; }\n        100% { transform: translate(-50%, -50%) scale(1); opacity: 0; }\n    }\n    @keyframes fadeIn {\n        from { opacity: 0; }\n        to { opacity: 1; }\n    }\n    @keyframes fadeOut {\n        from { opacity: 1; }\n        to { opacity: 0; }\n    }\n    @keyframes bounce {\n        0%, 100% { transform: translateY(0); }\n        50% { transform: translateY(-20px); }\n    }\n`;document.head.appendChild(style);function showToast(message,type='success'){elements.toastIcon.textContent=type==='success'?'+':'!';elements.toastMessage.textContent=message;elements.toast.className=`toast ${type} show`;setTimeout(()=>{elements.toast.classList.remove('show');},3000);}\nfunction showModal(icon,title,message,onConfirm){elements.modalIcon.textContent=icon;elements.modalTitle.textContent=title;elements.modalMessage.textContent=message;elements.modalOverlay.classList.add('show');elements.modalConfirm.onclick=()=>{hideModal();if(onConfirm)onConfirm();};}\nfunction hideModal(){elements.modalOverlay.classList.remove('show');state.showingConfirmModal=false;elements.modalConfirm.style.display='';elements.modalCancel.style.display='';elements.modalConfirm.textContent='Confirma';elements.modalCancel.textContent='Anuleaza';}\nfunction showFlipConfirmModal(){state.showingConfirmModal=true;state.flipCancelledWaitingFlipBack=false;elements.modalIcon.textContent='?';elements.modalTitle.textContent='Task Complete?';elements.modalMessage.textContent='Did you finish the task, or was the flip accidental?';elements.modalConfirm.textContent='Yes, I finished!';elements.modalCancel.textContent='Accidental flip';elements.modalConfirm.style.display='inline-block';elements.modalCancel.style.display='inline-block';elements.modalOverlay.classList.add('show');elements.modalConfirm.onclick=()=>{hideModal();sendAction({action:'confirmComplete'});showToast('Congratulations! Task completed!','success');state.selectedTaskId=0;renderTasks();};elements.modalCancel.onclick=()=>{state.flipCancelledWaitingFlipBack=true;elements.modalIcon.textContent='↻';elements.modalTitle.textContent='Flip back to resume';elements.modalMessage.textContent='Flip the cube face-down to continue your focus session.';elements.modalConfirm.style.display='none';elements.modalCancel.style.display='none';sendAction({action:'cancelComplete'});};}\nfunction updateClock(){const now=new Date();const hours=String(now.getHours()).padStart(2,'0');const minutes=String(now.getMinutes()).padStart(2,'0');elements.currentTime.textContent=`${hours}:${minutes}`;}\nfunction startLocalTimer(){setInterval(()=>{if(!state.wsConnected&&!state.eventsConnected&&state.timeLeft>0&&(state.status==='focusing'||state.status==='break')){state.timeLeft--;updateTimerDisplay();if(state.timeLeft===0){handleTimerComplete();}}},1000);}\nfunction handleTimerComplete(){if(state.status==='focusing'){const activeTask=state.tasks.find(t=>t.active);const breakDuration=activeTask?activeTask.breakDuration:5;showToast('Focus terminat! Ia o pauza!','success');state.status='break';state.timeLeft=breakDuration*60;state.totalTime=breakDuration*60;updateStatus({state:'break',taskName:'Pauza',timeLeft:state.timeLeft,totalTime:state.totalTime});}else if(state.status==='break'){const activeTask=state.tasks.find(t=>t.active);if(activeTask){state.status='focusing';state.timeLeft=activeTask.focusDuration*60;state.totalTime=activeTask.focusDuration*60;state.currentTask=activeTask.name;updateStatus({state:'focusing',taskName:activeTask.name,timeLeft:state.timeLeft,totalTime:state.totalTime});showToast('Pauza terminata! Continua cu focus!','success');}else{state.status='idle';state.timeLeft=0;state.currentTask=null;updateStatus({state:'idle',taskName:''});renderTasks();}}}\nasync function fetchWeeklyStats(){if(isDevMode()){updateWeeklyStats({weekly:{totalTasks:0,totalFocus:0,avgTasksPerDay:0,mostProductiveDayName:'-'},days:[]});return;}\ntry{const response=await fetch(`${CONFIG.API_BASE}/api/stats`);const data=Messages.decodeStats(await response.json());updateWeeklyStats(data);}catch(e){console.error('Failed to fetch weekly stats:',e);}}\nfunction updateWeeklyStats(data){if(!data)return;if(data.todayTasks!==undefined||data.todayFocus!==undefined){state.stats.completed=data.todayTasks||0;state.stats.focusMinutes=data.todayFocus||0;elements.tasksCompleted.textContent=state.stats.completed;elements.focusTotal.textContent=state.stats.focusMinutes;const total=state.tasks.length||state.stats.total||1;const percent=Math.round((state.stats.completed/total)*100);elements.progressPercent.textContent=`${percent}%`;elements.progressFill.style.width=`${percent}%`;}\nif(!data.weekly)return;const weekly=data.weekly;if(elements.weeklyTasks)elements.weeklyTasks.textContent=weekly.totalTasks||0;if(elements.weeklyFocus)elements.weeklyFocus.textContent=weekly.totalFocus||0;if(elements.weeklyAvg)elements.weeklyAvg.textContent=(weekly.avgTasksPerDay||0).toFixed(1);if(elements.bestDay)elements.bestDay.textContent=weekly.mostProductiveDayName||'-';if(elements.weeklyChart&&data.days){renderWeeklyChart(data.days);}}\nfunction renderWeeklyChart(days){if(!elements.weeklyChart)return;const dayNames=['Dum','Lun','Mar','Mie','Joi','Vin','Sam'];const today=new Date().getDay();const maxTasks=Math.max(...days.map(d=>d.tasks||0),1);let html='';for(let i=6;i>=0;i--){const dayData=days.find(d=>d.daysAgo===i)||{tasks:0,focus:0,valid:false};const height=dayData.valid?Math.max((dayData.tasks/maxTasks)*100,8):8;const dayIndex=(today-i+7)%7;const isToday=i===0;html+=`<div class=\"chart-bar ${isToday ? 'today' : ''} ${dayData.valid ? 'has-data' : ''}\" \n                      style=\"height: ${height}%\" \n                      data-day=\"${dayNames[dayIndex]}\"\n                      onclick=\"showDayDetails(${i}, ${dayData.tasks || 0}, ${dayData.focus || 0}, '${dayNames[dayIndex]}')\"\n                      title=\"${dayData.tasks || 0} task-uri, ${dayData.focus || 0} min focus\"></div>`;}\nelements.weeklyChart.innerHTML=html;}\nfunction showDayDetails(daysAgo,tasks,focus,dayName){const label=daysAgo===0?'Azi':(daysAgo===1?'Ieri':dayName);const hours=Math.floor(focus/60);const mins=focus%60;const focusStr=hours>0?`${hours}h ${mins}m`:`${mins} min`;showToast(`${label}: ${tasks} task-uri, ${focusStr} focus`,'success');}\nfunction syncTimeFromPhone(){const now=new Date();const hours=now.getHours();const minutes=now.getMinutes();const seconds=now.getSeconds();const day=now.getDate();const month=now.getMonth()+1;const year=now.getFullYear();sendWebSocketMessage({action:'setTime',hours:hours,minutes:minutes,seconds:seconds,day:day,month:month,year:year});showToast(`Ora sincronizata: ${String(hours).padStart(2, '0')}:${String(minutes).padStart(2, '0')}`,'success');}\nfunction resetDay(){showModal('⚠️','Resetare Zi','Aceasta va reseta toate task-urile si planta pentru o zi noua. Esti sigur?',()=>{sendAction({action:'restartDay'});state.tasks=[];state.plant.stage=0;state.pendingWater=0;state.wateredCount=0;state.dailyGoal=0;state.goalLocked=false;state.status='idle';state.timeLeft=0;renderTasks();updatePlant();updateStatus({state:'idle',taskName:''});showToast('Zi resetata! Incepe o zi noua!','success');});}\nfunction loadMockData(){state.tasks=[];state.plant.stage=0;state.plant.isWithered=false;state.pendingWater=0;state.wateredCount=0;state.dailyGoal=0;state.currentSessionGoal=0;state.goalLocked=false;state.status='idle';state.timeLeft=0;state.totalTime=0;state.currentTask=null;state.stats={completed:0,total:0,focusMinutes:0};if(elements.dailyGoalInput){elements.dailyGoalInput.value=3;}\nif(elements.btnWater){elements.btnWater.disabled=true;}\nrenderTasks();updatePlant();updateStats(state.stats);updateStatus({state:'idle',taskName:null,timeLeft:0,totalTime:0});elements.espIP.textContent='Dev Mode';}\nfunction handleMockAction(action){console.log('Mock action:',action);return{success:true};}\nfunction initEventListeners(){elements.btnAddTask.addEventListener('click',addTask);elements.taskName.addEventListener('keypress',(e)=>{if(e.key==='Enter')addTask();});if(elements.btnSetGoal){elements.btnSetGoal.addEventListener('click',setDailyGoal);}\nif(elements.dailyGoalInput){elements.dailyGoalInput.addEventListener('keypress',(e)=>{if(e.key==='Enter')setDailyGoal();});}\nelements.taskItems.addEventListener('click',handleTaskListClick);elements.btnWater.addEventListener('click',waterPlant);elements.btnKill.addEventListener('click',killPlant);if(elements.btnSyncTime){elements.btnSyncTime.addEventListener('click',syncTimeFromPhone);}\nif(elements.btnResetDay){elements.btnResetDay.addEventListener('click',resetDay);}\nif(elements.btnScreenMirror){elements.btnScreenMirror.addEventListener('click',toggleScreenMirror);}\nelements.modalOverlay.addEventListener('click',(e)=>{if(e.target===elements.modalOverlay&&!state.flipCancelledWaitingFlipBack){hideModal();}});document.addEventListener('touchend',(e)=>{const now=Date.now();if(now-(window.lastTouchEnd||0)<300){e.preventDefault();}\nwindow.lastTouchEnd=now;},false);}\nfunction init(){console.log('🌱 Productivity Bloom initializing...');initEventListeners();updateClock();setInterval(updateClock,1000);if('serviceWorker'in navigator&&window.isSecureContext){navigator.serviceWorker.register('/sw.js').catch(e=>{console.log('Service worker not registered:',e);});}\nconnectWebSocket();startLocalTimer();console.log('Fetching initial status...');fetchStatus();fetchTasks();fetchWeeklyStats();console.log('🌱 Productivity Bloom ready!');}\nif(document.readyState==='loading'){document.addEventListener('DOMContentLoaded',init);}else{init();}</script>\n</body>\n</html>";
+
+const char MANIFEST_JSON[] PROGMEM = "{\"name\":\"Productivity Bloom\",\"short_name\":\"Bloom\",\"start_url\":\"/\",\"scope\":\"/\",\"display\":\"standalone\",\"background_color\":\"#1a1a2e\",\"theme_color\":\"#2ecc71\",\"icons\":[{\"src\":\"/icon.svg\",\"sizes\":\"any\",\"type\":\"image/svg+xml\"}]}";
+
+const char ICON_SVG[] PROGMEM = "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 64 64\"><rect width=\"64\" height=\"64\" rx=\"12\" fill=\"#1a1a2e\"/><path d=\"M32 54V30\" stroke=\"#2ecc71\" stroke-width=\"4\" stroke-linecap=\"round\"/><path d=\"M32 38c-10 0-16-6-16-14 10 0 16 6 16 14zm0-6c0-10 6-16 16-16 0 10-6 16-16 16z\" fill=\"#2ecc71\"/></svg>";
+
+const char SERVICE_WORKER_JS[] PROGMEM = "const CACHE_NAME='bloom-a630a33ed355';const APP_SHELL=['/','/manifest.json','/icon.svg'];self.addEventListener('install',(event)=>{event.waitUntil(caches.open(CACHE_NAME).then(cache=>cache.addAll(APP_SHELL)).then(()=>self.skipWaiting()));});self.addEventListener('activate',(event)=>{event.waitUntil(caches.keys().then(keys=>Promise.all(keys.filter(k=>k!==CACHE_NAME).map(k=>caches.delete(k)))).then(()=>self.clients.claim()));});self.addEventListener('fetch',(event)=>{const url=new URL(event.request.url);if(event.request.method!=='GET'||url.origin!==self.location.origin)return;if(!APP_SHELL.includes(url.pathname))return;event.respondWith(caches.match(url.pathname).then(cached=>cached||fetch(event.request)));});";
 
 #endif
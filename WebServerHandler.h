@@ -9,10 +9,25 @@
 #include <ArduinoJson.h>
 #include <time.h>
 #include <sys/time.h>   // For settimeofday
+#include <nvs.h>        // nvs_get_stats for /api/flash
 #include "config.h"
+#include "FeatureProfile.h"
 #include "SystemState.h"
 #include "WebContent.h"  // Embedded HTML/CSS/JS
 #include "Analytics.h"   // Weekly stats
+#include "WebActions.h"  // Action dispatch shared by WebSocket and REST
+#include "FrameMirror.h" // OLED screen mirroring
+#include "LoopStats.h"   // Main loop timing for /api/perf
+#include "LatencyTrace.h" // Stage timing for /api/latency
+#include "NvsWriteLog.h"  // NVS write trace for /api/flash
+#include "ScenarioRunner.h" // Scripted runs for /api/scenario
+#include "HeapTracker.h"    // Allocation sites for /api/heap
+#include "InputJournal.h"   // Input journal for /api/journal
+#include "EventStream.h"    // Server-Sent Events for /api/events
+#include "StateMessages.h"  // Generated message writers (messages.json)
+#include "KeepAliveWebServer.h" // Persistent HTTP connections
+#include "DisplayPowerManager.h" // OLED contrast/sleep for /api/display
+#include "BackupArchive.h"    // Archive for /api/backup and /api/restore
 
 // Forward declaration
 extern Analytics analytics;
@@ -51,11 +66,33 @@ public:
     void broadcastPlant();
     void broadcastTasks();
     void broadcastRevive();  // Special message when plant is revived
+    void broadcastStats();   // Analytics changed (STATS_CHANGED)
+
+    // OLED mirror: called by the renderer after each committed frame
+    void publishFrame(const uint8_t* tiles, bool rotated);
+
+    // Flip the cube in software (POST /api/latency)
+    void onSyntheticFlip(std::function<void()> callback) { syntheticFlipCallback = callback; }
+
+    // Scripted scenarios (POST /api/scenario)
+    void setScenarioRunner(ScenarioRunner* runner) { scenarioRunner = runner; }
+
+    // Handle a JSON action as if a WebSocket client had sent it
+    void injectMessage(const char* json) {
+        handleWebSocketMessage(LOCAL_CLIENT, (uint8_t*)json, strlen(json));
+    }
+
+    // Outgoing WebSocket messages since the last call
+    uint32_t takeWsMessageCount() {
+        uint32_t count = wsMessagesSent;
+        wsMessagesSent = 0;
+        return count;
+    }
 
 private:
-    WebServer server;
+    KeepAliveWebServer server;
     WebSocketsServer webSocket;
-    DNSServer dnsServer;  // For captive portal
+    Subsystem<Features::captivePortal, DNSServer> dnsServer;
 
     SystemState* systemState;  // Single source of truth
 
@@ -65,9 +102,50 @@ private:
     uint8_t lastMinute;
     uint32_t lastBroadcast;
 
+    // OLED mirror (only encodes while someone is subscribed)
+    FrameMirror frameMirror;
+    uint32_t screenSubscribers;     // Bit per WebSocket client number
+    const uint8_t* screenTiles;     // Last committed frame (U8g2 buffer)
+    bool screenRotated;
+
+    uint32_t wsMessagesSent;
+    EventStream eventStream;
+    void broadcastText(const char* message, size_t length, EventStream::Topic topic, const char* event);
+
+    // Outgoing JSON is written here, one message at a time (all on the loop task)
+    char messageBuffer[MESSAGE_BUFFER_SIZE];
+    TaskMsg taskMsgs[MAX_TASKS];
+    template <typename Msg> size_t serialize(const Msg& msg);
+    void sendMessage(int code, size_t length);
+
+    // Stats message, rebuilt only after Analytics records something
+    char statsJson[STATS_BUFFER_SIZE];
+    size_t statsLength;
+    bool statsDirty;
+    const char* getStatsJson();
+
+    // Optimistic concurrency: actions carrying "ver" apply only on that version
+    bool versionMatches(JsonDocument& request);
+    StatusMsg deltaStatus;
+    PlantMsg deltaPlant;
+    template <typename Reply> void fillDelta(Reply& reply, uint32_t clientVer);
+    void sendAck(uint8_t num, JsonDocument& request, bool ok);
+    void sendActionReply(JsonDocument& request, const char* action, bool applied);
+
+    std::function<void()> syntheticFlipCallback;
+    ScenarioRunner* scenarioRunner;
+
+    // Backup being sent, or restore being decoded (one request at a time)
+    BackupImage backupImage;
+    BackupReader restoreReader;
+
+    static const uint8_t LOCAL_CLIENT = 31;  // Client number for injected messages
+
     // Route handlers
     void setupRoutes();
     void handleRoot();
+    bool notModified();
+    void sendShellFile(const char* contentType, PGM_P content);
     void handleApiStatus();
     void handleApiTasks();
     void handleApiAddTask();
@@ -76,6 +154,20 @@ private:
     void handleApiToggleTask();
     void handleApiAction();
     void handleApiStats();
+    void handleApiScreen();
+    void handleApiPerf();
+    void handleApiDisplay();
+    void handleApiProfile();
+    void handleApiLatency();
+    void handleApiLatencyRun();
+    void handleApiFlash();
+    void handleApiScenario();
+    void handleApiHeap();
+    void handleApiJournal();
+    void handleApiBackup();
+    void handleApiRestore();
+    void handleRestoreBody();
+    void handleApiEvents();
     void handleNotFound();
 
     // WebSocket handlers
@@ -95,21 +187,32 @@ WebServerHandler::WebServerHandler(SystemState* state)
     timeSynced = false;
     lastMinute = 255;
     lastBroadcast = 0;
+    screenSubscribers = 0;
+    screenTiles = nullptr;
+    screenRotated = false;
+    wsMessagesSent = 0;
+    scenarioRunner = nullptr;
+    statsLength = 0;
+    statsDirty = true;
 }
 
 void WebServerHandler::begin() {
     // No filesystem needed - using embedded content
     DEBUG_PRINTLN("Using embedded web content");
 
-    // Connect to WiFi
-    if (connectWiFi()) {
-        syncTime();
-    } else {
+    // Connect to WiFi, own access point as the fallback
+    bool joined = false;
+    if constexpr (Features::stationWifi) {
+        joined = connectWiFi();
+        if (joined) syncTime();
+    }
+    if (!joined) {
         setupAP();
     }
 
     // Setup HTTP routes
     setupRoutes();
+    eventStream.begin();
 
     // Setup WebSocket
     webSocket.begin();
@@ -130,12 +233,15 @@ void WebServerHandler::loop() {
     
     // Handle HTTP requests
     server.handleClient();
+    eventStream.loop();
     
     // Process DNS requests frequently in AP mode (critical for captive portal!)
     // DNS must respond quickly or phone will timeout and show "no internet"
-    if (!wifiConnected) {
-        // Process DNS on every loop iteration for fast response
-        dnsServer.processNextRequest();
+    if constexpr (Features::captivePortal) {
+        if (!wifiConnected) {
+            // Process DNS on every loop iteration for fast response
+            dnsServer->processNextRequest();
+        }
     }
 
     // Periodic status broadcast
@@ -181,7 +287,7 @@ bool WebServerHandler::connectWiFi() {
 }
 
 void WebServerHandler::setupAP() {
-    DEBUG_PRINTLN("Setting up Access Point with Captive Portal...");
+    DEBUG_PRINTLN("Setting up Access Point...");
     WiFi.mode(WIFI_AP);
     
     // Configure AP with specific settings for better captive portal detection
@@ -195,11 +301,13 @@ void WebServerHandler::setupAP() {
     
     // Start DNS server for captive portal - redirects ALL domains to ESP32
     // The "*" pattern matches any domain name query
-    dnsServer.setErrorReplyCode(DNSReplyCode::NoError);
-    dnsServer.start(DNS_PORT, "*", WiFi.softAPIP());
-    
+    if constexpr (Features::captivePortal) {
+        dnsServer->setErrorReplyCode(DNSReplyCode::NoError);
+        dnsServer->start(DNS_PORT, "*", WiFi.softAPIP());
+        DEBUG_PRINTLN("Captive Portal active - all domains redirect to ESP32");
+    }
+
     DEBUG_PRINTF("AP IP: %s\n", WiFi.softAPIP().toString().c_str());
-    DEBUG_PRINTLN("Captive Portal active - all domains redirect to ESP32");
     DEBUG_PRINTLN("Connect to WiFi 'ProductivityBloom' password 'bloom2024'");
 }
 
@@ -221,6 +329,7 @@ void WebServerHandler::syncTime() {
     struct tm timeinfo;
     if (::getLocalTime(&timeinfo, 5000)) {
         timeSynced = true;
+        inputJournal.recordTimeSync(false, time(nullptr));
         DEBUG_PRINTF("Time synced: %02d:%02d:%02d\n",
                      timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
     } else {
@@ -261,85 +370,98 @@ void WebServerHandler::setupRoutes() {
 
     // Serve embedded HTML (includes CSS and JS inline)
     server.on("/", HTTP_GET, [this]() { handleRoot(); });
-    
-    // ============================================
-    // CAPTIVE PORTAL DETECTION ENDPOINTS
-    // These trick the phone into thinking it has internet
-    // so it doesn't show the annoying captive portal popup
-    // ============================================
-    
-    // Apple iOS/macOS - redirect to main page so the captive portal shows our app
-    // After user interacts, we'll respond with Success to keep connection stable
-    server.on("/hotspot-detect.html", HTTP_GET, [this]() { 
-        // If user already connected to web interface, return Success to keep connection
-        if (webClientConnected) {
-            server.send(200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>");
-        } else {
-            // First time - redirect to our app so it opens in captive portal popup
-            server.sendHeader("Location", "http://192.168.4.1/");
-            server.send(302, "text/html", "");
-        }
+
+    // App shell extras: install manifest + service worker (see data/sw.js)
+    server.on("/manifest.json", HTTP_GET, [this]() {
+        sendShellFile("application/manifest+json", MANIFEST_JSON);
     });
-    server.on("/library/test/success.html", HTTP_GET, [this]() { 
-        if (webClientConnected) {
-            server.send(200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>");
-        } else {
-            server.sendHeader("Location", "http://192.168.4.1/");
-            server.send(302, "text/html", "");
-        }
+    server.on("/icon.svg", HTTP_GET, [this]() {
+        sendShellFile("image/svg+xml", ICON_SVG);
     });
-    server.on("/captive-portal/api/v1/status", HTTP_GET, [this]() { 
-        server.send(200, "application/json", "{\"success\":true}");
-        webClientConnected = true;
+    server.on("/sw.js", HTTP_GET, [this]() {
+        sendShellFile("application/javascript", SERVICE_WORKER_JS);
     });
     
-    // Android - MUST return exactly 204 with empty body
-    // Google connectivity check endpoints
-    server.on("/generate_204", HTTP_GET, [this]() { 
-        server.send(204, "", "");
-        webClientConnected = true;
-    });
-    server.on("/gen_204", HTTP_GET, [this]() { 
-        server.send(204, "", "");
-        webClientConnected = true;
-    });
-    // Additional Android endpoints
-    server.on("/mobile/status.php", HTTP_GET, [this]() { 
-        server.send(204, "", "");
-        webClientConnected = true;
-    });
-    server.on("/connectivity-check.html", HTTP_GET, [this]() { 
-        server.send(204, "", "");
-        webClientConnected = true;
-    });
-    server.on("/check_network_status.txt", HTTP_GET, [this]() { 
-        server.send(204, "", "");
-        webClientConnected = true;
-    });
+    if constexpr (Features::captivePortal) {
+        // ============================================
+        // CAPTIVE PORTAL DETECTION ENDPOINTS
+        // These trick the phone into thinking it has internet
+        // so it doesn't show the annoying captive portal popup
+        // ============================================
     
-    // Windows NCSI - return expected responses
-    server.on("/ncsi.txt", HTTP_GET, [this]() { 
-        server.send(200, "text/plain", "Microsoft NCSI");
-        webClientConnected = true;
-    });
-    server.on("/connecttest.txt", HTTP_GET, [this]() { 
-        server.send(200, "text/plain", "Microsoft Connect Test");
-        webClientConnected = true;
-    });
-    server.on("/redirect", HTTP_GET, [this]() { 
-        server.send(200, "text/plain", "Microsoft NCSI");
-        webClientConnected = true;
-    });
+        // Apple iOS/macOS - redirect to main page so the captive portal shows our app
+        // After user interacts, we'll respond with Success to keep connection stable
+        server.on("/hotspot-detect.html", HTTP_GET, [this]() { 
+            // If user already connected to web interface, return Success to keep connection
+            if (webClientConnected) {
+                server.send(200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>");
+            } else {
+                // First time - redirect to our app so it opens in captive portal popup
+                server.sendHeader("Location", "http://192.168.4.1/");
+                server.send(302, "text/html", "");
+            }
+        });
+        server.on("/library/test/success.html", HTTP_GET, [this]() { 
+            if (webClientConnected) {
+                server.send(200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>");
+            } else {
+                server.sendHeader("Location", "http://192.168.4.1/");
+                server.send(302, "text/html", "");
+            }
+        });
+        server.on("/captive-portal/api/v1/status", HTTP_GET, [this]() { 
+            server.send(200, "application/json", "{\"success\":true}");
+            webClientConnected = true;
+        });
     
-    // Firefox
-    server.on("/success.txt", HTTP_GET, [this]() { 
-        server.send(200, "text/plain", "success");
-        webClientConnected = true;
-    });
-    server.on("/canonical.html", HTTP_GET, [this]() { 
-        server.send(200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>");
-        webClientConnected = true;
-    });
+        // Android - MUST return exactly 204 with empty body
+        // Google connectivity check endpoints
+        server.on("/generate_204", HTTP_GET, [this]() { 
+            server.send(204, "", "");
+            webClientConnected = true;
+        });
+        server.on("/gen_204", HTTP_GET, [this]() { 
+            server.send(204, "", "");
+            webClientConnected = true;
+        });
+        // Additional Android endpoints
+        server.on("/mobile/status.php", HTTP_GET, [this]() { 
+            server.send(204, "", "");
+            webClientConnected = true;
+        });
+        server.on("/connectivity-check.html", HTTP_GET, [this]() { 
+            server.send(204, "", "");
+            webClientConnected = true;
+        });
+        server.on("/check_network_status.txt", HTTP_GET, [this]() { 
+            server.send(204, "", "");
+            webClientConnected = true;
+        });
+    
+        // Windows NCSI - return expected responses
+        server.on("/ncsi.txt", HTTP_GET, [this]() { 
+            server.send(200, "text/plain", "Microsoft NCSI");
+            webClientConnected = true;
+        });
+        server.on("/connecttest.txt", HTTP_GET, [this]() { 
+            server.send(200, "text/plain", "Microsoft Connect Test");
+            webClientConnected = true;
+        });
+        server.on("/redirect", HTTP_GET, [this]() { 
+            server.send(200, "text/plain", "Microsoft NCSI");
+            webClientConnected = true;
+        });
+    
+        // Firefox
+        server.on("/success.txt", HTTP_GET, [this]() { 
+            server.send(200, "text/plain", "success");
+            webClientConnected = true;
+        });
+        server.on("/canonical.html", HTTP_GET, [this]() { 
+            server.send(200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>");
+            webClientConnected = true;
+        });
+    }
 
     // API: Get status
     server.on("/api/status", HTTP_GET, [this]() { handleApiStatus(); });
@@ -356,6 +478,54 @@ void WebServerHandler::setupRoutes() {
     // API: Stats
     server.on("/api/stats", HTTP_GET, [this]() { handleApiStats(); });
 
+    // API: Current OLED frame as PBM image
+    server.on("/api/screen", HTTP_GET, [this]() { handleApiScreen(); });
+
+    // API: Main loop timing (for load testing)
+    server.on("/api/perf", HTTP_GET, [this]() { handleApiPerf(); });
+
+    // API: Build profile and its footprint
+    server.on("/api/profile", HTTP_GET, [this]() { handleApiProfile(); });
+
+    // API: OLED contrast, sleep state and estimated current
+    if constexpr (Features::oled) {
+        server.on("/api/display", HTTP_GET, [this]() { handleApiDisplay(); });
+    }
+
+    // API: Last flip / web action latency by stage
+    server.on("/api/latency", HTTP_GET, [this]() { handleApiLatency(); });
+#if LATENCY_RUN
+    // API: Synthetic traced flip (starts / pauses sessions, so test builds only)
+    server.on("/api/latency", HTTP_POST, [this]() { handleApiLatencyRun(); });
+#endif
+
+    // API: NVS usage + write trace (?since=<seq> pages through the log)
+    server.on("/api/flash", HTTP_GET, [this]() { handleApiFlash(); });
+
+#if SCENARIO_RUNNER
+    // API: Run a scenario script on virtual time (body = script text)
+    server.on("/api/scenario", HTTP_POST, [this]() { handleApiScenario(); });
+#endif
+
+    // API: Heap fragmentation + allocation sites (?offset=<n>, ?reset=1)
+    server.on("/api/heap", HTTP_GET, [this]() { handleApiHeap(); });
+
+    // API: Raw input journal (binary, decode with journal_replay.py)
+    server.on("/api/journal", HTTP_GET, [this]() { handleApiJournal(); });
+
+    // API: Backup archive (binary, see BackupArchive.h / backup_tool.py)
+    server.on("/api/backup", HTTP_GET, [this]() { handleApiBackup(); });
+    server.on("/api/restore", HTTP_POST, [this]() { handleApiRestore(); },
+              [this]() { handleRestoreBody(); });
+
+    // API: Server-Sent Events for read-only displays (Last-Event-ID resumes)
+    server.on("/api/events", HTTP_GET, [this]() { handleApiEvents(); });
+
+    // Request headers the handlers read (the WebServer drops the rest);
+    // Connection decides keep-alive
+    static const char* headerKeys[] = { "Last-Event-ID", "If-None-Match", "Connection" };
+    server.collectHeaders(headerKeys, 3);
+
     // 404 handler
     server.onNotFound([this]() { handleNotFound(); });
 }
@@ -367,10 +537,11 @@ void WebServerHandler::handleRoot() {
     // Debug: show free heap
     DEBUG_PRINTF("handleRoot: Free heap = %d bytes\n", ESP.getFreeHeap());
     
-    // IMPORTANT: No-cache headers to prevent Safari caching issues
-    server.sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-    server.sendHeader("Pragma", "no-cache");
-    server.sendHeader("Expires", "0");
+    // Returning phones revalidate: same build = 304, no 70 KB resend
+    if (notModified()) {
+        DEBUG_PRINTLN("handleRoot: Not modified");
+        return;
+    }
     
     // Add CORS headers for WebSocket connectivity in AP mode
     server.sendHeader("Access-Control-Allow-Origin", "*");
@@ -404,58 +575,39 @@ void WebServerHandler::handleRoot() {
     DEBUG_PRINTLN("handleRoot: Done sending");
 }
 
+// "no-cache" still lets the browser keep the page, it just has to ask
+// first (Safari used to show stale pages with plain caching). The ETag is
+// the build's content hash from build_webcontent.py.
+bool WebServerHandler::notModified() {
+    static const char ETAG[] = "\"" WEB_CONTENT_VERSION "\"";
+    server.sendHeader("Cache-Control", "no-cache");
+    server.sendHeader("ETag", ETAG);
+    if (server.header("If-None-Match") != ETAG) return false;
+    server.send(304, "text/plain", "");
+    return true;
+}
+
+void WebServerHandler::sendShellFile(const char* contentType, PGM_P content) {
+    if (notModified()) return;
+    server.send_P(200, contentType, content);
+}
+
 void WebServerHandler::handleApiStatus() {
     DEBUG_PRINTLN("API: /api/status called");
     // CORS for AP mode
     server.sendHeader("Access-Control-Allow-Origin", "*");
     
-    StaticJsonDocument<512> doc;
-    JsonObject root = doc.to<JsonObject>();
-
-    root["state"] = systemState->getModeString();
-    root["timeLeft"] = systemState->getTimeLeft();
-    root["totalTime"] = systemState->getTotalTime();
-
-    const char* taskName = systemState->getCurrentTaskName();
-    root["taskName"] = taskName ? taskName : (char*)nullptr;
-
-    JsonObject plantObj = root.createNestedObject("plant");
-    PlantInfo plant = systemState->getPlantInfo();
-    plantObj["stage"] = plant.stage;
-    plantObj["isWithered"] = plant.isWithered;
-    plantObj["canWater"] = plant.canWater;
-    plantObj["wateredCount"] = plant.wateredCount;
-    plantObj["totalGoal"] = plant.totalGoal;
-    plantObj["pendingWater"] = systemState->getPendingWaterCount();
-    plantObj["dailyGoal"] = systemState->getDailyGoal();
-
-    JsonObject statsObj = root.createNestedObject("stats");
-    statsObj["completed"] = systemState->getCompletedCount();
-    statsObj["total"] = systemState->getTaskCount();
-
-    String response;
-    serializeJson(doc, response);
-    server.send(200, "application/json", response);
+    ApiStatusMsg msg;
+    fillApiStatus(msg, systemState);
+    sendMessage(200, serialize(msg));
 }
 
 void WebServerHandler::handleApiTasks() {
-    StaticJsonDocument<1024> doc;
-    JsonArray tasksArray = doc.createNestedArray("tasks");
-
-    TaskInfo* tasks = systemState->getTasks();
-    for (int i = 0; i < systemState->getTaskCount(); i++) {
-        JsonObject task = tasksArray.createNestedObject();
-        task["id"] = tasks[i].id;
-        task["name"] = tasks[i].name;
-        task["focusDuration"] = tasks[i].focusDuration;
-        task["breakDuration"] = tasks[i].breakDuration;
-        task["completed"] = tasks[i].completed;
-        task["started"] = tasks[i].started;
-    }
-
-    String response;
-    serializeJson(doc, response);
-    server.send(200, "application/json", response);
+    ApiTasksMsg msg;
+    msg.tasks = taskMsgs;
+    msg.tasksCount = fillTasks(taskMsgs, systemState);
+    msg.ver = systemState->getVersion();
+    sendMessage(200, serialize(msg));
 }
 
 void WebServerHandler::handleApiAddTask() {
@@ -476,6 +628,7 @@ void WebServerHandler::handleApiAddTask() {
     uint16_t focus = doc["focusDuration"] | 25;
     uint16_t breakTime = doc["breakDuration"] | 5;
 
+    inputJournal.recordAddTask(name, focus, breakTime);
     if (systemState->addTask(name, focus, breakTime)) {
         broadcastTasks();
         server.send(200, "application/json", "{\"success\":true}");
@@ -500,108 +653,414 @@ void WebServerHandler::handleApiAction() {
 
     const char* action = doc["action"];
 
-    if (strcmp(action, "water") == 0) {
-        systemState->waterPlant();
-        server.send(200, "application/json", "{\"success\":true,\"action\":\"water\"}");
+    // Stale version: nothing applied, the reply brings the client up to date
+    if (!versionMatches(doc)) {
+        ActionReplyMsg reply;
+        reply.success = false;
+        reply.hasOk = true;
+        reply.ok = false;
+        reply.hasVer = true;
+        fillDelta(reply, doc["ver"]);
+        sendMessage(409, serialize(reply));
+        return;
     }
-    else if (strcmp(action, "kill") == 0) {
-        systemState->killPlant();
-        systemState->clearAllTasks();  // Clear tasks on demo kill
-        analytics.forceDailyReset();   // Reset today's stats
-        broadcastTasks();              // Notify clients
-        broadcastStatus();
-        server.send(200, "application/json", "{\"success\":true,\"action\":\"kill\"}");
+
+    inputJournal.recordAction(action, doc["taskId"] | 0, doc["goal"] | 0);
+    if (strcmp(action, "addTask") == 0) {
+        // Same body as the WebSocket action (REST fallback of the web app)
+        inputJournal.recordAddTask(doc["task"]["name"] | "Untitled", doc["task"]["focusDuration"] | 25,
+                                   doc["task"]["breakDuration"] | 5);
     }
-    else if (strcmp(action, "pause") == 0) {
-        systemState->pauseTimer();
-        server.send(200, "application/json", "{\"success\":true,\"action\":\"pause\"}");
+
+    ActionResult result = applyWebAction(*systemState, analytics, doc);
+    if (result == ActionResult::UNKNOWN) {
+        server.send(400, "application/json", "{\"error\":\"Unknown action\"}");
+        return;
     }
-    else if (strcmp(action, "resume") == 0) {
-        systemState->resumeTimer();
-        server.send(200, "application/json", "{\"success\":true,\"action\":\"resume\"}");
+
+    if (strcmp(action, "kill") == 0) {
+        broadcastTasks();   // Notify clients
+        broadcastStatus();
+    } else if (strcmp(action, "restartDay") == 0) {
+        broadcastTasks();   // Notify clients that tasks are cleared
+        broadcastStatus();
+        broadcastPlant();
+    } else if (strcmp(action, "selectTask") == 0) {
+        broadcastStatus();
     }
-    else if (strcmp(action, "setGoal") == 0) {
-        uint8_t goal = doc["goal"] | 0;
-        systemState->setDailyGoal(goal);
-        server.send(200, "application/json", "{\"success\":true,\"action\":\"setGoal\"}");
+    sendActionReply(doc, action, result == ActionResult::APPLIED);
+}
+
+void WebServerHandler::handleApiStats() {
+    server.send(200, "application/json", getStatsJson());
+}
+
+// Same body for /api/stats, the "stats" WebSocket message and its SSE event
+const char* WebServerHandler::getStatsJson() {
+    if (!statsDirty) return statsJson;
+
+    StatsMsg msg;
+    DayMsg days[7];
+    fillStats(msg, days, analytics);
+
+    JsonWriter writer(statsJson, sizeof(statsJson));
+    writeJson(writer, msg);
+    if (!writer.ok()) DEBUG_PRINTLN("WebServer: Stats message truncated (STATS_BUFFER_SIZE)");
+    statsLength = writer.length();
+    statsDirty = false;
+    return statsJson;
+}
+
+void WebServerHandler::handleApiScreen() {
+    if (!screenTiles) {
+        server.send(503, "application/json", "{\"error\":\"No frame yet\"}");
+        return;
     }
-    else if (strcmp(action, "restartDay") == 0) {
-        systemState->restartDay();
-        analytics.forceDailyReset();  // Reset today's statistics too
-        broadcastTasks();   // Notify clients that tasks are cleared
-        broadcastStatus();  // Update status
-        broadcastPlant();   // Update plant state
-        server.send(200, "application/json", "{\"success\":true,\"action\":\"restartDay\"}");
-    }
-    else if (strcmp(action, "revive") == 0) {
-        systemState->revivePlant();
-        server.send(200, "application/json", "{\"success\":true,\"action\":\"revive\"}");
-    }
-    else if (strcmp(action, "selectTask") == 0) {
-        // Select task for flip control (prepare to start with MPU flip)
-        uint32_t taskId = doc["taskId"] | 0;
-        if (taskId > 0) {
-            systemState->selectTaskForFlip(taskId);
-            broadcastStatus();  // Notify clients
-            server.send(200, "application/json", "{\"success\":true,\"action\":\"selectTask\"}");
-        } else {
-            server.send(400, "application/json", "{\"error\":\"Invalid taskId\"}");
+
+    // PBM P4: 1 bit per pixel, MSB = leftmost, 1 = black.
+    // Written in the orientation the user reads, lit pixels white.
+    const char header[] = "P4\n128 128\n";
+    const size_t ROW_BYTES = 16;
+    server.setContentLength(sizeof(header) - 1 + ROW_BYTES * 128);
+    server.send(200, "image/x-portable-bitmap", "");
+    server.sendContent(header, sizeof(header) - 1);
+
+    uint8_t chunk[ROW_BYTES * 8];
+    for (uint8_t y0 = 0; y0 < 128; y0 += 8) {
+        for (uint8_t dy = 0; dy < 8; dy++) {
+            uint8_t y = y0 + dy;
+            for (uint8_t bx = 0; bx < ROW_BYTES; bx++) {
+                uint8_t bits = 0;
+                for (uint8_t b = 0; b < 8; b++) {
+                    uint8_t x = bx * 8 + b;
+                    uint8_t nx = screenRotated ? 127 - x : x;
+                    uint8_t ny = screenRotated ? 127 - y : y;
+                    bool lit = screenTiles[(ny >> 3) * 128 + nx] & (1 << (ny & 7));
+                    if (!lit) bits |= 0x80 >> b;
+                }
+                chunk[dy * ROW_BYTES + bx] = bits;
+            }
         }
+        server.sendContent((const char*)chunk, sizeof(chunk));
     }
-    else if (strcmp(action, "confirmComplete") == 0) {
-        // User confirms task completion after flip
-        systemState->confirmTaskComplete();
-        server.send(200, "application/json", "{\"success\":true,\"action\":\"confirmComplete\"}");
+}
+
+void WebServerHandler::handleApiPerf() {
+    StaticJsonDocument<384> doc;
+    doc["loopsPerSec"] = loopStats.loopsPerSec;
+    doc["avgSystemUs"] = loopStats.avgSystemUs;
+    doc["avgWebUs"] = loopStats.avgWebUs;
+    doc["avgAnalyticsUs"] = loopStats.avgAnalyticsUs;
+    doc["avgOledUs"] = loopStats.avgOledUs;
+    doc["maxWebUs"] = loopStats.maxWebUs;
+    doc["maxSensorGapMs"] = loopStats.maxSensorGapMs;
+    doc["wsMessagesPerSec"] = loopStats.wsMessagesPerSec;
+    doc["wsClients"] = webSocket.connectedClients();
+    doc["sseClients"] = eventStream.getClientCount();
+    doc["httpConnections"] = server.getOpenConnections();
+    doc["httpRequests"] = server.getRequestCount();
+    doc["httpReused"] = server.getReusedCount();
+    doc["freeHeap"] = ESP.getFreeHeap();
+    doc["minFreeHeap"] = ESP.getMinFreeHeap();
+
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
+}
+
+void WebServerHandler::handleApiDisplay() {
+    StaticJsonDocument<256> doc;
+    doc["contrast"] = displayPower->getContrast();
+    doc["light"] = displayPower->getLightLevel();
+    doc["asleep"] = displayPower->isAsleep();
+    doc["faceDown"] = displayPower->isFaceDown();
+    doc["litPixels"] = displayPower->getLitPixels();
+    doc["currentUa"] = displayPower->getCurrentMicroamps();
+    doc["avgCurrentUa"] = displayPower->getAverageMicroamps();
+    doc["asleepPercent"] = displayPower->getAsleepPercent();
+    doc["sleeps"] = displayPower->getSleepCount();
+
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
+}
+
+// Linker symbols bounding static RAM (ESP32 sections.ld)
+extern "C" char _data_start, _data_end, _bss_start, _bss_end;
+
+void WebServerHandler::handleApiProfile() {
+    StaticJsonDocument<384> doc;
+    doc["profile"] = Features::name;
+
+    JsonObject features = doc.createNestedObject("features");
+    features["oled"] = Features::oled;
+    features["mpu"] = Features::mpu;
+    features["buzzer"] = Features::buzzer;
+    features["stationWifi"] = Features::stationWifi;
+    features["captivePortal"] = Features::captivePortal;
+
+    doc["flashBytes"] = ESP.getSketchSize();
+    doc["staticRamBytes"] = (uint32_t)((&_data_end - &_data_start) + (&_bss_end - &_bss_start));
+    doc["freeHeap"] = ESP.getFreeHeap();
+    doc["avgLoopUs"] = loopStats.loopsPerSec ? 1000000 / loopStats.loopsPerSec : 0;
+    doc["avgOledUs"] = loopStats.avgOledUs;
+    doc["avgWebUs"] = loopStats.avgWebUs;
+
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
+}
+
+void WebServerHandler::handleApiLatency() {
+    StaticJsonDocument<512> doc;
+    doc["active"] = latencyTrace.isActive();
+
+    for (uint8_t k = 0; k < LatencyTrace::KIND_COUNT; k++) {
+        LatencyTrace::Kind kind = (LatencyTrace::Kind)k;
+        const LatencyTrace::Result& result = latencyTrace.last(kind);
+        JsonObject entry = doc.createNestedObject(LatencyTrace::kindName(kind));
+        entry["id"] = result.id;
+        entry["totalUs"] = result.totalUs;
+        JsonObject stages = entry.createNestedObject("stagesUs");
+        for (uint8_t s = 1; s < (uint8_t)LatencyStage::COUNT; s++) {
+            stages[LatencyTrace::stageName(s)] = result.stageUs[s];
+        }
     }
-    else if (strcmp(action, "cancelComplete") == 0) {
-        // User says flip was accidental
-        systemState->cancelTaskComplete();
-        server.send(200, "application/json", "{\"success\":true,\"action\":\"cancelComplete\"}");
+
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
+}
+
+void WebServerHandler::handleApiLatencyRun() {
+    if (!syntheticFlipCallback) {
+        server.send(503, "application/json", "{\"error\":\"Flip not available\"}");
+        return;
     }
-    else {
-        server.send(400, "application/json", "{\"error\":\"Unknown action\"}");
+
+    syntheticFlipCallback();
+
+    StaticJsonDocument<64> doc;
+    doc["success"] = true;
+    doc["trace"] = latencyTrace.id();
+
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
+}
+
+void WebServerHandler::handleApiFlash() {
+    static const uint8_t MAX_LOG_ENTRIES = 16;  // Per request; clients page with ?since
+
+    StaticJsonDocument<2560> doc;
+
+    nvs_stats_t stats;
+    if (nvs_get_stats(NULL, &stats) == ESP_OK) {
+        JsonObject nvs = doc.createNestedObject("nvs");
+        nvs["usedEntries"] = stats.used_entries;
+        nvs["freeEntries"] = stats.free_entries;
+        nvs["totalEntries"] = stats.total_entries;
+        nvs["namespaces"] = stats.namespace_count;
+    }
+
+    doc["uptimeMs"] = millis();
+    doc["writes"] = nvsWriteLog.getTotalWrites();
+    doc["bytes"] = nvsWriteLog.getTotalBytes();
+    doc["nextSeq"] = nvsWriteLog.nextSequence();
+
+    // [seq, ms, namespace, key, type, size, hash]
+    uint32_t since = server.hasArg("since") ? server.arg("since").toInt() : 0;
+    JsonArray log = doc.createNestedArray("log");
+    for (uint8_t i = 0; i < MAX_LOG_ENTRIES; i++) {
+        const NvsWrite* w = nvsWriteLog.find(since);
+        if (!w) break;
+        JsonArray entry = log.createNestedArray();
+        entry.add(w->seq);
+        entry.add(w->ms);
+        entry.add(nvsWriteLog.namespaceName(w->ns));
+        entry.add((const char*)w->key);
+        entry.add(w->type);
+        entry.add(w->size);
+        entry.add(w->hash);
+        since = w->seq + 1;
     }
+
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
 }
 
-void WebServerHandler::handleApiStats() {
-    StaticJsonDocument<512> doc;
-    
-    // Today's stats
-    DailyStats today = analytics.getTodayStats();
-    doc["todayTasks"] = today.tasksCompleted;
-    doc["todayFocus"] = today.focusMinutes;
-    doc["todayBreak"] = today.breakMinutes;
-    doc["todaySessions"] = today.sessionsCount;
-    
-    // Weekly report
-    WeeklyReport week = analytics.getWeeklyReport();
-    JsonObject weekly = doc.createNestedObject("weekly");
-    weekly["totalTasks"] = week.totalTasks;
-    weekly["totalFocus"] = week.totalFocusMinutes;
-    weekly["totalBreak"] = week.totalBreakMinutes;
-    weekly["totalSessions"] = week.totalSessions;
-    weekly["avgTasksPerDay"] = week.avgTasksPerDay;
-    weekly["avgFocusPerDay"] = week.avgFocusPerDay;
-    weekly["mostProductiveDay"] = week.mostProductiveDay;
-    weekly["mostProductiveTasks"] = week.mostProductiveTasks;
-    weekly["daysRecorded"] = week.daysRecorded;
-    weekly["hasFullWeek"] = week.hasFullWeek;
-    
-    // Day names for display
-    const char* dayNames[] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
-    weekly["mostProductiveDayName"] = dayNames[week.mostProductiveDay];
-    
-    // Daily breakdown (last 7 days)
-    JsonArray days = doc.createNestedArray("days");
-    for (int i = 0; i < 7; i++) {
-        DailyStats day = analytics.getDayStats(i);
-        JsonObject dayObj = days.createNestedObject();
-        dayObj["daysAgo"] = i;
-        dayObj["tasks"] = day.tasksCompleted;
-        dayObj["focus"] = day.focusMinutes;
-        dayObj["valid"] = day.valid;
+void WebServerHandler::handleApiScenario() {
+    if (!scenarioRunner) {
+        server.send(503, "application/json", "{\"error\":\"Scenarios not available\"}");
+        return;
+    }
+    if (!server.hasArg("plain")) {
+        server.send(400, "application/json", "{\"error\":\"No body\"}");
+        return;
+    }
+
+    inputJournal.recordScenario();
+    uint32_t start = millis();
+    bool passed = scenarioRunner->run(server.arg("plain").c_str());
+
+    StaticJsonDocument<1024> doc;
+    doc["passed"] = passed;
+    doc["steps"] = scenarioRunner->getSteps();
+    doc["simulatedS"] = scenarioRunner->getSimulatedSeconds();
+    doc["elapsedMs"] = millis() - start;
+    doc["failureCount"] = scenarioRunner->getTotalFailures();
+
+    JsonArray failures = doc.createNestedArray("failures");
+    for (uint8_t i = 0; i < scenarioRunner->getFailureCount(); i++) {
+        const ScenarioFailure& f = scenarioRunner->getFailure(i);
+        JsonObject entry = failures.createNestedObject();
+        entry["line"] = f.line;
+        entry["message"] = (const char*)f.message;
+    }
+
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
+}
+
+void WebServerHandler::handleApiJournal() {
+    if (!inputJournal.isAvailable()) {
+        server.send(503, "application/json", "{\"error\":\"No journal partition\"}");
+        return;
+    }
+
+    // Stream it: the whole journal does not fit in RAM
+    static uint8_t chunk[1024];
+    uint32_t size = inputJournal.size();
+    server.setContentLength(size);
+    server.send(200, "application/octet-stream", "");
+    for (uint32_t offset = 0; offset < size; offset += sizeof(chunk)) {
+        inputJournal.read(offset, chunk, sizeof(chunk));
+        server.sendContent((const char*)chunk, sizeof(chunk));
+    }
+}
+
+void WebServerHandler::handleApiBackup() {
+    // One snapshot for both passes: Content-Length has to match the body
+    captureBackup(backupImage, *systemState, analytics);
+    size_t size = BackupWriter().write(backupImage);
+
+    server.setContentLength(size);
+    server.sendHeader("Content-Disposition", "attachment; filename=\"bloom-backup.blbk\"");
+    server.send(200, "application/octet-stream", "");
+    BackupWriter writer([this](const uint8_t* data, size_t length) {
+        server.sendContent((const char*)data, length);
+    });
+    writer.write(backupImage);
+}
+
+// Body chunks as they come off the socket (application/octet-stream)
+void WebServerHandler::handleRestoreBody() {
+    // The core calls this for multipart file parts too, with no raw
+    // buffer behind raw(); handleApiRestore() refuses those
+    if (!server.hasRawBody()) return;
+
+    HTTPRaw& raw = server.raw();
+    switch (raw.status) {
+        case RAW_START:
+            restoreReader.begin(backupImage);
+            break;
+        case RAW_WRITE:
+            restoreReader.feed(raw.buf, raw.currentSize);
+            break;
+        case RAW_ABORTED:
+            restoreReader.abort("Upload aborted");
+            break;
+        default:
+            break;
+    }
+}
+
+void WebServerHandler::handleApiRestore() {
+    // Form and multipart bodies were skipped by handleRestoreBody()
+    if (!server.hasRawBody()) {
+        server.send(415, "application/json", "{\"error\":\"Send the archive as application/octet-stream\"}");
+        return;
+    }
+
+    StaticJsonDocument<128> doc;
+    if (!restoreReader.finish()) {
+        doc["error"] = restoreReader.getError();
+        doc["bytes"] = restoreReader.getBytes();
+        String response;
+        serializeJson(doc, response);
+        server.send(400, "application/json", response);
+        return;
+    }
+
+    // The state no longer follows the journal (until the next boot)
+    inputJournal.recordScenario();
+    commitBackup(backupImage, *systemState, analytics);
+
+    doc["ok"] = true;
+    doc["tasks"] = backupImage.taskCount;
+    doc["bytes"] = restoreReader.getBytes();
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
+}
+
+void WebServerHandler::handleApiEvents() {
+    // EventSource sends Last-Event-ID on reconnects; ?lastEventId= lets a
+    // display that reloaded resume too
+    String lastId = server.hasHeader("Last-Event-ID") ? server.header("Last-Event-ID")
+                                                      : server.arg("lastEventId");
+    // Nothing broadcast yet since boot (no WebSocket client, no changes)
+    if (!eventStream.hasAllTopics()) {
+        broadcastTasks();
+        broadcastPlant();
+        broadcastStatus();
+        broadcastStats();
     }
 
+    WiFiClient client = server.client();
+    if (!eventStream.accept(client, strtoul(lastId.c_str(), nullptr, 10), lastId.length() > 0)) {
+        server.send(503, "application/json", "{\"error\":\"Too many event streams\"}");
+    }
+}
+
+void WebServerHandler::handleApiHeap() {
+    static const uint8_t SITES_PER_PAGE = 16;
+
+    if (server.hasArg("reset")) {
+        heapTracker.resetCounters();
+    }
+
+    StaticJsonDocument<2560> doc;
+    HeapSnapshot heap = HeapTracker::snapshot();
+    doc["freeBytes"] = heap.freeBytes;
+    doc["largestBlock"] = heap.largestBlock;
+    doc["minFreeBytes"] = heap.minFreeBytes;
+    doc["fragPermille"] = heap.fragPermille;
+    doc["uptimeS"] = millis() / 1000;
+    doc["tracking"] = (bool)HEAP_TRACKER;
+    doc["liveBytes"] = heapTracker.getLiveBytes();
+    doc["liveCount"] = heapTracker.getLiveCount();
+    doc["totalAllocs"] = heapTracker.getTotalAllocs();
+
+    // [index, addr, allocs, frees, liveBytes, peakLiveBytes] for used slots
+    uint8_t offset = server.hasArg("offset") ? server.arg("offset").toInt() : 0;
+    JsonArray sites = doc.createNestedArray("sites");
+    uint8_t index = offset;
+    for (; index < HeapTracker::MAX_SITES && sites.size() < SITES_PER_PAGE; index++) {
+        const HeapSite& site = heapTracker.site(index);
+        if (site.allocs == 0 && site.liveBytes == 0) continue;
+        JsonArray entry = sites.createNestedArray();
+        entry.add(index);
+        entry.add(site.addr);
+        entry.add(site.allocs);
+        entry.add(site.frees);
+        entry.add(site.liveBytes);
+        entry.add(site.peakLiveBytes);
+    }
+    doc["nextOffset"] = index < HeapTracker::MAX_SITES ? index : 0;
+
     String response;
     serializeJson(doc, response);
     server.send(200, "application/json", response);
@@ -612,58 +1071,60 @@ void WebServerHandler::handleNotFound() {
     String host = server.hostHeader();
     DEBUG_PRINTF("handleNotFound: URI=%s, Host=%s\n", uri.c_str(), host.c_str());
     
-    // In AP mode, handle captive portal detection
-    if (!wifiConnected) {
-        // Check if this looks like a connectivity check request
-        // These come from various domains like connectivitycheck.gstatic.com
-        if (uri.indexOf("generate_204") >= 0 || uri.indexOf("gen_204") >= 0) {
-            // Android connectivity check - MUST return 204
-            server.send(204, "", "");
-            webClientConnected = true;
-            return;
-        }
+    if constexpr (Features::captivePortal) {
+        // In AP mode, handle captive portal detection
+        if (!wifiConnected) {
+            // Check if this looks like a connectivity check request
+            // These come from various domains like connectivitycheck.gstatic.com
+            if (uri.indexOf("generate_204") >= 0 || uri.indexOf("gen_204") >= 0) {
+                // Android connectivity check - MUST return 204
+                server.send(204, "", "");
+                webClientConnected = true;
+                return;
+            }
         
-        // Apple captive portal detection - redirect to our page
-        if (host.indexOf("apple.com") >= 0 || host.indexOf("captive") >= 0 ||
-            uri.indexOf("hotspot-detect") >= 0 || uri.indexOf("library/test") >= 0) {
-            if (webClientConnected) {
-                // Already connected - return Success to maintain connection
-                server.send(200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>");
-            } else {
-                // First time - redirect to our app
-                server.sendHeader("Location", "http://192.168.4.1/");
-                server.send(302, "text/html", "");
+            // Apple captive portal detection - redirect to our page
+            if (host.indexOf("apple.com") >= 0 || host.indexOf("captive") >= 0 ||
+                uri.indexOf("hotspot-detect") >= 0 || uri.indexOf("library/test") >= 0) {
+                if (webClientConnected) {
+                    // Already connected - return Success to maintain connection
+                    server.send(200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>");
+                } else {
+                    // First time - redirect to our app
+                    server.sendHeader("Location", "http://192.168.4.1/");
+                    server.send(302, "text/html", "");
+                }
+                return;
             }
-            return;
-        }
         
-        // Google connectivity check (Android)
-        if (host.indexOf("google") >= 0 || host.indexOf("gstatic") >= 0 ||
-            host.indexOf("connectivitycheck") >= 0) {
-            server.send(204, "", "");
-            webClientConnected = true;
-            return;
-        }
+            // Google connectivity check (Android)
+            if (host.indexOf("google") >= 0 || host.indexOf("gstatic") >= 0 ||
+                host.indexOf("connectivitycheck") >= 0) {
+                server.send(204, "", "");
+                webClientConnected = true;
+                return;
+            }
         
-        if (uri.indexOf("ncsi") >= 0 || uri.indexOf("connecttest") >= 0) {
-            // Windows connectivity check
-            server.send(200, "text/plain", "Microsoft NCSI");
-            webClientConnected = true;
-            return;
-        }
+            if (uri.indexOf("ncsi") >= 0 || uri.indexOf("connecttest") >= 0) {
+                // Windows connectivity check
+                server.send(200, "text/plain", "Microsoft NCSI");
+                webClientConnected = true;
+                return;
+            }
         
-        if (uri.indexOf("success") >= 0) {
-            // Generic success check
-            server.send(200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>");
+            if (uri.indexOf("success") >= 0) {
+                // Generic success check
+                server.send(200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>");
+                webClientConnected = true;
+                return;
+            }
+        
+            // For all other unknown requests, serve the main page directly
+            // (avoid redirect which can cause captive portal loops)
             webClientConnected = true;
+            handleRoot();
             return;
         }
-        
-        // For all other unknown requests, serve the main page directly
-        // (avoid redirect which can cause captive portal loops)
-        webClientConnected = true;
-        handleRoot();
-        return;
     }
     server.send(404, "text/plain", "Not found");
 }
@@ -672,6 +1133,7 @@ void WebServerHandler::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t* pay
     switch (type) {
         case WStype_DISCONNECTED:
             DEBUG_PRINTF("WebSocket client #%u disconnected\n", num);
+            screenSubscribers &= ~(1UL << num);
             break;
 
         case WStype_CONNECTED:
@@ -681,6 +1143,11 @@ void WebServerHandler::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t* pay
             broadcastTasks();
             broadcastPlant();
             broadcastStatus();
+            {
+                const char* stats = getStatsJson();  // Only the new client needs it
+                webSocket.sendTXT(num, stats, statsLength);
+                wsMessagesSent++;
+            }
             break;
 
         case WStype_TEXT:
@@ -693,6 +1160,7 @@ void WebServerHandler::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t* pay
 }
 
 void WebServerHandler::handleWebSocketMessage(uint8_t num, uint8_t* payload, size_t length) {
+    uint32_t receivedUs = micros();
     StaticJsonDocument<256> doc;
     DeserializationError error = deserializeJson(doc, payload, length);
 
@@ -703,69 +1171,61 @@ void WebServerHandler::handleWebSocketMessage(uint8_t num, uint8_t* payload, siz
 
     const char* action = doc["action"];
 
-    if (strcmp(action, "getStatus") == 0) {
-        broadcastStatus();
-    }
-    else if (strcmp(action, "getTasks") == 0) {
-        broadcastTasks();
-    }
-    else if (strcmp(action, "water") == 0) {
-        systemState->waterPlant();
-    }
-    else if (strcmp(action, "kill") == 0) {
-        systemState->killPlant();
-        systemState->clearAllTasks();  // Clear tasks on demo kill
-        analytics.forceDailyReset();   // Reset today's stats
-        broadcastTasks();              // Notify clients
-        broadcastStatus();
-    }
-    else if (strcmp(action, "pause") == 0) {
-        systemState->pauseTimer();
-    }
-    else if (strcmp(action, "resume") == 0) {
-        systemState->resumeTimer();
-    }
-    else if (strcmp(action, "addTask") == 0) {
-        const char* name = doc["task"]["name"] | "Untitled";
-        uint16_t focus = doc["task"]["focusDuration"] | 25;
-        uint16_t breakTime = doc["task"]["breakDuration"] | 5;
-        systemState->addTask(name, focus, breakTime);
-    }
-    else if (strcmp(action, "startTask") == 0) {
-        uint32_t taskId = doc["taskId"];
-        systemState->startTask(taskId);
+    // Client render acknowledgement for a traced status broadcast
+    if (strcmp(action, "traceAck") == 0) {
+        latencyTrace.acknowledge(doc["trace"] | 0);
+        return;
     }
-    else if (strcmp(action, "deleteTask") == 0) {
-        uint32_t taskId = doc["taskId"];
-        systemState->deleteTask(taskId);
+
+    // {"trace":1} on any action times it through to the client render
+    bool traced = !doc["trace"].isNull();
+    if (traced) {
+        latencyTrace.begin(LatencyTrace::WEB, receivedUs);
+        latencyTrace.mark(LatencyStage::DETECTED);
     }
-    else if (strcmp(action, "toggleTask") == 0) {
-        uint32_t taskId = doc["taskId"];
-        systemState->toggleTaskComplete(taskId);
+
+    // {"ver":N,"id":R} applies the action only if the state is still at
+    // version N; either way the sender gets {"type":"ack","id":R,...}
+    bool versioned = !doc["ver"].isNull();
+    if (versioned && !versionMatches(doc)) {
+        sendAck(num, doc, false);
+        return;
     }
-    else if (strcmp(action, "setGoal") == 0) {
-        uint8_t goal = doc["goal"];
-        systemState->setDailyGoal(goal);
+
+    // Scenario input is not user input: the run itself is journaled
+    bool journaled = num != LOCAL_CLIENT;
+    if (journaled) {
+        inputJournal.recordAction(action, doc["taskId"] | 0, doc["goal"] | 0);
+        if (strcmp(action, "addTask") == 0) {
+            inputJournal.recordAddTask(doc["task"]["name"] | "Untitled", doc["task"]["focusDuration"] | 25,
+                                       doc["task"]["breakDuration"] | 5);
+        }
     }
-    else if (strcmp(action, "restartDay") == 0) {
-        systemState->restartDay();
-        analytics.forceDailyReset();  // Reset today's statistics too
+
+    ActionResult result = applyWebAction(*systemState, analytics, doc);
+
+    if (result != ActionResult::UNKNOWN) {
+        if (strcmp(action, "kill") == 0) {
+            broadcastTasks();  // Notify clients
+            broadcastStatus();
+        }
     }
-    else if (strcmp(action, "revive") == 0) {
-        systemState->revivePlant();
+    else if (strcmp(action, "getStatus") == 0) {
+        broadcastStatus();
     }
-    else if (strcmp(action, "selectTask") == 0) {
-        // Select task for flip control
-        uint32_t taskId = doc["taskId"];
-        systemState->selectTaskForFlip(taskId);
+    else if (strcmp(action, "getTasks") == 0) {
+        broadcastTasks();
     }
-    else if (strcmp(action, "confirmComplete") == 0) {
-        // User confirms task completion after flip
-        systemState->confirmTaskComplete();
+    else if (strcmp(action, "subscribeScreen") == 0) {
+        // Keyframe right away - idle screens may not change for minutes
+        screenSubscribers |= (1UL << num);
+        if (screenTiles) {
+            uint16_t len = frameMirror.encodeKey(screenTiles, screenRotated);
+            webSocket.sendBIN(num, frameMirror.packet(), len);
+        }
     }
-    else if (strcmp(action, "cancelComplete") == 0) {
-        // User says flip was accidental
-        systemState->cancelTaskComplete();
+    else if (strcmp(action, "unsubscribeScreen") == 0) {
+        screenSubscribers &= ~(1UL << num);
     }
     else if (strcmp(action, "setTime") == 0) {
         // Sync time from phone
@@ -788,80 +1248,171 @@ void WebServerHandler::handleWebSocketMessage(uint8_t num, uint8_t* payload, siz
         time_t t = mktime(&timeinfo);
         struct timeval tv = { .tv_sec = t, .tv_usec = 0 };
         settimeofday(&tv, NULL);
+        if (journaled) inputJournal.recordTimeSync(true, t);
         
         timeSynced = true;
         DEBUG_PRINTF("Time synced from phone: %02d:%02d:%02d\n", hours, minutes, seconds);
     }
+
+    // Nothing applied (unknown task, full list, ...): the sender's
+    // optimistic edit has to go, so it gets the delta like a stale one
+    if (versioned) {
+        sendAck(num, doc, result != ActionResult::UNCHANGED);
+    }
+
+    if (traced) {
+        latencyTrace.mark(LatencyStage::APPLIED);
+        broadcastStatus();  // Carries the trace id for the client to acknowledge
+    }
 }
 
-void WebServerHandler::broadcastStatus() {
-    StaticJsonDocument<256> doc;
-    doc["type"] = "status";
-    doc["state"] = systemState->getModeString();
-    doc["timeLeft"] = systemState->getTimeLeft();
-    doc["totalTime"] = systemState->getTotalTime();
-    doc["waitingForConfirmation"] = systemState->isWaitingForConfirmation();
+bool WebServerHandler::versionMatches(JsonDocument& request) {
+    return request["ver"].isNull() || request["ver"].as<uint32_t>() == systemState->getVersion();
+}
+
+// Serializes into messageBuffer; 0 if the message did not fit
+template <typename Msg>
+size_t WebServerHandler::serialize(const Msg& msg) {
+    JsonWriter writer(messageBuffer, sizeof(messageBuffer));
+    writeJson(writer, msg);
+    if (writer.ok()) return writer.length();
+    DEBUG_PRINTLN("WebServer: Message too large (MESSAGE_BUFFER_SIZE)");
+    return 0;
+}
+
+void WebServerHandler::sendMessage(int code, size_t length) {
+    if (length == 0) {
+        server.send(500, "application/json", "{\"error\":\"Reply too large\"}");
+        return;
+    }
+    server.send(code, "application/json", messageBuffer);
+}
+
+// What changed since the client's version (everything if it is unknown)
+template <typename Reply>
+void WebServerHandler::fillDelta(Reply& reply, uint32_t clientVer) {
+    uint32_t current = systemState->getVersion();
+    uint32_t behind = current - clientVer;
+    reply.ver = current;
+
+    if (current - systemState->getStateChangedAt() < behind) {
+        fillStatus(deltaStatus, systemState);
+        reply.status = &deltaStatus;
+        reply.hasTasks = true;
+        reply.tasks = taskMsgs;
+        reply.tasksCount = fillTasks(taskMsgs, systemState);
+    }
+    if (current - systemState->getPlantChangedAt() < behind) {
+        fillPlant(deltaPlant, systemState);
+        reply.plant = &deltaPlant;
+    }
+}
+
+// Accepted actions are acked with the new version only: the broadcasts
+// queued by the change follow. A rejected one gets the delta right away.
+void WebServerHandler::sendAck(uint8_t num, JsonDocument& request, bool ok) {
+    if (num == LOCAL_CLIENT) return;
+
+    AckMsg reply;
+    reply.id = request["id"] | 0;
+    reply.ok = ok;
+    if (ok) {
+        reply.ver = systemState->getVersion();
+    } else {
+        fillDelta(reply, request["ver"]);
+    }
+
+    size_t length = serialize(reply);
+    if (length == 0) return;
+    webSocket.sendTXT(num, messageBuffer, length);
+    wsMessagesSent++;
+}
+
+// REST clients get no broadcasts, so their reply carries the delta.
+// An action that changed nothing is refused the same way (409 / 400).
+void WebServerHandler::sendActionReply(JsonDocument& request, const char* action, bool applied) {
+    ActionReplyMsg reply;
+    reply.success = applied;
+    reply.action = action;
+    bool versioned = !request["ver"].isNull();
+    if (versioned) {
+        reply.hasOk = true;
+        reply.ok = applied;
+        reply.hasVer = true;
+        fillDelta(reply, request["ver"]);
+    }
+    sendMessage(applied ? 200 : (versioned ? 409 : 400), serialize(reply));
+}
 
-    const char* taskName = systemState->getCurrentTaskName();
-    doc["taskName"] = taskName ? taskName : (char*)nullptr;
+void WebServerHandler::broadcastStatus() {
+    StatusMsg msg;
+    fillStatus(msg, systemState);
+    if (latencyTrace.isActive()) {
+        msg.hasTrace = true;
+        msg.trace = latencyTrace.id();
+    }
 
-    String message;
-    serializeJson(doc, message);
-    webSocket.broadcastTXT(message);
+    size_t length = serialize(msg);
+    if (length) broadcastText(messageBuffer, length, EventStream::STATUS, "status");
+    latencyTrace.mark(LatencyStage::BROADCAST);
 }
 
 void WebServerHandler::broadcastPlant() {
-    StaticJsonDocument<192> doc;
-    doc["type"] = "plant";
-
-    PlantInfo plant = systemState->getPlantInfo();
-    doc["stage"] = plant.stage;
-    doc["isWithered"] = plant.isWithered;
-    doc["wateredCount"] = plant.wateredCount;
-    doc["totalGoal"] = plant.totalGoal;
-    doc["pendingWater"] = systemState->getPendingWaterCount();
-    doc["dailyGoal"] = systemState->getDailyGoal();
-
-    String message;
-    serializeJson(doc, message);
-    
+    PlantMsg msg;
+    fillPlant(msg, systemState);
+
     DEBUG_PRINTF("broadcastPlant: stage=%d, watered=%d/%d, pending=%d\n", 
-                 plant.stage, plant.wateredCount, plant.totalGoal, 
-                 systemState->getPendingWaterCount());
-    
-    webSocket.broadcastTXT(message);
+                 msg.stage, msg.wateredCount, msg.totalGoal, msg.pendingWater);
+
+    size_t length = serialize(msg);
+    if (length) broadcastText(messageBuffer, length, EventStream::PLANT, "plant");
 }
 
 void WebServerHandler::broadcastTasks() {
-    StaticJsonDocument<1024> doc;
-    doc["type"] = "tasks";
+    TasksMsg msg;
+    msg.ver = systemState->getVersion();
+    msg.tasks = taskMsgs;
+    msg.tasksCount = fillTasks(taskMsgs, systemState);
 
-    JsonArray tasksArray = doc.createNestedArray("tasks");
-    TaskInfo* tasks = systemState->getTasks();
+    size_t length = serialize(msg);
+    if (length) broadcastText(messageBuffer, length, EventStream::TASKS, "tasks");
+}
+
+void WebServerHandler::broadcastText(const char* message, size_t length, EventStream::Topic topic, const char* event) {
+    if (scenarioRunner && scenarioRunner->isRunning()) return;  // Clients resync when it ends
+    webSocket.broadcastTXT(message, length);
+    wsMessagesSent += webSocket.connectedClients();
+    eventStream.publish(topic, event, message, length);
+}
+
+void WebServerHandler::publishFrame(const uint8_t* tiles, bool rotated) {
+    screenTiles = tiles;
+    screenRotated = rotated;
+    if (screenSubscribers == 0) return;
+
+    uint16_t len = frameMirror.encodeDelta(tiles, rotated);
+    if (len == 0) return;  // Nothing changed on screen
 
-    for (int i = 0; i < systemState->getTaskCount(); i++) {
-        JsonObject task = tasksArray.createNestedObject();
-        task["id"] = tasks[i].id;
-        task["name"] = tasks[i].name;
-        task["focusDuration"] = tasks[i].focusDuration;
-        task["breakDuration"] = tasks[i].breakDuration;
-        task["completed"] = tasks[i].completed;
-        task["started"] = tasks[i].started;
+    for (uint8_t num = 0; num < 32; num++) {
+        if (screenSubscribers & (1UL << num)) {
+            webSocket.sendBIN(num, frameMirror.packet(), len);
+            wsMessagesSent++;
+        }
     }
+}
 
-    String message;
-    serializeJson(doc, message);
-    webSocket.broadcastTXT(message);
+void WebServerHandler::broadcastStats() {
+    statsDirty = true;
+    const char* stats = getStatsJson();
+    broadcastText(stats, statsLength, EventStream::STATS, "stats");
 }
 
 void WebServerHandler::broadcastRevive() {
-    StaticJsonDocument<128> doc;
-    doc["type"] = "revive";
-    doc["message"] = "Plant Revived! You can plant again!";
-    
-    String message;
-    serializeJson(doc, message);
-    webSocket.broadcastTXT(message);
+    ReviveMsg msg;
+    msg.message = "Plant Revived! You can plant again!";
+
+    size_t length = serialize(msg);
+    if (length) broadcastText(messageBuffer, length, EventStream::TRANSIENT, "revive");
     DEBUG_PRINTLN("WebSocket: Broadcast plant revive message");
 }
 
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Back up the cube's tasks, plant and analytics, and restore them
+
+Talks to /api/backup and /api/restore (format in BackupArchive.h):
+a versioned, CRC32-checked record stream. "show" decodes an archive
+offline and checks it, so a file can be inspected before pushing it.
+
+Usage:
+    python3 backup_tool.py pull 192.168.1.50 -o cube.blbk
+    python3 backup_tool.py show cube.blbk
+    python3 backup_tool.py push cube.blbk 192.168.1.77
+
+A push replaces the target's plant, goals, tasks and weekly history in
+one step; any running session is stopped. Uses only the standard library.
+"""
+
+import argparse
+import json
+import struct
+import sys
+import urllib.error
+import urllib.request
+import zlib
+
+MAGIC = b"BLBK"
+VERSION = 1
+
+PLANT, TASK, TODAY, DAY, SKETCHES, END = 1, 2, 3, 4, 5, 0xFF
+DAYS = ["Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"]
+
+# QuantileSketch.h: count u16, 7 marker heights f32, 7 positions u16
+SKETCH = struct.Struct("<H7f7H")
+SKETCH_NAMES = ["focus s", "pauses", "break s"]
+MARKER_FRACTIONS = [0, 0.25, 0.5, 0.7, 0.9, 0.95, 1]
+
+
+# ============================================
+# Decoding
+# ============================================
+
+def decode(data):
+    """Records as dicts; raises ValueError where the cube would refuse it"""
+    if data[:4] != MAGIC:
+        raise ValueError("not a backup archive")
+    if len(data) < 5 or data[4] > VERSION:
+        raise ValueError(f"archive version {data[4] if len(data) > 4 else '?'} is newer than {VERSION}")
+
+    records = []
+    pos = 5
+    while True:
+        if pos + 2 > len(data):
+            raise ValueError("archive truncated")
+        tag, length = data[pos], data[pos + 1]
+        payload = data[pos + 2:pos + 2 + length]
+        if len(payload) < length:
+            raise ValueError("archive truncated")
+
+        if tag == END:
+            (crc,) = struct.unpack("<I", payload)
+            if zlib.crc32(data[:pos + 2]) != crc:
+                raise ValueError("checksum mismatch")
+            if pos + 2 + length != len(data):
+                raise ValueError("data after end record")
+            return records
+
+        if tag == PLANT:
+            records.append(dict(kind="plant", stage=payload[0], withered=bool(payload[1]),
+                                pending=payload[2], watered=payload[3],
+                                dailyGoal=payload[4], sessionGoal=payload[5]))
+        elif tag == TASK:
+            task_id, focus, brk, flags = struct.unpack_from("<IHHB", payload)
+            records.append(dict(kind="task", id=task_id, focus=focus, brk=brk,
+                                done=bool(flags & 1), started=bool(flags & 2),
+                                name=payload[9:].decode("utf-8", "replace")))
+        elif tag in (TODAY, DAY):
+            dow, tasks, focus, brk, sessions = struct.unpack_from("<BBHHB", payload)
+            rec = dict(kind="today" if tag == TODAY else "day", dayOfWeek=dow, tasks=tasks,
+                       focus=focus, brk=brk, sessions=sessions)
+            if tag == TODAY:
+                rec["date"] = payload[7:].decode("ascii", "replace")
+            records.append(rec)
+        elif tag == SKETCHES:
+            sketches = []
+            for i, name in enumerate(SKETCH_NAMES):
+                values = SKETCH.unpack_from(payload, i * SKETCH.size)
+                sketches.append(dict(name=name, count=values[0], heights=values[1:8]))
+            records.append(dict(kind="sketches", sketches=sketches))
+        else:
+            records.append(dict(kind=f"unknown tag {tag}", length=length))
+        pos += 2 + length
+
+
+def quantiles(sketch):
+    """min, p50, p90, max as the firmware reports them"""
+    count, heights = sketch["count"], sketch["heights"]
+    if count == 0:
+        return [0, 0, 0, 0]
+    markers = [0, 2, 4, 6]
+    if count <= len(heights):  # Still exact samples
+        return [heights[int((count - 1) * MARKER_FRACTIONS[i] + 0.5)] for i in markers]
+    return [heights[i] for i in markers]
+
+
+def show(data):
+    records = decode(data)
+    print(f"{len(data)} bytes, version {data[4]}, CRC ok")
+    for rec in records:
+        kind = rec["kind"]
+        if kind == "plant":
+            print(f"plant   stage {rec['stage']}{' (withered)' if rec['withered'] else ''}, "
+                  f"watered {rec['watered']}, pending {rec['pending']}, "
+                  f"goal {rec['dailyGoal']} (session {rec['sessionGoal']})")
+        elif kind == "task":
+            flags = " done" if rec["done"] else (" started" if rec["started"] else "")
+            print(f"task    {rec['name']!r} {rec['focus']}/{rec['brk']} min{flags}  (id {rec['id']})")
+        elif kind in ("today", "day"):
+            label = f"today   {rec['date']}" if kind == "today" else f"day     {DAYS[rec['dayOfWeek']]}"
+            print(f"{label}: {rec['tasks']} tasks, {rec['focus']} min focus, "
+                  f"{rec['brk']} min break, {rec['sessions']} sessions")
+        elif kind == "sketches":
+            for sketch in rec["sketches"]:
+                print(f"sketch  {sketch['name']:<8} n={sketch['count']} "
+                      + " ".join(f"{label}={value:.1f}" for label, value in
+                                 zip(("min", "p50", "p90", "max"), quantiles(sketch))))
+        else:
+            print(f"{kind} ({rec['length']} bytes, skipped by this firmware)")
+
+
+# ============================================
+# Device
+# ============================================
+
+def pull(host):
+    with urllib.request.urlopen(f"http://{host}/api/backup", timeout=10) as response:
+        return response.read()
+
+
+def push(host, data):
+    request = urllib.request.Request(
+        f"http://{host}/api/restore", data=data, method="POST",
+        headers={"Content-Type": "application/octet-stream"})
+    try:
+        with urllib.request.urlopen(request, timeout=30) as response:
+            return json.loads(response.read())
+    except urllib.error.HTTPError as e:
+        return json.loads(e.read() or b"{}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("pull", help="Download a backup")
+    p.add_argument("host")
+    p.add_argument("-o", "--output", required=True)
+
+    p = sub.add_parser("show", help="Decode and check a backup")
+    p.add_argument("archive")
+
+    p = sub.add_parser("push", help="Restore a backup onto a cube")
+    p.add_argument("archive")
+    p.add_argument("host")
+
+    args = parser.parse_args()
+
+    if args.command == "pull":
+        data = pull(args.host)
+        records = decode(data)
+        with open(args.output, "wb") as f:
+            f.write(data)
+        tasks = sum(1 for r in records if r["kind"] == "task")
+        print(f"{len(data)} bytes, {tasks} tasks -> {args.output}")
+    elif args.command == "show":
+        with open(args.archive, "rb") as f:
+            show(f.read())
+    elif args.command == "push":
+        with open(args.archive, "rb") as f:
+            data = f.read()
+        decode(data)  # Refuse locally what the cube would refuse
+        result = push(args.host, data)
+        if not result.get("ok"):
+            sys.exit(f"Restore refused: {result.get('error', result)}")
+        print(f"Restored {result['tasks']} tasks ({result['bytes']} bytes)")
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except ValueError as e:
+        sys.exit(f"Bad archive: {e}")
@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+"""Generate Messages.h and data/messages.js from messages.json
+
+The C++ side gets one plain struct per message plus writeJson() overloads
+that print it through JsonWriter; the web app gets decoders that return
+every field of the schema (defaults for missing ones). Both come from the
+same file, so the firmware and the page can't disagree on a field name.
+
+Run it after editing messages.json, then build_webcontent.py.
+"""
+
+import json
+import re
+
+SCALARS = {
+    'u8': ('uint8_t', 'num', '0'),
+    'u16': ('uint16_t', 'num', '0'),
+    'u32': ('uint32_t', 'num', '0'),
+    'bool': ('bool', 'bool', 'false'),
+    'str': ('const char*', 'str', 'nullptr'),
+    'str?': ('const char*', 'strOrNull', 'nullptr'),
+}
+
+def load_schema(path):
+    with open(path, 'r', encoding='utf-8') as f:
+        schema = json.load(f)
+
+    types = {}
+    for name, fields in schema['structs'].items():
+        types[name] = {'name': name, 'tag': None, 'fields': fields, 'message': False}
+    for name, message in schema['messages'].items():
+        if name in types:
+            raise SystemExit(f'messages.json: {name} is both a struct and a message')
+        types[name] = {'name': name, 'tag': message.get('tag'), 'fields': message['fields'], 'message': True}
+
+    # Types may only use types declared before them (C++ needs the order)
+    seen = set()
+    for t in types.values():
+        for field in t['fields']:
+            base = field['type'].rstrip('[]')
+            if base not in SCALARS and base not in seen:
+                raise SystemExit(f"messages.json: {t['name']}.{field['name']} uses {field['type']} before it is declared")
+            if not re.match(r'^[A-Za-z_][A-Za-z0-9_]*$', field['name']):
+                raise SystemExit(f"messages.json: bad field name {field['name']}")
+        seen.add(t['name'])
+    return list(types.values())
+
+def is_array(field):
+    return field['type'].endswith('[]')
+
+def base_type(field):
+    return field['type'][:-2] if is_array(field) else field['type']
+
+def cap(name):
+    return name[0].upper() + name[1:]
+
+# ============================================
+# C++
+# ============================================
+
+def cpp_members(t):
+    lines = []
+    for field in t['fields']:
+        name, base = field['name'], base_type(field)
+        optional = field.get('optional', False)
+        if is_array(field):
+            if optional:
+                lines.append(f'    bool has{cap(name)} = false;')
+            elem = SCALARS[base][0] if base in SCALARS else f'{base}Msg'
+            lines.append(f'    const {elem}* {name} = nullptr;')
+            lines.append(f'    uint8_t {name}Count = 0;')
+        elif base in SCALARS:
+            ctype, _, default = SCALARS[base]
+            if optional:
+                lines.append(f'    bool has{cap(name)} = false;')
+            lines.append(f'    {ctype} {name} = {default};')
+        elif optional:
+            lines.append(f'    const {base}Msg* {name} = nullptr;      // nullptr: left out')
+        else:
+            lines.append(f'    {base}Msg {name};')
+    return lines
+
+def cpp_value(base, expr):
+    if base in ('u8', 'u16', 'u32'):
+        return f'w.u32({expr});'
+    if base == 'bool':
+        return f'w.boolean({expr});'
+    if base == 'str':
+        return f'w.str({expr} ? {expr} : "");'
+    if base == 'str?':
+        return f'w.str({expr});'
+    return f'writeObject(w, {expr});'
+
+def cpp_fields(t):
+    lines = []
+    for field in t['fields']:
+        name, base = field['name'], base_type(field)
+        optional = field.get('optional', False)
+        key = f'w.key(MsgKey::{name});'
+        if is_array(field):
+            body = [key, 'w.beginArray();',
+                    f'for (uint8_t i = 0; i < m.{name}Count; i++) {cpp_value(base, f"m.{name}[i]")}',
+                    'w.endArray();']
+            cond = f'm.has{cap(name)}' if optional else None
+        elif base in SCALARS:
+            body = [key, cpp_value(base, f'm.{name}')]
+            cond = f'm.has{cap(name)}' if optional else None
+        else:
+            body = [key, cpp_value(base, f'*m.{name}' if optional else f'm.{name}')]
+            cond = f'm.{name}' if optional else None
+
+        if cond:
+            lines.append(f'    if ({cond}) {{')
+            lines.extend(f'        {b}' for b in body)
+            lines.append('    }')
+        else:
+            lines.extend(f'    {b}' for b in body)
+    return lines
+
+def generate_cpp(types):
+    keys = sorted({field['name'] for t in types for field in t['fields']})
+    tags = [t for t in types if t['tag']]
+
+    out = []
+    out.append('#ifndef MESSAGES_H')
+    out.append('#define MESSAGES_H')
+    out.append('')
+    out.append('// Generated by build_messages.py from messages.json - do not edit')
+    out.append('')
+    out.append('#include <stdint.h>')
+    out.append('#include "JsonWriter.h"')
+    out.append('')
+    out.append('namespace MsgKey {')
+    for k in keys:
+        out.append(f'constexpr char {k}[] = "\\"{k}\\":";')
+    out.append('}')
+    out.append('')
+    out.append('namespace MsgTag {')
+    for t in tags:
+        out.append(f'constexpr char {t["tag"]}[] = "\\"type\\":\\"{t["tag"]}\\"";')
+    out.append('}')
+
+    for t in types:
+        name = t['name']
+        out.append('')
+        out.append(f'struct {name}Msg {{')
+        out.extend(cpp_members(t))
+        out.append('};')
+        out.append('')
+        out.append(f'inline void writeFields(JsonWriter& w, const {name}Msg& m) {{')
+        out.extend(cpp_fields(t))
+        out.append('}')
+        out.append('')
+        out.append(f'inline void writeObject(JsonWriter& w, const {name}Msg& m) {{')
+        out.append('    w.beginObject();')
+        out.append('    writeFields(w, m);')
+        out.append('    w.endObject();')
+        out.append('}')
+
+    # Top-level messages: same object, tagged with "type" when the schema has one
+    for t in types:
+        if not t['message']:
+            continue
+        name = t['name']
+        out.append('')
+        out.append(f'inline void writeJson(JsonWriter& w, const {name}Msg& m) {{')
+        out.append('    w.beginObject();')
+        if t['tag']:
+            out.append(f'    w.member(MsgTag::{t["tag"]});')
+        out.append('    writeFields(w, m);')
+        out.append('    w.endObject();')
+        out.append('}')
+
+    out.append('')
+    out.append('#endif // MESSAGES_H')
+    return '\n'.join(out) + '\n'
+
+# ============================================
+# JavaScript
+# ============================================
+
+def js_value(base, expr):
+    if base in SCALARS:
+        return f'{SCALARS[base][1]}({expr})'
+    return f'decode{base}({expr})'
+
+def generate_js(types):
+    out = []
+    out.append('/**')
+    out.append(' * Productivity Bloom - Message decoders')
+    out.append(' * Generated by build_messages.py from messages.json - do not edit')
+    out.append(' */')
+    out.append('')
+    out.append('const Messages = (() => {')
+    out.append("    const num = v => (typeof v === 'number' ? v : 0);")
+    out.append('    const bool = v => v === true;')
+    out.append("    const str = v => (typeof v === 'string' ? v : '');")
+    out.append("    const strOrNull = v => (typeof v === 'string' ? v : null);")
+    out.append('    const list = (v, decode) => (Array.isArray(v) ? v.map(decode) : []);')
+
+    for t in types:
+        out.append('')
+        out.append(f'    function decode{t["name"]}(d) {{')
+        out.append('        d = d || {};')
+        out.append('        const m = {')
+        optional = []
+        for field in t['fields']:
+            name, base = field['name'], base_type(field)
+            if is_array(field):
+                elem = SCALARS[base][1] if base in SCALARS else f'decode{base}'
+                value = f'list(d.{name}, {elem})'
+            else:
+                value = js_value(base, f'd.{name}')
+            if field.get('optional', False):
+                optional.append((name, value))
+            else:
+                out.append(f'            {name}: {value},')
+        out.append('        };')
+        for name, value in optional:
+            out.append(f'        if (d.{name} !== undefined) m.{name} = {value};')
+        out.append('        return m;')
+        out.append('    }')
+
+    out.append('')
+    out.append('    const byType = {')
+    for t in types:
+        if t['tag']:
+            out.append(f"        {t['tag']}: decode{t['name']},")
+    out.append('    };')
+    out.append('')
+    out.append('    // Tagged messages get every schema field; other types pass through')
+    out.append('    function decode(d) {')
+    out.append('        const decoder = d && byType[d.type];')
+    out.append('        if (!decoder) return d;')
+    out.append('        const m = decoder(d);')
+    out.append('        m.type = d.type;')
+    out.append('        return m;')
+    out.append('    }')
+    out.append('')
+    names = ', '.join(f'decode{t["name"]}' for t in types if t['message'])
+    out.append(f'    return {{ decode, {names} }};')
+    out.append('})();')
+    return '\n'.join(out) + '\n'
+
+def main():
+    types = load_schema('messages.json')
+    messages = sum(1 for t in types if t['message'])
+
+    with open('Messages.h', 'w', encoding='utf-8') as f:
+        f.write(generate_cpp(types))
+    with open('data/messages.js', 'w', encoding='utf-8') as f:
+        f.write(generate_js(types))
+
+    print('Messages.h and data/messages.js regenerated successfully!')
+    print(f'{messages} messages, {len(types) - messages} structs')
+
+if __name__ == '__main__':
+    main()
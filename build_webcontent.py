@@ -1,8 +1,21 @@
 #!/usr/bin/env python3
-"""Generate WebContent.h from data folder files"""
+"""Generate WebContent.h from data folder files
 
-import os
+Minifies the scripts (token-aware), drops CSS rules that nothing in the
+page or scripts refers to, inlines everything into one page and fails
+when that page grows past the budget below.
+"""
+
+import gzip
+import hashlib
+import json
 import re
+import sys
+
+# Size budget of the inlined page (INDEX_HTML): flash it takes and what a
+# phone downloads on its first visit. Raise it on purpose, not by accident.
+BUDGET_PAGE_BYTES = 72 * 1024
+BUDGET_PAGE_GZIP = 18 * 1024
 
 def escape_for_c(content):
     """Escape string for C/C++ string literal"""
@@ -22,57 +35,316 @@ def escape_for_c(content):
             result.append(char)
     return ''.join(result)
 
+# ============================================
+# JavaScript
+# ============================================
+
+# Longest first: the tokenizer takes the first match
+PUNCTUATORS = sorted("""
+    >>>= ... === !== **= <<= >>= >>> &&= ||= ??= => == != <= >= && || ?? ?.
+    ++ -- += -= *= /= %= &= |= ^= ** << >>
+    { } ( ) [ ] ; , < > + - * / % & | ^ ! ~ ? : = . @ #
+""".split(), key=len, reverse=True)
+
+# After these a '/' starts a regex, not a division
+REGEX_KEYWORDS = {'return', 'typeof', 'instanceof', 'in', 'of', 'new', 'delete',
+                  'void', 'throw', 'case', 'do', 'else', 'yield', 'await'}
+
+# A line break after these ends the statement (ASI restricted productions)
+RESTRICTED = {'return', 'break', 'continue', 'throw', 'yield', 'async'}
+
+WORD_CHARS = re.compile(r'[A-Za-z0-9_$\\]')
+
+def scan_string(src, i):
+    quote = src[i]
+    i += 1
+    while src[i] != quote:
+        i += 2 if src[i] == '\\' else 1
+    return i + 1
+
+def scan_template(src, i):
+    """Template literal, including nested ${...} code. Kept verbatim."""
+    i += 1
+    while src[i] != '`':
+        if src[i] == '\\':
+            i += 2
+        elif src.startswith('${', i):
+            i = scan_braces(src, i + 2)
+        else:
+            i += 1
+    return i + 1
+
+def scan_braces(src, i):
+    depth = 0
+    while True:
+        c = src[i]
+        if c in '\'"':
+            i = scan_string(src, i)
+        elif c == '`':
+            i = scan_template(src, i)
+        elif c == '{':
+            depth += 1
+            i += 1
+        elif c == '}':
+            if depth == 0:
+                return i + 1
+            depth -= 1
+            i += 1
+        else:
+            i += 1
+
+def scan_regex(src, i):
+    i += 1
+    in_class = False
+    while in_class or src[i] != '/':
+        if src[i] == '\\':
+            i += 1
+        elif src[i] == '[':
+            in_class = True
+        elif src[i] == ']':
+            in_class = False
+        i += 1
+    i += 1
+    while i < len(src) and src[i].isalpha():
+        i += 1
+    return i
+
+def tokenize_js(src):
+    """(kind, text) pairs; kind is 'ws' (with newline flag), 'word', 'punct' or 'literal'"""
+    tokens = []
+    last = None  # Last significant token
+    i = 0
+    while i < len(src):
+        c = src[i]
+        if c.isspace() or src.startswith('//', i) or src.startswith('/*', i):
+            # Whitespace and comments collapse into one separator
+            start = i
+            while i < len(src):
+                if src[i].isspace():
+                    i += 1
+                elif src.startswith('//', i):
+                    end = src.find('\n', i)
+                    i = len(src) if end < 0 else end
+                elif src.startswith('/*', i):
+                    i = src.index('*/', i + 2) + 2
+                else:
+                    break
+            tokens.append(('ws', '\n' if '\n' in src[start:i] else ' '))
+            continue
+
+        start = i
+        if c in '\'"':
+            i = scan_string(src, i)
+            kind = 'literal'
+        elif c == '`':
+            i = scan_template(src, i)
+            kind = 'literal'
+        elif c == '/' and (last is None or
+                           (last[0] == 'punct' and last[1] not in (')', ']')) or
+                           (last[0] == 'word' and last[1] in REGEX_KEYWORDS)):
+            i = scan_regex(src, i)
+            kind = 'literal'
+        elif WORD_CHARS.match(c) or (c == '.' and i + 1 < len(src) and src[i + 1].isdigit()):
+            while i < len(src) and (WORD_CHARS.match(src[i]) or
+                                    (src[i] == '.' and src[start].isdigit())):
+                i += 1
+            kind = 'word'
+        else:
+            p = next((p for p in PUNCTUATORS if src.startswith(p, i)), None)
+            if p is None:
+                raise SystemExit(f'minify_js: unexpected {c!r} at offset {i}')
+            i += len(p)
+            kind = 'punct'
+        last = (kind, src[start:i])
+        tokens.append(last)
+    return tokens
+
+def keeps_line_break(prev, token):
+    """Would dropping a line break between prev and token change the program?"""
+    if prev[0] == 'word' and prev[1] in RESTRICTED:
+        return True
+    if token[0] == 'punct' and token[1] in ('++', '--'):
+        return True
+    if prev[0] == 'punct' and prev[1] not in (')', ']', '}', '++', '--'):
+        return False    # The expression goes on: no semicolon can be inserted here
+    if token[0] == 'punct' and token[1] not in ('(', '[', '{', '+', '-', '/', '!', '~', '#'):
+        return False    # Cannot start a statement, so it continues this one
+    return True
+
 def minify_js(content):
-    """Safe JS minification - only remove empty lines and leading/trailing whitespace"""
-    lines = content.split('\n')
-    result = []
-    for line in lines:
-        # Keep the line content but strip leading/trailing whitespace
-        stripped = line.strip()
-        if stripped:  # Skip completely empty lines
-            result.append(stripped)
-    # Join with semicolon+space to be safe (avoids ASI issues)
-    # Actually, just use newlines to be completely safe
-    return '\n'.join(result)
-
-def minify_css(content):
-    """Simple CSS minification"""
-    # Remove comments
+    """Token-aware: drops comments and whitespace, keeps line breaks only
+    where automatic semicolon insertion could depend on them. Strings,
+    templates and regexes are copied verbatim; names are not mangled."""
+    out = []
+    prev = None
+    gap = None
+    for token in tokenize_js(content):
+        if token[0] == 'ws':
+            gap = token[1]
+            continue
+        if prev is not None:
+            if gap == '\n' and keeps_line_break(prev, token):
+                out.append('\n')
+            elif (WORD_CHARS.match(prev[1][-1]) and WORD_CHARS.match(token[1][0])) or \
+                    (prev[1][-1] in '+-' and token[1][0] == prev[1][-1]):
+                out.append(' ')
+        out.append(token[1])
+        prev = token
+        gap = None
+    return ''.join(out)
+
+# ============================================
+# CSS
+# ============================================
+
+def parse_css(text):
+    """List of (prelude, body) blocks; @media / @supports bodies are parsed again"""
+    blocks = []
+    i = 0
+    while True:
+        brace = text.find('{', i)
+        if brace < 0:
+            return blocks
+        prelude = text[i:brace].strip()
+        depth, j = 1, brace + 1
+        while depth:
+            depth += {'{': 1, '}': -1}.get(text[j], 0)
+            j += 1
+        body = text[brace + 1:j - 1]
+        if prelude.startswith(('@media', '@supports')):
+            blocks.append((prelude, parse_css(body)))
+        else:
+            blocks.append((prelude, body))
+        i = j
+
+def selector_is_used(selector, used):
+    # :not(.x) matches when .x is absent, so its names don't count
+    plain = re.sub(r':not\([^)]*\)', '', selector)
+    plain = re.sub(r'\[[^\]]*\]', '', plain)
+    names = re.findall(r'[.#](-?[A-Za-z_][A-Za-z0-9_-]*)', plain)
+    return all(name in used for name in names)
+
+def squeeze(text):
+    text = re.sub(r'\s+', ' ', text).strip()
+    return re.sub(r'\s*([{}:;,])\s*', r'\1', text)
+
+def squeeze_selector(selector):
+    # Not around ':' here: ".a :hover" and ".a:hover" differ
+    selector = re.sub(r'\s+', ' ', selector).strip()
+    return re.sub(r'\s*([>~+])\s*', r'\1', selector)
+
+def prune_css(blocks, used, removed):
+    out = []
+    for prelude, body in blocks:
+        if isinstance(body, list):
+            inner = prune_css(body, used, removed)
+            if inner:
+                out.append(f'{squeeze(prelude)}{{{inner}}}')
+        elif prelude.startswith('@'):
+            out.append(f'{squeeze(prelude)}{{{squeeze(body)}}}')
+        else:
+            selectors = [s.strip() for s in prelude.split(',')]
+            kept = [s for s in selectors if selector_is_used(s, used)]
+            removed.extend(s for s in selectors if s not in kept)
+            if kept:
+                body = squeeze(body).rstrip(';')
+                out.append(f"{','.join(squeeze_selector(s) for s in kept)}{{{body}}}")
+    return ''.join(out)
+
+def minify_css(content, referenced):
+    """Drops comments, whitespace and the rules whose classes or ids appear
+    nowhere in referenced (page + scripts), then unused @keyframes."""
     content = re.sub(r'/\*.*?\*/', '', content, flags=re.DOTALL)
-    # Collapse whitespace
-    content = re.sub(r'\s+', ' ', content)
-    # Remove spaces around special chars
-    content = re.sub(r'\s*([{}:;,])\s*', r'\1', content)
-    return content.strip()
+    used = set(re.findall(r'[A-Za-z_][A-Za-z0-9_-]*', referenced))
+    removed = []
+    css = prune_css(parse_css(content), used, removed)
+
+    animations = set(re.findall(r'animation(?:-name)?:([^;}]*)', css))
+    animated = set(re.findall(r'[A-Za-z_][A-Za-z0-9_-]*', ' '.join(animations))) | used
+    def keep_keyframes(match):
+        if match.group(1) in animated:
+            return match.group(0)
+        removed.append(f'@keyframes {match.group(1)}')
+        return ''
+    css = re.sub(r'@keyframes ([A-Za-z0-9_-]+)\{(?:[^{}]*\{[^{}]*\})*[^{}]*\}', keep_keyframes, css)
+    return css, removed
+
+def minify_html(content):
+    """Comments and indentation only: the page has no <pre> or <textarea>"""
+    content = re.sub(r'<!--.*?-->', '', content, flags=re.DOTALL)
+    return re.sub(r'\n\s*', '\n', content).strip()
+
+def write_string(f, name, content):
+    f.write(f'const char {name}[] PROGMEM = "')
+    f.write(escape_for_c(content))
+    f.write('";\n\n')
+
+def gzip_size(text):
+    return len(gzip.compress(text.encode('utf-8'), 9))
 
 def main():
     # Read files
     with open('data/index.html', 'r', encoding='utf-8') as f:
-        html = f.read()
+        html_source = f.read()
     with open('data/style.css', 'r', encoding='utf-8') as f:
-        css = minify_css(f.read())
+        css_source = f.read()
     with open('data/app.js', 'r', encoding='utf-8') as f:
-        js = minify_js(f.read())
+        js_source = f.read()
+    with open('data/messages.js', 'r', encoding='utf-8') as f:
+        messages_source = f.read()  # Generated by build_messages.py
+    with open('data/manifest.json', 'r', encoding='utf-8') as f:
+        manifest = json.dumps(json.load(f), separators=(',', ':'))
+    with open('data/icon.svg', 'r', encoding='utf-8') as f:
+        icon = f.read().strip()
+    with open('data/sw.js', 'r', encoding='utf-8') as f:
+        sw = minify_js(f.read())
+
+    html = minify_html(html_source)
+    js = minify_js(js_source)
+    messages_js = minify_js(messages_source)
+    css, removed = minify_css(css_source, html_source + js_source + messages_source)
 
     # Inject CSS and JS into HTML
     html = html.replace('<link rel="stylesheet" href="style.css">', f'<style>{css}</style>')
+    html = html.replace('<script src="messages.js"></script>', f'<script>{messages_js}</script>')
     html = html.replace('<script src="app.js"></script>', f'<script>{js}</script>')
 
-    # Escape for C string
-    escaped = escape_for_c(html)
+    # App shell version: ETag on the device, cache name in the service worker
+    version = hashlib.sha1((html + manifest + icon + sw).encode('utf-8')).hexdigest()[:12]
+    sw = sw.replace('__WEB_VERSION__', version)
+
+    print(f'{"":14}{"source":>9}{"minified":>10}{"gzip":>8}')
+    for name, source, result in (('index.html', html_source, minify_html(html_source)),
+                                 ('style.css', css_source, css),
+                                 ('app.js', js_source, js),
+                                 ('messages.js', messages_source, messages_js)):
+        print(f'{name:14}{len(source):>9}{len(result):>10}{gzip_size(result):>8}')
+    if removed:
+        print(f'Unused CSS removed ({len(removed)}): {", ".join(removed)}')
+
+    # The page goes out whole on every first visit: keep it within budget
+    page_bytes = len(html.encode('utf-8'))
+    page_gzip = gzip_size(html)
+    print(f'Page: {page_bytes} bytes, {page_gzip} gzipped '
+          f'(budget {BUDGET_PAGE_BYTES} / {BUDGET_PAGE_GZIP})')
+    if page_bytes > BUDGET_PAGE_BYTES or page_gzip > BUDGET_PAGE_GZIP:
+        print('Page over budget - WebContent.h not written')
+        sys.exit(1)
 
     # Write header file
     with open('WebContent.h', 'w', encoding='utf-8') as f:
         f.write('#ifndef WEB_CONTENT_H\n')
         f.write('#define WEB_CONTENT_H\n\n')
         f.write('#include <pgmspace.h>\n\n')
-        f.write('const char INDEX_HTML[] PROGMEM = "')
-        f.write(escaped)
-        f.write('";\n\n')
+        f.write(f'#define WEB_CONTENT_VERSION "{version}"\n\n')
+        write_string(f, 'INDEX_HTML', html)
+        write_string(f, 'MANIFEST_JSON', manifest)
+        write_string(f, 'ICON_SVG', icon)
+        write_string(f, 'SERVICE_WORKER_JS', sw)
         f.write('#endif\n')
 
     print('WebContent.h regenerated successfully!')
-    print(f'Total size: {len(escaped)} chars')
+    print(f'Total size: {len(escape_for_c(html))} chars (version {version})')
 
 if __name__ == '__main__':
     main()
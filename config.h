@@ -1,6 +1,15 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+// ============================================
+// Feature Profile (see FeatureProfile.h)
+// ============================================
+// DeskCubeProfile, DashboardProfile or KioskProfile; disabled
+// subsystems are not compiled in. Override with -DBLOOM_PROFILE=...
+#ifndef BLOOM_PROFILE
+#define BLOOM_PROFILE DeskCubeProfile
+#endif
+
 // ============================================
 // WiFi Configuration
 // ============================================
@@ -18,6 +27,36 @@
 #define GMT_OFFSET_SEC 7200      // UTC+2 (Romania standard time)
 #define DAYLIGHT_OFFSET_SEC 3600 // +1 hour for DST (summer time)
 
+// ============================================
+// MQTT Telemetry (local broker, e.g. Mosquitto)
+// ============================================
+#define MQTT_ENABLED true
+#define MQTT_BROKER ""                  // Host or IP, "" = don't publish
+#define MQTT_PORT 1883
+#define MQTT_USER ""
+#define MQTT_PASSWORD ""
+#define MQTT_TOPIC_PREFIX "bloom"       // Topics: bloom/<cube id>/state, ...
+#define MQTT_BATCH_MS 2000              // Events wait this long to share a message
+#define MQTT_BATCH_MAX 8                // ... or until this many are queued
+#define MQTT_OUTBOX_SIZE 32             // Events kept while the broker is away
+#define MQTT_BUFFER_SIZE 1024           // PubSubClient packet buffer
+#define MQTT_SOCKET_TIMEOUT_S 2
+#define MQTT_BACKOFF_MIN_MS 2000        // Reconnect backoff, doubles per failure
+#define MQTT_BACKOFF_MAX_MS 60000
+#define MQTT_TASK_STACK 4096
+
+// ============================================
+// Fleet Uploads (fleet_server.py on the LAN)
+// ============================================
+#define FLEET_ENABLED true
+#define FLEET_SERVER ""                 // e.g. "http://192.168.1.10:8750", "" = off
+#define FLEET_UPLOAD_INTERVAL_MS 300000 // Records wait this long to share a batch
+#define FLEET_BATCH_MAX 32              // ... or until this many are queued
+#define FLEET_QUEUE_SIZE 64             // Records kept while the server is away
+#define FLEET_BACKOFF_MAX_MS 3600000
+#define FLEET_TIMEOUT_MS 3000
+#define FLEET_TASK_STACK 6144
+
 // ============================================
 // Pin Definitions
 // ============================================
@@ -56,6 +95,7 @@
 // LDR threshold for revive (higher = more light needed)
 #define LDR_REVIVE_THRESHOLD 3000
 #define LDR_REVIVE_DURATION 3000  // ms of light exposure needed
+#define LDR_REVIVE_HYSTERESIS 200 // Once reviving, light counts until it drops this far below
 
 // Flip detection sensitivity
 #define FLIP_THRESHOLD 8.0  // m/s² acceleration change
@@ -68,6 +108,62 @@
 #define WEBSOCKET_UPDATE_INTERVAL 1000    // Send updates every second
 #define ANIMATION_FRAME_DELAY 50          // Animation speed
 
+// ============================================
+// Web Server
+// ============================================
+#define SSE_MAX_CLIENTS 4               // Open /api/events streams
+#define SSE_KEEPALIVE_MS 15000          // Comment line on idle streams
+#define MESSAGE_BUFFER_SIZE 2048        // Largest JSON message (ack with status + plant + all tasks)
+#define STATS_BUFFER_SIZE 1280          // Cached stats message (~970 bytes at most)
+#define HTTP_KEEPALIVE_SLOTS 3          // Open HTTP connections (each is an lwIP socket)
+#define HTTP_KEEPALIVE_TIMEOUT_MS 5000  // Close a connection idle this long
+#define HTTP_KEEPALIVE_MAX_REQUESTS 100 // Then close it anyway (bounds one client's hold)
+
+// ============================================
+// Display Rendering
+// ============================================
+#define OLED_SPI_HZ 2000000     // SPI clock to the SSD1327
+#define OLED_REFRESH_MS 100     // Min time between two frames (10 FPS)
+#define OLED_GRAYSCALE true     // Stream native 4bpp frames (false = U8g2 sendBuffer)
+#define OLED_MONO_LEVEL 15      // Gray level for U8g2 text/lines (0-15)
+#define OLED_GLOW_LEVEL 6       // Peak level of the soft glow behind flowers
+#define GRAY_FB_BENCHMARK false // Print 4bpp kernel timings at boot
+#define OLED_PRERENDER true     // Draw likely next timer frame ahead of flips
+#define PRERENDER_LEAD_SECONDS 2 // Prerender when a timer has this much left
+#define RENDER_SELFTEST false   // Print draw time / SPI bytes per screen at boot (goldens: host/)
+
+// ============================================
+// Display Power
+// ============================================
+#define DISPLAY_POWER_MANAGER true      // LDR contrast + panel sleep (false = fixed contrast, always on)
+#define DISPLAY_CONTRAST_FIXED 200      // Contrast with the manager off
+#define DISPLAY_CONTRAST_MIN 16         // Dark room
+#define DISPLAY_CONTRAST_MAX 220        // Bright room
+#define DISPLAY_CONTRAST_STEP 8         // Change needed before the panel is told (hysteresis)
+#define DISPLAY_LIGHT_SMOOTHING 3       // LDR moving average weight 1/2^n per sensor read
+#define DISPLAY_SLEEP_FACE_DOWN true    // Panel off while the cube lies on its screen
+#define DISPLAY_FACE_DOWN_DELAY_MS 2000 // ...after this long (quick flips back stay lit)
+#define DISPLAY_IDLE_SLEEP_MS 300000    // Panel off after 5 min in idle without input (0 = never)
+#define DISPLAY_ON_BASE_UA 1200         // Current model: panel on, all pixels dark
+#define DISPLAY_FULL_WHITE_UA 45000     // Current model: all pixels at level 15, contrast 255
+#define DISPLAY_SLEEP_UA 10             // Current model: sleep mode
+
+// ============================================
+// Diagnostics
+// ============================================
+#define LATENCY_TRACE true              // Stage timestamps for flips / traced web actions
+#define LATENCY_TRACE_TIMEOUT_MS 2000   // Finish a trace if no client acknowledges it
+#define NVS_TRACE true                  // Log NVS writes for /api/flash
+#define NVS_TRACE_DEPTH 128             // Writes kept (saveTasks() alone is up to 61)
+#define LATENCY_RUN false               // POST /api/latency flips the cube in software, test builds only
+#define SCENARIO_RUNNER false           // POST /api/scenario, test builds only (wipes NVS, sets the clock)
+#ifndef HEAP_TRACKER
+#define HEAP_TRACKER false              // Per-call-site operator new accounting (/api/heap)
+#endif
+#define INPUT_JOURNAL true              // Record inputs to flash for replay (/api/journal)
+#define JOURNAL_PARTITION_LABEL "spiffs" // Data partition it overwrites (no filesystem is used)
+#define JOURNAL_SECTORS 16              // 4 KB each, oldest erased ahead from loop()
+
 // ============================================
 // NVS Keys (Persistent Storage)
 // ============================================
@@ -78,6 +174,7 @@
 #define NVS_KEY_TASKS_DONE "tasksDone"
 #define NVS_KEY_TASKS_TOTAL "tasksTotal"
 #define NVS_KEY_FOCUS_MINUTES "focusMins"
+#define NVS_RESTORE_NAMESPACE "bloomRestore" // Validated backup until it is applied
 
 // ============================================
 // Debug
@@ -46,7 +46,16 @@ const state = {
     goalLocked: false, // Dacă obiectivul a fost confirmat
     selectedTaskId: 0,  // Task pregătit pentru pornire cu flip MPU
     showingConfirmModal: false,  // Modal de confirmare flip
-    flipCancelledWaitingFlipBack: false  // Waiting for user to flip back after cancel
+    flipCancelledWaitingFlipBack: false,  // Waiting for user to flip back after cancel
+    lastTraceAck: 0,  // Latency trace id already acknowledged
+    events: null,     // EventSource used while the WebSocket is down
+    eventsConnected: false,
+    statusPoll: null, // /api/status poll when the cube refuses the event stream
+    version: null,    // Cube state version the UI is showing (see sendAction)
+    server: { status: null, plant: null, tasks: null },  // Last state the cube sent
+    actionQueue: [],
+    actionInFlight: null,
+    nextActionId: 1
 };
 
 // Plant stages configuration
@@ -116,6 +125,10 @@ const elements = {
     weeklyChart: document.getElementById('weeklyChart'),
     bestDay: document.getElementById('bestDay'),
     
+    // Screen Mirror
+    screenCanvas: document.getElementById('screenCanvas'),
+    btnScreenMirror: document.getElementById('btnScreenMirror'),
+    
     // Footer
     espIP: document.getElementById('espIP'),
     
@@ -166,19 +179,29 @@ function connectWebSocket() {
     try {
         console.log('Attempting WebSocket connection to:', CONFIG.WS_URL);
         state.ws = new WebSocket(CONFIG.WS_URL);
+        state.ws.binaryType = 'arraybuffer';  // OLED mirror frames
         
         state.ws.onopen = () => {
             console.log('WebSocket connected successfully');
             state.wsConnected = true;
             setConnectionStatus(true);
             showToast('Conectat la ESP32!', 'success');
-            // Refresh stats on reconnect
-            fetchWeeklyStats();
+            // The cube sends tasks, plant, status and stats on connect
+            stopEventStream();
+            stopStatusPolling();
+            // Resume screen mirror (server answers with a keyframe)
+            if (screenMirror.subscribed) {
+                state.ws.send(JSON.stringify({ action: 'subscribeScreen' }));
+            }
         };
         
         state.ws.onmessage = (event) => {
+            if (event.data instanceof ArrayBuffer) {
+                handleScreenFrame(event.data);
+                return;
+            }
             try {
-                const data = JSON.parse(event.data);
+                const data = Messages.decode(JSON.parse(event.data));
                 handleWebSocketMessage(data);
             } catch (e) {
                 console.error('Failed to parse WS message:', e);
@@ -189,6 +212,13 @@ function connectWebSocket() {
             console.log('WebSocket disconnected');
             state.wsConnected = false;
             setConnectionStatus(false);
+            startEventStream();
+            // An unacked action may or may not have applied: the state sent on
+            // reconnect settles it. Anything queued goes over REST meanwhile.
+            if (state.actionInFlight) {
+                state.actionInFlight = null;
+                sendNextAction();
+            }
             // Reconnect after delay
             setTimeout(connectWebSocket, CONFIG.RECONNECT_INTERVAL);
         };
@@ -205,20 +235,86 @@ function connectWebSocket() {
     }
 }
 
+// While the WebSocket is down, follow the cube over Server-Sent Events
+// (same messages; the browser reconnects and resumes by itself)
+function startEventStream() {
+    if (state.events || isDevMode() || typeof EventSource === 'undefined') return;
+
+    state.events = new EventSource(`${CONFIG.API_BASE}/api/events`);
+    ['status', 'plant', 'tasks', 'stats', 'revive'].forEach(type => {
+        state.events.addEventListener(type, (event) => {
+            handleWebSocketMessage(Messages.decode(JSON.parse(event.data)));
+        });
+    });
+    state.events.onopen = () => {
+        state.eventsConnected = true;
+        stopStatusPolling();
+        setConnectionStatus(true);
+        console.log('Following the cube via /api/events (WebSocket unavailable)');
+    };
+    state.events.onerror = () => {
+        state.eventsConnected = false;
+        // A dropped stream reconnects by itself; a refused one (503, all
+        // stream slots taken) is CLOSED for good, so poll instead
+        if (state.events && state.events.readyState === EventSource.CLOSED) {
+            state.events = null;
+            startStatusPolling();
+        }
+    };
+}
+
+function stopEventStream() {
+    if (!state.events) return;
+    state.events.close();
+    state.events = null;
+    state.eventsConnected = false;
+}
+
+// Last resort while the WebSocket is down: poll /api/status every 2 s
+function startStatusPolling() {
+    if (state.statusPoll) return;
+    console.log('Polling /api/status (WebSocket and /api/events unavailable)');
+    state.statusPoll = setInterval(() => {
+        if (state.wsConnected) {
+            stopStatusPolling();
+            return;
+        }
+        fetchStatus();
+    }, 2000);
+}
+
+function stopStatusPolling() {
+    if (!state.statusPoll) return;
+    clearInterval(state.statusPoll);
+    state.statusPoll = null;
+}
+
 function handleWebSocketMessage(data) {
+    if (data.ver !== undefined) {
+        state.version = data.ver;
+    }
     switch (data.type) {
         case 'status':
+            noteServerState('status', data);
             updateStatus(data);
+            if (data.trace && data.trace !== state.lastTraceAck) {
+                acknowledgeTrace(data.trace);
+            }
             break;
         case 'plant':
+            noteServerState('plant', data);
             updatePlant(data);
             break;
         case 'tasks':
+            noteServerState('tasks', data.tasks || []);
             state.tasks = data.tasks || [];
             renderTasks();
             break;
+        case 'ack':
+            handleActionAck(data);
+            break;
         case 'stats':
-            updateStats(data);
+            updateWeeklyStats(data);
             break;
         case 'flip':
             showToast('Cub întors! ' + (data.paused ? 'Pauză' : 'Continui'), 'success');
@@ -230,6 +326,16 @@ function handleWebSocketMessage(data) {
     }
 }
 
+// Latency trace: tell the cube once this status has been painted
+function acknowledgeTrace(id) {
+    state.lastTraceAck = id;
+    requestAnimationFrame(() => {
+        if (state.ws && state.ws.readyState === WebSocket.OPEN) {
+            state.ws.send(JSON.stringify({ action: 'traceAck', trace: id }));
+        }
+    });
+}
+
 function sendWebSocketMessage(data) {
     if (state.ws && state.ws.readyState === WebSocket.OPEN) {
         state.ws.send(JSON.stringify(data));
@@ -239,6 +345,182 @@ function sendWebSocketMessage(data) {
     }
 }
 
+// ============================================
+// Actions (optimistic, versioned)
+// ============================================
+
+// State-changing actions are applied to the UI right away and sent with
+// the version that UI was showing. The cube applies them only if nothing
+// changed since; otherwise its ack rejects them and carries what did.
+// One action is in flight at a time: the next needs the version the ack returns.
+function sendAction(data) {
+    state.actionQueue.push(data);
+    if (!state.actionInFlight) {
+        sendNextAction();
+    }
+}
+
+function sendNextAction() {
+    const action = state.actionQueue.shift() || null;
+    state.actionInFlight = action;
+    if (!action) return;
+
+    action.id = state.nextActionId++;
+    if (state.version !== null) {
+        action.ver = state.version;
+    }
+
+    if (state.ws && state.ws.readyState === WebSocket.OPEN) {
+        state.ws.send(JSON.stringify(action));
+    } else {
+        // REST replies carry the delta themselves (there are no broadcasts)
+        sendAPIRequest(action).then(reply => {
+            // null = not delivered; success without ok = an error reply
+            // (unknown action, unversioned refusal). ok: false is an ack.
+            if (!reply || (!reply.success && reply.ok === undefined)) {
+                rejectAction(action, reply !== null);
+                return;
+            }
+            handleActionAck(Object.assign({}, reply, { id: action.id }));
+        });
+    }
+}
+
+// Nothing was applied: undo the optimistic edits and drop the actions
+// queued on top of them
+function rejectAction(action, refused) {
+    if (!state.actionInFlight || action.id !== state.actionInFlight.id) return;
+    state.actionInFlight = null;
+    state.actionQueue = [];
+    restoreServerState();
+    if (refused) {
+        showToast('Cubul a refuzat actiunea', 'error');
+    }
+}
+
+function handleActionAck(ack) {
+    if (!state.actionInFlight || ack.id !== state.actionInFlight.id) return;
+    const sentVer = state.actionInFlight.ver;
+    state.actionInFlight = null;
+
+    if (ack.ver !== undefined) {
+        state.version = ack.ver;
+    }
+    if (ack.ok === false) {
+        // Another phone or the cube got there first, or the cube had nothing
+        // to apply (same version back): undo our optimistic edits, then take
+        // what changed. Queued actions built on them go too.
+        state.actionQueue = [];
+        restoreServerState();
+        if (ack.ver !== undefined && ack.ver === sentVer) {
+            showToast('Cubul a refuzat actiunea', 'error');
+        } else {
+            showToast('Starea s-a schimbat intre timp, actiunea a fost anulata', 'error');
+        }
+    }
+    applyServerDelta(ack);
+    sendNextAction();
+}
+
+// Copies: the optimistic updates edit state.tasks in place
+function noteServerState(kind, data) {
+    state.server[kind] = JSON.parse(JSON.stringify(data));
+}
+
+function restoreServerState() {
+    const server = state.server;
+    if (server.tasks) {
+        state.tasks = JSON.parse(JSON.stringify(server.tasks));
+        renderTasks();
+    }
+    if (server.plant) updatePlant(server.plant);
+    if (server.status) updateStatus(server.status);
+}
+
+function applyServerDelta(reply) {
+    if (reply.tasks) {
+        noteServerState('tasks', reply.tasks);
+        state.tasks = reply.tasks;
+        renderTasks();
+    }
+    if (reply.plant) {
+        noteServerState('plant', reply.plant);
+        updatePlant(reply.plant);
+    }
+    if (reply.status) {
+        noteServerState('status', reply.status);
+        updateStatus(reply.status);
+    }
+}
+
+// ============================================
+// Cube Screen Mirror
+// ============================================
+
+// Binary frames: [kind, flags, seqLo, seqHi, ...zero-run RLE]
+// kind 0 = full frame, 1 = XOR delta vs previous frame
+const screenMirror = {
+    subscribed: false,
+    frame: new Uint8Array(2048),  // U8g2 tile layout: 16 pages x 128 columns
+    rotated: false
+};
+
+function toggleScreenMirror() {
+    if (!state.ws || state.ws.readyState !== WebSocket.OPEN) {
+        showToast('Necesita conexiune WebSocket', 'error');
+        return;
+    }
+    screenMirror.subscribed = !screenMirror.subscribed;
+    state.ws.send(JSON.stringify({
+        action: screenMirror.subscribed ? 'subscribeScreen' : 'unsubscribeScreen'
+    }));
+    elements.btnScreenMirror.textContent = screenMirror.subscribed ? 'Opreste' : 'Arata ecranul';
+}
+
+function handleScreenFrame(buffer) {
+    const packet = new Uint8Array(buffer);
+    const isKey = packet[0] === 0;
+    const frame = screenMirror.frame;
+    let out = 0;
+    let i = 4;
+
+    while (i < packet.length && out < frame.length) {
+        const token = packet[i++];
+        const count = (token & 0x7F) + 1;
+        if (token & 0x80) {
+            if (isKey) frame.fill(0, out, out + count);
+            out += count;
+        } else {
+            for (let k = 0; k < count; k++, out++, i++) {
+                frame[out] = isKey ? packet[i] : frame[out] ^ packet[i];
+            }
+        }
+    }
+
+    screenMirror.rotated = (packet[1] & 1) !== 0;
+    drawScreenFrame();
+}
+
+function drawScreenFrame() {
+    const ctx = elements.screenCanvas.getContext('2d');
+    const image = ctx.createImageData(128, 128);
+    const frame = screenMirror.frame;
+
+    for (let y = 0; y < 128; y++) {
+        for (let x = 0; x < 128; x++) {
+            // Show it the way the user reads the cube
+            const nx = screenMirror.rotated ? 127 - x : x;
+            const ny = screenMirror.rotated ? 127 - y : y;
+            const lit = frame[(ny >> 3) * 128 + nx] & (1 << (ny & 7));
+            const p = (y * 128 + x) * 4;
+            const v = lit ? 255 : 0;
+            image.data[p] = image.data[p + 1] = image.data[p + 2] = v;
+            image.data[p + 3] = 255;
+        }
+    }
+    ctx.putImageData(image, 0, 0);
+}
+
 // ============================================
 // API Communication
 // ============================================
@@ -255,7 +537,7 @@ async function sendAPIRequest(action) {
             headers: { 'Content-Type': 'application/json' },
             body: JSON.stringify(action)
         });
-        return await response.json();
+        return Messages.decodeActionReply(await response.json());
     } catch (e) {
         console.error('API request failed:', e);
         showToast('Eroare de conexiune', 'error');
@@ -270,7 +552,9 @@ async function fetchTasks() {
     
     try {
         const response = await fetch(`${CONFIG.API_BASE}/api/tasks`);
-        const data = await response.json();
+        const data = Messages.decodeApiTasks(await response.json());
+        if (data.ver !== undefined) state.version = data.ver;
+        noteServerState('tasks', data.tasks || []);
         state.tasks = data.tasks || [];
         renderTasks();
     } catch (e) {
@@ -291,8 +575,11 @@ async function fetchStatus() {
     try {
         const response = await fetch(url);
         console.log('fetchStatus response:', response.status);
-        const data = await response.json();
+        const data = Messages.decodeApiStatus(await response.json());
         console.log('fetchStatus data:', data);
+        if (data.ver !== undefined) state.version = data.ver;
+        noteServerState('status', data);
+        noteServerState('plant', data.plant);
         updateStatus(data);
         updatePlant(data.plant);
         updateStats(data.stats);
@@ -366,11 +653,6 @@ function updateStatus(data) {
     // Only re-render tasks if status or current task changed (avoid flickering)
     if (prevStatus !== state.status || prevTask !== state.currentTask) {
         renderTasks();
-        
-        // Refresh stats when transitioning to idle or break (session ended)
-        if (state.status === 'idle' || state.status === 'break') {
-            fetchWeeklyStats();
-        }
     }
 }
 
@@ -536,7 +818,7 @@ function setDailyGoal() {
     updatePlant();
     showToast(`Obiectiv setat: ${goalValue} task-uri! Planta a fost resetata.`, 'success');
     
-    sendWebSocketMessage({
+    sendAction({
         action: 'setGoal',
         goal: goalValue
     });
@@ -590,61 +872,145 @@ function updateStats(data) {
 // Task Management
 // ============================================
 
+// Task rows by id. A render builds each task's view and touches only the
+// rows (and within them, the parts) that differ from what is on screen.
+const taskRows = new Map();
+
 function renderTasks() {
     const container = elements.taskItems;
-    
-    if (state.tasks.length === 0) {
-        container.innerHTML = `
-            <div class="empty-state">
-                <span class="empty-icon">--</span>
-                <span class="empty-text">Niciun task adaugat</span>
-            </div>
-        `;
-        elements.taskCount.textContent = '0 task-uri';
-        return;
+    const seen = new Set();
+    let anchor = elements.emptyState;  // Rows follow the empty-state node
+    let completed = 0;
+
+    for (const task of state.tasks) {
+        if (task.completed) completed++;
+        seen.add(task.id);
+
+        let row = taskRows.get(task.id);
+        if (!row) {
+            row = createTaskRow(task.id);
+            taskRows.set(task.id, row);
+        }
+        patchTaskRow(row, taskView(task));
+
+        if (anchor.nextSibling !== row.el) {
+            container.insertBefore(row.el, anchor.nextSibling);
+        }
+        anchor = row.el;
     }
-    
-    container.innerHTML = state.tasks.map(task => {
-        const isSelected = state.selectedTaskId === task.id;
-        const isActive = task.active || (state.status === 'focusing' && state.currentTask === task.name);
-        
-        // Determine hint text based on state
-        let hintText = '';
-        if (isSelected && !isActive) {
-            hintText = '<div class="task-hint">Flip the cube to start!</div>';
-        } else if (isActive && state.status === 'focusing') {
-            hintText = '<div class="task-hint active">Flip back when done</div>';
+
+    for (const [id, row] of taskRows) {
+        if (!seen.has(id)) {
+            row.el.remove();
+            taskRows.delete(id);
         }
-        // No hint for completed tasks or idle state
-        
-        return `
-        <div class="task-item ${task.completed ? 'completed' : ''} ${isActive ? 'active' : ''} ${isSelected ? 'selected' : ''}" data-id="${task.id}">
-            <div class="task-checkbox ${task.completed ? 'checked' : ''} ${!task.started ? 'disabled' : ''}" 
-                 ${task.started ? `onclick="toggleTaskComplete(${task.id})"` : `onclick="showToast('Trebuie sa pornesti task-ul inainte!', 'error')"`}>
-            </div>
-            <div class="task-info">
-                <div class="task-name">${escapeHtml(task.name)}</div>
-                <div class="task-duration">Focus: ${task.focusDuration}min / Pauza: ${task.breakDuration}min</div>
-                ${hintText}
-            </div>
-            <div class="task-actions">
-                ${!task.completed && !isActive ? `
-                    ${!isSelected ? `<button class="task-btn select" onclick="selectTask(${task.id})" title="Select">&#10003;</button>` : ''}
-                    ${isSelected ? `<button class="task-btn cancel" onclick="cancelSelection()" title="Cancel">&#10007;</button>` : ''}
-                    <button class="task-btn delete" onclick="deleteTask(${task.id})" title="Delete">&#10005;</button>
-                ` : ''}
-            </div>
-        </div>
-    `}).join('');
-    
+    }
+
+    elements.emptyState.style.display = state.tasks.length === 0 ? '' : 'none';
     elements.taskCount.textContent = `${state.tasks.length} task-uri`;
     updateStats({
-        completed: state.tasks.filter(t => t.completed).length,
+        completed: completed,
         total: state.tasks.length,
         focusMinutes: state.stats.focusMinutes
     });
 }
 
+// Everything a task row shows
+function taskView(task) {
+    const selected = state.selectedTaskId === task.id;
+    const active = !!(task.active || (state.status === 'focusing' && state.currentTask === task.name));
+
+    let hint = '';
+    if (selected && !active) {
+        hint = 'Flip the cube to start!';
+    } else if (active && state.status === 'focusing') {
+        hint = 'Flip back when done';
+    }
+
+    return {
+        name: task.name,
+        duration: `Focus: ${task.focusDuration}min / Pauza: ${task.breakDuration}min`,
+        completed: !!task.completed,
+        started: !!task.started,
+        active: active,
+        selected: selected,
+        hint: hint,
+        // Select / cancel / delete buttons only for tasks not done or running
+        editable: !task.completed && !active
+    };
+}
+
+function createTaskRow(id) {
+    const el = document.createElement('div');
+    el.className = 'task-item';
+    el.dataset.id = id;
+    el.innerHTML = `
+        <div class="task-checkbox" data-action="toggle"></div>
+        <div class="task-info">
+            <div class="task-name"></div>
+            <div class="task-duration"></div>
+            <div class="task-hint"></div>
+        </div>
+        <div class="task-actions">
+            <button class="task-btn select" data-action="select" title="Select">&#10003;</button>
+            <button class="task-btn cancel" data-action="cancel" title="Cancel">&#10007;</button>
+            <button class="task-btn delete" data-action="delete" title="Delete">&#10005;</button>
+        </div>
+    `;
+    return {
+        el: el,
+        checkbox: el.querySelector('.task-checkbox'),
+        name: el.querySelector('.task-name'),
+        duration: el.querySelector('.task-duration'),
+        hint: el.querySelector('.task-hint'),
+        actions: el.querySelector('.task-actions'),
+        select: el.querySelector('.task-btn.select'),
+        cancel: el.querySelector('.task-btn.cancel'),
+        view: {}
+    };
+}
+
+function patchTaskRow(row, view) {
+    const old = row.view;
+    if (view.name !== old.name) row.name.textContent = view.name;
+    if (view.duration !== old.duration) row.duration.textContent = view.duration;
+    if (view.completed !== old.completed || view.active !== old.active || view.selected !== old.selected) {
+        row.el.classList.toggle('completed', view.completed);
+        row.el.classList.toggle('active', view.active);
+        row.el.classList.toggle('selected', view.selected);
+    }
+    if (view.completed !== old.completed || view.started !== old.started) {
+        row.checkbox.classList.toggle('checked', view.completed);
+        row.checkbox.classList.toggle('disabled', !view.started);
+    }
+    if (view.hint !== old.hint || view.active !== old.active) {
+        row.hint.textContent = view.hint;
+        row.hint.classList.toggle('active', view.active);
+        row.hint.style.display = view.hint ? '' : 'none';
+    }
+    if (view.editable !== old.editable || view.selected !== old.selected) {
+        row.actions.style.display = view.editable ? '' : 'none';
+        row.select.style.display = view.selected ? 'none' : '';
+        row.cancel.style.display = view.selected ? '' : 'none';
+    }
+    row.view = view;
+}
+
+// One listener for every row, present and future
+function handleTaskListClick(e) {
+    const target = e.target.closest('[data-action]');
+    const row = target && target.closest('.task-item');
+    if (!row) return;
+
+    const id = Number(row.dataset.id);
+    switch (target.dataset.action) {
+        case 'toggle': toggleTaskComplete(id); break;
+        case 'select': selectTask(id); break;
+        case 'cancel': cancelSelection(); break;
+        case 'delete': deleteTask(id); break;
+    }
+}
+
 function addTask() {
     const name = elements.taskName.value.trim();
     const focusDuration = parseInt(elements.focusTime.value) || 25;
@@ -673,7 +1039,7 @@ function addTask() {
     };
     
     // Send to ESP32
-    sendWebSocketMessage({
+    sendAction({
         action: 'addTask',
         task: newTask
     });
@@ -696,7 +1062,7 @@ function startTask(id) {
     const task = state.tasks.find(t => t.id === id);
     if (!task) return;
     
-    sendWebSocketMessage({
+    sendAction({
         action: 'startTask',
         taskId: id
     });
@@ -737,7 +1103,7 @@ function selectTask(id) {
         return;
     }
     
-    sendWebSocketMessage({
+    sendAction({
         action: 'selectTask',
         taskId: id
     });
@@ -789,7 +1155,7 @@ function toggleTaskComplete(id) {
         actualMinutesSpent = task.focusDuration;
     }
     
-    sendWebSocketMessage({
+    sendAction({
         action: 'toggleTask',
         taskId: id,
         completed: task.completed
@@ -836,7 +1202,7 @@ function deleteTask(id) {
             
             state.tasks = state.tasks.filter(t => t.id !== id);
             
-            sendWebSocketMessage({
+            sendAction({
                 action: 'deleteTask',
                 taskId: id
             });
@@ -873,7 +1239,7 @@ function waterPlant() {
         return;
     }
     
-    sendWebSocketMessage({ action: 'water' });
+    sendAction({ action: 'water' });
     
     // Folosește currentSessionGoal dacă există, altfel totalTasks
     const goalsToComplete = state.currentSessionGoal > 0 ? state.currentSessionGoal : state.tasks.length;
@@ -923,7 +1289,7 @@ function killPlant() {
         'Demo Mode',
         'Aceasta va omori planta pentru demonstratie. Poti sa o reinvii cu senzorul de lumina.',
         () => {
-            sendWebSocketMessage({ action: 'kill' });
+            sendAction({ action: 'kill' });
             
             state.plant.isWithered = true;
             updatePlant({ stage: state.plant.stage, isWithered: true });
@@ -1074,7 +1440,7 @@ function showFlipConfirmModal() {
     // Confirm = task completed
     elements.modalConfirm.onclick = () => {
         hideModal();
-        sendWebSocketMessage({ action: 'confirmComplete' });
+        sendAction({ action: 'confirmComplete' });
         showToast('Congratulations! Task completed!', 'success');
         state.selectedTaskId = 0;
         renderTasks();
@@ -1088,16 +1454,10 @@ function showFlipConfirmModal() {
         elements.modalMessage.textContent = 'Flip the cube face-down to continue your focus session.';
         elements.modalConfirm.style.display = 'none';
         elements.modalCancel.style.display = 'none';
-        sendWebSocketMessage({ action: 'cancelComplete' });
+        sendAction({ action: 'cancelComplete' });
     };
 }
 
-function escapeHtml(text) {
-    const div = document.createElement('div');
-    div.textContent = text;
-    return div.innerHTML;
-}
-
 function updateClock() {
     const now = new Date();
     const hours = String(now.getHours()).padStart(2, '0');
@@ -1107,14 +1467,14 @@ function updateClock() {
 
 // ============================================
 // Timer Logic (local countdown for smooth UI)
-// Only runs when WebSocket is disconnected
+// Only runs when neither the WebSocket nor /api/events is connected
 // ============================================
 
 function startLocalTimer() {
     setInterval(() => {
         // Only run local timer if WebSocket is NOT connected
         // When connected, ESP32 sends updates and we use those
-        if (!state.wsConnected && state.timeLeft > 0 && (state.status === 'focusing' || state.status === 'break')) {
+        if (!state.wsConnected && !state.eventsConnected && state.timeLeft > 0 && (state.status === 'focusing' || state.status === 'break')) {
             state.timeLeft--;
             updateTimerDisplay();
             
@@ -1190,7 +1550,7 @@ async function fetchWeeklyStats() {
     
     try {
         const response = await fetch(`${CONFIG.API_BASE}/api/stats`);
-        const data = await response.json();
+        const data = Messages.decodeStats(await response.json());
         updateWeeklyStats(data);
     } catch (e) {
         console.error('Failed to fetch weekly stats:', e);
@@ -1303,7 +1663,7 @@ function resetDay() {
         'Resetare Zi',
         'Aceasta va reseta toate task-urile si planta pentru o zi noua. Esti sigur?',
         () => {
-            sendWebSocketMessage({ action: 'restartDay' });
+            sendAction({ action: 'restartDay' });
             
             // Reset local state
             state.tasks = [];
@@ -1395,6 +1755,9 @@ function initEventListeners() {
         });
     }
     
+    // Task list (rows come and go, the listener stays on the container)
+    elements.taskItems.addEventListener('click', handleTaskListClick);
+    
     // Plant actions
     elements.btnWater.addEventListener('click', waterPlant);
     elements.btnKill.addEventListener('click', killPlant);
@@ -1409,6 +1772,11 @@ function initEventListeners() {
         elements.btnResetDay.addEventListener('click', resetDay);
     }
     
+    // Screen mirror
+    if (elements.btnScreenMirror) {
+        elements.btnScreenMirror.addEventListener('click', toggleScreenMirror);
+    }
+    
     // Modal - only allow closing by clicking overlay if NOT waiting for flip back
     // Note: modalCancel behavior is set dynamically in showModal/showFlipConfirmModal
     elements.modalOverlay.addEventListener('click', (e) => {
@@ -1442,6 +1810,14 @@ function init() {
     updateClock();
     setInterval(updateClock, 1000);
     
+    // Cache the app shell for the next visit. Browsers only allow service
+    // workers on https / localhost; over plain http the ETag on / does it.
+    if ('serviceWorker' in navigator && window.isSecureContext) {
+        navigator.serviceWorker.register('/sw.js').catch(e => {
+            console.log('Service worker not registered:', e);
+        });
+    }
+    
     // Try WebSocket first
     connectWebSocket();
     
@@ -1454,17 +1830,8 @@ function init() {
     fetchTasks();
     fetchWeeklyStats();
     
-    // Refresh weekly stats every 30 seconds
-    setInterval(fetchWeeklyStats, 30000);
-    
-    // API polling only when WebSocket is not connected
-    // Reduces load when already getting updates via WebSocket
-    setInterval(() => {
-        if (!state.wsConnected) {
-            fetchStatus();
-            console.log('Polling for status (WS disconnected)...');
-        }
-    }, 2000);  // Poll every 2 seconds instead of 1
+    // No polling: stats and state are pushed (WebSocket, or /api/events
+    // while the WebSocket is down; /api/status polls only if both fail)
     
     console.log('🌱 Productivity Bloom ready!');
 }
@@ -0,0 +1,220 @@
+/**
+ * Productivity Bloom - Message decoders
+ * Generated by build_messages.py from messages.json - do not edit
+ */
+
+const Messages = (() => {
+    const num = v => (typeof v === 'number' ? v : 0);
+    const bool = v => v === true;
+    const str = v => (typeof v === 'string' ? v : '');
+    const strOrNull = v => (typeof v === 'string' ? v : null);
+    const list = (v, decode) => (Array.isArray(v) ? v.map(decode) : []);
+
+    function decodeTask(d) {
+        d = d || {};
+        const m = {
+            id: num(d.id),
+            name: str(d.name),
+            focusDuration: num(d.focusDuration),
+            breakDuration: num(d.breakDuration),
+            completed: bool(d.completed),
+            started: bool(d.started),
+        };
+        return m;
+    }
+
+    function decodeWeekly(d) {
+        d = d || {};
+        const m = {
+            totalTasks: num(d.totalTasks),
+            totalFocus: num(d.totalFocus),
+            totalBreak: num(d.totalBreak),
+            totalSessions: num(d.totalSessions),
+            avgTasksPerDay: num(d.avgTasksPerDay),
+            avgFocusPerDay: num(d.avgFocusPerDay),
+            mostProductiveDay: num(d.mostProductiveDay),
+            mostProductiveTasks: num(d.mostProductiveTasks),
+            daysRecorded: num(d.daysRecorded),
+            hasFullWeek: bool(d.hasFullWeek),
+            mostProductiveDayName: str(d.mostProductiveDayName),
+        };
+        return m;
+    }
+
+    function decodeDay(d) {
+        d = d || {};
+        const m = {
+            daysAgo: num(d.daysAgo),
+            tasks: num(d.tasks),
+            focus: num(d.focus),
+            valid: bool(d.valid),
+        };
+        return m;
+    }
+
+    function decodeQuantiles(d) {
+        d = d || {};
+        const m = {
+            count: num(d.count),
+            min: num(d.min),
+            p50: num(d.p50),
+            p90: num(d.p90),
+            max: num(d.max),
+        };
+        return m;
+    }
+
+    function decodePlantSummary(d) {
+        d = d || {};
+        const m = {
+            stage: num(d.stage),
+            isWithered: bool(d.isWithered),
+            canWater: bool(d.canWater),
+            wateredCount: num(d.wateredCount),
+            totalGoal: num(d.totalGoal),
+            pendingWater: num(d.pendingWater),
+            dailyGoal: num(d.dailyGoal),
+        };
+        return m;
+    }
+
+    function decodeTaskCounts(d) {
+        d = d || {};
+        const m = {
+            completed: num(d.completed),
+            total: num(d.total),
+        };
+        return m;
+    }
+
+    function decodeStatus(d) {
+        d = d || {};
+        const m = {
+            ver: num(d.ver),
+            state: str(d.state),
+            timeLeft: num(d.timeLeft),
+            totalTime: num(d.totalTime),
+            waitingForConfirmation: bool(d.waitingForConfirmation),
+            taskName: strOrNull(d.taskName),
+        };
+        if (d.trace !== undefined) m.trace = num(d.trace);
+        return m;
+    }
+
+    function decodePlant(d) {
+        d = d || {};
+        const m = {
+            ver: num(d.ver),
+            stage: num(d.stage),
+            isWithered: bool(d.isWithered),
+            wateredCount: num(d.wateredCount),
+            totalGoal: num(d.totalGoal),
+            pendingWater: num(d.pendingWater),
+            dailyGoal: num(d.dailyGoal),
+        };
+        return m;
+    }
+
+    function decodeTasks(d) {
+        d = d || {};
+        const m = {
+            ver: num(d.ver),
+            tasks: list(d.tasks, decodeTask),
+        };
+        return m;
+    }
+
+    function decodeStats(d) {
+        d = d || {};
+        const m = {
+            todayTasks: num(d.todayTasks),
+            todayFocus: num(d.todayFocus),
+            todayBreak: num(d.todayBreak),
+            todaySessions: num(d.todaySessions),
+            weekly: decodeWeekly(d.weekly),
+            days: list(d.days, decodeDay),
+            focusSeconds: decodeQuantiles(d.focusSeconds),
+            pauseTenths: decodeQuantiles(d.pauseTenths),
+            breakSeconds: decodeQuantiles(d.breakSeconds),
+        };
+        return m;
+    }
+
+    function decodeRevive(d) {
+        d = d || {};
+        const m = {
+            message: str(d.message),
+        };
+        return m;
+    }
+
+    function decodeAck(d) {
+        d = d || {};
+        const m = {
+            id: num(d.id),
+            ok: bool(d.ok),
+            ver: num(d.ver),
+        };
+        if (d.status !== undefined) m.status = decodeStatus(d.status);
+        if (d.plant !== undefined) m.plant = decodePlant(d.plant);
+        if (d.tasks !== undefined) m.tasks = list(d.tasks, decodeTask);
+        return m;
+    }
+
+    function decodeActionReply(d) {
+        d = d || {};
+        const m = {
+            success: bool(d.success),
+        };
+        if (d.action !== undefined) m.action = str(d.action);
+        if (d.ok !== undefined) m.ok = bool(d.ok);
+        if (d.ver !== undefined) m.ver = num(d.ver);
+        if (d.status !== undefined) m.status = decodeStatus(d.status);
+        if (d.plant !== undefined) m.plant = decodePlant(d.plant);
+        if (d.tasks !== undefined) m.tasks = list(d.tasks, decodeTask);
+        return m;
+    }
+
+    function decodeApiStatus(d) {
+        d = d || {};
+        const m = {
+            state: str(d.state),
+            timeLeft: num(d.timeLeft),
+            totalTime: num(d.totalTime),
+            taskName: strOrNull(d.taskName),
+            plant: decodePlantSummary(d.plant),
+            stats: decodeTaskCounts(d.stats),
+            ver: num(d.ver),
+        };
+        return m;
+    }
+
+    function decodeApiTasks(d) {
+        d = d || {};
+        const m = {
+            tasks: list(d.tasks, decodeTask),
+            ver: num(d.ver),
+        };
+        return m;
+    }
+
+    const byType = {
+        status: decodeStatus,
+        plant: decodePlant,
+        tasks: decodeTasks,
+        stats: decodeStats,
+        revive: decodeRevive,
+        ack: decodeAck,
+    };
+
+    // Tagged messages get every schema field; other types pass through
+    function decode(d) {
+        const decoder = d && byType[d.type];
+        if (!decoder) return d;
+        const m = decoder(d);
+        m.type = d.type;
+        return m;
+    }
+
+    return { decode, decodeStatus, decodePlant, decodeTasks, decodeStats, decodeRevive, decodeAck, decodeActionReply, decodeApiStatus, decodeApiTasks };
+})();
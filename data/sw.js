@@ -0,0 +1,38 @@
+/**
+ * Productivity Bloom - Service Worker
+ * App shell din cache, starea live vine apoi prin WebSocket / API
+ */
+
+// build_webcontent.py replaces the placeholder with the content hash,
+// so every new build is a new worker with its own cache
+const CACHE_NAME = 'bloom-__WEB_VERSION__';
+const APP_SHELL = ['/', '/manifest.json', '/icon.svg'];
+
+self.addEventListener('install', (event) => {
+    event.waitUntil(
+        caches.open(CACHE_NAME)
+            .then(cache => cache.addAll(APP_SHELL))
+            .then(() => self.skipWaiting())
+    );
+});
+
+self.addEventListener('activate', (event) => {
+    event.waitUntil(
+        caches.keys()
+            .then(keys => Promise.all(keys.filter(k => k !== CACHE_NAME).map(k => caches.delete(k))))
+            .then(() => self.clients.claim())
+    );
+});
+
+// Shell: cache first. API calls and everything else go to the cube.
+self.addEventListener('fetch', (event) => {
+    const url = new URL(event.request.url);
+    if (event.request.method !== 'GET' || url.origin !== self.location.origin) return;
+
+    // Exact paths only: captive portal probes must still reach the cube
+    if (!APP_SHELL.includes(url.pathname)) return;
+
+    event.respondWith(
+        caches.match(url.pathname).then(cached => cached || fetch(event.request))
+    );
+});
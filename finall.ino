@@ -19,15 +19,28 @@
 #include <U8g2lib.h>
 #include <math.h>
 #include "config.h"
+#include "FeatureProfile.h"
 #include "IntervalTimer.h"
 #include "EventQueue.h"
 #include "SystemState.h"
 #include "DisplayRenderer.h"
+#include "DisplayPowerManager.h"
 #include "WebServerHandler.h"
 #include "Analytics.h"
 #include "QRCodeGenerator.h"
 #include "MPU6050Handler.h"
 #include "BuzzerHandler.h"
+#include "RenderSelfTest.h"
+#include "LoopStats.h"
+#include "SimClock.h"
+#include "ScenarioRunner.h"
+#include "HeapTracker.h"
+#include "InputJournal.h"
+#include "MqttPublisher.h"
+#include "FleetUploader.h"
+#include "BackupArchive.h"
+#include "SessionTracker.h"
+#include "ScreenOverlays.h"
 
 // ============================================
 // Global Objects
@@ -40,35 +53,60 @@ SystemState systemState;
 Analytics analytics;
 
 // MPU-6050 Handler (flip detection)
-MPU6050Handler mpuHandler;
+Subsystem<Features::mpu, MPU6050Handler> mpuHandler;
 
 // Buzzer Handler (audio feedback)
-BuzzerHandler buzzer;
+Subsystem<Features::buzzer, BuzzerHandler> buzzer;
 
 // OLED Display - Waveshare 1.5" SSD1327 128x128
 // U8G2_R2 = 180 degree rotation so text is readable when cube is on table
-U8G2_SSD1327_WS_128X128_F_4W_HW_SPI u8g2(U8G2_R2, OLED_CS, OLED_DC, OLED_RST);
+Subsystem<Features::oled, U8G2_SSD1327_WS_128X128_F_4W_HW_SPI> u8g2(U8G2_R2, OLED_CS, OLED_DC, OLED_RST);
 
 // Display Renderer (new architecture)
-DisplayRenderer display(u8g2);
+Subsystem<Features::oled, DisplayRenderer> display(u8g2);
+
+// Ambient contrast + panel sleep (served on /api/display)
+Subsystem<Features::oled, DisplayPowerManager> displayPower(u8g2, display);
 
 // Web Server Handler
 WebServerHandler* webServer = nullptr;
 
+// Loop timing snapshot (served on /api/perf)
+LoopStats loopStats;
+
+// Input-to-pixels stage timing (served on /api/latency)
+LatencyTrace latencyTrace;
+
+// NVS write log (served on /api/flash)
+NvsWriteLog nvsWriteLog;
+
+// Allocation sites (operator new is replaced when HEAP_TRACKER is set)
+HeapTracker heapTracker;
+
+// Every external input, in flash (served on /api/journal)
+InputJournal inputJournal(systemState);
+
+// State + session telemetry to a local MQTT broker
+MqttPublisher mqttPublisher(systemState, analytics);
+
+// Session/day records pushed to fleet_server.py
+FleetUploader fleetUploader;
+
+// Virtual time for scenario runs (see SimClock.h)
+uint32_t simClockOffsetMs = 0;
+ScenarioRunner scenarioRunner(systemState, analytics);
+
 // ============================================
 // Interval Timers (replaces manual millis())
 // ============================================
 IntervalTimer sensorTimer(SENSOR_READ_INTERVAL);  // 100ms default
-IntervalTimer oledRefreshTimer(100);              // 10 FPS
+IntervalTimer oledRefreshTimer(OLED_REFRESH_MS);  // 10 FPS
 IntervalTimer statsTimer(1000);                   // 1 second
 
 // ============================================
 // Timed Screen Overlays (congrats, revive)
 // ============================================
-OneShotTimer congratsTimer;
-OneShotTimer reviveTimer;
-bool showingCongrats = false;
-bool showingRevive = false;
+ScreenOverlays overlays;
 
 // ============================================
 // State Tracking
@@ -76,12 +114,15 @@ bool showingRevive = false;
 bool showedWelcome = false;
 bool displayFlipped = true;  // Start with 180° so text is readable
 volatile bool oledNeedsRefresh = true;
+bool cubeFaceDown = false;  // Last orientation passed to handleCubeFlip()
 
-// Track previous mode for session recording
-SystemMode previousMode = MODE_IDLE;
-uint32_t sessionStartTime = 0;
-uint32_t accumulatedFocusMs = 0;  // Accumulated focus time in ms (for pause handling)
-uint32_t accumulatedBreakMs = 0;  // Accumulated break time in ms
+// Focus/break sessions for analytics, from mode changes
+SessionTracker sessionTracker(analytics);
+
+// Flip-to-pixels latency (micros() at flip detection, 0 = none pending)
+uint32_t flipDetectedUs = 0;
+uint32_t lastFlipLatencyUs = 0;
+uint32_t mpuPollUs = 0;  // Start of the MPU poll that reported the latest flip
 
 // ============================================
 // Forward Declarations
@@ -89,6 +130,15 @@ uint32_t accumulatedBreakMs = 0;  // Accumulated break time in ms
 void processEvents();
 void handleMidnight();
 void refreshOLED();
+void updateFramePrediction();
+bool commitPredictedFrame();
+void reportFlipLatency(bool predicted);
+void handleCubeFlip(bool isFlipped, uint32_t inputUs);
+void updateDisplayPower();
+void wakeDisplay();
+void checkOverlayTimers();
+void scenarioStep();
+const char* currentScreenName();
 
 // ============================================
 // Setup
@@ -106,55 +156,72 @@ void setup() {
     pinMode(LDR_PIN, INPUT);
 
     // Initialize OLED Display
-    DEBUG_PRINTLN("Initializing OLED...");
-    
-    pinMode(OLED_RST, OUTPUT);
-    digitalWrite(OLED_RST, LOW);
-    delay(50);
-    digitalWrite(OLED_RST, HIGH);
-    delay(100);
-    
-    SPI.begin(OLED_SCLK, -1, OLED_MOSI, OLED_CS);
-    SPI.setFrequency(2000000);
-
-    delay(100);
-
-    u8g2.begin();
-    delay(50);
-    // Rotation is set in constructor (U8G2_R2 = 180°)
-    u8g2.clearBuffer();
-    u8g2.setFont(u8g2_font_6x12_tr);
-    u8g2.setDrawColor(1);
-    u8g2.setContrast(200);
-
-    // Show splash screen
-    display.beginFrame();
-    u8g2.setFont(u8g2_font_ncenB14_tr);
     const char* title = "Bloom v3.0";
-    int16_t titleWidth = u8g2.getStrWidth(title);
-    u8g2.drawStr((128 - titleWidth) / 2, 55, title);
-    
-    u8g2.setFont(u8g2_font_6x12_tr);
-    const char* subtitle = "Connecting WiFi...";
-    int16_t subWidth = u8g2.getStrWidth(subtitle);
-    u8g2.drawStr((128 - subWidth) / 2, 75, subtitle);
-    display.endFrame();
-
-    DEBUG_PRINTLN("OLED initialized!");
+    if constexpr (Features::oled) {
+        DEBUG_PRINTLN("Initializing OLED...");
+
+        pinMode(OLED_RST, OUTPUT);
+        digitalWrite(OLED_RST, LOW);
+        delay(50);
+        digitalWrite(OLED_RST, HIGH);
+        delay(100);
+
+        SPI.begin(OLED_SCLK, -1, OLED_MOSI, OLED_CS);
+        SPI.setFrequency(OLED_SPI_HZ);
+
+        delay(100);
+
+        u8g2->begin();
+        delay(50);
+        // Rotation is set in constructor (U8G2_R2 = 180°)
+        u8g2->clearBuffer();
+        u8g2->setFont(u8g2_font_6x12_tr);
+        u8g2->setDrawColor(1);
+        displayPower->begin(analogRead(LDR_PIN));
+
+#if GRAY_FB_BENCHMARK
+        benchmarkGrayFramebuffer(display->grayBuffer(), *u8g2);
+#endif
+#if RENDER_SELFTEST
+        runRenderSelfTest(*display, *u8g2);
+#endif
+
+        // Show splash screen
+        display->beginFrame();
+        u8g2->setFont(u8g2_font_ncenB14_tr);
+        int16_t titleWidth = u8g2->getStrWidth(title);
+        u8g2->drawStr((128 - titleWidth) / 2, 55, title);
+
+        u8g2->setFont(u8g2_font_6x12_tr);
+        const char* subtitle = "Connecting WiFi...";
+        int16_t subWidth = u8g2->getStrWidth(subtitle);
+        u8g2->drawStr((128 - subWidth) / 2, 75, subtitle);
+        display->endFrame();
+
+        DEBUG_PRINTLN("OLED initialized!");
+    }
 
     // Initialize SystemState
     systemState.begin();
 
+    // Input journal: boot record now, state snapshot once analytics is loaded
+    inputJournal.begin();
+    inputJournal.recordBoot(time(nullptr));
+
     // Register callbacks (legacy support - they also push to EventQueue)
-    systemState.onStateChanged([]() {
-        oledNeedsRefresh = true;
-    });
-    systemState.onTimerTick([]() {
-        oledNeedsRefresh = true;
-    });
-    systemState.onPlantChanged([]() {
-        oledNeedsRefresh = true;
-    });
+    if constexpr (Features::oled) {
+        systemState.onStateChanged([]() {
+            oledNeedsRefresh = true;
+            displayPower->noteActivity();
+        });
+        systemState.onTimerTick([]() {
+            oledNeedsRefresh = true;
+        });
+        systemState.onPlantChanged([]() {
+            oledNeedsRefresh = true;
+            displayPower->noteActivity();
+        });
+    }
 
     DEBUG_PRINTLN("SystemState initialized!");
 
@@ -163,61 +230,101 @@ void setup() {
     webServer = new WebServerHandler(&systemState);
     webServer->begin();
 
+    // Mirror every committed OLED frame to subscribed web clients
+    if constexpr (Features::oled) {
+        display->onFrameCommitted([](const uint8_t* tiles, bool rotated) {
+            latencyTrace.mark(LatencyStage::FRAME);
+            displayPower->onFrame(tiles);
+            if (webServer) {
+                webServer->publishFrame(tiles, rotated);
+            }
+        });
+    }
+
+#if LATENCY_RUN
+    // Flip without touching the cube, for latency measurements. Not a
+    // real input: the journal only marks where replay stops matching.
+    webServer->onSyntheticFlip([]() {
+        inputJournal.recordScenario();
+        handleCubeFlip(!cubeFaceDown, micros());
+    });
+#endif
+
+#if SCENARIO_RUNNER
+    // Scripted scenarios (POST /api/scenario) use the same entry points
+    scenarioRunner.onFlip([](bool isFlipped) { handleCubeFlip(isFlipped, micros()); });
+    scenarioRunner.onStep(scenarioStep);
+    scenarioRunner.onWebAction([](const char* json) { webServer->injectMessage(json); });
+    scenarioRunner.onScreen(currentScreenName);
+    scenarioRunner.onFinish([]() {
+        // Outputs were held back during the run: catch everything up once
+        eventQueue.push(Event::WEB_BROADCAST);
+        eventQueue.push(Event::STATS_CHANGED);
+        eventQueue.push(Event::OLED_REFRESH);
+        webServer->broadcastTasks();
+    });
+    webServer->setScenarioRunner(&scenarioRunner);
+#endif
+
     // Update OLED to show ready state
-    if (webServer->isAPMode()) {
-        display.beginFrame();
-        display.drawBorder();
-        display.drawQRScreen();
-        display.endFrame();
-        DEBUG_PRINTLN("Showing AP mode QR code screen");
-    } else {
-        display.beginFrame();
-        u8g2.setFont(u8g2_font_ncenB14_tr);
-        u8g2.drawStr((128 - titleWidth) / 2, 55, title);
-        
-        u8g2.setFont(u8g2_font_6x12_tr);
-        String ipMsg = "IP: " + webServer->getIP();
-        int16_t ipWidth = u8g2.getStrWidth(ipMsg.c_str());
-        u8g2.drawStr((128 - ipWidth) / 2, 75, ipMsg.c_str());
-        display.endFrame();
-        delay(2000);
+    if constexpr (Features::oled) {
+        if (webServer->isAPMode()) {
+            display->beginFrame();
+            display->drawBorder();
+            display->drawQRScreen();
+            display->endFrame();
+            DEBUG_PRINTLN("Showing AP mode QR code screen");
+        } else {
+            display->beginFrame();
+            u8g2->setFont(u8g2_font_ncenB14_tr);
+            u8g2->drawStr((128 - u8g2->getStrWidth(title)) / 2, 55, title);
+
+            u8g2->setFont(u8g2_font_6x12_tr);
+            String ipMsg = "IP: " + webServer->getIP();
+            int16_t ipWidth = u8g2->getStrWidth(ipMsg.c_str());
+            u8g2->drawStr((128 - ipWidth) / 2, 75, ipMsg.c_str());
+            display->endFrame();
+            delay(2000);
+        }
     }
     
     // Initialize Analytics
     DEBUG_PRINTLN("Initializing Analytics...");
     analytics.begin();
     analytics.onMidnight(handleMidnight);
+    sessionTracker.onReport([](bool focus, uint32_t mins) {
+        if (scenarioRunner.isRunning()) return;  // Not for sessions a scenario made up
+        mqttPublisher.sessionCompleted(focus ? "focus" : "break", mins, systemState.getCurrentTaskName());
+        fleetUploader.recordSession(focus, mins);
+    });
+    resumeBackupRestore(systemState, analytics);  // Reset during POST /api/restore
+    inputJournal.recordSnapshot(analytics);
+
+    // MQTT runs in its own task; retained topics start from the loaded state
+    mqttPublisher.begin();
+    mqttPublisher.stateChanged();
+    fleetUploader.begin();
 
     // Initialize MPU-6050 (flip detection)
-    DEBUG_PRINTLN("Initializing MPU-6050...");
-    if (mpuHandler.begin()) {
-        DEBUG_PRINTLN("MPU-6050 initialized successfully!");
-        // Register flip callback
-        mpuHandler.onFlip([](bool isFlipped) {
-            DEBUG_PRINTF("MPU FLIP callback: isFlipped=%d\n", isFlipped);
-            
-            // Rotate display based on cube orientation
-            // isFlipped=true means OLED facing down, need U8G2_R0
-            // isFlipped=false means OLED facing up, need U8G2_R2
-            if (isFlipped) {
-                u8g2.setDisplayRotation(U8G2_R0);  // Normal when cube is flipped
-            } else {
-                u8g2.setDisplayRotation(U8G2_R2);  // 180° when cube is normal
-            }
-            
-            systemState.handleFlip(isFlipped);
-            oledNeedsRefresh = true;
-            if (webServer) {
-                webServer->broadcastStatus();
-            }
-        });
-    } else {
-        DEBUG_PRINTLN("WARNING: MPU-6050 not found! Flip control disabled.");
+    if constexpr (Features::mpu) {
+        DEBUG_PRINTLN("Initializing MPU-6050...");
+        if (mpuHandler->begin()) {
+            DEBUG_PRINTLN("MPU-6050 initialized successfully!");
+            // Register flip callback
+            mpuHandler->onFlip([](bool isFlipped) {
+                inputJournal.recordFlip(isFlipped);
+                handleCubeFlip(isFlipped, mpuPollUs);
+            });
+        } else {
+            DEBUG_PRINTLN("WARNING: MPU-6050 not found! Flip control disabled.");
+        }
     }
 
     // Initialize Buzzer
-    DEBUG_PRINTLN("Initializing Buzzer...");
-    buzzer.begin();
+    if constexpr (Features::buzzer) {
+        DEBUG_PRINTLN("Initializing Buzzer...");
+        buzzer->begin();
+    }
 
     DEBUG_PRINTLN("Setup complete!");
     DEBUG_PRINTF("Access web interface at: http://%s\n", webServer->getIP().c_str());
@@ -236,6 +343,7 @@ void loop() {
     static uint32_t loopCount = 0;
     static uint32_t lastPrint = 0;
     static uint32_t totalSystemTime = 0, totalWebTime = 0, totalAnalyticsTime = 0, totalOledTime = 0;
+    static uint32_t maxWebTime = 0, maxSensorGap = 0, lastSensorRead = 0;
     loopCount++;
     
     uint32_t startTime = micros();
@@ -249,7 +357,9 @@ void loop() {
     if (webServer) {
         webServer->loop();
     }
-    totalWebTime += (micros() - startTime);
+    uint32_t webTime = micros() - startTime;
+    totalWebTime += webTime;
+    if (webTime > maxWebTime) maxWebTime = webTime;
     
     // 3. Analytics loop (midnight check)
     startTime = micros();
@@ -258,41 +368,56 @@ void loop() {
 
     // 4. Read sensors on interval
     if (sensorTimer.elapsed()) {
+        uint32_t now = millis();
+        if (lastSensorRead != 0 && now - lastSensorRead > maxSensorGap) {
+            maxSensorGap = now - lastSensorRead;
+        }
+        lastSensorRead = now;
+
         int ldrValue = analogRead(LDR_PIN);
+        inputJournal.recordLight(ldrValue);
         systemState.handleLightSensor(ldrValue);
-        
+        if constexpr (Features::oled) {
+            displayPower->updateLight(ldrValue);
+        }
+
         // Update MPU-6050 (flip detection)
-        mpuHandler.update();
-        
-        // Debug MPU every 2 seconds
-        static uint32_t lastMpuDebug = 0;
-        if (millis() - lastMpuDebug > 2000) {
-            lastMpuDebug = millis();
-            DEBUG_PRINTF("MPU Debug: initialized=%d, accelZ=%d, flipped=%d\n", 
-                        mpuHandler.isInitialized(), mpuHandler.getAccelZ(), mpuHandler.getIsFlipped());
+        if constexpr (Features::mpu) {
+            mpuPollUs = micros();
+            mpuHandler->update();
+
+            // Debug MPU every 2 seconds
+            static uint32_t lastMpuDebug = 0;
+            if (millis() - lastMpuDebug > 2000) {
+                lastMpuDebug = millis();
+                DEBUG_PRINTF("MPU Debug: initialized=%d, accelZ=%d, flipped=%d\n",
+                            mpuHandler->isInitialized(), mpuHandler->getAccelZ(), mpuHandler->getIsFlipped());
+            }
         }
     }
 
     // 5. Process event queue
     processEvents();
+    latencyTrace.loop();
 
     // 6. Check overlay timers
-    if (showingCongrats && congratsTimer.expired()) {
-        showingCongrats = false;
-        oledNeedsRefresh = true;
-    }
-    if (showingRevive && reviveTimer.expired()) {
-        showingRevive = false;
-        oledNeedsRefresh = true;
-    }
+    checkOverlayTimers();
 
     // 7. Refresh OLED when needed (rate limited)
     startTime = micros();
-    if (oledNeedsRefresh && oledRefreshTimer.elapsed()) {
-        refreshOLED();
-        oledNeedsRefresh = false;
+    if constexpr (Features::oled) {
+        updateDisplayPower();
+        if (oledNeedsRefresh && oledRefreshTimer.elapsed()) {
+            refreshOLED();
+            oledNeedsRefresh = false;
+        }
     }
     totalOledTime += (micros() - startTime);
+
+    // Flash housekeeping only when no input or frame is waiting on us
+    if (eventQueue.isEmpty() && !oledNeedsRefresh) {
+        inputJournal.loop();
+    }
     
     // 8. Broadcast WebSocket status once per second (not on every OLED refresh)
     static uint32_t lastWsBroadcast = 0;
@@ -310,8 +435,19 @@ void loop() {
             DEBUG_PRINTF("Loops/sec: %lu | System: %luμs | Web: %luμs | Analytics: %luμs | OLED: %luμs\n", 
                         loopCount, totalSystemTime/loopCount, totalWebTime/loopCount, 
                         totalAnalyticsTime/loopCount, totalOledTime/loopCount);
+
+            loopStats.loopsPerSec = loopCount;
+            loopStats.avgSystemUs = totalSystemTime / loopCount;
+            loopStats.avgWebUs = totalWebTime / loopCount;
+            loopStats.avgAnalyticsUs = totalAnalyticsTime / loopCount;
+            loopStats.avgOledUs = totalOledTime / loopCount;
+            loopStats.maxWebUs = maxWebTime;
+            loopStats.maxSensorGapMs = maxSensorGap;
+            loopStats.wsMessagesPerSec = webServer ? webServer->takeWsMessageCount() * 1000 / (now - lastPrint) : 0;
+
             loopCount = 0;
             totalSystemTime = totalWebTime = totalAnalyticsTime = totalOledTime = 0;
+            maxWebTime = maxSensorGap = 0;
             lastPrint = now;
         }
     }
@@ -319,35 +455,45 @@ void loop() {
     yield();
 }
 
+void checkOverlayTimers() {
+    if (overlays.update()) {
+        oledNeedsRefresh = true;
+    }
+}
+
+// One pass of the state-driving half of loop() (no sensors, no OLED),
+// run by ScenarioRunner after each simulated second. Outputs (web,
+// MQTT, fleet, buzzer, prerender) stay quiet while it runs.
+void scenarioStep() {
+    systemState.loop();
+    analytics.loop();
+    processEvents();
+    checkOverlayTimers();
+}
+
 // ============================================
 // Event Processing
 // ============================================
 void processEvents() {
+    bool live = !scenarioRunner.isRunning();  // Broadcasts are gated in broadcastText()
+
     while (eventQueue.hasEvents()) {
         EventData event = eventQueue.popData();
-        
+
+        // State side first: overlays, session analytics
+        if (overlays.handle(event.type)) {
+            oledNeedsRefresh = true;
+        }
+        sessionTracker.handle(event.type, systemState.getMode());
+
         switch (event.type) {
             case Event::MIDNIGHT:
                 // Already handled by callback, but can add extra logic here
                 DEBUG_PRINTLN("Event: MIDNIGHT processed");
                 break;
                 
-            case Event::PLANT_BLOOMED:
-                if (!showingCongrats) {
-                    showingCongrats = true;
-                    congratsTimer.start(5000);
-                    oledNeedsRefresh = true;
-                    DEBUG_PRINTLN("Event: PLANT_BLOOMED - showing congrats!");
-                }
-                break;
-                
             case Event::PLANT_REVIVED:
-                if (!showingRevive) {
-                    showingRevive = true;
-                    reviveTimer.start(4000);
-                    oledNeedsRefresh = true;
-                    DEBUG_PRINTLN("Event: PLANT_REVIVED - showing celebration!");
-                }
+                if (live) mqttPublisher.stateChanged();
                 // Broadcast to web clients
                 if (webServer) {
                     webServer->broadcastPlant();
@@ -357,12 +503,15 @@ void processEvents() {
                 break;
                 
             case Event::PLANT_WATERED:
-                analytics.recordTaskCompleted();
+                if (live) mqttPublisher.stateChanged();
                 DEBUG_PRINTLN("Event: PLANT_WATERED - recorded in analytics");
                 break;
                 
             case Event::STATE_CHANGED:
-                handleStateChanged();
+                if (live) mqttPublisher.stateChanged();
+                if constexpr (Features::oled) {
+                    if (live) updateFramePrediction();
+                }
                 if (webServer) {
                     webServer->broadcastTasks();
                 }
@@ -373,19 +522,32 @@ void processEvents() {
                 {
                     uint16_t timeLeft = systemState.getTimeLeft();
                     SystemMode mode = systemState.getMode();
-                    if ((mode == MODE_FOCUSING || mode == MODE_BREAK) && timeLeft <= 3 && timeLeft > 0) {
-                        buzzer.playCountdownBeep(timeLeft);
+                    if constexpr (Features::buzzer) {
+                        if (live && (mode == MODE_FOCUSING || mode == MODE_BREAK) && timeLeft <= 3 && timeLeft > 0) {
+                            buzzer->playCountdownBeep(timeLeft);
+                        }
                     }
                 }
+                if constexpr (Features::oled) {
+                    if (live) updateFramePrediction();
+                }
                 break;
                 
             case Event::WEB_BROADCAST:
+                if (live) mqttPublisher.stateChanged();
                 if (webServer) {
                     webServer->broadcastPlant();
                     webServer->broadcastStatus();
                 }
                 break;
                 
+            case Event::STATS_CHANGED:
+                if (live) mqttPublisher.stateChanged();
+                if (webServer) {
+                    webServer->broadcastStats();
+                }
+                break;
+                
             case Event::OLED_REFRESH:
                 oledNeedsRefresh = true;
                 break;
@@ -398,198 +560,281 @@ void processEvents() {
 }
 
 // ============================================
-// State Change Handler (for analytics)
+// Midnight Handler
 // ============================================
-void handleStateChanged() {
-    SystemMode currentMode = systemState.getMode();
-    
-    // Helper lambda to round milliseconds to minutes (round up if >= 30 seconds)
-    auto msToMins = [](uint32_t ms) -> uint32_t {
-        uint32_t totalSeconds = ms / 1000;
-        uint32_t mins = totalSeconds / 60;
-        uint32_t remainingSeconds = totalSeconds % 60;
-        if (remainingSeconds >= 30) mins++;  // Round up if >= 30 seconds
-        return mins;
-    };
-    
-    // When entering FOCUSING mode (fresh start, not resume from pause)
-    if (currentMode == MODE_FOCUSING && previousMode != MODE_FOCUSING && previousMode != MODE_PAUSED) {
-        sessionStartTime = millis();
-        accumulatedFocusMs = 0;
-        DEBUG_PRINTLN("Analytics: Starting new focus session");
+void handleMidnight() {
+    DEBUG_PRINTLN("Midnight! Checking if daily goals were met...");
+
+    // Goal check, withering and the day reset are SystemState's
+    bool goalMet = systemState.endDay();
+    if (!scenarioRunner.isRunning()) {
+        mqttPublisher.dayEnded(goalMet);
+        fleetUploader.recordDay(analytics.getTodayStats(), goalMet);
     }
-    
-    // When entering BREAK mode (focus just completed)
-    if (currentMode == MODE_BREAK && previousMode != MODE_BREAK) {
-        // If coming from focusing, record the focus session first
-        if (previousMode == MODE_FOCUSING || accumulatedFocusMs > 0) {
-            uint32_t focusMs = accumulatedFocusMs;
-            if (previousMode == MODE_FOCUSING && sessionStartTime > 0) {
-                focusMs += (millis() - sessionStartTime);
-            }
-            uint32_t focusMins = msToMins(focusMs);
-            if (focusMins > 0) {
-                analytics.recordFocusSession(focusMins);
-                DEBUG_PRINTF("Analytics: Recorded focus session: %lu min\n", focusMins);
-            }
-            accumulatedFocusMs = 0;
-        }
-        // Start break timer
-        sessionStartTime = millis();
-        accumulatedBreakMs = 0;
-        DEBUG_PRINTLN("Analytics: Starting break session");
+    if (!goalMet && webServer) {
+        webServer->broadcastPlant();
     }
-    
-    // When leaving FOCUSING to PAUSED (flip detected)
-    if (previousMode == MODE_FOCUSING && currentMode == MODE_PAUSED) {
-        // Accumulate the focus time so far
-        if (sessionStartTime > 0) {
-            accumulatedFocusMs += (millis() - sessionStartTime);
-            DEBUG_PRINTF("Analytics: Paused focus, accumulated: %lu ms\n", accumulatedFocusMs);
+    oledNeedsRefresh = true;
+}
+
+// ============================================
+// OLED Refresh
+// ============================================
+// Name of the screen refreshOLED() draws right now (same precedence)
+const char* currentScreenName() {
+    return overlays.screenName(systemState.getMode());
+}
+
+void refreshOLED() {
+    if constexpr (Features::oled) {
+        SPI.setFrequency(OLED_SPI_HZ);
+
+        if (commitPredictedFrame()) return;
+
+        display->beginFrame();
+        display->drawBorder();
+
+        // Clock in top-right
+        int hour, minute;
+        analytics.getCurrentTime(hour, minute);
+        display->drawClock(hour, minute);
+
+        // Check overlays first
+        if (overlays.showingRevive()) {
+            display->drawReviveScreen(overlays.progressQ16());
+            display->endFrame();
+            delay(5);
+            oledNeedsRefresh = true;  // Keep refreshing until timer expires
+            return;
         }
-        sessionStartTime = 0;
-    }
-    
-    // When resuming from PAUSED to FOCUSING
-    if (previousMode == MODE_PAUSED && currentMode == MODE_FOCUSING) {
-        sessionStartTime = millis();
-        DEBUG_PRINTLN("Analytics: Resumed focus session");
+
+        if (overlays.showingCongrats()) {
+            display->drawCongratsScreen(overlays.progressQ16());
+            display->endFrame();
+            delay(5);
+            oledNeedsRefresh = true;  // Keep refreshing until timer expires
+            return;
+        }
+
+        // Draw based on mode
+        SystemMode mode = systemState.getMode();
+        PlantInfo plant = systemState.getPlantInfo();
+        const char* taskName = systemState.getCurrentTaskName();
+
+        switch (mode) {
+            case MODE_IDLE:
+                display->drawIdleScreen(
+                    plant,
+                    webServer && webServer->isAPMode(),
+                    webServer && webServer->hasWebClient(),
+                    !showedWelcome
+                );
+                showedWelcome = true;
+                break;
+
+            case MODE_FOCUSING:
+                display->drawFocusScreen(
+                    taskName,
+                    systemState.getTimeLeft(),
+                    systemState.getTotalTime()
+                );
+                break;
+
+            case MODE_BREAK:
+                display->drawBreakScreen(
+                    taskName,
+                    systemState.getTimeLeft(),
+                    systemState.getTotalTime()
+                );
+                break;
+
+            case MODE_PAUSED:
+                display->drawPausedScreen(
+                    taskName,
+                    systemState.getTimeLeft(),
+                    systemState.getTotalTime()
+                );
+                break;
+
+            case MODE_WITHERED:
+                display->drawWitheredScreen();
+                break;
+        }
+
+        display->endFrame();
+        reportFlipLatency(false);
+        updateFramePrediction();  // Clock may have moved on since the last prediction
+        delay(10);
     }
-    
-    // When going IDLE from anywhere (task completed or cancelled)
-    if (currentMode == MODE_IDLE && previousMode != MODE_IDLE) {
-        // Record any accumulated focus time
-        if (previousMode == MODE_FOCUSING || previousMode == MODE_PAUSED) {
-            uint32_t focusMs = accumulatedFocusMs;
-            if (previousMode == MODE_FOCUSING && sessionStartTime > 0) {
-                focusMs += (millis() - sessionStartTime);
-            }
-            uint32_t focusMins = msToMins(focusMs);
-            if (focusMins > 0) {
-                analytics.recordFocusSession(focusMins);
-                DEBUG_PRINTF("Analytics: Recorded focus session (completed): %lu min\n", focusMins);
+}
+
+// ============================================
+// Cube Flip
+// ============================================
+// inputUs is when the flip was first observable (start of the MPU poll),
+// so the trace includes the time spent reading and debouncing it.
+void handleCubeFlip(bool isFlipped, uint32_t inputUs) {
+    latencyTrace.begin(LatencyTrace::FLIP, inputUs);
+    latencyTrace.mark(LatencyStage::DETECTED);
+    flipDetectedUs = micros();
+    DEBUG_PRINTF("MPU FLIP callback: isFlipped=%d\n", isFlipped);
+    cubeFaceDown = isFlipped;
+
+    // A scenario flip moves the state only; the panel follows the real cube
+    bool live = !scenarioRunner.isRunning();
+
+    // Rotate display based on cube orientation
+    // isFlipped=true means OLED facing down, need U8G2_R0
+    // isFlipped=false means OLED facing up, need U8G2_R2
+    if constexpr (Features::oled) {
+        if (live) {
+            if (isFlipped) {
+                u8g2->setDisplayRotation(U8G2_R0);  // Normal when cube is flipped
+            } else {
+                u8g2->setDisplayRotation(U8G2_R2);  // 180° when cube is normal
             }
         }
-        // Record any accumulated break time
-        if (previousMode == MODE_BREAK && sessionStartTime > 0) {
-            uint32_t breakMs = accumulatedBreakMs + (millis() - sessionStartTime);
-            uint32_t breakMins = msToMins(breakMs);
-            if (breakMins > 0) {
-                analytics.recordBreakSession(breakMins);
-                DEBUG_PRINTF("Analytics: Recorded break session: %lu min\n", breakMins);
+    }
+
+    systemState.handleFlip(isFlipped);
+    latencyTrace.mark(LatencyStage::APPLIED);
+
+    if constexpr (Features::oled) {
+        if (live) {
+            displayPower->setFaceDown(isFlipped);
+
+            if (displayPower->isAsleep() && !displayPower->shouldSleep(systemState.getMode())) {
+                wakeDisplay();
+            } else {
+                // Pre-rendered frame goes out right away, skipping the rate limit
+                oledNeedsRefresh = !commitPredictedFrame();
             }
         }
-        
-        // Reset everything
-        accumulatedFocusMs = 0;
-        accumulatedBreakMs = 0;
-        sessionStartTime = 0;
     }
-    
-    previousMode = currentMode;
+    if (webServer) {
+        webServer->broadcastStatus();
+    }
 }
 
 // ============================================
-// Midnight Handler
+// Display Power
 // ============================================
-void handleMidnight() {
-    DEBUG_PRINTLN("Midnight! Checking if daily goals were met...");
-    
-    PlantInfo plant = systemState.getPlantInfo();
-    
-    if (plant.totalGoal > 0 && plant.wateredCount < plant.totalGoal) {
-        DEBUG_PRINTF("Goals NOT met! (%d/%d) - Plant withers!\n", 
-                     plant.wateredCount, plant.totalGoal);
-        systemState.killPlant();
-        
-        if (webServer) {
-            webServer->broadcastPlant();
+// Face-down / idle puts the panel to sleep; anything else wakes it.
+
+void updateDisplayPower() {
+    if constexpr (Features::oled) {
+        bool sleep = displayPower->shouldSleep(systemState.getMode());
+        if (sleep && !displayPower->isAsleep()) {
+            displayPower->sleep();
+        } else if (!sleep && displayPower->isAsleep()) {
+            wakeDisplay();
         }
-    } else if (plant.totalGoal > 0) {
-        DEBUG_PRINTF("Goals met! (%d/%d) - Great job!\n", 
-                     plant.wateredCount, plant.totalGoal);
     }
-    
-    systemState.resetForNewDay();
-    oledNeedsRefresh = true;
+}
+
+// The current frame goes into the dark panel, then it is switched on
+void wakeDisplay() {
+    if constexpr (Features::oled) {
+        oledNeedsRefresh = false;
+        displayPower->wake([]() {
+            if (!commitPredictedFrame()) refreshOLED();
+        });
+    }
 }
 
 // ============================================
-// OLED Refresh
+// Speculative Frames
 // ============================================
-void refreshOLED() {
-    SPI.setFrequency(2000000);
-    
-    display.beginFrame();
-    display.drawBorder();
-    
-    // Clock in top-right
+// Timer screens are fully determined by a FrameKey, so the next one can
+// be drawn before the event that shows it: a selected task waiting for
+// the flip, or a focus/break timer about to roll over.
+
+FrameKey frameKeyFor(SystemMode mode, uint32_t taskId, uint32_t timeLeft, uint32_t totalTime, bool rotated) {
     int hour, minute;
     analytics.getCurrentTime(hour, minute);
-    display.drawClock(hour, minute);
-
-    // Check overlays first
-    if (showingRevive) {
-        display.drawReviveScreen();
-        display.endFrame();
-        delay(5);
-        oledNeedsRefresh = true;  // Keep refreshing until timer expires
-        return;
+
+    FrameKey key;
+    key.mode = mode;
+    key.taskId = taskId;
+    key.timeLeft = timeLeft;
+    key.totalTime = totalTime;
+    key.minuteOfDay = hour * 60 + minute;
+    key.rotated = rotated;
+    return key;
+}
+
+// Same draw calls as refreshOLED() for the timer modes
+void drawTimerFrame(const FrameKey& key, const char* taskName) {
+    if constexpr (Features::oled) {
+        display->drawBorder();
+        display->drawClock(key.minuteOfDay / 60, key.minuteOfDay % 60);
+
+        if (key.mode == MODE_FOCUSING) {
+            display->drawFocusScreen(taskName, key.timeLeft, key.totalTime);
+        } else {
+            display->drawBreakScreen(taskName, key.timeLeft, key.totalTime);
+        }
     }
-    
-    if (showingCongrats) {
-        display.drawCongratsScreen();
-        display.endFrame();
-        delay(5);
-        oledNeedsRefresh = true;  // Keep refreshing until timer expires
-        return;
+}
+
+void updateFramePrediction() {
+#if OLED_PRERENDER
+    if constexpr (Features::oled) {
+        SystemMode mode = systemState.getMode();
+        TaskInfo* task = nullptr;
+        FrameKey key;
+
+        if (mode == MODE_IDLE && systemState.hasSelectedTask()) {
+            // Next frame: focus screen with a full timer, cube face down (R0)
+            task = systemState.getTask(systemState.getSelectedTaskId());
+            if (!task) return;
+            uint32_t total = task->focusDuration * 60;
+            key = frameKeyFor(MODE_FOCUSING, task->id, total, total, false);
+        } else if ((mode == MODE_FOCUSING || mode == MODE_BREAK) &&
+                   systemState.getTimeLeft() <= PRERENDER_LEAD_SECONDS) {
+            // Next frame: the other timer phase, same orientation
+            task = systemState.getTask(systemState.getActiveTaskId());
+            if (!task) return;
+            SystemMode next = (mode == MODE_FOCUSING) ? MODE_BREAK : MODE_FOCUSING;
+            uint32_t total = ((next == MODE_BREAK) ? task->breakDuration : task->focusDuration) * 60;
+            key = frameKeyFor(next, task->id, total, total, display->isRotated());
+        } else {
+            return;
+        }
+
+        if (display->isPredicted(key)) return;
+
+        uint32_t start = micros();
+        display->prerender(key, [&]() { drawTimerFrame(key, task->name); });
+        DEBUG_PRINTF("Prerendered mode %d frame in %lu us\n", key.mode, micros() - start);
     }
+#endif
+}
+
+// Send the pre-rendered frame if it is exactly what should be shown now
+bool commitPredictedFrame() {
+#if OLED_PRERENDER
+    if constexpr (Features::oled) {
+        if (overlays.active()) return false;
+
+        SystemMode mode = systemState.getMode();
+        if (mode != MODE_FOCUSING && mode != MODE_BREAK) return false;
 
-    // Draw based on mode
-    SystemMode mode = systemState.getMode();
-    PlantInfo plant = systemState.getPlantInfo();
-    const char* taskName = systemState.getCurrentTaskName();
-
-    switch (mode) {
-        case MODE_IDLE:
-            display.drawIdleScreen(
-                plant,
-                webServer && webServer->isAPMode(),
-                webServer && webServer->hasWebClient(),
-                !showedWelcome
-            );
-            showedWelcome = true;
-            break;
-
-        case MODE_FOCUSING:
-            display.drawFocusScreen(
-                taskName,
-                systemState.getTimeLeft(),
-                systemState.getTotalTime()
-            );
-            break;
-
-        case MODE_BREAK:
-            display.drawBreakScreen(
-                taskName,
-                systemState.getTimeLeft(),
-                systemState.getTotalTime()
-            );
-            break;
-
-        case MODE_PAUSED:
-            display.drawPausedScreen(
-                taskName,
-                systemState.getTimeLeft(),
-                systemState.getTotalTime()
-            );
-            break;
-
-        case MODE_WITHERED:
-            display.drawWitheredScreen();
-            break;
+        FrameKey key = frameKeyFor(mode, systemState.getActiveTaskId(), systemState.getTimeLeft(),
+                                   systemState.getTotalTime(), display->isRotated());
+        if (!display->commitPrediction(key)) return false;
+
+        reportFlipLatency(true);
+        return true;
     }
+#endif
+    return false;
+}
 
-    display.endFrame();
-    delay(10);
+// Flip detection -> frame on the panel, end to end
+void reportFlipLatency(bool predicted) {
+    if (flipDetectedUs == 0) return;
+    lastFlipLatencyUs = micros() - flipDetectedUs;
+    flipDetectedUs = 0;
+    DEBUG_PRINTF("Flip->pixels: %lu us (%s)\n", lastFlipLatencyUs, predicted ? "prerendered" : "rendered");
 }
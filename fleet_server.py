@@ -0,0 +1,450 @@
+#!/usr/bin/env python3
+"""Fleet aggregator: collects session/day records from many cubes
+
+Cubes built with FLEET_SERVER push batches of 16-byte records (see
+FleetUploader.h) to POST /upload. Each device gets an append-only
+columnar store - one file per field - and the server answers range and
+group-by queries over all of them from memory.
+
+Usage:
+    python3 fleet_server.py serve --data fleet/ --port 8750
+    python3 fleet_server.py query http://localhost:8750 --from 2026-10-01 \\
+        --group device --metrics focus,tasks,goalMet
+    python3 fleet_server.py simulate http://localhost:8750 --cubes 20 --days 30
+    python3 fleet_server.py selftest
+
+Query API:
+    GET /query?from=YYYY-MM-DD&to=YYYY-MM-DD&group=device|day|week|weekday|hour
+              &metrics=focus,break,tasks,sessions,goalMet,days,
+                       focusSessions,focusMinutes,breakSessions,breakMinutes
+              &device=<mac>&agg=sum|avg
+    GET /devices
+
+Records from a cube whose clock was not set yet (ts 0) are stored but
+left out of queries.
+
+`selftest` runs the server and a few simulated cubes (with failed
+uploads, lost responses and reboots) in one process and checks that
+every record arrived exactly once. Uses only the standard library.
+"""
+
+import argparse
+import array
+import bisect
+import datetime
+import json
+import os
+import random
+import struct
+import sys
+import tempfile
+import threading
+import time
+import urllib.parse
+import urllib.request
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+MAGIC = b"BLMF"
+VERSION = 1
+HEADER = struct.Struct("<4sBB6s")
+RECORD = struct.Struct("<IIBBHHH")
+
+FOCUS, BREAK, DAY = 1, 2, 3
+
+# Column name, array typecode (matches FleetRecord)
+COLUMNS = [("seq", "I"), ("ts", "I"), ("kind", "B"), ("a", "B"),
+           ("b", "H"), ("c", "H"), ("d", "H")]
+
+# metric -> (record kind, value from (a, b, c, d))
+METRICS = {
+    "focus":         (DAY, lambda a, b, c, d: b),
+    "break":         (DAY, lambda a, b, c, d: c),
+    "tasks":         (DAY, lambda a, b, c, d: a),
+    "sessions":      (DAY, lambda a, b, c, d: d & 0x7FFF),
+    "goalMet":       (DAY, lambda a, b, c, d: d >> 15),
+    "days":          (DAY, lambda a, b, c, d: 1),
+    "focusSessions": (FOCUS, lambda a, b, c, d: 1),
+    "focusMinutes":  (FOCUS, lambda a, b, c, d: b),
+    "breakSessions": (BREAK, lambda a, b, c, d: 1),
+    "breakMinutes":  (BREAK, lambda a, b, c, d: b),
+}
+
+WEEKDAYS = ["Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"]
+
+
+# ============================================
+# Storage
+# ============================================
+
+class DeviceStore:
+    """Append-only columns for one cube, mirrored in memory"""
+
+    def __init__(self, path):
+        self.path = path
+        os.makedirs(path, exist_ok=True)
+        self.cols = {}
+        for name, code in COLUMNS:
+            col = array.array(code)
+            file = os.path.join(path, name + ".col")
+            if os.path.exists(file):
+                with open(file, "rb") as f:
+                    col.frombytes(f.read())
+            self.cols[name] = col
+        # A crash mid-append can leave columns of different lengths
+        n = min(len(c) for c in self.cols.values())
+        for name, code in COLUMNS:
+            if len(self.cols[name]) != n:
+                del self.cols[name][n:]
+                with open(os.path.join(path, name + ".col"), "wb") as f:
+                    self.cols[name].tofile(f)
+        self.cursor = max(self.cols["seq"]) if n else 0
+        ts = self.cols["ts"]
+        self.ts_sorted = all(ts[i] <= ts[i + 1] for i in range(n - 1))
+        self.last_upload = None
+
+    def __len__(self):
+        return len(self.cols["seq"])
+
+    def append(self, records):
+        """Records newer than the cursor; returns how many were new"""
+        fresh = [r for r in sorted(records) if r[0] > self.cursor]
+        if not fresh:
+            return 0
+        ts = self.cols["ts"]
+        if (ts and fresh[0][1] < ts[-1]) or any(a[1] > b[1] for a, b in zip(fresh, fresh[1:])):
+            self.ts_sorted = False   # Clock not set yet, or set backwards: queries scan
+        for i, (name, code) in enumerate(COLUMNS):
+            values = array.array(code, (r[i] for r in fresh))
+            with open(os.path.join(self.path, name + ".col"), "ab") as f:
+                values.tofile(f)
+            self.cols[name].extend(values)
+        self.cursor = fresh[-1][0]
+        return len(fresh)
+
+
+class Fleet:
+    def __init__(self, root, utc_offset_h=0):
+        self.root = root
+        self.tz = datetime.timezone(datetime.timedelta(hours=utc_offset_h))
+        self.lock = threading.Lock()
+        self.devices = {}
+        os.makedirs(root, exist_ok=True)
+        for name in sorted(os.listdir(root)):
+            if os.path.isdir(os.path.join(root, name)):
+                self.devices[name] = DeviceStore(os.path.join(root, name))
+
+    def upload(self, body):
+        if len(body) < HEADER.size:
+            raise ValueError("short upload")
+        magic, version, count, mac = HEADER.unpack_from(body)
+        if magic != MAGIC or version != VERSION:
+            raise ValueError("not a fleet upload")
+        if len(body) != HEADER.size + count * RECORD.size:
+            raise ValueError("length does not match record count")
+        device = mac.hex()
+        records = [RECORD.unpack_from(body, HEADER.size + i * RECORD.size) for i in range(count)]
+
+        with self.lock:
+            store = self.devices.get(device)
+            if store is None:
+                store = self.devices[device] = DeviceStore(os.path.join(self.root, device))
+            added = store.append(records)
+            store.last_upload = time.time()
+            return {"cursor": store.cursor, "added": added}
+
+    def device_list(self):
+        with self.lock:
+            return [{"device": name, "records": len(s), "cursor": s.cursor,
+                     "lastUpload": s.last_upload} for name, s in self.devices.items()]
+
+    # ============================================
+    # Queries
+    # ============================================
+
+    def group_key(self, group, device, ts):
+        if group == "device":
+            return device
+        if group == "all":
+            return "all"
+        t = datetime.datetime.fromtimestamp(ts, self.tz)
+        if group == "day":
+            return t.strftime("%Y-%m-%d")
+        if group == "week":
+            year, week, _ = t.isocalendar()
+            return f"{year}-W{week:02d}"
+        if group == "weekday":
+            return WEEKDAYS[t.weekday()]
+        if group == "hour":
+            return f"{t.hour:02d}"
+        raise ValueError(f"unknown group {group}")
+
+    def day_start(self, date):
+        return int(datetime.datetime.strptime(date, "%Y-%m-%d").replace(tzinfo=self.tz).timestamp())
+
+    def query(self, start=None, end=None, group="device", metrics=("focus",), device=None, agg="sum"):
+        for m in metrics:
+            if m not in METRICS:
+                raise ValueError(f"unknown metric {m}")
+        lo = self.day_start(start) if start else 1
+        hi = self.day_start(end) + 86400 if end else 2 ** 32
+
+        sums, counts = {}, {}
+        with self.lock:
+            stores = [(name, s) for name, s in self.devices.items() if device in (None, name)]
+            for name, store in stores:
+                ts = store.cols["ts"]
+                # Uploads normally arrive in time order, so the range is a slice
+                if store.ts_sorted:
+                    rows = range(bisect.bisect_left(ts, lo), bisect.bisect_left(ts, hi))
+                else:
+                    rows = [i for i, t in enumerate(ts) if lo <= t < hi]
+                for i in rows:
+                    t = ts[i]
+                    kind = store.cols["kind"][i]
+                    values = (store.cols["a"][i], store.cols["b"][i], store.cols["c"][i], store.cols["d"][i])
+                    key = self.group_key(group, name, t)
+                    for m in metrics:
+                        want, fn = METRICS[m]
+                        if kind == want:
+                            row = sums.setdefault(key, dict.fromkeys(metrics, 0))
+                            row[m] += fn(*values)
+                            count_row = counts.setdefault(key, dict.fromkeys(metrics, 0))
+                            count_row[m] += 1
+
+        if agg == "avg":
+            for key, row in sums.items():
+                for m in metrics:
+                    row[m] = round(row[m] / counts[key][m], 2) if counts[key][m] else 0
+        return {"group": group, "metrics": list(metrics), "agg": agg,
+                "rows": [dict(key=k, **sums[k]) for k in sorted(sums)]}
+
+
+# ============================================
+# HTTP
+# ============================================
+
+def make_handler(fleet):
+    class Handler(BaseHTTPRequestHandler):
+        def send_json(self, code, obj):
+            body = json.dumps(obj).encode()
+            self.send_response(code)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+        def do_POST(self):
+            if self.path != "/upload":
+                return self.send_json(404, {"error": "not found"})
+            body = self.rfile.read(int(self.headers.get("Content-Length", 0)))
+            try:
+                self.send_json(200, fleet.upload(body))
+            except ValueError as e:
+                self.send_json(400, {"error": str(e)})
+
+        def do_GET(self):
+            url = urllib.parse.urlparse(self.path)
+            args = {k: v[0] for k, v in urllib.parse.parse_qs(url.query).items()}
+            if url.path == "/devices":
+                return self.send_json(200, fleet.device_list())
+            if url.path != "/query":
+                return self.send_json(404, {"error": "not found"})
+            try:
+                result = fleet.query(args.get("from"), args.get("to"), args.get("group", "device"),
+                                     args.get("metrics", "focus").split(","), args.get("device"),
+                                     args.get("agg", "sum"))
+                self.send_json(200, result)
+            except ValueError as e:
+                self.send_json(400, {"error": str(e)})
+
+        def log_message(self, format, *args):
+            pass
+
+    return Handler
+
+
+def serve(data, port, utc_offset):
+    fleet = Fleet(data, utc_offset)
+    server = ThreadingHTTPServer(("", port), make_handler(fleet))
+    print(f"Fleet server on :{port}, {len(fleet.devices)} devices in {data}")
+    server.serve_forever()
+
+
+# ============================================
+# Simulated cubes
+# ============================================
+
+class SimCube:
+    """Queues records and uploads them like FleetUploader does"""
+
+    def __init__(self, rng, index):
+        self.rng = rng
+        self.mac = bytes([0x24, 0x6F, 0x28, index >> 16 & 0xFF, index >> 8 & 0xFF, index & 0xFF])
+        self.boots = 0
+        self.queue = []          # Unacknowledged records (kept in NVS)
+        self.delivered = {}      # seq -> record the server acknowledged
+        self.carried = 0         # Records that waited through a reboot
+        self.reboot()
+
+    def reboot(self):
+        self.carried += len(self.queue)
+        self.boots += 1
+        self.next_seq = self.boots << 16
+
+    def add(self, ts, kind, a=0, b=0, c=0, d=0):
+        self.queue.append((self.next_seq, ts, kind, a, b, c, d))
+        self.next_seq += 1
+
+    def simulate_day(self, day_start):
+        t = day_start + 8 * 3600 + self.rng.randint(0, 3600)
+        tasks = focus = brk = sessions = 0
+        for _ in range(self.rng.randint(0, 6)):
+            f = self.rng.choice([15, 25, 25, 45])
+            self.add(t, FOCUS, b=f)
+            t += f * 60
+            focus += f
+            sessions += 1
+            if self.rng.random() < 0.8:
+                tasks += 1
+                b = self.rng.choice([5, 10])
+                self.add(t, BREAK, b=b)
+                t += b * 60
+                brk += b
+            t = min(t + self.rng.randint(0, 7200), day_start + 86000)
+        goal = self.rng.randint(1, 5)
+        self.add(day_start + 86399, DAY, a=tasks, b=focus, c=brk,
+                 d=sessions | (0x8000 if tasks >= goal else 0))
+
+    def upload(self, url, fail_rate):
+        while self.queue:
+            batch = self.queue[:32]
+            body = HEADER.pack(MAGIC, VERSION, len(batch), self.mac)
+            body += b"".join(RECORD.pack(*r) for r in batch)
+            roll = self.rng.random()
+            if roll < fail_rate:
+                return False                        # Server unreachable: try later
+            request = urllib.request.Request(f"{url}/upload", data=body, method="POST",
+                                             headers={"Content-Type": "application/octet-stream"})
+            with urllib.request.urlopen(request, timeout=10) as response:
+                cursor = json.loads(response.read())["cursor"]
+            if roll < fail_rate * 2:
+                continue                            # Response lost: same batch again
+            for r in self.queue:
+                if r[0] <= cursor:
+                    self.delivered[r[0]] = r
+            self.queue = [r for r in self.queue if r[0] > cursor]
+        return True
+
+
+def simulate(url, cubes, days, seed, fail_rate=0.1, reboot_rate=0.05, start=None):
+    rng = random.Random(seed)
+    fleet = [SimCube(random.Random(rng.random()), i) for i in range(cubes)]
+    start = start or datetime.date.today() - datetime.timedelta(days=days)
+    t0 = time.monotonic()
+    for day in range(days):
+        day_start = int(datetime.datetime.combine(start + datetime.timedelta(days=day),
+                                                  datetime.time(), datetime.timezone.utc).timestamp())
+        for cube in fleet:
+            cube.simulate_day(day_start)
+            if cube.rng.random() < reboot_rate:
+                cube.reboot()
+            cube.upload(url, fail_rate)
+    for cube in fleet:
+        while not cube.upload(url, 0):
+            pass
+    sent = sum(len(c.delivered) for c in fleet)
+    print(f"{cubes} cubes x {days} days: {sent} records delivered, "
+          f"{sum(c.carried for c in fleet)} carried over reboots, {time.monotonic() - t0:.1f} s")
+    return fleet, start
+
+
+def selftest(cubes, days):
+    with tempfile.TemporaryDirectory() as data:
+        fleet = Fleet(data)
+        server = ThreadingHTTPServer(("127.0.0.1", 0), make_handler(fleet))
+        threading.Thread(target=server.serve_forever, daemon=True).start()
+        url = f"http://127.0.0.1:{server.server_address[1]}"
+
+        sims, start = simulate(url, cubes, days, seed=1)
+        ok = True
+        for cube in sims:
+            store = fleet.devices[cube.mac.hex()]
+            stored = list(zip(*(store.cols[name] for name, _ in COLUMNS)))
+            expected = [cube.delivered[s] for s in sorted(cube.delivered)]
+            if stored != expected:
+                ok = False
+                print(f"  {cube.mac.hex()}: stored {len(stored)} records, expected {len(expected)}")
+
+        t0 = time.monotonic()
+        result = fleet.query(start.isoformat(), None, "week", ["focus", "tasks", "goalMet", "days"])
+        elapsed = (time.monotonic() - t0) * 1000
+        focus = sum(r["focus"] for r in result["rows"])
+        expected_focus = sum(r[4] for c in sims for r in c.delivered.values() if r[2] == DAY)
+        if focus != expected_focus:
+            ok = False
+            print(f"  weekly focus total {focus}, expected {expected_focus}")
+        print(f"group-by week over {sum(len(s) for s in fleet.devices.values())} records: {elapsed:.1f} ms")
+
+        # Reload from disk: the columns must come back identical
+        reloaded = Fleet(data)
+        if reloaded.query(group="device", metrics=["focus"]) != fleet.query(group="device", metrics=["focus"]):
+            ok = False
+            print("  reloaded store differs")
+
+        server.shutdown()
+        print("selftest", "passed" if ok else "FAILED")
+        return ok
+
+
+# ============================================
+# Main
+# ============================================
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("serve", help="Run the aggregator")
+    p.add_argument("--data", default="fleet_data", help="Store directory")
+    p.add_argument("--port", type=int, default=8750)
+    p.add_argument("--utc-offset", type=float, default=0, help="Hours, for day/week grouping")
+
+    p = sub.add_parser("query", help="Query a running server")
+    p.add_argument("url")
+    p.add_argument("--from", dest="start")
+    p.add_argument("--to", dest="end")
+    p.add_argument("--group", default="device")
+    p.add_argument("--metrics", default="focus,tasks")
+    p.add_argument("--device")
+    p.add_argument("--agg", default="sum", choices=["sum", "avg"])
+
+    p = sub.add_parser("simulate", help="Push records from simulated cubes")
+    p.add_argument("url")
+    p.add_argument("--cubes", type=int, default=10)
+    p.add_argument("--days", type=int, default=30)
+    p.add_argument("--seed", type=int, default=1)
+
+    p = sub.add_parser("selftest", help="Server + simulated cubes in one process")
+    p.add_argument("--cubes", type=int, default=8)
+    p.add_argument("--days", type=int, default=60)
+
+    args = parser.parse_args()
+    if args.command == "serve":
+        serve(args.data, args.port, args.utc_offset)
+    elif args.command == "query":
+        params = {k: v for k, v in [("from", args.start), ("to", args.end), ("group", args.group),
+                                    ("metrics", args.metrics), ("device", args.device),
+                                    ("agg", args.agg)] if v}
+        with urllib.request.urlopen(f"{args.url}/query?{urllib.parse.urlencode(params)}") as response:
+            result = json.loads(response.read())
+        print(f"{result['group']:>18}  " + "  ".join(f"{m:>13}" for m in result["metrics"]))
+        for row in result["rows"]:
+            print(f"{row['key']:>18}  " + "  ".join(f"{row[m]:>13}" for m in result["metrics"]))
+    elif args.command == "simulate":
+        simulate(args.url, args.cubes, args.days, args.seed)
+    elif args.command == "selftest":
+        sys.exit(0 if selftest(args.cubes, args.days) else 1)
+
+
+if __name__ == "__main__":
+    main()
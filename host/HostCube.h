@@ -0,0 +1,104 @@
+#ifndef HOST_CUBE_H
+#define HOST_CUBE_H
+
+/**
+ * ============================================
+ * HostCube - The cube's state half, on the host
+ * ============================================
+ *
+ * The globals finall.ino defines for the state code, wired the way the
+ * sketch wires them for a scenario run: flips go to handleFlip(), web
+ * actions through applyWebAction(), events to the overlays and the
+ * session tracker, midnight to endDay(). No web server, MQTT, fleet,
+ * buzzer or OLED - those are outputs, and a scenario holds them back on
+ * the cube too.
+ *
+ * One program = one translation unit = one cube (SystemState.h defines
+ * the event queue), like the sketch.
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <Preferences.h>
+#include "config.h"
+#include "SimClock.h"
+#include "EventQueue.h"
+#include "LatencyTrace.h"
+#include "NvsWriteLog.h"
+#include "SystemState.h"
+#include "Analytics.h"
+#include "SessionTracker.h"
+#include "ScreenOverlays.h"
+#include "WebActions.h"
+#include "ScenarioRunner.h"
+
+// 2026-01-05 08:00 UTC, a Monday: the clock a freshly synced cube would have
+static const time_t HOST_EPOCH = 1767600000;
+
+uint32_t simClockOffsetMs = 0;
+LatencyTrace latencyTrace;
+NvsWriteLog nvsWriteLog;
+
+SystemState systemState;
+Analytics analytics;
+SessionTracker sessionTracker(analytics);
+ScreenOverlays overlays;
+ScenarioRunner scenarioRunner(systemState, analytics);
+
+// The state half of processEvents() in finall.ino
+inline void hostProcessEvents() {
+    while (eventQueue.hasEvents()) {
+        EventData event = eventQueue.popData();
+        overlays.handle(event.type);
+        sessionTracker.handle(event.type, systemState.getMode());
+    }
+}
+
+// Same as scenarioStep() in finall.ino
+inline void hostStep() {
+    systemState.loop();
+    analytics.loop();
+    hostProcessEvents();
+    overlays.update();
+}
+
+// A client's WebSocket message; false if it was not a state action
+inline bool hostWebAction(const char* json) {
+    StaticJsonDocument<512> doc;
+    if (deserializeJson(doc, json)) return false;
+    return applyWebAction(systemState, analytics, doc) != ActionResult::UNKNOWN;
+}
+
+// The sketch's loop between two runs, for a minute: a run that moved
+// the date rolls the day over when the wall clock goes back
+inline void hostSettle() {
+    for (uint8_t s = 0; s < 61; s++) {
+        hostAdvanceMs(1000);
+        hostStep();
+    }
+}
+
+inline const char* hostScreenName() {
+    return overlays.screenName(systemState.getMode());
+}
+
+// Boot with an empty NVS and a synced clock (UTC, so runs match everywhere)
+inline void hostBegin(time_t wallClock = HOST_EPOCH) {
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    struct timeval tv = { wallClock, 0 };
+    settimeofday(&tv, nullptr);
+
+    systemState.begin();
+    analytics.begin();
+    analytics.onMidnight([]() { systemState.endDay(); });
+    sessionTracker.reset(systemState.getMode());
+
+    scenarioRunner.onFlip([](bool isFlipped) { systemState.handleFlip(isFlipped); });
+    scenarioRunner.onStep(hostStep);
+    scenarioRunner.onWebAction([](const char* json) { hostWebAction(json); });
+    scenarioRunner.onScreen(hostScreenName);
+    hostStep();
+}
+
+#endif // HOST_CUBE_H
@@ -0,0 +1,82 @@
+/**
+ * ============================================
+ * anim_host - Q16 animation helpers vs the float originals
+ * ============================================
+ *
+ * The overlay animations draw with Animation::easeInOutQ16, bounceQ16
+ * and oscillateQ16 (table lookups). This sweeps t over 0..1 and checks
+ * each against the float Animation function it replaces, and
+ * OneShotTimer::progressQ16() against progress() on virtual time.
+ * Limits are in Q16 LSB (65536 = 1.0), the same as FixedMath's
+ * compile-time checks against double.
+ *
+ * Usage:
+ *   ./build/anim_host
+ */
+
+#include <Arduino.h>
+#include "IntervalTimer.h"
+#include "TimedScreenManager.h"
+
+#include <functional>
+
+struct CurveCheck {
+    const char* name;
+    std::function<uint32_t(uint32_t)> fixed;
+    std::function<float(float)> reference;
+    int32_t limit;
+};
+
+// Largest |fixed - reference| over t = 0 .. 1 in steps of `step` (Q16)
+static int32_t worstError(const CurveCheck& c, uint32_t step, uint32_t& worstT) {
+    int32_t worst = 0;
+    worstT = 0;
+    for (uint32_t t = 0; t <= FixedMath::Q16_ONE; t += step) {
+        float expect = c.reference((float)t / FixedMath::Q16_ONE) * FixedMath::Q16_ONE;
+        int32_t err = abs((int32_t)c.fixed(t) - (int32_t)lroundf(expect));
+        if (err > worst) {
+            worst = err;
+            worstT = t;
+        }
+    }
+    return worst;
+}
+
+int main() {
+    const CurveCheck curves[] = {
+        {"easeInOut", Animation::easeInOutQ16, Animation::easeInOut, 64},
+        {"bounce", Animation::bounceQ16, Animation::bounce, 320},
+        {"oscillate x1", [](uint32_t t) { return Animation::oscillateQ16(t); },
+         [](float t) { return Animation::oscillate(t); }, 16},
+        {"oscillate x2", [](uint32_t t) { return Animation::oscillateQ16(t, 2); },
+         [](float t) { return Animation::oscillate(t, 2.0f); }, 16},
+    };
+
+    int failed = 0;
+    for (const CurveCheck& c : curves) {
+        uint32_t worstT;
+        int32_t worst = worstError(c, 1, worstT);
+        bool ok = worst <= c.limit;
+        printf("%s %-13s max error %3ld LSB (%.3f%%) at t=%.4f, limit %ld\n", ok ? "ok  " : "FAIL", c.name,
+               (long)worst, worst * 100.0 / FixedMath::Q16_ONE, (double)worstT / FixedMath::Q16_ONE, (long)c.limit);
+        if (!ok) failed++;
+    }
+
+    // Timer progress: 0 before start, tracks progress() while running, 1 once expired
+    OneShotTimer timer;
+    int32_t worst = 0;
+    bool endsOk = timer.progressQ16() == 0;
+    timer.start(4000);
+    for (uint32_t ms = 0; ms <= 4000; ms += 7) {
+        float expect = timer.progress() * FixedMath::Q16_ONE;
+        worst = std::max(worst, (int32_t)abs((int32_t)timer.progressQ16() - (int32_t)lroundf(expect)));
+        hostAdvanceMs(7);
+    }
+    endsOk = endsOk && timer.expired() && timer.progressQ16() == FixedMath::Q16_ONE;
+    bool ok = worst <= 1 && endsOk;
+    printf("%s %-13s max error %3ld LSB, ends %s\n", ok ? "ok  " : "FAIL", "progressQ16",
+           (long)worst, endsOk ? "0 -> 65536" : "WRONG");
+    if (!ok) failed++;
+
+    return failed ? 1 : 0;
+}
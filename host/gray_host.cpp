@@ -0,0 +1,275 @@
+/**
+ * ============================================
+ * gray_host - GrayFramebuffer kernels vs per-pixel reference
+ * ============================================
+ *
+ * Runs clear, fillRect, blitGray, blendMask and blitMonoTiles on random
+ * inputs (random buffer underneath, clipped and misaligned rectangles,
+ * empty mask words and tiles) and checks every pixel against a plain
+ * one-pixel-at-a-time version of the documented behaviour. Then times
+ * each kernel with the arguments of benchmarkGrayFramebuffer(), next to
+ * the reference, in ns per call on this machine.
+ *
+ * Usage:
+ *   ./build/gray_host                    check + timings
+ *   ./build/gray_host --cases 20000      more random cases per kernel
+ *   ./build/gray_host --iterations 5000  average timings over more calls
+ */
+
+#include <Arduino.h>
+#include "GrayFramebuffer.h"
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+static const int W = GrayFramebuffer::WIDTH;
+static const int H = GrayFramebuffer::HEIGHT;
+
+typedef std::vector<uint8_t> Pixels;  // W*H levels, row-major
+
+// ============================================
+// Reference (one pixel at a time)
+// ============================================
+
+static uint8_t nibbleAt(const uint8_t* packed, int x, int y, int stride) {
+    uint8_t b = packed[y * stride + x / 2];
+    return (x & 1) ? (b & 0x0F) : (b >> 4);  // left pixel in the high nibble
+}
+
+static Pixels unpack(const GrayFramebuffer& fb) {
+    Pixels px(W * H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) px[y * W + x] = nibbleAt(fb.data(), x, y, W / 2);
+    }
+    return px;
+}
+
+static void refClear(Pixels& px, uint8_t level) {
+    for (uint8_t& p : px) p = level & 0x0F;
+}
+
+static void refFillRect(Pixels& px, int x, int y, int w, int h, uint8_t level) {
+    for (int py = y; py < y + h; py++) {
+        for (int qx = x; qx < x + w; qx++) {
+            if (qx >= 0 && qx < W && py >= 0 && py < H) px[py * W + qx] = level & 0x0F;
+        }
+    }
+}
+
+static void refBlitGray(Pixels& px, int x, int y, int w, int h, const uint32_t* src) {
+    if ((x & 7) || (w & 7)) return;
+    for (int sy = 0; sy < h; sy++) {
+        for (int sx = 0; sx < w; sx++) {
+            int qx = x + sx, py = y + sy;
+            if (qx >= 0 && qx < W && py >= 0 && py < H) {
+                px[py * W + qx] = nibbleAt((const uint8_t*)src, sx, sy, w / 2);
+            }
+        }
+    }
+}
+
+static void refBlendMask(Pixels& px, int x, int y, int w, int h, const uint32_t* mask, uint8_t level) {
+    if ((x & 7) || (w & 7)) return;
+    for (int sy = 0; sy < h; sy++) {
+        for (int sx = 0; sx < w; sx++) {
+            int qx = x + sx, py = y + sy;
+            if (qx < 0 || qx >= W || py < 0 || py >= H) continue;
+            int cov = nibbleAt((const uint8_t*)mask, sx, sy, w / 2);
+            int v = (cov * level * 2 + 15) / 30;  // cov * level / 15, rounded
+            uint8_t& p = px[py * W + qx];
+            if (v > p) p = v;
+        }
+    }
+}
+
+static void refBlitMonoTiles(Pixels& px, const uint8_t* tiles, uint8_t level) {
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            if ((tiles[(y >> 3) * W + x] >> (y & 7)) & 1) px[y * W + x] = level & 0x0F;
+        }
+    }
+}
+
+// ============================================
+// Random inputs
+// ============================================
+
+static uint32_t rngState = 0x2545F491;
+
+static uint32_t rnd() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static int rndRange(int lo, int hi) { return lo + (int)(rnd() % (uint32_t)(hi - lo + 1)); }
+
+// Random words, about a quarter of them zero (the kernels skip those)
+static void fillRandom(uint32_t* words, size_t count) {
+    for (size_t i = 0; i < count; i++) words[i] = (rnd() & 3) ? rnd() : 0;
+}
+
+static void randomize(GrayFramebuffer& fb) {
+    for (int row = 0; row < H; row++) fillRandom(fb.rowWords(row), GrayFramebuffer::WORDS_PER_ROW);
+}
+
+static void randomTiles(uint8_t* tiles) {
+    for (int tile = 0; tile < W * H / 64; tile++) {
+        bool empty = rnd() & 1;
+        for (int b = 0; b < 8; b++) tiles[tile * 8 + b] = empty ? 0 : (uint8_t)rnd();
+    }
+}
+
+// ============================================
+// Check
+// ============================================
+
+struct KernelCheck {
+    const char* name;
+    int failed = 0;
+    std::string firstFailure;
+};
+
+static void compare(KernelCheck& check, const GrayFramebuffer& fb, const Pixels& want, const char* args) {
+    Pixels got = unpack(fb);
+    int diff = 0, fx = -1, fy = -1;
+    for (int p = 0; p < W * H; p++) {
+        if (got[p] == want[p]) continue;
+        if (diff++ == 0) { fx = p % W; fy = p / W; }
+    }
+    if (diff == 0) return;
+    if (check.failed++ == 0) {
+        char buf[200];
+        snprintf(buf, sizeof(buf), "%s: %d px differ, first (%d,%d) got %u want %u",
+                 args, diff, fx, fy, got[fy * W + fx], want[fy * W + fx]);
+        check.firstFailure = buf;
+    }
+}
+
+static const int MAX_SPRITE = 64;
+
+int main(int argc, char** argv) {
+    int cases = 2000;
+    int iterations = 2000;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--cases" && i + 1 < argc) cases = std::max(1, atoi(argv[++i]));
+        else if (arg == "--iterations" && i + 1 < argc) iterations = std::max(1, atoi(argv[++i]));
+        else {
+            fprintf(stderr, "usage: %s [--cases N] [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    static GrayFramebuffer fb;
+    static uint32_t sprite[MAX_SPRITE * MAX_SPRITE / 8];
+    static uint8_t tiles[W * H / 8];
+    char args[120];
+
+    KernelCheck checks[5];
+    checks[0].name = "clear";
+    checks[1].name = "fillRect";
+    checks[2].name = "blitGray";
+    checks[3].name = "blendMask";
+    checks[4].name = "blitMonoTiles";
+
+    for (int c = 0; c < cases; c++) {
+        uint8_t level = rnd() & 0x0F;
+
+        randomize(fb);
+        Pixels want = unpack(fb);
+        fb.clear(level);
+        refClear(want, level);
+        snprintf(args, sizeof(args), "clear(%u)", level);
+        compare(checks[0], fb, want, args);
+
+        // Any rectangle, partly or fully off screen
+        int x = rndRange(-20, W + 4), y = rndRange(-20, H + 4);
+        int w = rndRange(-4, W + 24), h = rndRange(-4, H + 24);
+        randomize(fb);
+        want = unpack(fb);
+        fb.fillRect(x, y, w, h, level);
+        refFillRect(want, x, y, w, h, level);
+        snprintf(args, sizeof(args), "fillRect(%d, %d, %d, %d, %u)", x, y, w, h, level);
+        compare(checks[1], fb, want, args);
+
+        // Sprites: mostly aligned (a misaligned one must be a no-op)
+        x = (rnd() & 7) ? rndRange(-MAX_SPRITE / 8, W / 8 + 1) * 8 : rndRange(-MAX_SPRITE, W);
+        y = rndRange(-MAX_SPRITE, H + 4);
+        w = (rnd() & 7) ? rndRange(0, MAX_SPRITE / 8) * 8 : rndRange(1, MAX_SPRITE);
+        h = rndRange(0, MAX_SPRITE);
+        fillRandom(sprite, sizeof(sprite) / sizeof(sprite[0]));
+
+        randomize(fb);
+        want = unpack(fb);
+        fb.blitGray(x, y, w, h, sprite);
+        refBlitGray(want, x, y, w, h, sprite);
+        snprintf(args, sizeof(args), "blitGray(%d, %d, %d, %d)", x, y, w, h);
+        compare(checks[2], fb, want, args);
+
+        randomize(fb);
+        want = unpack(fb);
+        fb.blendMask(x, y, w, h, sprite, level);
+        refBlendMask(want, x, y, w, h, sprite, level);
+        snprintf(args, sizeof(args), "blendMask(%d, %d, %d, %d, %u)", x, y, w, h, level);
+        compare(checks[3], fb, want, args);
+
+        randomTiles(tiles);
+        randomize(fb);
+        want = unpack(fb);
+        fb.blitMonoTiles(tiles, level);
+        refBlitMonoTiles(want, tiles, level);
+        snprintf(args, sizeof(args), "blitMonoTiles(%u)", level);
+        compare(checks[4], fb, want, args);
+    }
+
+    int failed = 0;
+    for (const KernelCheck& check : checks) {
+        if (check.failed == 0) {
+            printf("ok   %-14s %d cases\n", check.name, cases);
+        } else {
+            printf("FAIL %-14s %d/%d cases, %s\n", check.name, check.failed, cases, check.firstFailure.c_str());
+            failed++;
+        }
+    }
+
+    // Timings: the arguments of benchmarkGrayFramebuffer()
+    for (size_t i = 0; i < 32 * 32 / 8; i++) sprite[i] = 0x12345678UL * (i + 1);
+    randomTiles(tiles);
+    Pixels ref = unpack(fb);
+
+    auto nsPerCall = [iterations](const std::function<void(int)>& body) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) body(i);
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+    };
+
+    struct Timing {
+        const char* name;
+        std::function<void(int)> kernel;
+        std::function<void(int)> reference;
+    };
+    const Timing timings[] = {
+        {"clear", [&](int i) { fb.clear(i & 0x0F); }, [&](int i) { refClear(ref, i & 0x0F); }},
+        {"fillRect", [&](int i) { fb.fillRect(3, 5, 101, 90, i & 0x0F); },
+         [&](int i) { refFillRect(ref, 3, 5, 101, 90, i & 0x0F); }},
+        {"blitGray 32", [&](int) { fb.blitGray(48, 48, 32, 32, sprite); },
+         [&](int) { refBlitGray(ref, 48, 48, 32, 32, sprite); }},
+        {"blendMask 32", [&](int) { fb.blendMask(48, 48, 32, 32, sprite, 9); },
+         [&](int) { refBlendMask(ref, 48, 48, 32, 32, sprite, 9); }},
+        {"blitMonoTiles", [&](int) { fb.blitMonoTiles(tiles, 15); },
+         [&](int) { refBlitMonoTiles(ref, tiles, 15); }},
+    };
+
+    printf("\nkernel          ns/call  reference  speedup\n");
+    for (const Timing& t : timings) {
+        double kernelNs = nsPerCall(t.kernel);
+        double refNs = nsPerCall(t.reference);
+        printf("%-14s  %7.0f  %9.0f  %6.1fx\n", t.name, kernelNs, refNs, refNs / kernelNs);
+    }
+
+    return failed ? 1 : 0;
+}
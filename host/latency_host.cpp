@@ -0,0 +1,303 @@
+/**
+ * ============================================
+ * latency_host - Flip / web action to pixels, simulated
+ * ============================================
+ *
+ * The host half of the latency benchmark (the cube half is
+ * POST /api/latency + load_test.py). Runs the real SystemState,
+ * DisplayRenderer and LatencyTrace through the sketch's flip and
+ * WebSocket paths on virtual time, charging the parts that cost time
+ * on the cube from a model:
+ *
+ *   I2C     the MPU read that saw the flip (5 bytes at 100 kHz)
+ *   NVS     each Preferences write (--nvs-us, default 2 ms)
+ *   SPI     every byte to the panel at OLED_SPI_HZ
+ *   wait    OLED_REFRESH_MS rate limit, the last frame --since-ms ago
+ *
+ * CPU time is not on the virtual clock; the host time of the whole
+ * path is printed next to it. The stage list is the cube's, so a new
+ * NVS write, a lost prerender or a bigger frame shows up here first.
+ *
+ * Glue that lives in finall.ino (handleCubeFlip, refreshOLED, the
+ * frame prediction) is mirrored below, like HostCube mirrors
+ * scenarioStep().
+ *
+ * Usage:
+ *   ./build/latency_host                   breakdown of each interaction
+ *   ./build/latency_host --budget-ms 100   exit 1 if one takes longer
+ */
+
+#include "HostCube.h"
+#include <U8g2lib.h>
+#include "IntervalTimer.h"
+#include "DisplayRenderer.h"
+#include "StateMessages.h"
+
+#include <chrono>
+#include <string>
+
+static const uint32_t I2C_HZ = 100000;     // Wire default
+static const uint8_t MPU_READ_BYTES = 5;   // addr+reg, addr+2 data bytes
+
+struct Charges {
+    uint32_t i2cUs = 0;
+    uint32_t nvsUs = 0;
+    uint16_t nvsWrites = 0;
+    uint32_t spiUs = 0;
+    uint32_t spiBytes = 0;
+    uint32_t waitUs = 0;
+    uint8_t frames = 0;
+    size_t statusBytes = 0;
+};
+
+static U8G2_SSD1327_WS_128X128_F_4W_HW_SPI u8g2(U8G2_R2, OLED_CS, OLED_DC, OLED_RST);
+static DisplayRenderer display(u8g2);
+static IntervalTimer refreshTimer(OLED_REFRESH_MS);
+static bool needsRefresh = false;
+static Charges charges;
+static uint32_t nvsWriteUs = 2000;
+
+// ============================================
+// Device costs on the virtual clock
+// ============================================
+
+static u8x8_msg_cb busByteCb = nullptr;
+
+static uint8_t spiByteCb(u8x8_t* u8x8, uint8_t msg, uint8_t argInt, void* argPtr) {
+    if (msg == U8X8_MSG_BYTE_SEND) {
+        uint32_t us = (uint32_t)((uint64_t)argInt * 8 * 1000000 / OLED_SPI_HZ);
+        charges.spiBytes += argInt;
+        charges.spiUs += us;
+        hostAdvanceUs(us);
+    }
+    return busByteCb(u8x8, msg, argInt, argPtr);
+}
+
+static void chargeNvsWrite(const char*, const char*, size_t) {
+    charges.nvsWrites++;
+    charges.nvsUs += nvsWriteUs;
+    hostAdvanceUs(nvsWriteUs);
+}
+
+// ============================================
+// Mirrors of the sketch's display glue
+// ============================================
+
+static FrameKey frameKeyFor(SystemMode mode, uint32_t taskId, uint32_t timeLeft, uint32_t totalTime, bool rotated) {
+    int hour, minute;
+    analytics.getCurrentTime(hour, minute);
+    FrameKey key;
+    key.mode = mode;
+    key.taskId = taskId;
+    key.timeLeft = timeLeft;
+    key.totalTime = totalTime;
+    key.minuteOfDay = hour * 60 + minute;
+    key.rotated = rotated;
+    return key;
+}
+
+static void drawTimerFrame(const FrameKey& key, const char* taskName) {
+    display.drawBorder();
+    display.drawClock(key.minuteOfDay / 60, key.minuteOfDay % 60);
+    if (key.mode == MODE_FOCUSING) display.drawFocusScreen(taskName, key.timeLeft, key.totalTime);
+    else display.drawBreakScreen(taskName, key.timeLeft, key.totalTime);
+}
+
+// updateFramePrediction(), the idle -> focus case
+static void updateFramePrediction() {
+    if (systemState.getMode() != MODE_IDLE || !systemState.hasSelectedTask()) return;
+    TaskInfo* task = systemState.getTask(systemState.getSelectedTaskId());
+    if (!task) return;
+    uint32_t total = task->focusDuration * 60;
+    FrameKey key = frameKeyFor(MODE_FOCUSING, task->id, total, total, false);
+    if (display.isPredicted(key)) return;
+    display.prerender(key, [&]() { drawTimerFrame(key, task->name); });
+}
+
+static bool commitPredictedFrame() {
+    if (overlays.active()) return false;
+    SystemMode mode = systemState.getMode();
+    if (mode != MODE_FOCUSING && mode != MODE_BREAK) return false;
+    FrameKey key = frameKeyFor(mode, systemState.getActiveTaskId(), systemState.getTimeLeft(),
+                               systemState.getTotalTime(), display.isRotated());
+    return display.commitPrediction(key);
+}
+
+// refreshOLED(), state screens only
+static void refreshOLED() {
+    if (commitPredictedFrame()) return;
+    display.beginFrame();
+    display.drawBorder();
+    int hour, minute;
+    analytics.getCurrentTime(hour, minute);
+    display.drawClock(hour, minute);
+
+    const char* taskName = systemState.getCurrentTaskName();
+    switch (systemState.getMode()) {
+        case MODE_FOCUSING: display.drawFocusScreen(taskName, systemState.getTimeLeft(), systemState.getTotalTime()); break;
+        case MODE_BREAK: display.drawBreakScreen(taskName, systemState.getTimeLeft(), systemState.getTotalTime()); break;
+        case MODE_PAUSED: display.drawPausedScreen(taskName, systemState.getTimeLeft(), systemState.getTotalTime()); break;
+        case MODE_WITHERED: display.drawWitheredScreen(); break;
+        default: display.drawIdleScreen(systemState.getPlantInfo(), false, true, false); break;
+    }
+    display.endFrame();
+    updateFramePrediction();
+}
+
+// WebServerHandler::broadcastStatus() minus the sockets
+static void broadcastStatus() {
+    static char buffer[MESSAGE_BUFFER_SIZE];
+    StatusMsg msg;
+    fillStatus(msg, &systemState);
+    if (latencyTrace.isActive()) {
+        msg.hasTrace = true;
+        msg.trace = latencyTrace.id();
+    }
+    JsonWriter writer(buffer, sizeof(buffer));
+    writeJson(writer, msg);
+    charges.statusBytes = writer.length();
+    latencyTrace.mark(LatencyStage::BROADCAST);
+}
+
+// processEvents() + the loop's rate-limited refresh, until the frame is out
+static void runLoopUntilFrame() {
+    uint32_t waitStart = micros();
+    for (uint16_t i = 0; i < 1000; i++) {
+        systemState.loop();
+        while (eventQueue.hasEvents()) {
+            EventData event = eventQueue.popData();
+            if (overlays.handle(event.type)) needsRefresh = true;
+            sessionTracker.handle(event.type, systemState.getMode());
+            if (event.type == Event::STATE_CHANGED || event.type == Event::TIMER_TICK) updateFramePrediction();
+            if (event.type == Event::OLED_REFRESH) needsRefresh = true;
+        }
+        if (needsRefresh && refreshTimer.elapsed()) {
+            charges.waitUs = micros() - waitStart;
+            refreshOLED();
+            needsRefresh = false;
+            return;
+        }
+        if (!needsRefresh) return;
+        hostAdvanceMs(1);
+    }
+}
+
+// handleCubeFlip()
+static void flip(bool isFlipped) {
+    uint32_t i2cUs = MPU_READ_BYTES * 9 * 1000000UL / I2C_HZ;
+    uint32_t inputUs = micros();
+    hostAdvanceUs(i2cUs);
+    charges.i2cUs = i2cUs;
+
+    latencyTrace.begin(LatencyTrace::FLIP, inputUs);
+    latencyTrace.mark(LatencyStage::DETECTED);
+    u8g2.setDisplayRotation(isFlipped ? U8G2_R0 : U8G2_R2);
+    systemState.handleFlip(isFlipped);
+    latencyTrace.mark(LatencyStage::APPLIED);
+    needsRefresh = !commitPredictedFrame();
+    broadcastStatus();
+    runLoopUntilFrame();
+}
+
+// handleWebSocketMessage() for a traced action
+static void webAction(const char* json) {
+    uint32_t receivedUs = micros();
+    StaticJsonDocument<512> doc;
+    deserializeJson(doc, json);
+    latencyTrace.begin(LatencyTrace::WEB, receivedUs);
+    latencyTrace.mark(LatencyStage::DETECTED);
+    applyWebAction(systemState, analytics, doc);
+    latencyTrace.mark(LatencyStage::APPLIED);
+    broadcastStatus();
+    needsRefresh = true;
+    runLoopUntilFrame();
+}
+
+// ============================================
+// Report
+// ============================================
+
+static uint32_t reportInteraction(const char* name, LatencyTrace::Kind kind,
+                                  const std::function<void()>& run, uint32_t sinceFrameMs) {
+    // The panel last changed sinceFrameMs ago
+    refreshTimer.reset();
+    hostAdvanceMs(sinceFrameMs);
+    charges = Charges();
+
+    auto start = std::chrono::steady_clock::now();
+    run();
+    double cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // No client here: finish the trace the way a timeout would
+    hostAdvanceMs(LATENCY_TRACE_TIMEOUT_MS + 1);
+    latencyTrace.loop();
+    const LatencyTrace::Result& r = latencyTrace.last(kind);
+
+    printf("%s -> %s\n ", name, systemState.getModeString());
+    for (uint8_t s = 1; s < (uint8_t)LatencyStage::CLIENT; s++) {
+        if (r.stageUs[s] >= 0) printf(" %s %.2f", LatencyTrace::stageName(s), r.stageUs[s] / 1000.0);
+        else printf(" %s -", LatencyTrace::stageName(s));
+    }
+    printf("  | total %.2f ms\n", r.totalUs / 1000.0);
+    printf("  i2c %.2f | nvs %.2f (%u writes) | wait %.2f | spi %.2f (%u frames, %lu B) | status %zu B | host cpu %.3f ms\n\n",
+           charges.i2cUs / 1000.0, charges.nvsUs / 1000.0, charges.nvsWrites, charges.waitUs / 1000.0,
+           charges.spiUs / 1000.0, charges.frames, (unsigned long)charges.spiBytes, charges.statusBytes, cpuMs);
+    return r.totalUs;
+}
+
+int main(int argc, char** argv) {
+    uint32_t budgetMs = 0;
+    uint32_t sinceFrameMs = 50;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--budget-ms" && i + 1 < argc) budgetMs = atoi(argv[++i]);
+        else if (arg == "--nvs-us" && i + 1 < argc) nvsWriteUs = atoi(argv[++i]);
+        else if (arg == "--since-ms" && i + 1 < argc) sinceFrameMs = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--budget-ms N] [--nvs-us N] [--since-ms N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    hostBegin();
+    u8g2.begin();
+    busByteCb = u8g2.getU8x8()->byte_cb;
+    u8g2.getU8x8()->byte_cb = spiByteCb;
+    hostNvsWriteHook() = chargeNvsWrite;
+    display.onFrameCommitted([](const uint8_t*, bool) {
+        latencyTrace.mark(LatencyStage::FRAME);
+        charges.frames++;
+    });
+
+    // A task selected and its focus frame prerendered, cube face up
+    systemState.restartDay();
+    systemState.restoreTask("Read", 25, 5, false, false);
+    systemState.selectTaskForFlip(systemState.getTasks()[0].id);
+    hostStep();
+    refreshOLED();
+
+    printf("latency_host: NVS write %lu us, SPI %lu Hz, last frame %lu ms before the input\n\n",
+           (unsigned long)nvsWriteUs, (unsigned long)OLED_SPI_HZ, (unsigned long)sinceFrameMs);
+
+    struct Interaction {
+        const char* name;
+        LatencyTrace::Kind kind;
+        std::function<void()> run;
+    };
+    const Interaction interactions[] = {
+        {"flip down: start focus (prerendered)", LatencyTrace::FLIP, []() { flip(true); }},
+        {"flip up: pause", LatencyTrace::FLIP, []() { flip(false); }},
+        {"web resume", LatencyTrace::WEB, []() { webAction("{\"action\":\"resume\",\"trace\":1}"); }},
+        {"web pause", LatencyTrace::WEB, []() { webAction("{\"action\":\"pause\",\"trace\":1}"); }},
+    };
+
+    int over = 0;
+    for (const Interaction& interaction : interactions) {
+        uint32_t totalUs = reportInteraction(interaction.name, interaction.kind, interaction.run, sinceFrameMs);
+        if (budgetMs && totalUs > budgetMs * 1000) {
+            printf("  OVER BUDGET (%lu ms)\n\n", (unsigned long)budgetMs);
+            over++;
+        }
+    }
+    return over ? 1 : 0;
+}
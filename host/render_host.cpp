@@ -0,0 +1,179 @@
+/**
+ * ============================================
+ * render_host - Golden frames for every screen
+ * ============================================
+ *
+ * Draws each RenderSelfTest screen through the real DisplayRenderer
+ * (into the U8g2 stand-in, see shims/U8g2lib.h) and compares it pixel
+ * by pixel with host/golden/<screen>.pbm. Reports per screen the draw
+ * and send time on this machine (averaged, only useful relative to
+ * each other) and the SPI bytes the frame puts on the bus.
+ *
+ * Goldens are plain PBMs (P1) in reading orientation, so a changed
+ * frame shows up in `git diff` and opens in any image viewer.
+ *
+ * Usage:
+ *   ./build/render_host                 check, write differing frames to build/render/
+ *   ./build/render_host --record        (re)write the goldens after a visual change
+ *   ./build/render_host --repeat 200    average timings over more frames
+ */
+
+#include "HostCube.h"
+#include <U8g2lib.h>
+#include "DisplayRenderer.h"
+#include "RenderSelfTest.h"
+
+#include <chrono>
+#include <string>
+#include <sys/stat.h>
+
+static const int W = OLED_WIDTH;
+static const int H = OLED_HEIGHT;
+
+typedef std::vector<uint8_t> Image;  // W*H, 1 = lit, reading orientation
+
+// Tile buffer drawn with U8G2_R2 -> the picture as it reads on the panel
+static Image captureFrame(const uint8_t* tiles) {
+    Image img(W * H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            int nx = W - 1 - x, ny = H - 1 - y;
+            img[y * W + x] = (tiles[(ny >> 3) * W + nx] >> (ny & 7)) & 1;
+        }
+    }
+    return img;
+}
+
+static bool writePbm(const std::string& path, const Image& img, const char* name) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) return false;
+    fprintf(f, "P1\n# %s - host/render_host.cpp\n%d %d\n", name, W, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) fputc('0' + img[y * W + x], f);
+        fputc('\n', f);
+    }
+    return fclose(f) == 0;
+}
+
+static bool readPbm(const std::string& path, Image& img) {
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) return false;
+
+    auto skipSpaceAndComments = [f]() {
+        int c;
+        while ((c = fgetc(f)) != EOF) {
+            if (c == '#') {
+                while ((c = fgetc(f)) != EOF && c != '\n') {}
+            } else if (!isspace(c)) {
+                ungetc(c, f);
+                return;
+            }
+        }
+    };
+
+    char magic[3] = {0};
+    int w = 0, h = 0;
+    bool ok = fread(magic, 1, 2, f) == 2 && strcmp(magic, "P1") == 0;
+    if (ok) {
+        skipSpaceAndComments();
+        ok = fscanf(f, "%d", &w) == 1;
+        skipSpaceAndComments();
+        ok = ok && fscanf(f, "%d", &h) == 1 && w == W && h == H;
+    }
+
+    img.assign(W * H, 0);
+    for (int i = 0; ok && i < W * H; i++) {
+        skipSpaceAndComments();
+        int c = fgetc(f);
+        ok = c == '0' || c == '1';
+        img[i] = c == '1';
+    }
+    fclose(f);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    bool record = false;
+    int repeat = 20;
+    std::string goldenDir = "golden";
+    std::string outDir = "build/render";
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--record") record = true;
+        else if (arg == "--repeat" && i + 1 < argc) repeat = std::max(1, atoi(argv[++i]));
+        else if (arg == "--golden" && i + 1 < argc) goldenDir = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) outDir = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--record] [--repeat N] [--golden DIR] [--out DIR]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    hostBegin();
+    U8G2_SSD1327_WS_128X128_F_4W_HW_SPI u8g2(U8G2_R2, OLED_CS, OLED_DC, OLED_RST);
+    DisplayRenderer display(u8g2);
+    u8g2.begin();
+
+    // Nanoseconds: RenderCost's *Us fields hold ns on the host (differences
+    // stay right across the uint32_t wrap)
+    auto nowNs = []() -> uint32_t {
+        return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    };
+
+    int failed = 0;
+    printf("screen        draw_us  send_us  spi_bytes  result\n");
+
+    for (uint8_t i = 0; i < RENDER_SCREEN_COUNT; i++) {
+        const char* name = RENDER_SCREENS[i];
+        uint64_t drawNs = 0, sendNs = 0;
+        RenderCost cost = {};
+        for (int r = 0; r < repeat; r++) {
+            cost = renderSelfTestScreen(display, u8g2, i, nowNs);
+            drawNs += cost.drawUs;
+            sendNs += cost.sendUs;
+        }
+        Image frame = captureFrame(u8g2.getBufferPtr());
+
+        std::string golden = goldenDir + "/" + name + ".pbm";
+        std::string result;
+        if (record) {
+            result = writePbm(golden, frame, name) ? "recorded" : "CANNOT WRITE " + golden;
+            if (result != "recorded") failed++;
+        } else {
+            Image want;
+            if (!readPbm(golden, want)) {
+                result = "NO GOLDEN (--record)";
+                failed++;
+            } else {
+                int diff = 0, x0 = W, y0 = H, x1 = -1, y1 = -1;
+                for (int p = 0; p < W * H; p++) {
+                    if (frame[p] == want[p]) continue;
+                    diff++;
+                    x0 = std::min(x0, p % W); x1 = std::max(x1, p % W);
+                    y0 = std::min(y0, p / W); y1 = std::max(y1, p / W);
+                }
+                if (diff == 0) {
+                    result = "ok";
+                } else {
+                    mkdir(outDir.c_str(), 0755);
+                    std::string out = outDir + "/" + name + ".pbm";
+                    writePbm(out, frame, name);
+                    char buf[160];
+                    snprintf(buf, sizeof(buf), "DIFF %d px in x %d-%d y %d-%d -> %s",
+                             diff, x0, x1, y0, y1, out.c_str());
+                    result = buf;
+                    failed++;
+                }
+            }
+        }
+
+        printf("%-12s  %7.1f  %7.1f  %9u  %s\n", name, drawNs / 1000.0 / repeat,
+               sendNs / 1000.0 / repeat, cost.spiBytes, result.c_str());
+    }
+
+    printf("%d/%d screens %s\n", RENDER_SCREEN_COUNT - failed, RENDER_SCREEN_COUNT,
+           record ? "recorded" : "match the goldens");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * ============================================
+ * scenario_host - Run scenario scripts without a cube
+ * ============================================
+ *
+ * The same ScenarioRunner, SystemState and Analytics code as the
+ * firmware, compiled for the host (see HostCube.h). Scripts run one
+ * after another on one virtual cube, as run_scenarios.py runs them on
+ * a real one.
+ *
+ * Usage:
+ *   ./build/scenario_host scenarios/day.scn scenarios/revive.scn
+ *   HOST_VERBOSE=1 ./build/scenario_host day.scn   (firmware debug output)
+ */
+
+#include "HostCube.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <scenario.scn>...\n", argv[0]);
+        return 2;
+    }
+
+    hostBegin();
+
+    int failed = 0;
+    for (int i = 1; i < argc; i++) {
+        std::ifstream file(argv[i]);
+        if (!file) {
+            printf("FAIL %s  (cannot read)\n", argv[i]);
+            failed++;
+            continue;
+        }
+        std::stringstream script;
+        script << file.rdbuf();
+
+        auto start = std::chrono::steady_clock::now();
+        bool passed = scenarioRunner.run(script.str().c_str());
+        double elapsedMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        printf("%s %s  (%lu s simulated in %.1f ms)\n", passed ? "ok  " : "FAIL", argv[i],
+               (unsigned long)scenarioRunner.getSimulatedSeconds(), elapsedMs);
+        for (uint8_t f = 0; f < scenarioRunner.getFailureCount(); f++) {
+            const ScenarioFailure& failure = scenarioRunner.getFailure(f);
+            printf("       %s:%u: %s\n", argv[i], failure.line, failure.message);
+        }
+        int hidden = scenarioRunner.getTotalFailures() - scenarioRunner.getFailureCount();
+        if (hidden > 0) printf("       ... and %d more\n", hidden);
+        if (!passed) failed++;
+        hostSettle();
+    }
+
+    printf("%d/%d passed\n", argc - 1 - failed, argc - 1);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,205 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/**
+ * ============================================
+ * Arduino.h for host builds
+ * ============================================
+ *
+ * Just enough of the Arduino-ESP32 core for the state headers
+ * (SystemState, Analytics, ScenarioRunner, ...) to compile with g++.
+ *
+ * Time is virtual: millis()/micros() only move with delay() or
+ * hostAdvanceMs(), and the wall clock (time, gettimeofday,
+ * settimeofday, getLocalTime) is a counter the program sets - a test
+ * never touches the machine's clock and runs the same on every host.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdarg.h>
+#include <time.h>
+#include <sys/time.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define PROGMEM
+#define F(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+
+using std::min;
+using std::max;
+
+template <typename T, typename L, typename H>
+inline T constrain(T x, L low, H high) { return x < low ? low : (x > high ? high : x); }
+
+// ============================================
+// Virtual time
+// ============================================
+
+inline uint64_t& hostMicros() {
+    static uint64_t us = 0;
+    return us;
+}
+
+inline void hostAdvanceUs(uint64_t us) { hostMicros() += us; }
+inline void hostAdvanceMs(uint32_t ms) { hostMicros() += (uint64_t)ms * 1000; }
+
+inline uint32_t millis() { return (uint32_t)(hostMicros() / 1000); }
+inline uint32_t micros() { return (uint32_t)hostMicros(); }
+inline void delay(uint32_t ms) { hostAdvanceMs(ms); }
+inline void delayMicroseconds(uint32_t us) { hostAdvanceUs(us); }
+inline void yield() {}
+
+// Wall clock: seconds at the last settimeofday() plus virtual time since
+struct HostWallClock {
+    time_t setAt = 0;         // 0 = never set, like an ESP32 before NTP
+    uint64_t setAtUs = 0;
+};
+
+inline HostWallClock& hostWallClock() {
+    static HostWallClock clock;
+    return clock;
+}
+
+inline time_t hostTime(time_t* out) {
+    HostWallClock& c = hostWallClock();
+    time_t now = c.setAt + (time_t)((hostMicros() - c.setAtUs) / 1000000);
+    if (out) *out = now;
+    return now;
+}
+
+inline int hostGettimeofday(struct timeval* tv, void*) {
+    HostWallClock& c = hostWallClock();
+    uint64_t us = hostMicros() - c.setAtUs;
+    tv->tv_sec = c.setAt + (time_t)(us / 1000000);
+    tv->tv_usec = (suseconds_t)(us % 1000000);
+    return 0;
+}
+
+inline int hostSettimeofday(const struct timeval* tv, const void*) {
+    HostWallClock& c = hostWallClock();
+    c.setAt = tv->tv_sec;
+    c.setAtUs = hostMicros() - (uint64_t)tv->tv_usec;
+    return 0;
+}
+
+#define time(out) hostTime(out)
+#define gettimeofday(tv, tz) hostGettimeofday(tv, tz)
+#define settimeofday(tv, tz) hostSettimeofday(tv, tz)
+
+// Arduino-ESP32: false until the clock has been set (year < 2016)
+inline bool getLocalTime(struct tm* info, uint32_t = 5000) {
+    time_t now = hostTime(nullptr);
+    localtime_r(&now, info);
+    return info->tm_year > (2016 - 1900);
+}
+
+// FreeRTOS critical sections: one thread on the host
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+inline uint32_t esp_random() {
+    static uint32_t state = 0x9E3779B9;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// ============================================
+// String
+// ============================================
+
+class String {
+public:
+    String() {}
+    String(const char* s) : s(s ? s : "") {}
+    String(const std::string& s) : s(s) {}
+    String(char c) : s(1, c) {}
+    String(int v) : s(std::to_string(v)) {}
+    String(unsigned v) : s(std::to_string(v)) {}
+    String(long v) : s(std::to_string(v)) {}
+    String(unsigned long v) : s(std::to_string(v)) {}
+
+    const char* c_str() const { return s.c_str(); }
+    size_t length() const { return s.size(); }
+    bool isEmpty() const { return s.empty(); }
+    char operator[](size_t i) const { return i < s.size() ? s[i] : 0; }
+
+    bool operator==(const String& o) const { return s == o.s; }
+    bool operator==(const char* o) const { return s == (o ? o : ""); }
+    bool operator!=(const String& o) const { return s != o.s; }
+    bool operator!=(const char* o) const { return !(*this == o); }
+
+    String& operator+=(const String& o) { s += o.s; return *this; }
+    String& operator+=(const char* o) { s += o; return *this; }
+    String& operator+=(char c) { s += c; return *this; }
+    friend String operator+(String a, const String& b) { return a += b; }
+    friend String operator+(String a, const char* b) { return a += b; }
+    friend String operator+(const char* a, const String& b) { return String(a) += b; }
+
+    void reserve(size_t n) { s.reserve(n); }
+    int indexOf(char c) const { size_t i = s.find(c); return i == std::string::npos ? -1 : (int)i; }
+    String substring(size_t from, size_t to = std::string::npos) const {
+        return from >= s.size() ? String() : String(s.substr(from, to - from));
+    }
+    long toInt() const { return atol(s.c_str()); }
+
+    const std::string& str() const { return s; }
+
+private:
+    std::string s;
+};
+
+// ============================================
+// Serial (quiet unless HOST_VERBOSE is set)
+// ============================================
+
+class HostSerial {
+public:
+    void begin(unsigned long) {}
+
+    int printf(const char* format, ...) {
+        if (!verbose()) return 0;
+        va_list args;
+        va_start(args, format);
+        int n = vfprintf(stderr, format, args);
+        va_end(args);
+        return n;
+    }
+
+    void print(const char* s) { if (verbose()) fputs(s, stderr); }
+    void print(const String& s) { print(s.c_str()); }
+    void print(long v) { if (verbose()) fprintf(stderr, "%ld", v); }
+    void println(const char* s = "") { if (verbose()) fprintf(stderr, "%s\n", s); }
+    void println(const String& s) { println(s.c_str()); }
+    void println(long v) { if (verbose()) fprintf(stderr, "%ld\n", v); }
+
+private:
+    static bool verbose() {
+        static bool on = getenv("HOST_VERBOSE") != nullptr;
+        return on;
+    }
+};
+
+inline HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,426 @@
+#ifndef HOST_ARDUINO_JSON_H
+#define HOST_ARDUINO_JSON_H
+
+/**
+ * ============================================
+ * ArduinoJson.h for host builds
+ * ============================================
+ *
+ * The subset of the ArduinoJson 6 API the state code uses: documents
+ * of objects/arrays/scalars, doc["a"]["b"] access with `| default`,
+ * as<T>(), isNull(), assignment, deserializeJson() and serializeJson().
+ * No capacity limits - StaticJsonDocument<N> ignores N.
+ */
+
+#include <Arduino.h>
+
+class JsonValue {
+public:
+    enum Type : uint8_t { NUL, BOOL, INT, FLOAT, STRING, OBJECT, ARRAY };
+
+    Type type = NUL;
+    bool b = false;
+    int64_t i = 0;
+    double f = 0;
+    std::string s;
+    std::vector<std::pair<std::string, JsonValue>> members;  // OBJECT
+    std::vector<JsonValue> items;                            // ARRAY
+
+    JsonValue* member(const std::string& key) {
+        if (type != OBJECT) return nullptr;
+        for (auto& m : members) {
+            if (m.first == key) return &m.second;
+        }
+        return nullptr;
+    }
+
+    JsonValue& memberOrAdd(const std::string& key) {
+        if (type != OBJECT) {
+            *this = JsonValue();
+            type = OBJECT;
+        }
+        JsonValue* found = member(key);
+        if (found) return *found;
+        members.emplace_back(key, JsonValue());
+        return members.back().second;
+    }
+
+    void serialize(std::string& out) const {
+        char buf[32];
+        switch (type) {
+            case NUL: out += "null"; break;
+            case BOOL: out += b ? "true" : "false"; break;
+            case INT: out += std::to_string(i); break;
+            case FLOAT: snprintf(buf, sizeof(buf), "%.9g", f); out += buf; break;
+            case STRING: quote(s, out); break;
+            case OBJECT:
+                out += '{';
+                for (size_t n = 0; n < members.size(); n++) {
+                    if (n) out += ',';
+                    quote(members[n].first, out);
+                    out += ':';
+                    members[n].second.serialize(out);
+                }
+                out += '}';
+                break;
+            case ARRAY:
+                out += '[';
+                for (size_t n = 0; n < items.size(); n++) {
+                    if (n) out += ',';
+                    items[n].serialize(out);
+                }
+                out += ']';
+                break;
+        }
+    }
+
+private:
+    static void quote(const std::string& text, std::string& out) {
+        out += '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (c == '\n') {
+                out += "\\n";
+            } else if ((uint8_t)c < 0x20) {
+                char esc[8];
+                snprintf(esc, sizeof(esc), "\\u%04x", c);
+                out += esc;
+            } else {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+};
+
+// doc["a"]["b"]: a path that is only created when assigned to
+class JsonVariant {
+public:
+    JsonVariant(JsonValue* root, std::vector<std::string> path) : root(root), path(std::move(path)) {}
+
+    JsonVariant operator[](const char* key) const {
+        std::vector<std::string> p = path;
+        p.push_back(key);
+        return JsonVariant(root, p);
+    }
+
+    bool isNull() const {
+        const JsonValue* v = resolve();
+        return !v || v->type == JsonValue::NUL;
+    }
+
+    template <typename T>
+    bool is() const { return check((T*)nullptr); }
+
+    template <typename T>
+    T as() const { return convert((T*)nullptr); }
+
+    template <typename T>
+    operator T() const { return as<T>(); }
+
+    // Value, or the default when missing or of another type
+    const char* operator|(const char* fallback) const {
+        const JsonValue* v = resolve();
+        return v && v->type == JsonValue::STRING ? v->s.c_str() : fallback;
+    }
+
+    template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    T operator|(T fallback) const {
+        const JsonValue* v = resolve();
+        if (!v) return fallback;
+        if (v->type == JsonValue::INT) return (T)v->i;
+        if (v->type == JsonValue::FLOAT) return (T)v->f;
+        if (v->type == JsonValue::BOOL) return (T)v->b;
+        return fallback;
+    }
+
+    JsonVariant& operator=(const char* value) {
+        JsonValue& v = create();
+        v = JsonValue();
+        if (value) {
+            v.type = JsonValue::STRING;
+            v.s = value;
+        }
+        return *this;
+    }
+
+    JsonVariant& operator=(const String& value) { return *this = value.c_str(); }
+    JsonVariant& operator=(bool value) {
+        JsonValue& v = create();
+        v = JsonValue();
+        v.type = JsonValue::BOOL;
+        v.b = value;
+        return *this;
+    }
+
+    template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    JsonVariant& operator=(T value) {
+        JsonValue& v = create();
+        v = JsonValue();
+        if (std::is_floating_point<T>::value) {
+            v.type = JsonValue::FLOAT;
+            v.f = value;
+        } else {
+            v.type = JsonValue::INT;
+            v.i = (int64_t)value;
+        }
+        return *this;
+    }
+
+private:
+    JsonValue* root;
+    std::vector<std::string> path;
+
+    const JsonValue* resolve() const {
+        JsonValue* v = root;
+        for (const std::string& key : path) {
+            v = v->member(key);
+            if (!v) return nullptr;
+        }
+        return v;
+    }
+
+    JsonValue& create() {
+        JsonValue* v = root;
+        for (const std::string& key : path) v = &v->memberOrAdd(key);
+        return *v;
+    }
+
+    bool check(const char**) const {
+        const JsonValue* v = resolve();
+        return v && v->type == JsonValue::STRING;
+    }
+    template <typename T>
+    bool check(T*) const {
+        const JsonValue* v = resolve();
+        return v && (v->type == JsonValue::INT || v->type == JsonValue::FLOAT || v->type == JsonValue::BOOL);
+    }
+
+    const char* convert(const char**) const { return *this | (const char*)nullptr; }
+    String convert(String*) const { return String(*this | ""); }
+    template <typename T>
+    T convert(T*) const { return *this | (T)0; }
+};
+
+class JsonDocument {
+public:
+    JsonVariant operator[](const char* key) { return JsonVariant(&root, {key}); }
+    JsonVariant as() { return JsonVariant(&root, {}); }
+    bool isNull() const { return root.type == JsonValue::NUL; }
+    void clear() { root = JsonValue(); }
+
+    JsonValue& value() { return root; }
+    const JsonValue& value() const { return root; }
+
+private:
+    JsonValue root;
+};
+
+template <size_t CAPACITY>
+class StaticJsonDocument : public JsonDocument {};
+
+class DynamicJsonDocument : public JsonDocument {
+public:
+    explicit DynamicJsonDocument(size_t) {}
+};
+
+// ============================================
+// Parsing
+// ============================================
+
+class DeserializationError {
+public:
+    enum Code { Ok, InvalidInput, IncompleteInput };
+
+    DeserializationError(Code code = Ok) : code(code) {}
+    explicit operator bool() const { return code != Ok; }
+    const char* c_str() const {
+        return code == Ok ? "Ok" : (code == InvalidInput ? "InvalidInput" : "IncompleteInput");
+    }
+
+private:
+    Code code;
+};
+
+class HostJsonParser {
+public:
+    HostJsonParser(const char* p, const char* end) : p(p), end(end) {}
+
+    DeserializationError parse(JsonValue& out) {
+        skip();
+        if (p == end) return DeserializationError::IncompleteInput;
+        if (!value(out, 0)) return error;
+        return DeserializationError::Ok;
+    }
+
+private:
+    const char* p;
+    const char* end;
+    DeserializationError error = DeserializationError::InvalidInput;
+
+    void skip() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+    }
+
+    bool fail(DeserializationError::Code code) {
+        error = code;
+        return false;
+    }
+
+    bool literal(const char* word) {
+        size_t n = strlen(word);
+        if ((size_t)(end - p) < n) return fail(DeserializationError::IncompleteInput);
+        if (strncmp(p, word, n) != 0) return fail(DeserializationError::InvalidInput);
+        p += n;
+        return true;
+    }
+
+    bool string(std::string& out) {
+        p++;  // Opening quote
+        while (p < end && *p != '"') {
+            if (*p == '\\') {
+                if (++p == end) break;
+                switch (*p) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u': {
+                        if (end - p < 5) return fail(DeserializationError::IncompleteInput);
+                        unsigned code = strtoul(std::string(p + 1, p + 5).c_str(), nullptr, 16);
+                        p += 4;
+                        if (code < 0x80) {
+                            out += (char)code;
+                        } else if (code < 0x800) {
+                            out += (char)(0xC0 | (code >> 6));
+                            out += (char)(0x80 | (code & 0x3F));
+                        } else {
+                            out += (char)(0xE0 | (code >> 12));
+                            out += (char)(0x80 | ((code >> 6) & 0x3F));
+                            out += (char)(0x80 | (code & 0x3F));
+                        }
+                        break;
+                    }
+                    default: out += *p; break;
+                }
+                p++;
+            } else {
+                out += *p++;
+            }
+        }
+        if (p == end) return fail(DeserializationError::IncompleteInput);
+        p++;  // Closing quote
+        return true;
+    }
+
+    bool value(JsonValue& out, int depth) {
+        if (depth > 10) return fail(DeserializationError::InvalidInput);
+        skip();
+        if (p == end) return fail(DeserializationError::IncompleteInput);
+
+        if (*p == '{') {
+            out.type = JsonValue::OBJECT;
+            p++;
+            skip();
+            if (p < end && *p == '}') { p++; return true; }
+            while (true) {
+                skip();
+                if (p == end) return fail(DeserializationError::IncompleteInput);
+                if (*p != '"') return fail(DeserializationError::InvalidInput);
+                std::string key;
+                if (!string(key)) return false;
+                skip();
+                if (p == end) return fail(DeserializationError::IncompleteInput);
+                if (*p++ != ':') return fail(DeserializationError::InvalidInput);
+                if (!value(out.memberOrAdd(key), depth + 1)) return false;
+                skip();
+                if (p == end) return fail(DeserializationError::IncompleteInput);
+                if (*p == '}') { p++; return true; }
+                if (*p++ != ',') return fail(DeserializationError::InvalidInput);
+            }
+        }
+        if (*p == '[') {
+            out.type = JsonValue::ARRAY;
+            p++;
+            skip();
+            if (p < end && *p == ']') { p++; return true; }
+            while (true) {
+                out.items.emplace_back();
+                if (!value(out.items.back(), depth + 1)) return false;
+                skip();
+                if (p == end) return fail(DeserializationError::IncompleteInput);
+                if (*p == ']') { p++; return true; }
+                if (*p++ != ',') return fail(DeserializationError::InvalidInput);
+            }
+        }
+        if (*p == '"') {
+            out.type = JsonValue::STRING;
+            return string(out.s);
+        }
+        if (*p == 't') { out.type = JsonValue::BOOL; out.b = true; return literal("true"); }
+        if (*p == 'f') { out.type = JsonValue::BOOL; out.b = false; return literal("false"); }
+        if (*p == 'n') { out.type = JsonValue::NUL; return literal("null"); }
+
+        const char* start = p;
+        bool isFloat = false;
+        while (p < end && (isdigit((uint8_t)*p) || *p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E')) {
+            if (*p == '.' || *p == 'e' || *p == 'E') isFloat = true;
+            p++;
+        }
+        if (p == start) return fail(DeserializationError::InvalidInput);
+        std::string number(start, p);
+        if (isFloat) {
+            out.type = JsonValue::FLOAT;
+            out.f = strtod(number.c_str(), nullptr);
+        } else {
+            out.type = JsonValue::INT;
+            out.i = strtoll(number.c_str(), nullptr, 10);
+        }
+        return true;
+    }
+};
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const char* input, size_t length) {
+    doc.clear();
+    return HostJsonParser(input, input + length).parse(doc.value());
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const char* input) {
+    return deserializeJson(doc, input, strlen(input));
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const String& input) {
+    return deserializeJson(doc, input.c_str(), input.length());
+}
+
+// ============================================
+// Output
+// ============================================
+
+inline size_t serializeJson(const JsonDocument& doc, String& out) {
+    std::string text;
+    doc.value().serialize(text);
+    out = String(text);
+    return text.size();
+}
+
+inline size_t serializeJson(const JsonDocument& doc, char* out, size_t size) {
+    std::string text;
+    doc.value().serialize(text);
+    if (size == 0) return 0;
+    size_t n = std::min(text.size(), size - 1);
+    memcpy(out, text.data(), n);
+    out[n] = '\0';
+    return n;
+}
+
+inline size_t measureJson(const JsonDocument& doc) {
+    std::string text;
+    doc.value().serialize(text);
+    return text.size();
+}
+
+#endif // HOST_ARDUINO_JSON_H
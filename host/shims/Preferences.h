@@ -0,0 +1,146 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+/**
+ * ============================================
+ * Preferences.h for host builds
+ * ============================================
+ *
+ * NVS as an in-memory map shared by every Preferences object, so data
+ * survives end()/begin() like on the cube. hostNvsErase() is a factory
+ * reset; hostNvs() lets a test look at what was stored, and
+ * hostNvsWriteHook() sees every write (e.g. to charge its flash time).
+ *
+ * The map allocates with malloc, not operator new: it stands in for
+ * flash, so soak_host's HeapTracker must not count it as heap.
+ */
+
+#include <Arduino.h>
+
+template <typename T>
+struct HostFlashAllocator {
+    typedef T value_type;
+    HostFlashAllocator() = default;
+    template <typename U> HostFlashAllocator(const HostFlashAllocator<U>&) {}
+    T* allocate(size_t n) {
+        T* p = (T*)malloc(n * sizeof(T));
+        if (!p) abort();
+        return p;
+    }
+    void deallocate(T* p, size_t) { free(p); }
+    template <typename U> bool operator==(const HostFlashAllocator<U>&) const { return true; }
+    template <typename U> bool operator!=(const HostFlashAllocator<U>&) const { return false; }
+};
+
+typedef std::basic_string<char, std::char_traits<char>, HostFlashAllocator<char>> HostNvsKey;
+typedef std::vector<uint8_t, HostFlashAllocator<uint8_t>> HostNvsValue;
+typedef std::map<HostNvsKey, HostNvsValue, std::less<HostNvsKey>,
+                 HostFlashAllocator<std::pair<const HostNvsKey, HostNvsValue>>> HostNvsSpace;
+typedef std::map<HostNvsKey, HostNvsSpace, std::less<HostNvsKey>,
+                 HostFlashAllocator<std::pair<const HostNvsKey, HostNvsSpace>>> HostNvs;
+
+inline HostNvs& hostNvs() {
+    static HostNvs nvs;
+    return nvs;
+}
+
+inline void hostNvsErase() { hostNvs().clear(); }
+
+typedef std::function<void(const char* ns, const char* key, size_t len)> HostNvsWriteHook;
+
+inline HostNvsWriteHook& hostNvsWriteHook() {
+    static HostNvsWriteHook hook;
+    return hook;
+}
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = NULL) {
+        (void)partitionLabel;
+        ns = name;
+        this->readOnly = readOnly;
+        open = true;
+        return true;
+    }
+
+    void end() { open = false; }
+
+    bool clear() {
+        if (!writable()) return false;
+        hostNvs()[ns.c_str()].clear();
+        return true;
+    }
+
+    bool remove(const char* key) {
+        return writable() && hostNvs()[ns.c_str()].erase(key) > 0;
+    }
+
+    bool isKey(const char* key) { return find(key) != nullptr; }
+
+    size_t putBool(const char* key, bool value) { return putUChar(key, value ? 1 : 0); }
+    size_t putUChar(const char* key, uint8_t value) { return put(key, &value, sizeof(value)); }
+    size_t putUShort(const char* key, uint16_t value) { return put(key, &value, sizeof(value)); }
+    size_t putUInt(const char* key, uint32_t value) { return put(key, &value, sizeof(value)); }
+    size_t putULong(const char* key, uint32_t value) { return putUInt(key, value); }
+    size_t putString(const char* key, const char* value) { return put(key, value, strlen(value) + 1); }
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+    size_t putBytes(const char* key, const void* value, size_t len) { return put(key, value, len); }
+
+    bool getBool(const char* key, bool defaultValue = false) { return getUChar(key, defaultValue) != 0; }
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return get(key, defaultValue); }
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0) { return get(key, defaultValue); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return get(key, defaultValue); }
+    uint32_t getULong(const char* key, uint32_t defaultValue = 0) { return getUInt(key, defaultValue); }
+
+    String getString(const char* key, const String& defaultValue = String()) {
+        const HostNvsValue* v = find(key);
+        if (!v || v->empty()) return defaultValue;
+        return String((const char*)v->data());
+    }
+
+    size_t getBytesLength(const char* key) {
+        const HostNvsValue* v = find(key);
+        return v ? v->size() : 0;
+    }
+
+    size_t getBytes(const char* key, void* buf, size_t maxLen) {
+        const HostNvsValue* v = find(key);
+        if (!v || v->size() > maxLen) return 0;
+        memcpy(buf, v->data(), v->size());
+        return v->size();
+    }
+
+private:
+    std::string ns;
+    bool readOnly = true;
+    bool open = false;
+
+    bool writable() const { return open && !readOnly; }
+
+    const HostNvsValue* find(const char* key) {
+        if (!open) return nullptr;
+        auto space = hostNvs().find(ns.c_str());
+        if (space == hostNvs().end()) return nullptr;
+        auto item = space->second.find(key);
+        return item == space->second.end() ? nullptr : &item->second;
+    }
+
+    size_t put(const char* key, const void* value, size_t len) {
+        if (!writable()) return 0;
+        const uint8_t* p = (const uint8_t*)value;
+        hostNvs()[ns.c_str()][key].assign(p, p + len);
+        if (hostNvsWriteHook()) hostNvsWriteHook()(ns.c_str(), key, len);
+        return len;
+    }
+
+    template <typename T>
+    T get(const char* key, T defaultValue) {
+        const HostNvsValue* v = find(key);
+        if (!v || v->size() != sizeof(T)) return defaultValue;
+        T value;
+        memcpy(&value, v->data(), sizeof(T));
+        return value;
+    }
+};
+
+#endif // HOST_PREFERENCES_H
@@ -0,0 +1,384 @@
+#ifndef HOST_U8G2LIB_H
+#define HOST_U8G2LIB_H
+
+/**
+ * ============================================
+ * U8g2lib.h for host builds
+ * ============================================
+ *
+ * A 128x128 full-buffer U8G2 with the calls DisplayRenderer and
+ * GrayFramebuffer make: the same tile buffer layout (16 tile rows x 128
+ * bytes, LSB on top), R0/R2, draw colors 0/1/2, and line, circle, disc
+ * and ellipse in U8g2's own integer algorithms. Triangles are a plain
+ * scanline fill.
+ *
+ * Fonts are stand-ins: every font draws the same 5x7 glyphs, scaled,
+ * with a fixed advance close to the real font's. Text lands where the
+ * renderer puts it but is not the panel's typeface, so host goldens
+ * pin the renderer's layout, not U8g2's glyphs.
+ *
+ * The bus is a byte counter: sendBuffer() and the cad calls reach
+ * u8x8->byte_cb with U8X8_MSG_BYTE_SEND like on the ESP32, so wrapping
+ * the callback counts SPI bytes. sendBuffer() sends what the SSD1327
+ * driver sends - each tile row as a column/row window and 4bpp data.
+ */
+
+#include <Arduino.h>
+
+// ============================================
+// u8x8 layer
+// ============================================
+
+#define U8X8_MSG_BYTE_SEND 23
+#define U8X8_MSG_BYTE_START_TRANSFER 24
+#define U8X8_MSG_BYTE_END_TRANSFER 25
+
+struct u8x8_struct;
+typedef struct u8x8_struct u8x8_t;
+typedef uint8_t (*u8x8_msg_cb)(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void* arg_ptr);
+
+struct u8x8_struct {
+    u8x8_msg_cb byte_cb;
+    uint8_t x_offset;
+    uint32_t bytesSent;  // Host only: everything that reached the bus
+};
+
+inline uint8_t hostBusByteCb(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void*) {
+    if (msg == U8X8_MSG_BYTE_SEND) u8x8->bytesSent += arg_int;
+    return 1;
+}
+
+inline void u8x8_cad_StartTransfer(u8x8_t* u8x8) { u8x8->byte_cb(u8x8, U8X8_MSG_BYTE_START_TRANSFER, 0, nullptr); }
+inline void u8x8_cad_EndTransfer(u8x8_t* u8x8) { u8x8->byte_cb(u8x8, U8X8_MSG_BYTE_END_TRANSFER, 0, nullptr); }
+inline void u8x8_cad_SendCmd(u8x8_t* u8x8, uint8_t cmd) { u8x8->byte_cb(u8x8, U8X8_MSG_BYTE_SEND, 1, &cmd); }
+inline void u8x8_cad_SendArg(u8x8_t* u8x8, uint8_t arg) { u8x8->byte_cb(u8x8, U8X8_MSG_BYTE_SEND, 1, &arg); }
+inline void u8x8_cad_SendData(u8x8_t* u8x8, uint8_t cnt, uint8_t* data) { u8x8->byte_cb(u8x8, U8X8_MSG_BYTE_SEND, cnt, data); }
+
+// ============================================
+// u8g2 layer
+// ============================================
+
+struct u8g2_cb_t {
+    bool flip;  // 180 degrees
+};
+
+inline const u8g2_cb_t u8g2_cb_r0 = { false };
+inline const u8g2_cb_t u8g2_cb_r2 = { true };
+#define U8G2_R0 (&u8g2_cb_r0)
+#define U8G2_R2 (&u8g2_cb_r2)
+
+#define U8G2_DRAW_UPPER_RIGHT 0x01
+#define U8G2_DRAW_UPPER_LEFT  0x02
+#define U8G2_DRAW_LOWER_LEFT  0x04
+#define U8G2_DRAW_LOWER_RIGHT 0x08
+#define U8G2_DRAW_ALL 0x0F
+
+struct u8g2_t {
+    u8x8_t u8x8;
+    const u8g2_cb_t* cb;
+    uint8_t* tile_buf_ptr;
+};
+
+// Stand-in fonts: { advance, scale }
+inline const uint8_t u8g2_font_5x7_tr[] = { 5, 1 };
+inline const uint8_t u8g2_font_5x8_tr[] = { 5, 1 };
+inline const uint8_t u8g2_font_6x12_tr[] = { 6, 1 };
+inline const uint8_t u8g2_font_ncenB12_tr[] = { 11, 2 };
+inline const uint8_t u8g2_font_ncenB14_tr[] = { 12, 2 };
+inline const uint8_t u8g2_font_logisoso22_tn[] = { 16, 3 };
+
+// Classic 5x7 glyphs, ' '..'~', one byte per column, LSB on top
+inline const uint8_t HOST_GLYPHS[95][5] = {
+    {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14},
+    {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x56,0x20,0x50}, {0x00,0x05,0x03,0x00,0x00},
+    {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x2A,0x1C,0x7F,0x1C,0x2A}, {0x08,0x08,0x3E,0x08,0x08},
+    {0x00,0x50,0x30,0x00,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x60,0x60,0x00,0x00}, {0x20,0x10,0x08,0x04,0x02},
+    {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x42,0x61,0x51,0x49,0x46}, {0x21,0x41,0x45,0x4B,0x31},
+    {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x30}, {0x01,0x71,0x09,0x05,0x03},
+    {0x36,0x49,0x49,0x49,0x36}, {0x06,0x49,0x49,0x29,0x1E}, {0x00,0x36,0x36,0x00,0x00}, {0x00,0x56,0x36,0x00,0x00},
+    {0x08,0x14,0x22,0x41,0x00}, {0x14,0x14,0x14,0x14,0x14}, {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x51,0x09,0x06},
+    {0x32,0x49,0x79,0x41,0x3E}, {0x7E,0x11,0x11,0x11,0x7E}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+    {0x7F,0x41,0x41,0x22,0x1C}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01}, {0x3E,0x41,0x49,0x49,0x7A},
+    {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41},
+    {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x0C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+    {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x46,0x49,0x49,0x49,0x31},
+    {0x01,0x01,0x7F,0x01,0x01}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F},
+    {0x63,0x14,0x08,0x14,0x63}, {0x07,0x08,0x70,0x08,0x07}, {0x61,0x51,0x49,0x45,0x43}, {0x00,0x7F,0x41,0x41,0x00},
+    {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x7F,0x00}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40},
+    {0x00,0x01,0x02,0x04,0x00}, {0x20,0x54,0x54,0x54,0x78}, {0x7F,0x48,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x20},
+    {0x38,0x44,0x44,0x48,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x08,0x7E,0x09,0x01,0x02}, {0x0C,0x52,0x52,0x52,0x3E},
+    {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x44,0x3D,0x00}, {0x7F,0x10,0x28,0x44,0x00},
+    {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x18,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38},
+    {0x7C,0x14,0x14,0x14,0x08}, {0x08,0x14,0x14,0x18,0x7C}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x20},
+    {0x04,0x3F,0x44,0x40,0x20}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C},
+    {0x44,0x28,0x10,0x28,0x44}, {0x0C,0x50,0x50,0x50,0x3C}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00},
+    {0x00,0x00,0x7F,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x10,0x08,0x08,0x10,0x08},
+};
+
+class U8G2 {
+public:
+    static const uint8_t WIDTH = 128;
+    static const uint8_t HEIGHT = 128;
+
+    U8G2(const u8g2_cb_t* rotation) {
+        u.u8x8.byte_cb = hostBusByteCb;
+        u.u8x8.x_offset = 0;
+        u.u8x8.bytesSent = 0;
+        u.cb = rotation;
+        u.tile_buf_ptr = tiles;
+        memset(tiles, 0, sizeof(tiles));
+    }
+
+    bool begin() { return true; }
+    void setPowerSave(uint8_t) {}
+    void setContrast(uint8_t) {}
+
+    u8g2_t* getU8g2() { return &u; }
+    u8x8_t* getU8x8() { return &u.u8x8; }
+    uint8_t* getBufferPtr() { return u.tile_buf_ptr; }
+    void setDisplayRotation(const u8g2_cb_t* rotation) { u.cb = rotation; }
+
+    void clearBuffer() { memset(u.tile_buf_ptr, 0, WIDTH * HEIGHT / 8); }
+
+    // SSD1327 driver path: per tile row a window, then 8 lines of 4bpp
+    void sendBuffer() {
+        u8x8_t* u8x8 = &u.u8x8;
+        uint8_t line[WIDTH / 2];
+        u8x8_cad_StartTransfer(u8x8);
+        for (uint8_t tileRow = 0; tileRow < HEIGHT / 8; tileRow++) {
+            u8x8_cad_SendCmd(u8x8, 0x15);
+            u8x8_cad_SendArg(u8x8, u8x8->x_offset);
+            u8x8_cad_SendArg(u8x8, u8x8->x_offset + WIDTH / 2 - 1);
+            u8x8_cad_SendCmd(u8x8, 0x75);
+            u8x8_cad_SendArg(u8x8, tileRow * 8);
+            u8x8_cad_SendArg(u8x8, tileRow * 8 + 7);
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                const uint8_t* t = u.tile_buf_ptr + tileRow * WIDTH;
+                for (uint8_t x = 0; x < WIDTH; x += 2) {
+                    uint8_t left = (t[x] >> bit) & 1 ? 0xF0 : 0;
+                    uint8_t right = (t[x + 1] >> bit) & 1 ? 0x0F : 0;
+                    line[x / 2] = left | right;
+                }
+                u8x8_cad_SendData(u8x8, sizeof(line), line);
+            }
+        }
+        u8x8_cad_EndTransfer(u8x8);
+    }
+
+    void setDrawColor(uint8_t color) { drawColor = color; }
+    void setFont(const uint8_t* f) { font = f; }
+
+    // ============================================
+    // Primitives (logical coordinates, clipped)
+    // ============================================
+
+    void drawPixel(int16_t x, int16_t y) {
+        if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) return;
+        if (u.cb->flip) {
+            x = WIDTH - 1 - x;
+            y = HEIGHT - 1 - y;
+        }
+        uint8_t* b = u.tile_buf_ptr + (y >> 3) * WIDTH + x;
+        uint8_t mask = 1 << (y & 7);
+        if (drawColor == 0) *b &= ~mask;
+        else if (drawColor == 1) *b |= mask;
+        else *b ^= mask;
+    }
+
+    void drawHLine(int16_t x, int16_t y, int16_t w) { for (int16_t i = 0; i < w; i++) drawPixel(x + i, y); }
+    void drawVLine(int16_t x, int16_t y, int16_t h) { for (int16_t i = 0; i < h; i++) drawPixel(x, y + i); }
+
+    void drawBox(int16_t x, int16_t y, int16_t w, int16_t h) {
+        for (int16_t i = 0; i < h; i++) drawHLine(x, y + i, w);
+    }
+
+    void drawFrame(int16_t x, int16_t y, int16_t w, int16_t h) {
+        if (w == 0 || h == 0) return;
+        drawHLine(x, y, w);
+        if (h >= 2) {
+            drawHLine(x, y + h - 1, w);
+            drawVLine(x, y + 1, h - 2);
+            drawVLine(x + w - 1, y + 1, h - 2);
+        }
+    }
+
+    // u8g2_DrawLine: Bresenham, steep lines swapped
+    void drawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
+        int16_t dx = abs(x2 - x1), dy = abs(y2 - y1);
+        bool swapxy = dy > dx;
+        if (swapxy) {
+            std::swap(dx, dy);
+            std::swap(x1, y1);
+            std::swap(x2, y2);
+        }
+        if (x1 > x2) {
+            std::swap(x1, x2);
+            std::swap(y1, y2);
+        }
+        int16_t err = dx >> 1;
+        int16_t ystep = y2 > y1 ? 1 : -1;
+        int16_t y = y1;
+        for (int16_t x = x1; x <= x2; x++) {
+            if (swapxy) drawPixel(y, x);
+            else drawPixel(x, y);
+            err -= dy;
+            if (err < 0) {
+                y += ystep;
+                err += dx;
+            }
+        }
+    }
+
+    void drawCircle(int16_t x0, int16_t y0, int16_t rad, uint8_t option = U8G2_DRAW_ALL) {
+        circle(x0, y0, rad, option, false);
+    }
+
+    void drawDisc(int16_t x0, int16_t y0, int16_t rad, uint8_t option = U8G2_DRAW_ALL) {
+        circle(x0, y0, rad, option, true);
+    }
+
+    // u8g2_DrawEllipse: two midpoint passes, 4-way symmetric
+    void drawEllipse(int16_t x0, int16_t y0, int16_t rx, int16_t ry, uint8_t option = U8G2_DRAW_ALL) {
+        int32_t rxrx2 = 2L * rx * rx;
+        int32_t ryry2 = 2L * ry * ry;
+
+        int16_t x = rx, y = 0;
+        int32_t xchg = (1L - 2 * rx) * ry * ry;
+        int32_t ychg = (int32_t)rx * rx;
+        int32_t err = 0;
+        int32_t stopx = ryry2 * rx, stopy = 0;
+        while (stopx >= stopy) {
+            ellipseSection(x, y, x0, y0, option);
+            y++;
+            stopy += rxrx2;
+            err += ychg;
+            ychg += rxrx2;
+            if (2 * err + xchg > 0) {
+                x--;
+                stopx -= ryry2;
+                err += xchg;
+                xchg += ryry2;
+            }
+        }
+
+        x = 0;
+        y = ry;
+        xchg = (int32_t)ry * ry;
+        ychg = (1L - 2 * ry) * rx * rx;
+        err = 0;
+        stopx = 0;
+        stopy = rxrx2 * ry;
+        while (stopx <= stopy) {
+            ellipseSection(x, y, x0, y0, option);
+            x++;
+            stopx += ryry2;
+            err += xchg;
+            xchg += ryry2;
+            if (2 * err + ychg > 0) {
+                y--;
+                stopy -= rxrx2;
+                err += ychg;
+                ychg += rxrx2;
+            }
+        }
+    }
+
+    // Filled; each row spans the edges crossing its center line
+    void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
+        int16_t px[3] = { x0, x1, x2 }, py[3] = { y0, y1, y2 };
+        int16_t top = min(y0, min(y1, y2)), bottom = max(y0, max(y1, y2));
+        for (int16_t y = top; y <= bottom; y++) {
+            int16_t left = INT16_MAX, right = INT16_MIN;
+            for (uint8_t e = 0; e < 3; e++) {
+                int16_t ax = px[e], ay = py[e], bx = px[(e + 1) % 3], by = py[(e + 1) % 3];
+                if (y < min(ay, by) || y > max(ay, by)) continue;
+                if (ay == by) {
+                    left = min(left, min(ax, bx));
+                    right = max(right, max(ax, bx));
+                    continue;
+                }
+                int16_t x = ax + (int32_t)(bx - ax) * (y - ay) / (by - ay);
+                left = min(left, x);
+                right = max(right, x);
+            }
+            if (left <= right) drawHLine(left, y, right - left + 1);
+        }
+    }
+
+    // ============================================
+    // Text (stand-in glyphs, see top)
+    // ============================================
+
+    int16_t getStrWidth(const char* s) const { return (int16_t)(strlen(s) * font[0]); }
+
+    // (x, y) = left end of the baseline, like U8g2
+    int16_t drawStr(int16_t x, int16_t y, const char* s) {
+        uint8_t scale = font[1];
+        int16_t top = y - 7 * scale + 1;
+        for (const char* c = s; *c; c++, x += font[0]) {
+            if (*c < ' ' || *c > '~') continue;
+            const uint8_t* glyph = HOST_GLYPHS[*c - ' '];
+            for (uint8_t col = 0; col < 5; col++) {
+                for (uint8_t row = 0; row < 7; row++) {
+                    if (glyph[col] & (1 << row)) drawBox(x + col * scale, top + row * scale, scale, scale);
+                }
+            }
+        }
+        return getStrWidth(s);
+    }
+
+private:
+    u8g2_t u;
+    uint8_t tiles[WIDTH * HEIGHT / 8];
+    uint8_t drawColor = 1;
+    const uint8_t* font = u8g2_font_6x12_tr;
+
+    // u8g2_draw_circle / u8g2_draw_disc: midpoint circle, 8-way symmetric
+    void circle(int16_t x0, int16_t y0, int16_t rad, uint8_t option, bool fill) {
+        int16_t f = 1 - rad;
+        int16_t ddFx = 1, ddFy = -2 * rad;
+        int16_t x = 0, y = rad;
+        circleSection(x, y, x0, y0, option, fill);
+        while (x < y) {
+            if (f >= 0) {
+                y--;
+                ddFy += 2;
+                f += ddFy;
+            }
+            x++;
+            ddFx += 2;
+            f += ddFx;
+            circleSection(x, y, x0, y0, option, fill);
+        }
+    }
+
+    void circleSection(int16_t x, int16_t y, int16_t x0, int16_t y0, uint8_t option, bool fill) {
+        if (fill) {
+            if (option & U8G2_DRAW_UPPER_RIGHT) { drawVLine(x0 + x, y0 - y, y + 1); drawVLine(x0 + y, y0 - x, x + 1); }
+            if (option & U8G2_DRAW_UPPER_LEFT)  { drawVLine(x0 - x, y0 - y, y + 1); drawVLine(x0 - y, y0 - x, x + 1); }
+            if (option & U8G2_DRAW_LOWER_RIGHT) { drawVLine(x0 + x, y0, y + 1); drawVLine(x0 + y, y0, x + 1); }
+            if (option & U8G2_DRAW_LOWER_LEFT)  { drawVLine(x0 - x, y0, y + 1); drawVLine(x0 - y, y0, x + 1); }
+            return;
+        }
+        if (option & U8G2_DRAW_UPPER_RIGHT) { drawPixel(x0 + x, y0 - y); drawPixel(x0 + y, y0 - x); }
+        if (option & U8G2_DRAW_UPPER_LEFT)  { drawPixel(x0 - x, y0 - y); drawPixel(x0 - y, y0 - x); }
+        if (option & U8G2_DRAW_LOWER_RIGHT) { drawPixel(x0 + x, y0 + y); drawPixel(x0 + y, y0 + x); }
+        if (option & U8G2_DRAW_LOWER_LEFT)  { drawPixel(x0 - x, y0 + y); drawPixel(x0 - y, y0 + x); }
+    }
+
+    void ellipseSection(int16_t x, int16_t y, int16_t x0, int16_t y0, uint8_t option) {
+        if (option & U8G2_DRAW_UPPER_RIGHT) drawPixel(x0 + x, y0 - y);
+        if (option & U8G2_DRAW_UPPER_LEFT)  drawPixel(x0 - x, y0 - y);
+        if (option & U8G2_DRAW_LOWER_RIGHT) drawPixel(x0 + x, y0 + y);
+        if (option & U8G2_DRAW_LOWER_LEFT)  drawPixel(x0 - x, y0 + y);
+    }
+};
+
+// The panel the sketch uses
+class U8G2_SSD1327_WS_128X128_F_4W_HW_SPI : public U8G2 {
+public:
+    U8G2_SSD1327_WS_128X128_F_4W_HW_SPI(const u8g2_cb_t* rotation, uint8_t cs, uint8_t dc, uint8_t reset)
+        : U8G2(rotation) {}
+};
+
+#endif // HOST_U8G2LIB_H
@@ -0,0 +1,45 @@
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+/**
+ * ============================================
+ * esp_heap_caps.h for host builds
+ * ============================================
+ *
+ * HeapTracker::snapshot() from glibc's malloc statistics:
+ * - free bytes:    free space inside the arena (fordblks)
+ * - largest block: the top chunk (keepcost), a lower bound of the
+ *                  largest free block - free space that is not at the
+ *                  top of the arena is what fragmentation means here
+ * - minimum free:  lowest free bytes seen by any of these calls
+ *
+ * Not the ESP-IDF heap: compare trends, not absolute numbers.
+ */
+
+#include <malloc.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+
+inline size_t hostMinFreeBytes(size_t free) {
+    static size_t minFree = SIZE_MAX;
+    if (free < minFree) minFree = free;
+    return minFree;
+}
+
+inline size_t heap_caps_get_free_size(uint32_t) {
+    size_t free = mallinfo2().fordblks;
+    hostMinFreeBytes(free);
+    return free;
+}
+
+inline size_t heap_caps_get_largest_free_block(uint32_t) {
+    return mallinfo2().keepcost;
+}
+
+inline size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+    return hostMinFreeBytes(heap_caps_get_free_size(caps));
+}
+
+#endif // HOST_ESP_HEAP_CAPS_H
@@ -0,0 +1,125 @@
+/**
+ * ============================================
+ * soak_host - soak_test.py's days on the host, with HeapTracker
+ * ============================================
+ *
+ * Built with HEAP_TRACKER on: the firmware's tracking operator new
+ * counts every allocation the state code makes per call site. Reads
+ * scenario scripts on stdin; each day ends with a line
+ *
+ *   %% sample          run the day, then print one JSON line
+ *   %% sample reset    ... and zero the site counters (end of warm-up)
+ *
+ * The JSON line is the scenario result plus an /api/heap page holding
+ * every site, so soak_test.py --host-build reports it like a real cube's.
+ * The heap numbers come from glibc (see shims/esp_heap_caps.h); the
+ * site counts are what matter here. No web server, WebSockets or
+ * MQTT - only the state half HostCube.h wires up.
+ *
+ * Usage (built with -no-pie, so addr2line -e build/soak_host resolves
+ * the site addresses):
+ *   python3 soak_test.py --host-build host/build/soak_host --days 365
+ */
+
+#include "HostCube.h"
+#include "HeapTracker.h"
+#include "JsonWriter.h"
+
+static_assert(HEAP_TRACKER, "soak_host is built with -DHEAP_TRACKER=true (see Makefile)");
+
+HeapTracker heapTracker;
+
+static void printDay(bool passed) {
+    static char buffer[8192];
+    JsonWriter w(buffer, sizeof(buffer));
+    w.beginObject();
+    w.key("\"passed\":");
+    w.boolean(passed);
+    w.key("\"failures\":");
+    w.beginArray();
+    for (uint8_t f = 0; f < scenarioRunner.getFailureCount(); f++) {
+        const ScenarioFailure& failure = scenarioRunner.getFailure(f);
+        w.beginObject();
+        w.key("\"line\":");
+        w.u32(failure.line);
+        w.key("\"message\":");
+        w.str(failure.message);
+        w.endObject();
+    }
+    w.endArray();
+
+    // Same fields as WebServerHandler::handleApiHeap(), all sites on one page
+    HeapSnapshot heap = HeapTracker::snapshot();
+    w.key("\"heap\":");
+    w.beginObject();
+    w.key("\"freeBytes\":");
+    w.u32(heap.freeBytes);
+    w.key("\"largestBlock\":");
+    w.u32(heap.largestBlock);
+    w.key("\"minFreeBytes\":");
+    w.u32(heap.minFreeBytes);
+    w.key("\"fragPermille\":");
+    w.u32(heap.fragPermille);
+    w.key("\"tracking\":");
+    w.boolean(true);
+    w.key("\"liveBytes\":");
+    w.u32(heapTracker.getLiveBytes());
+    w.key("\"liveCount\":");
+    w.u32(heapTracker.getLiveCount());
+    w.key("\"totalAllocs\":");
+    w.u32(heapTracker.getTotalAllocs());
+    w.key("\"sites\":");
+    w.beginArray();
+    for (uint8_t index = 0; index < HeapTracker::MAX_SITES; index++) {
+        const HeapSite& site = heapTracker.site(index);
+        if (site.allocs == 0 && site.liveBytes == 0) continue;
+        w.beginArray();
+        w.u32(index);
+        w.u32(site.addr);
+        w.u32(site.allocs);
+        w.u32(site.frees);
+        w.u32(site.liveBytes);
+        w.u32(site.peakLiveBytes);
+        w.endArray();
+    }
+    w.endArray();
+    w.key("\"nextOffset\":");
+    w.u32(0);
+    w.endObject();
+    w.endObject();
+
+    if (!w.ok()) {
+        fprintf(stderr, "soak_host: day result does not fit in %zu bytes\n", sizeof(buffer));
+        exit(1);
+    }
+    printf("%s\n", w.c_str());
+    fflush(stdout);
+}
+
+int main() {
+    hostBegin();
+
+    // Static buffers: the harness itself must not show up as a site
+    static char script[256 * 1024];
+    static char line[1024];
+    size_t length = 0;
+    while (fgets(line, sizeof(line), stdin)) {
+        if (strncmp(line, "%% sample", 9) != 0) {
+            size_t n = strlen(line);
+            if (length + n >= sizeof(script)) {
+                fprintf(stderr, "soak_host: a day longer than %zu bytes\n", sizeof(script));
+                return 1;
+            }
+            memcpy(script + length, line, n + 1);
+            length += n;
+            continue;
+        }
+        script[length] = '\0';
+        bool passed = scenarioRunner.run(script);
+        hostSettle();
+        length = 0;
+        if (strncmp(line, "%% sample reset", 15) == 0) heapTracker.resetCounters();
+        printDay(passed);
+    }
+    return 0;
+}
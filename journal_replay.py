@@ -0,0 +1,399 @@
+#!/usr/bin/env python3
+"""Decode the cube's input journal and replay it on a test cube
+
+The firmware records every external input (flips, LDR threshold
+crossings, web actions, time syncs, boots with a state snapshot) into a
+flash ring - see InputJournal.h. This tool downloads it from
+/api/journal, prints it, turns it into a scenario script (see
+ScenarioRunner.h) and runs that on a test cube's virtual clock, so the
+state history of the reporting cube can be reproduced and inspected.
+
+Usage:
+    python3 journal_replay.py fetch 192.168.1.50 -o cube.jrnl
+    python3 journal_replay.py show cube.jrnl
+    python3 journal_replay.py script cube.jrnl -o replay.scn --boot 2
+    python3 journal_replay.py replay cube.jrnl 192.168.1.77
+
+Replay starts at a boot record (its snapshot restores plant, tasks and
+today's stats). Inputs are timed to the millisecond. Anything after a
+SCENARIO record is skipped until the next boot: a scenario run changed
+the state without going through the journal.
+
+The test cube runs a build with SCENARIO_RUNNER true in config.h (it
+serves /api/scenario); replay stops at once if it does not. Uses only
+the standard library. Replay resets the test cube's state.
+"""
+
+import argparse
+import datetime
+import json
+import struct
+import sys
+import urllib.error
+import urllib.request
+
+SECTOR_SIZE = 4096
+MAGIC = 0x4C4E524A
+
+BOOT, FLIP_DOWN, FLIP_UP, LIGHT, ACTION, TIME_SYNC, PLANT, TASK, STATS, SCENARIO = range(1, 11)
+
+ACTIONS = ["water", "kill", "pause", "resume", "addTask", "startTask", "deleteTask",
+           "toggleTask", "setGoal", "restartDay", "revive", "selectTask",
+           "confirmComplete", "cancelComplete"]
+TASK_ACTIONS = {"startTask", "deleteTask", "toggleTask", "selectTask"}
+
+RESET_REASONS = ["unknown", "power-on", "external", "software", "panic", "int-wdt",
+                 "task-wdt", "wdt", "deep-sleep", "brownout", "sdio"]
+
+LINES_PER_RUN = 200   # Keeps each POST body small for the cube
+
+
+# ============================================
+# Decoding
+# ============================================
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def byte(self):
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def varint(self):
+        value, shift = 0, 0
+        while True:
+            b = self.byte()
+            value |= (b & 0x7F) << shift
+            shift += 7
+            if b < 0x80:
+                return value
+
+    def rest(self):
+        value = self.data[self.pos:]
+        self.pos = len(self.data)
+        return value.decode(errors="replace")
+
+
+def decode_record(body):
+    """{'type', 'dt', ...fields} from the bytes after the length byte"""
+    r = Reader(body)
+    kind = r.byte()
+    rec = {"type": kind, "dt": r.varint()}
+    if kind == BOOT:
+        rec["reason"] = r.byte()
+        rec["wall"] = r.varint()
+    elif kind == LIGHT:
+        rec["value"] = r.varint()
+    elif kind == ACTION:
+        code = r.byte()
+        rec["action"] = ACTIONS[code] if code < len(ACTIONS) else f"#{code}"
+        if rec["action"] == "addTask":
+            rec["focus"] = r.varint()
+            rec["break"] = r.varint()
+            rec["name"] = r.rest()
+        elif rec["action"] in TASK_ACTIONS:
+            rec["index"] = r.byte()
+        elif rec["action"] == "setGoal":
+            rec["goal"] = r.byte()
+    elif kind == TIME_SYNC:
+        rec["phone"] = bool(r.byte())
+        rec["wall"] = r.varint()
+    elif kind == PLANT:
+        for key in ("stage", "withered", "pending", "watered", "goal", "session"):
+            rec[key] = r.byte()
+    elif kind == TASK:
+        rec["focus"] = r.varint()
+        rec["break"] = r.varint()
+        flags = r.byte()
+        rec["done"] = bool(flags & 1)
+        rec["started"] = bool(flags & 2)
+        rec["name"] = r.rest()
+    elif kind == STATS:
+        rec["tasks"] = r.byte()
+        rec["focus"] = r.varint()
+        rec["break"] = r.varint()
+        rec["sessions"] = r.byte()
+    return rec
+
+
+def decode(data):
+    """Records of all sectors, oldest first"""
+    sectors = []
+    for offset in range(0, len(data) - SECTOR_SIZE + 1, SECTOR_SIZE):
+        magic, seq = struct.unpack_from("<II", data, offset)
+        if magic == MAGIC:
+            sectors.append((seq, offset))
+
+    records = []
+    for _, offset in sorted(sectors):
+        pos, end = offset + 8, offset + SECTOR_SIZE
+        while pos < end and data[pos] != 0xFF:
+            length = data[pos]
+            if length == 0 or pos + 1 + length > end:
+                print(f"warning: damaged record at 0x{pos:x}", file=sys.stderr)
+                break
+            try:
+                records.append(decode_record(data[pos + 1:pos + 1 + length]))
+            except IndexError:
+                print(f"warning: truncated record at 0x{pos:x}", file=sys.stderr)
+            pos += 1 + length
+    return records
+
+
+def boots(records):
+    """Start indexes of each boot (a replay needs its snapshot)"""
+    return [i for i, rec in enumerate(records) if rec["type"] == BOOT]
+
+
+# ============================================
+# Listing
+# ============================================
+
+def wall_str(epoch):
+    return datetime.datetime.fromtimestamp(epoch, datetime.timezone.utc).strftime("%Y-%m-%d %H:%M:%S UTC")
+
+
+def describe(rec):
+    kind = rec["type"]
+    if kind == BOOT:
+        reason = RESET_REASONS[rec["reason"]] if rec["reason"] < len(RESET_REASONS) else rec["reason"]
+        return f"BOOT  reason={reason}" + (f"  clock={wall_str(rec['wall'])}" if rec["wall"] else "")
+    if kind in (FLIP_DOWN, FLIP_UP):
+        return "flip " + ("down" if kind == FLIP_DOWN else "up")
+    if kind == LIGHT:
+        return f"ldr {rec['value']}"
+    if kind == ACTION:
+        args = {k: v for k, v in rec.items() if k not in ("type", "dt", "action")}
+        return f"web {rec['action']} " + " ".join(f"{k}={v!r}" for k, v in args.items())
+    if kind == TIME_SYNC:
+        return f"time {'phone' if rec['phone'] else 'ntp'} {wall_str(rec['wall'])}"
+    if kind == PLANT:
+        return ("snapshot plant " + " ".join(f"{k}={rec[k]}" for k in
+                ("stage", "withered", "pending", "watered", "goal", "session")))
+    if kind == TASK:
+        flags = (" done" if rec["done"] else "") + (" started" if rec["started"] else "")
+        return f"snapshot task {rec['name']!r} {rec['focus']}/{rec['break']}{flags}"
+    if kind == STATS:
+        return (f"snapshot stats tasks={rec['tasks']} focus={rec['focus']} "
+                f"break={rec['break']} sessions={rec['sessions']}")
+    if kind == SCENARIO:
+        return "SCENARIO run (state no longer follows the journal)"
+    return f"unknown record type {kind}"
+
+
+def show(records):
+    boot = -1
+    ms = 0
+    for rec in records:
+        if rec["type"] == BOOT:
+            boot += 1
+            ms = 0
+        else:
+            ms += rec["dt"]
+        prefix = f"boot {boot:>3} +{ms / 1000:>10.3f}s" if boot >= 0 else f"{'(before first boot)':>26}"
+        print(f"{prefix}  {describe(rec)}")
+
+
+# ============================================
+# Scenario script
+# ============================================
+
+def quoted(name):
+    # The scenario tokenizer has no escapes and treats '#' as a comment
+    return '"' + name.replace('"', "'").replace("#", "No.") + '"'
+
+
+def to_script(records, first_boot=0):
+    """[(line, wall_epoch_or_None, ldr_or_None)] - the wall clock and light
+    level after each line, so a long replay can be split into several runs"""
+    starts = boots(records)
+    if first_boot >= len(starts):
+        raise SystemExit(f"journal has {len(starts)} boots")
+
+    lines = []
+    wall = None       # Wall clock (ms) at the current point, if known
+    ldr = None
+    pending = 0       # ms not yet waited
+    skipping = False
+
+    def emit(line):
+        lines.append((line, (wall - pending) // 1000 if wall is not None else None, ldr))
+
+    for rec in records[starts[first_boot]:]:
+        kind = rec["type"]
+        if kind == BOOT:
+            skipping = False
+            pending = 0
+            wall = rec["wall"] * 1000 if rec["wall"] else None
+            ldr = None
+            emit(f"# {describe(rec)}")
+            emit("reset")
+            if wall is not None:
+                emit(f"at @{wall // 1000}")
+            continue
+
+        if wall is not None:
+            wall += rec["dt"]
+        if skipping:
+            continue
+        pending += rec["dt"]
+
+        if kind == SCENARIO:
+            emit("# scenario run on the cube - skipped until the next boot")
+            skipping = True
+            continue
+
+        if pending and kind not in (PLANT, TASK, STATS):
+            emit(f"wait {pending}ms")
+            pending = 0
+
+        if kind in (FLIP_DOWN, FLIP_UP):
+            emit("flip down" if kind == FLIP_DOWN else "flip up")
+        elif kind == LIGHT:
+            ldr = rec["value"]
+            emit(f"ldr {ldr}")
+        elif kind == TIME_SYNC:
+            wall = rec["wall"] * 1000
+            emit(f"at @{rec['wall']}  # {'phone' if rec['phone'] else 'ntp'}")
+        elif kind == PLANT:
+            emit("plant " + " ".join(f"{k}={rec[k]}" for k in
+                 ("stage", "withered", "pending", "watered", "goal", "session")))
+        elif kind == TASK:
+            flags = (" done" if rec["done"] else "") + (" started" if rec["started"] else "")
+            emit(f"task {quoted(rec['name'])} {rec['focus']} {rec['break']}{flags}")
+        elif kind == STATS:
+            emit(f"stats tasks={rec['tasks']} focus={rec['focus']} "
+                 f"break={rec['break']} sessions={rec['sessions']}")
+        elif kind == ACTION:
+            action = rec["action"]
+            if action == "addTask":
+                emit(f"task {quoted(rec['name'])} {rec['focus']} {rec['break']}")
+            elif action in TASK_ACTIONS:
+                # An id the cube did not know replays as one the test cube does not know
+                ref = f"task=#{rec['index']}" if rec["index"] != 0xFF else "taskId=0"
+                emit(f"web {action} {ref}")
+            elif action == "setGoal":
+                emit(f"web setGoal goal={rec['goal']}")
+            elif not action.startswith("#"):
+                emit(f"web {action}")
+            else:
+                emit(f"# unknown action {action}")
+    return lines
+
+
+def runs(lines):
+    """Split into scripts of at most LINES_PER_RUN lines; each one re-sets
+    the wall clock and light level, which a run does not carry over"""
+    for start in range(0, len(lines), LINES_PER_RUN):
+        chunk = lines[start:start + LINES_PER_RUN]
+        head = []
+        if start:
+            _, wall, ldr = lines[start - 1]
+            if wall is not None:
+                head.append(f"at @{wall}")
+            if ldr is not None:
+                head.append(f"ldr {ldr}")
+        yield start, len(head), "\n".join(head + [line for line, _, _ in chunk]) + "\n"
+
+
+# ============================================
+# Cube I/O
+# ============================================
+
+def fetch(host, timeout=30):
+    with urllib.request.urlopen(f"http://{host}/api/journal", timeout=timeout) as response:
+        return response.read()
+
+
+def post_scenario(host, script, timeout):
+    request = urllib.request.Request(
+        f"http://{host}/api/scenario", data=script.encode(),
+        headers={"Content-Type": "text/plain"}, method="POST")
+    try:
+        with urllib.request.urlopen(request, timeout=timeout) as response:
+            return json.loads(response.read().decode())
+    except urllib.error.HTTPError as e:
+        if e.code == 404:
+            raise SystemExit(f"{host} has no /api/scenario: flash a build with "
+                             "SCENARIO_RUNNER true in config.h") from None
+        raise
+
+
+def replay(records, host, first_boot, timeout):
+    lines = to_script(records, first_boot)
+    failed = 0
+    for start, head, script in runs(lines):
+        result = post_scenario(host, script, timeout)
+        print(f"lines {start + 1}-{min(start + LINES_PER_RUN, len(lines))}: "
+              f"{result.get('simulatedS', 0)} s simulated in {result.get('elapsedMs', 0)} ms")
+        for failure in result.get("failures", []):
+            failed += 1
+            print(f"  script line {start + failure['line'] - head}: {failure['message']}")
+
+    with urllib.request.urlopen(f"http://{host}/api/status", timeout=timeout) as response:
+        status = json.loads(response.read().decode())
+    print("\nState after replay:")
+    print(json.dumps(status, indent=2))
+    return failed
+
+
+# ============================================
+# Main
+# ============================================
+
+def load(path):
+    with open(path, "rb") as f:
+        return decode(f.read())
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("fetch", help="Download the journal")
+    p.add_argument("host")
+    p.add_argument("-o", "--output", required=True)
+
+    p = sub.add_parser("show", help="Print the decoded journal")
+    p.add_argument("journal")
+
+    p = sub.add_parser("script", help="Write the journal as a scenario script")
+    p.add_argument("journal")
+    p.add_argument("-o", "--output", help="Default: stdout")
+    p.add_argument("--boot", type=int, default=0, help="First boot to replay from")
+
+    p = sub.add_parser("replay", help="Run the journal on a test cube")
+    p.add_argument("journal", help="Journal file, or host:<ip> to fetch it first")
+    p.add_argument("host", help="Test cube IP address")
+    p.add_argument("--boot", type=int, default=0, help="First boot to replay from")
+    p.add_argument("--timeout", type=float, default=120, help="Seconds per run")
+
+    args = parser.parse_args()
+
+    if args.command == "fetch":
+        data = fetch(args.host)
+        with open(args.output, "wb") as f:
+            f.write(data)
+        print(f"{len(data)} bytes, {len(decode(data))} records -> {args.output}")
+    elif args.command == "show":
+        show(load(args.journal))
+    elif args.command == "script":
+        text = "\n".join(line for line, _, _ in to_script(load(args.journal), args.boot)) + "\n"
+        if args.output:
+            with open(args.output, "w") as f:
+                f.write(text)
+        else:
+            sys.stdout.write(text)
+    elif args.command == "replay":
+        if args.journal.startswith("host:"):
+            records = decode(fetch(args.journal[5:]))
+        else:
+            records = load(args.journal)
+        sys.exit(1 if replay(records, args.host, args.boot, args.timeout) else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,509 @@
+#!/usr/bin/env python3
+"""Load test the cube's web stack: N WebSocket clients + M HTTP pollers
+
+Replays a mix of web actions against a real device and reports
+broadcast fan-out latency (p50/p99), dropped broadcasts and HTTP
+requests/s, together with the device's own loop timing from /api/perf.
+
+Usage:
+    python3 load_test.py 192.168.1.50 --ws 4 --http 2 --duration 30
+    python3 load_test.py 192.168.1.50 --sweep 1,2,4,6,8 --http 1
+    python3 load_test.py 192.168.1.50 --latency 20
+    python3 load_test.py 192.168.1.50 --ws 0 --http 3 --keepalive
+
+--keepalive makes the HTTP pollers reuse one connection each, like a
+browser does; compare httpP50Ms with and without it. The cube keeps at
+most HTTP_KEEPALIVE_SLOTS (3) connections open, so more pollers than
+that measure reconnect churn instead. With --ws 0 no actions are sent
+and only the HTTP side is measured.
+
+--latency N runs N traced flips and N traced web actions one at a time
+and prints the median time to each stage (see LatencyTrace.h). The
+synthetic flips come in pairs so the cube ends up the way it started;
+they need a build with LATENCY_RUN (config.h), otherwise only the web
+actions are traced. host/latency_host.cpp models the same stages
+without a cube (make -C host test).
+
+Uses only the standard library. Creates tasks named "lt-<n>" and
+deletes them again - run it against a test cube, not a real day.
+"""
+
+import argparse
+import base64
+import http.client
+import json
+import os
+import random
+import socket
+import struct
+import threading
+import time
+import urllib.error
+import urllib.request
+
+WS_PORT = 81
+
+
+# ============================================
+# Minimal WebSocket client (RFC 6455, text frames only)
+# ============================================
+
+class WebSocketClient:
+    def __init__(self, host, port=WS_PORT, timeout=5.0):
+        self.sock = socket.create_connection((host, port), timeout=timeout)
+        key = base64.b64encode(os.urandom(16)).decode()
+        request = (
+            f"GET / HTTP/1.1\r\nHost: {host}:{port}\r\n"
+            "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+            f"Sec-WebSocket-Key: {key}\r\nSec-WebSocket-Version: 13\r\n\r\n"
+        )
+        self.sock.sendall(request.encode())
+        response = b""
+        while b"\r\n\r\n" not in response:
+            chunk = self.sock.recv(1024)
+            if not chunk:
+                raise ConnectionError("handshake closed")
+            response += chunk
+        if b" 101 " not in response.split(b"\r\n", 1)[0]:
+            raise ConnectionError("handshake rejected")
+        self.buffer = response.split(b"\r\n\r\n", 1)[1]
+        self.sock.settimeout(None)  # Readers block; close() unblocks them
+        self.send_lock = threading.Lock()
+
+    def send_text(self, text):
+        payload = text.encode()
+        header = bytearray([0x81])
+        mask = os.urandom(4)
+        if len(payload) < 126:
+            header.append(0x80 | len(payload))
+        else:
+            header.append(0x80 | 126)
+            header += struct.pack(">H", len(payload))
+        masked = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+        with self.send_lock:
+            self.sock.sendall(bytes(header) + mask + masked)
+
+    def _read(self, n):
+        while len(self.buffer) < n:
+            chunk = self.sock.recv(4096)
+            if not chunk:
+                raise ConnectionError("closed")
+            self.buffer += chunk
+        data, self.buffer = self.buffer[:n], self.buffer[n:]
+        return data
+
+    def recv(self):
+        """Return (opcode, payload) of the next complete message"""
+        while True:
+            b0, b1 = self._read(2)
+            opcode = b0 & 0x0F
+            length = b1 & 0x7F
+            if length == 126:
+                length = struct.unpack(">H", self._read(2))[0]
+            elif length == 127:
+                length = struct.unpack(">Q", self._read(8))[0]
+            payload = self._read(length)
+            if opcode == 0x9:  # Ping -> pong
+                with self.send_lock:
+                    self.sock.sendall(bytes([0x8A, 0x80]) + os.urandom(4))
+                continue
+            if opcode == 0x8:
+                raise ConnectionError("server closed")
+            return opcode, payload
+
+    def close(self):
+        try:
+            self.sock.close()
+        except OSError:
+            pass
+
+
+# ============================================
+# Helpers
+# ============================================
+
+def percentile(values, p):
+    if not values:
+        return float("nan")
+    ordered = sorted(values)
+    k = min(len(ordered) - 1, int(round(p / 100.0 * (len(ordered) - 1))))
+    return ordered[k]
+
+
+def http_get_json(host, path, timeout=5.0):
+    with urllib.request.urlopen(f"http://{host}{path}", timeout=timeout) as response:
+        return json.loads(response.read().decode())
+
+
+def http_post_json(host, path, body, timeout=5.0):
+    request = urllib.request.Request(
+        f"http://{host}{path}", data=json.dumps(body).encode(),
+        headers={"Content-Type": "application/json"}, method="POST")
+    with urllib.request.urlopen(request, timeout=timeout) as response:
+        return json.loads(response.read().decode())
+
+
+# ============================================
+# Load run
+# ============================================
+
+class LoadRun:
+    def __init__(self, host, ws_clients, http_pollers, duration, rate, keepalive=False):
+        self.host = host
+        self.ws_count = ws_clients
+        self.http_count = http_pollers
+        self.keepalive = keepalive
+        self.duration = duration
+        self.rate = rate  # Actions per second
+
+        self.lock = threading.Lock()
+        self.pending = {}           # marker -> send time
+        self.seen = {}              # marker -> set of client indexes
+        self.latencies = []         # seconds, one per client per marker
+        self.ws_messages = 0
+        self.ws_errors = 0
+        self.http_latencies = []
+        self.http_errors = 0
+        self.stop = threading.Event()
+
+    def ws_reader(self, index, client):
+        while not self.stop.is_set():
+            try:
+                opcode, payload = client.recv()
+            except (OSError, ConnectionError):
+                if not self.stop.is_set():
+                    with self.lock:
+                        self.ws_errors += 1
+                return
+            now = time.monotonic()
+            with self.lock:
+                self.ws_messages += 1
+            if opcode != 0x1 or b'"tasks"' not in payload:
+                continue
+            text = payload.decode(errors="replace")
+            with self.lock:
+                for marker, sent in self.pending.items():
+                    if marker in text and index not in self.seen[marker]:
+                        self.seen[marker].add(index)
+                        self.latencies.append(now - sent)
+
+    def http_poller(self):
+        connection = None
+        while not self.stop.is_set():
+            start = time.monotonic()
+            try:
+                if self.keepalive:
+                    # Reconnects by itself when the cube closes the connection
+                    connection = connection or http.client.HTTPConnection(self.host, timeout=5.0)
+                    connection.request("GET", "/api/status")
+                    json.loads(connection.getresponse().read().decode())
+                else:
+                    http_get_json(self.host, "/api/status")
+                with self.lock:
+                    self.http_latencies.append(time.monotonic() - start)
+            except (OSError, http.client.HTTPException):
+                with self.lock:
+                    self.http_errors += 1
+                if connection:
+                    connection.close()
+                    connection = None
+                time.sleep(0.2)
+        if connection:
+            connection.close()
+
+    def drive(self, sender):
+        """Action mix: addTask (measured), getStatus, selectTask, deleteTask"""
+        seq = 0
+        created = []
+        interval = 1.0 / self.rate
+        while not self.stop.is_set():
+            choice = random.random()
+            if choice < 0.35 or not created:
+                seq += 1
+                marker = f"lt-{os.getpid()}-{seq}"
+                with self.lock:
+                    self.pending[marker] = time.monotonic()
+                    self.seen[marker] = set()
+                sender.send_text(json.dumps({
+                    "action": "addTask",
+                    "task": {"name": marker, "focusDuration": 25, "breakDuration": 5},
+                }))
+                created.append(marker)
+            elif choice < 0.55:
+                sender.send_text(json.dumps({"action": "getStatus"}))
+            elif choice < 0.75:
+                task_id = self.find_task_id(created[-1])
+                if task_id:
+                    sender.send_text(json.dumps({"action": "selectTask", "taskId": task_id}))
+            else:
+                self.delete_task(sender, created.pop(0))
+            # Keep well under MAX_TASKS
+            while len(created) > 4:
+                self.delete_task(sender, created.pop(0))
+            time.sleep(interval)
+        for marker in created:
+            self.delete_task(sender, marker)
+
+    def find_task_id(self, name):
+        try:
+            tasks = http_get_json(self.host, "/api/tasks").get("tasks", [])
+        except OSError:
+            return None
+        for task in tasks:
+            if task.get("name") == name:
+                return task.get("id")
+        return None
+
+    def delete_task(self, sender, name):
+        task_id = self.find_task_id(name)
+        if task_id:
+            sender.send_text(json.dumps({"action": "deleteTask", "taskId": task_id}))
+
+    def run(self):
+        perf_before = self.read_perf()
+        clients = []
+        for _ in range(self.ws_count):
+            try:
+                clients.append(WebSocketClient(self.host))
+            except (OSError, ConnectionError) as e:
+                print(f"  WebSocket connect failed: {e}")
+                self.ws_errors += 1
+        if self.ws_count and not clients:
+            raise SystemExit("No WebSocket client could connect")
+
+        threads = [threading.Thread(target=self.ws_reader, args=(i, c), daemon=True)
+                   for i, c in enumerate(clients)]
+        threads += [threading.Thread(target=self.http_poller, daemon=True)
+                    for _ in range(self.http_count)]
+        for t in threads:
+            t.start()
+
+        time.sleep(1.0)  # Let initial sync messages settle
+        driver = None
+        if clients:  # Actions go over the first WebSocket
+            driver = threading.Thread(target=self.drive, args=(clients[0],), daemon=True)
+            driver.start()
+        time.sleep(self.duration)
+        perf_during = self.read_perf()
+        self.stop.set()
+        if driver:
+            driver.join(timeout=10)
+        time.sleep(1.0)  # Late broadcasts still count
+        for c in clients:
+            c.close()
+
+        return self.report(len(clients), perf_before, perf_during)
+
+    def read_perf(self):
+        try:
+            return http_get_json(self.host, "/api/perf")
+        except (OSError, ValueError):
+            return {}
+
+    def report(self, connected, perf_before, perf_during):
+        expected = len(self.pending) * connected
+        received = len(self.latencies)
+        ms = [l * 1000 for l in self.latencies]
+        http_ms = [l * 1000 for l in self.http_latencies]
+        return {
+            "wsClients": connected,
+            "httpPollers": self.http_count,
+            "broadcasts": len(self.pending),
+            "fanoutP50Ms": percentile(ms, 50),
+            "fanoutP99Ms": percentile(ms, 99),
+            "dropped": expected - received,
+            "wsMessages": self.ws_messages,
+            "wsErrors": self.ws_errors,
+            "httpReqPerSec": len(self.http_latencies) / self.duration,
+            "httpP50Ms": percentile(http_ms, 50),
+            "httpP99Ms": percentile(http_ms, 99),
+            "httpErrors": self.http_errors,
+            "httpReused": (perf_during.get("httpReused", 0) - perf_before.get("httpReused", 0)
+                           if "httpReused" in perf_during else None),
+            "idleLoopsPerSec": perf_before.get("loopsPerSec"),
+            "loopsPerSec": perf_during.get("loopsPerSec"),
+            "maxWebUs": perf_during.get("maxWebUs"),
+            "maxSensorGapMs": perf_during.get("maxSensorGapMs"),
+            "minFreeHeap": perf_during.get("minFreeHeap"),
+        }
+
+
+# ============================================
+# Latency run (stage breakdown, one trace at a time)
+# ============================================
+
+STAGES = ["detected", "applied", "persisted", "frame", "broadcast", "client"]
+
+
+class LatencyRun:
+    def __init__(self, host, count):
+        self.host = host
+        self.count = count
+        self.stop = threading.Event()
+
+    def ack_reader(self, client):
+        """Acknowledge traced status messages, like the web UI does after painting"""
+        acked = set()
+        while not self.stop.is_set():
+            try:
+                opcode, payload = client.recv()
+            except (OSError, ConnectionError):
+                return
+            if opcode != 0x1 or b'"trace"' not in payload:
+                continue
+            try:
+                message = json.loads(payload.decode())
+            except ValueError:
+                continue
+            trace = message.get("trace")
+            if message.get("type") == "status" and trace and trace not in acked:
+                acked.add(trace)
+                client.send_text(json.dumps({"action": "traceAck", "trace": trace}))
+
+    def wait_result(self, kind, previous_id, timeout=5.0):
+        """Poll /api/latency until a new finished trace of this kind shows up"""
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            latency = http_get_json(self.host, "/api/latency")
+            result = latency.get(kind, {})
+            if not latency.get("active") and result.get("id") != previous_id:
+                return result
+            time.sleep(0.1)
+        return None
+
+    def last_id(self, kind):
+        return http_get_json(self.host, "/api/latency").get(kind, {}).get("id")
+
+    def run_flips(self):
+        results = []
+        for _ in range(self.count):
+            previous = self.last_id("flip")
+            try:
+                http_post_json(self.host, "/api/latency", {"kind": "flip"})
+            except urllib.error.HTTPError as e:
+                if e.code != 404:
+                    raise
+                print("  POST /api/latency not in this build (LATENCY_RUN) - skipping synthetic flips")
+                return results
+            result = self.wait_result("flip", previous)
+            if result:
+                results.append(result)
+            time.sleep(0.5)
+        if self.count % 2:
+            http_post_json(self.host, "/api/latency", {"kind": "flip"})  # Put it back
+        return results
+
+    def run_web(self, client):
+        results = []
+        for seq in range(1, self.count + 1):
+            marker = f"lt-lat-{os.getpid()}-{seq}"
+            previous = self.last_id("web")
+            client.send_text(json.dumps({
+                "action": "addTask", "trace": 1,
+                "task": {"name": marker, "focusDuration": 25, "breakDuration": 5},
+            }))
+            result = self.wait_result("web", previous)
+            if result:
+                results.append(result)
+            for task in http_get_json(self.host, "/api/tasks").get("tasks", []):
+                if task.get("name") == marker:
+                    client.send_text(json.dumps({"action": "deleteTask", "taskId": task["id"]}))
+            time.sleep(0.5)
+        return results
+
+    def run(self):
+        client = WebSocketClient(self.host)
+        reader = threading.Thread(target=self.ack_reader, args=(client,), daemon=True)
+        reader.start()
+        time.sleep(1.0)  # Let initial sync messages settle
+
+        rows = {}
+        status = http_get_json(self.host, "/api/status")
+        if status.get("state", "idle") == "idle":
+            rows["flip"] = self.run_flips()
+        else:
+            print("  Cube is not idle - skipping synthetic flips")
+        rows["web"] = self.run_web(client)
+
+        self.stop.set()
+        client.close()
+        return rows
+
+
+def print_latency(rows):
+    print(f"{'kind':>6}  {'n':>3}  " + "  ".join(f"{s:>9}" for s in STAGES) + f"  {'total':>9}")
+    for kind, results in rows.items():
+        cells = []
+        for stage in STAGES:
+            values = [r["stagesUs"][stage] for r in results if r["stagesUs"].get(stage, -1) >= 0]
+            cells.append(format_value(percentile(values, 50) / 1000.0) if values else "-")
+        total = percentile([r["totalUs"] for r in results], 50) / 1000.0
+        print(f"{kind:>6}  {len(results):>3}  " + "  ".join(f"{c:>9}" for c in cells)
+              + f"  {format_value(total):>9}")
+    print("(median ms after input)")
+
+
+# ============================================
+# Output
+# ============================================
+
+COLUMNS = [
+    ("wsClients", "ws"), ("httpPollers", "http"), ("fanoutP50Ms", "p50ms"),
+    ("fanoutP99Ms", "p99ms"), ("dropped", "drop"), ("httpReqPerSec", "req/s"),
+    ("httpP99Ms", "http99"), ("httpReused", "reused"), ("loopsPerSec", "loops/s"), ("maxSensorGapMs", "gapms"),
+    ("minFreeHeap", "minheap"),
+]
+
+
+def format_value(value):
+    if value is None:
+        return "-"
+    if isinstance(value, float):
+        return f"{value:.1f}"
+    return str(value)
+
+
+def print_table(rows):
+    print("  ".join(f"{title:>8}" for _, title in COLUMNS))
+    for row in rows:
+        print("  ".join(f"{format_value(row.get(key)):>8}" for key, _ in COLUMNS))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("host", help="Cube IP address")
+    parser.add_argument("--ws", type=int, default=2, help="WebSocket clients")
+    parser.add_argument("--http", type=int, default=1, help="HTTP /api/status pollers")
+    parser.add_argument("--duration", type=float, default=20, help="Seconds per run")
+    parser.add_argument("--rate", type=float, default=2, help="Actions per second")
+    parser.add_argument("--keepalive", action="store_true", help="HTTP pollers reuse their connection")
+    parser.add_argument("--sweep", help="Comma-separated WebSocket client counts")
+    parser.add_argument("--json", action="store_true", help="Print raw JSON rows")
+    parser.add_argument("--latency", type=int, metavar="N",
+                        help="Stage breakdown of N traced flips and web actions")
+    args = parser.parse_args()
+
+    if args.latency:
+        print(f"Tracing {args.latency} flips and {args.latency} web actions...")
+        rows = LatencyRun(args.host, args.latency).run()
+        if args.json:
+            print(json.dumps(rows, indent=2))
+        else:
+            print_latency(rows)
+        return
+
+    counts = [int(n) for n in args.sweep.split(",")] if args.sweep else [args.ws]
+    rows = []
+    for count in counts:
+        print(f"Running {count} WebSocket + {args.http} HTTP clients for {args.duration:.0f}s...")
+        rows.append(LoadRun(args.host, count, args.http, args.duration, args.rate, args.keepalive).run())
+        time.sleep(2)  # Let the device recover between points
+
+    if args.json:
+        print(json.dumps(rows, indent=2))
+    else:
+        print_table(rows)
+
+
+if __name__ == "__main__":
+    main()
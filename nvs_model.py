@@ -0,0 +1,648 @@
+#!/usr/bin/env python3
+"""Model flash wear of the cube's NVS writes (ESP-IDF page/entry layout)
+
+Replays NVS writes - a trace collected from a real device, or a scripted
+day that mirrors the firmware's save functions - through a model of the
+ESP-IDF NVS storage and counts entry writes, skipped (unchanged) writes,
+garbage collections and page erases, then projects the partition's
+lifetime.
+
+Usage:
+    python3 nvs_model.py collect 192.168.1.50 --minutes 60 -o day.jsonl
+    python3 nvs_model.py replay day.jsonl --partition 0x5000,0x6000
+    python3 nvs_model.py script --day heavy --days 60
+    python3 nvs_model.py script --day heavy --strategy current,tasks-blob,debounce:60
+
+Model (ESP-IDF nvs_flash, "v2" format):
+- 4096-byte pages: 32-byte header, 32-byte entry state bitmap,
+  126 entries of 32 bytes
+- Primitive items take 1 entry, strings 1 + ceil(len/32) (len includes
+  the terminator), blobs add one more entry for the blob index
+- A write whose value equals the stored one is skipped
+- Otherwise the new item is appended to the active page and the old one
+  is marked erased (a bitmap write, not a flash erase)
+- An item never spans pages; a page that cannot fit it is marked full
+- When only the reserved free page is left, the full page with the most
+  erased entries is compacted into it and then erased
+"""
+
+import argparse
+import collections
+import heapq
+import json
+import math
+import struct
+import sys
+import time
+import urllib.request
+
+PAGE_SIZE = 4096
+ENTRY_SIZE = 32
+ENTRIES_PER_PAGE = 126
+
+TYPE_U8 = 0x01
+TYPE_U16 = 0x02
+TYPE_U32 = 0x04
+TYPE_STR = 0x21
+TYPE_BLOB = 0x42
+
+DEFAULT_PARTITIONS = [0x5000, 0x6000, 0x10000]   # 0x5000 = Arduino default
+DEFAULT_ENDURANCE = 100000                       # Erase cycles per sector
+DAY_MS = 24 * 3600 * 1000
+
+# sizeof(TaskInfo) with padding (id, name[32], focus, break, completed, started)
+TASK_INFO_SIZE = 44
+MAX_TASKS = 10
+
+
+class NvsFullError(Exception):
+    pass
+
+
+def entry_span(item_type, size):
+    if item_type == TYPE_STR:
+        return 1 + math.ceil(size / ENTRY_SIZE)
+    if item_type == TYPE_BLOB:
+        return 2 + math.ceil(size / ENTRY_SIZE)
+    return 1
+
+
+def value_hash(data):
+    """Same FNV-1a fold as NvsWriteLog::hash()"""
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return (h >> 16) ^ (h & 0xFFFF)
+
+
+# ============================================
+# NVS storage model
+# ============================================
+
+class Page:
+    def __init__(self, index):
+        self.index = index
+        self.erase_count = 0
+        self.reset()
+
+    def reset(self):
+        self.next_free = 0
+        self.erased = 0
+        self.live = {}  # item id -> (full key, span, hash)
+
+    def room(self):
+        return ENTRIES_PER_PAGE - self.next_free
+
+
+class NvsModel:
+    def __init__(self, partition_bytes):
+        count = partition_bytes // PAGE_SIZE
+        if count < 3:
+            raise ValueError("NVS needs at least 3 pages")
+        self.pages = [Page(i) for i in range(count)]
+        self.free = collections.deque(self.pages)
+        self.used = []        # Full pages + active page, oldest first
+        self.active = None
+        self.location = {}    # (ns, key) -> (page, item id, span, hash)
+        self.next_item = 0
+
+        self.writes = 0
+        self.skipped = 0
+        self.entries_written = 0
+        self.entries_moved = 0
+        self.gc_runs = 0
+        self.erases = 0
+
+    def write(self, ns, key, item_type, size, hash_):
+        if ("", ns) not in self.location:
+            # First use of a namespace stores its index entry
+            self._store(("", ns), 1, 0)
+
+        self.writes += 1
+        span = entry_span(item_type, size)
+        current = self.location.get((ns, key))
+        if current and current[2] == span and current[3] == hash_:
+            self.skipped += 1
+            return
+        self._store((ns, key), span, hash_)
+
+    def _store(self, full, span, hash_):
+        page = self._page_with_room(span)
+        previous = self.location.get(full)  # Looked up after GC may have moved it
+
+        item = self.next_item
+        self.next_item += 1
+        page.live[item] = (full, span, hash_)
+        page.next_free += span
+        self.entries_written += span
+        self.location[full] = (page, item, span, hash_)
+
+        if previous:
+            old_page, old_item, old_span, _ = previous
+            del old_page.live[old_item]
+            old_page.erased += old_span
+
+    def _page_with_room(self, span):
+        if self.active and self.active.room() >= span:
+            return self.active
+        self._request_new_page()
+        if self.active.room() < span:
+            raise NvsFullError("item does not fit after compaction")
+        return self.active
+
+    def _activate(self):
+        page = self.free.popleft()
+        self.used.append(page)
+        self.active = page
+        return page
+
+    def _request_new_page(self):
+        if len(self.free) >= 2:
+            self._activate()
+            return
+
+        victim = None
+        for page in self.used:
+            if victim is None or page.erased > victim.erased:
+                victim = page
+        if victim is None or victim.erased == 0:
+            raise NvsFullError("no erased entries to reclaim")
+
+        target = self._activate()
+        for item, (full, span, hash_) in victim.live.items():
+            target.live[item] = (full, span, hash_)
+            target.next_free += span
+            self.location[full] = (target, item, span, hash_)
+            self.entries_moved += span
+        self.entries_written += sum(s for _, s, _ in victim.live.values())
+
+        victim.reset()
+        victim.erase_count += 1
+        self.erases += 1
+        self.gc_runs += 1
+        self.used.remove(victim)
+        self.free.append(victim)
+
+
+# ============================================
+# Write streams
+# ============================================
+
+def write_record(ms, ns, key, item_type, data):
+    return {"ms": ms, "ns": ns, "key": key, "type": item_type,
+            "size": len(data), "hash": value_hash(data)}
+
+
+class FirmwareWrites:
+    """Emits the NVS writes the firmware makes for each user action
+
+    Mirrors SystemState::saveState()/saveTasks() and
+    Analytics::saveToNVS()/saveDayToHistory() key for key.
+    """
+
+    def __init__(self):
+        self.records = []
+        self.ms = 0
+        self.day = 0
+        self.next_id = 1000
+        self.tasks = []
+        self.plant_stage = 0
+        self.withered = False
+        self.pending_water = 0
+        self.watered = 0
+        self.daily_goal = 0
+        self.session_goal = 0
+        self.stats = {"tasks": 0, "focus": 0, "break": 0, "sessions": 0}
+        self.stats_dirty = False
+        self.last_stats_save = 0
+
+    def put(self, ns, key, item_type, data):
+        self.records.append(write_record(self.ms, ns, key, item_type, data))
+
+    def put_u8(self, ns, key, value):
+        self.put(ns, key, TYPE_U8, struct.pack("<B", value))
+
+    def put_u16(self, ns, key, value):
+        self.put(ns, key, TYPE_U16, struct.pack("<H", value))
+
+    def put_u32(self, ns, key, value):
+        self.put(ns, key, TYPE_U32, struct.pack("<I", value))
+
+    def put_str(self, ns, key, value):
+        self.put(ns, key, TYPE_STR, value.encode() + b"\0")
+
+    def save_state(self):
+        for key, value in (("plantStage", self.plant_stage), ("plantWithered", int(self.withered)),
+                           ("pendingWater", self.pending_water), ("wateredCount", self.watered),
+                           ("dailyGoal", self.daily_goal), ("sessionGoal", self.session_goal),
+                           ("taskCount", len(self.tasks))):
+            self.put_u8("bloomState", key, value)
+
+    def save_tasks(self):
+        self.put_u8("bloomTasks", "count", len(self.tasks))
+        for i, task in enumerate(self.tasks):
+            self.put_u32("bloomTasks", f"t{i}_id", task["id"])
+            self.put_str("bloomTasks", f"t{i}_name", task["name"])
+            self.put_u16("bloomTasks", f"t{i}_focus", task["focus"])
+            self.put_u16("bloomTasks", f"t{i}_break", task["break"])
+            self.put_u8("bloomTasks", f"t{i}_done", int(task["done"]))
+            self.put_u8("bloomTasks", f"t{i}_start", int(task["started"]))
+
+    def save_stats(self):
+        self.put_str("bloom", "statsDate", f"2026-01-{1 + self.day % 28:02d}")
+        self.put_u8("bloom", "sDayOfWeek", self.day % 7)
+        self.put_u8("bloom", "sTasks", self.stats["tasks"])
+        self.put_u16("bloom", "sFocus", self.stats["focus"])
+        self.put_u16("bloom", "sBreak", self.stats["break"])
+        self.put_u8("bloom", "sSessions", self.stats["sessions"])
+        self.stats_dirty = False
+        self.last_stats_save = self.ms
+
+    def save_history(self):
+        d = self.day % 7
+        self.put_u8("bloom", f"h{d}Tasks", self.stats["tasks"])
+        self.put_u16("bloom", f"h{d}Focus", self.stats["focus"])
+        self.put_u16("bloom", f"h{d}Break", self.stats["break"])
+        self.put_u8("bloom", f"h{d}Sess", self.stats["sessions"])
+        self.put_u8("bloom", f"h{d}Valid", 1)
+
+    def advance(self, minutes):
+        """Let time pass; Analytics saves at most every 5 minutes when dirty"""
+        end = self.ms + int(minutes * 60000)
+        while True:
+            due = self.last_stats_save + 300000
+            if not self.stats_dirty or due > end:
+                break
+            self.ms = max(self.ms, due)
+            self.save_stats()
+        self.ms = end
+
+    # --- User actions (same persistence as SystemState) ---
+
+    def set_goal(self, goal):
+        previous = self.daily_goal
+        self.daily_goal = goal
+        self.session_goal = (goal - previous) & 0xFF if previous else goal  # uint8_t, as on device
+        self.plant_stage = self.pending_water = self.watered = 0
+        self.save_state()
+
+    def add_task(self, name, focus=25, brk=5):
+        if len(self.tasks) >= MAX_TASKS:
+            return
+        self.next_id += 7919
+        self.tasks.append({"id": self.next_id, "name": name, "focus": focus, "break": brk,
+                           "done": False, "started": False})
+        self.save_tasks()
+
+    def delete_task(self, index):
+        task = self.tasks.pop(index)
+        if task["done"] and self.pending_water:
+            self.pending_water -= 1
+        self.save_tasks()
+
+    def focus_session(self, index, minutes=None):
+        """Select, flip down, focus, flip up, confirm complete"""
+        task = self.tasks[index]
+        task["started"] = True
+        self.save_tasks()
+        self.advance(1)
+        self.advance(minutes or task["focus"])
+        self.stats["focus"] += minutes or task["focus"]
+        self.stats["sessions"] += 1
+        self.stats_dirty = True
+        task["done"] = True
+        self.pending_water += 1
+        self.stats["tasks"] += 1
+        self.save_tasks()
+        self.save_state()
+
+    def toggle(self, index):
+        task = self.tasks[index]
+        task["done"] = not task["done"]
+        self.pending_water = self.pending_water + 1 if task["done"] else max(0, self.pending_water - 1)
+        self.save_tasks()
+        self.save_state()
+
+    def water(self):
+        if self.pending_water == 0 or self.plant_stage >= 3:
+            return
+        self.pending_water -= 1
+        self.watered += 1
+        goal = self.session_goal or len(self.tasks)
+        self.plant_stage = 3 if self.watered >= goal else min(2, self.watered)
+        self.save_state()
+
+    def midnight(self):
+        if any(self.stats.values()):
+            self.save_history()
+        self.stats = dict.fromkeys(self.stats, 0)
+        self.save_stats()
+        self.plant_stage = self.pending_water = self.watered = 0
+        self.session_goal = self.daily_goal
+        self.save_state()
+        self.tasks = []
+        self.save_tasks()
+        self.day += 1
+
+
+def scripted_day(cube, profile):
+    """One day of use starting at midnight; ends at the next midnight"""
+    start = cube.ms
+    cube.advance(8 * 60)
+    if profile == "light":
+        cube.set_goal(3)
+        for i in range(3):
+            cube.add_task(f"Task {cube.day}-{i}")
+        for i in range(3):
+            cube.focus_session(i)
+            cube.water()
+            cube.advance(60)
+    else:
+        cube.set_goal(6)
+        for i in range(8):
+            cube.add_task(f"Heavy day {cube.day} task {i}")
+        cube.set_goal(8)
+        cube.delete_task(2)      # Shifts every later slot
+        cube.add_task("Inbox zero")
+        for i in range(len(cube.tasks)):
+            cube.focus_session(i)
+            cube.water()
+            if i % 3 == 0:
+                cube.toggle(i)   # Unticked by mistake...
+                cube.toggle(i)   # ...and ticked again
+            cube.advance(10)
+        cube.delete_task(0)
+        cube.add_task("Plan tomorrow", focus=15)
+    cube.advance(max(0, start + DAY_MS - cube.ms) / 60000)
+    cube.midnight()
+
+
+def scripted_stream(profile, days):
+    cube = FirmwareWrites()
+    for _ in range(days):
+        scripted_day(cube, profile)
+    return cube.records, days * DAY_MS
+
+
+def load_trace(path):
+    records = []
+    duration = None
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            record = json.loads(line)
+            if "durationMs" in record:
+                duration = record["durationMs"]
+            else:
+                records.append(record)
+    if not records:
+        raise SystemExit(f"{path}: no writes recorded")
+    if duration is None:
+        duration = max(1, records[-1]["ms"] - records[0]["ms"])
+    return records, duration
+
+
+def repeat_stream(records, duration, days):
+    """Tile a trace to cover `days` (timestamps shifted per repetition)"""
+    total = days * DAY_MS
+    out = []
+    offset = 0
+    base = records[0]["ms"]
+    while offset < total:
+        for r in records:
+            out.append(dict(r, ms=offset + r["ms"] - base))
+        offset += duration
+    return out, max(total, offset)
+
+
+# ============================================
+# Persistence strategies (transform the write stream)
+# ============================================
+
+def strategy_tasks_blob(records):
+    """saveTasks() as one blob of TaskInfo[] instead of 6 keys per task"""
+    out = []
+    group = []
+
+    def flush():
+        if not group:
+            return
+        h = value_hash(json.dumps([(g["key"], g["hash"]) for g in group]).encode())
+        count = (len(group) - 1) // 6
+        out.append({"ms": group[0]["ms"], "ns": "bloomTasks", "key": "tasks",
+                    "type": TYPE_BLOB, "size": 1 + count * TASK_INFO_SIZE, "hash": h})
+        group.clear()
+
+    for r in records:
+        if r["ns"] == "bloomTasks":
+            if group and (r["key"] == "count" or r["ms"] - group[-1]["ms"] > 20):
+                flush()
+            group.append(r)
+        else:
+            flush()
+            out.append(r)
+    flush()
+    return out
+
+
+def strategy_debounce(records, seconds):
+    """Mark dirty and write the latest value `seconds` after the first change"""
+    delay = int(seconds * 1000)
+    pending = {}   # (ns, key) -> record
+    due = []       # heap of (deadline, order, (ns, key))
+    out = []
+    order = 0
+
+    def release(until):
+        while due and due[0][0] <= until:
+            deadline, _, full = heapq.heappop(due)
+            out.append(dict(pending.pop(full), ms=deadline))
+
+    for r in records:
+        release(r["ms"])
+        full = (r["ns"], r["key"])
+        if full not in pending:
+            order += 1
+            heapq.heappush(due, (r["ms"] + delay, order, full))
+        pending[full] = r
+    release(float("inf"))
+    out.sort(key=lambda r: r["ms"])
+    return out
+
+
+def apply_strategy(name, records):
+    if name == "current":
+        return records
+    if name == "tasks-blob":
+        return strategy_tasks_blob(records)
+    if name.startswith("debounce:"):
+        return strategy_debounce(records, float(name.split(":", 1)[1]))
+    raise SystemExit(f"Unknown strategy '{name}' (current, tasks-blob, debounce:<s>)")
+
+
+# ============================================
+# Simulation + report
+# ============================================
+
+def simulate(records, duration_ms, partition, endurance):
+    model = NvsModel(partition)
+    error = None
+    try:
+        for r in records:
+            model.write(r["ns"], r["key"], r["type"], r["size"], r["hash"])
+    except NvsFullError as e:
+        error = str(e)
+
+    days = duration_ms / DAY_MS
+    worst = max(p.erase_count for p in model.pages)
+    worst_per_day = worst / days
+    years = endurance / worst_per_day / 365 if worst_per_day else float("inf")
+    return {
+        "partition": partition,
+        "pages": len(model.pages),
+        "days": days,
+        "writesPerDay": model.writes / days,
+        "skippedPct": 100.0 * model.skipped / model.writes if model.writes else 0.0,
+        "entriesPerDay": model.entries_written / days,
+        "movedPerDay": model.entries_moved / days,
+        "gcPerDay": model.gc_runs / days,
+        "erasesPerDay": model.erases / days,
+        "worstPageErasesPerDay": worst_per_day,
+        "lifetimeYears": years,
+        "error": error,
+    }
+
+
+COLUMNS = [
+    ("strategy", "strategy", 14), ("partition", "nvs", 7), ("writesPerDay", "puts/d", 8),
+    ("skippedPct", "skip%", 6), ("entriesPerDay", "entries/d", 9), ("gcPerDay", "gc/d", 6),
+    ("erasesPerDay", "erase/d", 7), ("worstPageErasesPerDay", "worst/d", 7),
+    ("lifetimeYears", "years", 8),
+]
+
+
+def format_cell(key, value):
+    if key == "partition":
+        return f"0x{value:X}"
+    if isinstance(value, float):
+        if math.isinf(value):
+            return "inf"
+        return f"{value:.0f}" if value >= 100 else f"{value:.1f}"
+    return str(value)
+
+
+def print_table(rows):
+    print("  ".join(f"{title:>{width}}" for _, title, width in COLUMNS))
+    for row in rows:
+        print("  ".join(f"{format_cell(key, row[key]):>{width}}" for key, _, width in COLUMNS))
+        if row["error"]:
+            print(f"    ! NVS full: {row['error']}")
+
+
+def run_models(records, duration_ms, args):
+    partitions = [int(p, 0) for p in args.partition.split(",")]
+    rows = []
+    for strategy in args.strategy.split(","):
+        stream = apply_strategy(strategy, records)
+        for partition in partitions:
+            row = simulate(stream, duration_ms, partition, args.endurance)
+            row["strategy"] = strategy
+            rows.append(row)
+    if args.json:
+        print(json.dumps(rows, indent=2))
+    else:
+        print_table(rows)
+        print(f"(lifetime = {args.endurance} erase cycles / busiest page's erases per day)")
+
+
+# ============================================
+# Commands
+# ============================================
+
+def cmd_collect(args):
+    """Poll /api/flash and append every NVS write to a JSONL trace"""
+    since = None
+    start = time.monotonic()
+    written = 0
+    lost = 0
+    with open(args.output, "w") as out:
+        while time.monotonic() - start < args.minutes * 60:
+            path = "/api/flash" if since is None else f"/api/flash?since={since}"
+            try:
+                with urllib.request.urlopen(f"http://{args.host}{path}", timeout=5) as response:
+                    data = json.loads(response.read().decode())
+            except (OSError, ValueError) as e:
+                print(f"  poll failed: {e}", file=sys.stderr)
+                time.sleep(args.interval)
+                continue
+
+            if since is None:
+                since = data["nextSeq"]  # Only writes from now on
+                print(f"Collecting from {args.host}: {data.get('nvs')}")
+                continue
+            if data["nextSeq"] < since:
+                print("  device rebooted - continuing from its new log", file=sys.stderr)
+                since = 0
+                continue
+
+            for seq, ms, ns, key, item_type, size, hash_ in data["log"]:
+                lost += seq - since
+                out.write(json.dumps({"seq": seq, "ms": ms, "ns": ns, "key": key,
+                                      "type": item_type, "size": size, "hash": hash_}) + "\n")
+                since = seq + 1
+                written += 1
+            if len(data["log"]) < 16:  # Caught up (device pages 16 per request)
+                time.sleep(args.interval)
+        out.write(json.dumps({"durationMs": int((time.monotonic() - start) * 1000)}) + "\n")
+
+    print(f"Recorded {written} writes to {args.output}" + (f" ({lost} lost)" if lost else ""))
+
+
+def cmd_replay(args):
+    records, duration = load_trace(args.trace)
+    print(f"{len(records)} writes over {duration / 60000:.1f} min, tiled to {args.days} days")
+    stream, total = repeat_stream(records, duration, args.days)
+    run_models(stream, total, args)
+
+
+def cmd_script(args):
+    records, total = scripted_stream(args.day, args.days)
+    print(f"Scripted '{args.day}' day x {args.days}: {len(records) // args.days} puts per day")
+    run_models(records, total, args)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    collect = sub.add_parser("collect", help="Record NVS writes from a device")
+    collect.add_argument("host", help="Cube IP address")
+    collect.add_argument("--minutes", type=float, default=60)
+    collect.add_argument("--interval", type=float, default=1.0, help="Poll interval (s)")
+    collect.add_argument("-o", "--output", default="nvs_trace.jsonl")
+    collect.set_defaults(func=cmd_collect)
+
+    for name, helptext in (("replay", "Model a collected trace"),
+                           ("script", "Model a scripted day of use")):
+        p = sub.add_parser(name, help=helptext)
+        if name == "replay":
+            p.add_argument("trace", help="JSONL from 'collect'")
+        else:
+            p.add_argument("--day", choices=["light", "heavy"], default="heavy")
+        p.add_argument("--days", type=int, default=60, help="Days to simulate")
+        p.add_argument("--partition", default=",".join(hex(p) for p in DEFAULT_PARTITIONS),
+                       help="NVS partition sizes, comma-separated")
+        p.add_argument("--strategy", default="current",
+                       help="current, tasks-blob, debounce:<seconds> (comma-separated)")
+        p.add_argument("--endurance", type=int, default=DEFAULT_ENDURANCE)
+        p.add_argument("--json", action="store_true", help="Print raw JSON rows")
+        p.set_defaults(func=cmd_replay if name == "replay" else cmd_script)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Flash, RAM and loop-latency footprint of every feature profile
+
+Builds the sketch once per profile in FeatureProfile.h with arduino-cli
+(-DBLOOM_PROFILE=<name>) and prints what each one costs. With --port and
+--device it also uploads every build, waits for the cube to come back
+and reads the loop timing from /api/profile.
+
+Usage:
+    python3 profile_footprint.py
+    python3 profile_footprint.py --fqbn esp32:esp32:esp32 --json
+    python3 profile_footprint.py --port /dev/ttyUSB0 --device 192.168.1.50
+"""
+
+import argparse
+import json
+import re
+import subprocess
+import sys
+import time
+import urllib.request
+
+SKETCH_RE = re.compile(r'Sketch uses (\d+) bytes')
+GLOBALS_RE = re.compile(r'Global variables use (\d+) bytes')
+
+def read_profiles(path='FeatureProfile.h'):
+    with open(path, 'r', encoding='utf-8') as f:
+        return re.findall(r'^struct (\w+Profile) : FeatureProfile<', f.read(), re.M)
+
+def build(profile, fqbn, upload_port=None):
+    cmd = ['arduino-cli', 'compile', '--fqbn', fqbn,
+           '--build-property', f'compiler.cpp.extra_flags=-DBLOOM_PROFILE={profile}', '.']
+    if upload_port:
+        cmd[2:2] = ['--upload', '--port', upload_port]
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout + result.stderr)
+        raise SystemExit(f'{profile}: build failed')
+
+    flash = SKETCH_RE.search(result.stdout)
+    ram = GLOBALS_RE.search(result.stdout)
+    return {
+        'profile': profile,
+        'flashBytes': int(flash.group(1)) if flash else None,
+        'staticRamBytes': int(ram.group(1)) if ram else None,
+    }
+
+def read_device(host, timeout):
+    # Boot, WiFi and one full LoopStats window
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        try:
+            with urllib.request.urlopen(f'http://{host}/api/profile', timeout=2) as response:
+                data = json.loads(response.read())
+            if data.get('avgLoopUs'):
+                return data
+        except OSError:
+            pass
+        time.sleep(1)
+    return None
+
+def fmt(value):
+    return '-' if value is None else f'{value:,}'
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--fqbn', default='esp32:esp32:esp32', help='Board for arduino-cli')
+    parser.add_argument('--port', help='Upload each build to this serial port')
+    parser.add_argument('--device', help='Cube IP address (with --port) for loop timing')
+    parser.add_argument('--timeout', type=float, default=60, help='Seconds to wait for the cube after an upload')
+    parser.add_argument('--json', action='store_true', help='Print raw JSON rows')
+    args = parser.parse_args()
+
+    if args.device and not args.port:
+        parser.error('--device needs --port (each profile has to be uploaded)')
+
+    rows = []
+    for profile in read_profiles():
+        print(f'Building {profile}...', file=sys.stderr)
+        row = build(profile, args.fqbn, args.port)
+        if args.device:
+            live = read_device(args.device, args.timeout)
+            row['avgLoopUs'] = live.get('avgLoopUs') if live else None
+            row['freeHeap'] = live.get('freeHeap') if live else None
+        rows.append(row)
+
+    if args.json:
+        print(json.dumps(rows, indent=2))
+        return
+
+    base = rows[0]
+    print(f"{'profile':<18} {'flash':>11} {'vs first':>10} {'static RAM':>11} {'loop us':>8} {'free heap':>10}")
+    for row in rows:
+        delta = None
+        if row['flashBytes'] is not None and base['flashBytes'] is not None:
+            delta = row['flashBytes'] - base['flashBytes']
+        print(f"{row['profile']:<18} {fmt(row['flashBytes']):>11} {fmt(delta):>10} "
+              f"{fmt(row['staticRamBytes']):>11} {fmt(row.get('avgLoopUs')):>8} {fmt(row.get('freeHeap')):>10}")
+
+if __name__ == '__main__':
+    main()
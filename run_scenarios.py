@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Run scenario scripts on a cube via POST /api/scenario
+
+Each file is one scenario in the ScenarioRunner format (see
+ScenarioRunner.h). The cube runs it on virtual time and reports failed
+expectations with line numbers.
+
+Usage:
+    python3 run_scenarios.py 192.168.1.50 scenarios/*.scn
+    python3 run_scenarios.py 192.168.1.50 flip_pause.scn --json
+
+Uses only the standard library. Scenarios reset the cube's state -
+run them against a test cube built with SCENARIO_RUNNER (config.h).
+Without a cube, `make -C host test` runs host/scenarios/ on the host.
+"""
+
+import argparse
+import json
+import sys
+import time
+import urllib.request
+
+
+def run_scenario(host, script, timeout):
+    request = urllib.request.Request(
+        f"http://{host}/api/scenario", data=script.encode(),
+        headers={"Content-Type": "text/plain"}, method="POST")
+    with urllib.request.urlopen(request, timeout=timeout) as response:
+        return json.loads(response.read().decode())
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("host", help="Cube IP address")
+    parser.add_argument("files", nargs="+", help="Scenario files")
+    parser.add_argument("--timeout", type=float, default=30, help="Seconds per scenario")
+    parser.add_argument("--json", action="store_true", help="Print raw JSON results")
+    args = parser.parse_args()
+
+    results = {}
+    failed = 0
+    start = time.monotonic()
+    for path in args.files:
+        with open(path) as f:
+            script = f.read()
+        try:
+            result = run_scenario(args.host, script, args.timeout)
+        except (OSError, ValueError) as e:
+            result = {"passed": False, "failures": [{"line": 0, "message": f"request failed: {e}"}]}
+        results[path] = result
+
+        if not result.get("passed"):
+            failed += 1
+        if not args.json:
+            status = "ok  " if result.get("passed") else "FAIL"
+            print(f"{status} {path}  ({result.get('simulatedS', 0)} s simulated "
+                  f"in {result.get('elapsedMs', 0)} ms)")
+            for failure in result.get("failures", []):
+                print(f"       {path}:{failure['line']}: {failure['message']}")
+            hidden = result.get("failureCount", 0) - len(result.get("failures", []))
+            if hidden > 0:
+                print(f"       ... and {hidden} more")
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+    else:
+        print(f"{len(args.files) - failed}/{len(args.files)} passed "
+              f"in {time.monotonic() - start:.1f} s")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,340 @@
+#!/usr/bin/env python3
+"""Soak test: a simulated year of use, with a heap fragmentation report
+
+Each simulated day is a generated scenario (see ScenarioRunner.h):
+goals, tasks, flip sessions, pauses, confirmations, watering, hundreds
+of web actions and a midnight rollover. It runs on the cube's virtual
+clock via /api/scenario. Every few days a reconnect storm opens and
+drops WebSocket clients. After each day /api/heap is sampled.
+
+The cube needs a test build: SCENARIO_RUNNER true in config.h (without
+it /api/scenario does not exist and the run stops at once), and
+HEAP_TRACKER true for the per-site part of the report.
+
+The report shows free heap, largest block and fragmentation over time.
+It lists every allocation site (HEAP_TRACKER) that still allocates
+after the warm-up - the steady-state sites - and the sites whose live
+bytes keep growing.
+
+--host-build runs the same days without a cube, on host/build/soak_host
+(make -C host): the state code with HeapTracker's operator new, fed
+the scripts on stdin. No web stack and no storms there, and the heap
+numbers are glibc's, but a leaking site shows up in seconds and
+addr2line names it. Exits 1 on scenario failures or live growth.
+
+Usage:
+    python3 soak_test.py 192.168.1.50 --days 365
+    python3 soak_test.py 192.168.1.50 --days 60 --elf build/finall.ino.elf
+    python3 soak_test.py --host-build --days 365
+
+Uses only the standard library (plus load_test.py next to it).
+Resets the cube's state - run it against a test cube.
+"""
+
+import argparse
+import json
+import os
+import random
+import shutil
+import subprocess
+import time
+import urllib.error
+import urllib.request
+
+from load_test import WebSocketClient, http_get_json
+
+WEB_ACTIONS = ["getStatus", "getTasks", "getStatus", "getTasks", "water"]
+
+
+# ============================================
+# Scenario generation
+# ============================================
+
+def generate_day(rng, day):
+    """One day of use as a scenario script, ending past midnight"""
+    lines = [f"# soak day {day}"]
+    if day == 0:
+        lines.append("reset")
+    lines.append("at 07:30")
+    lines.append("ldr 3500")   # Revives the plant if last night withered it
+    lines.append("wait 5s")
+    lines.append("ldr 0")
+
+    goal = rng.randint(2, 6)
+    lines.append(f"web setGoal goal={goal}")
+    tasks = []
+    for i in range(rng.randint(goal, min(goal + 3, 9))):
+        name = f"d{day}-t{i}"
+        focus = rng.choice([15, 25, 45])
+        tasks.append((name, focus))
+        lines.append(f'task "{name}" {focus} {rng.choice([5, 10])}')
+
+    for name, focus in tasks:
+        # Chatter from open web pages
+        for _ in range(rng.randint(10, 40)):
+            lines.append(f"web {rng.choice(WEB_ACTIONS)}")
+
+        roll = rng.random()
+        if roll < 0.1:
+            lines.append(f'web deleteTask task="{name}"')
+            continue
+        if roll < 0.25:
+            continue   # Left unfinished
+
+        lines.append(f'web selectTask task="{name}"')
+        lines.append("flip down")
+        # Stay inside the focus phase so the flip up asks for confirmation
+        first = rng.randint(1, focus // 2)
+        lines.append(f"wait {first}m")
+        if rng.random() < 0.3:
+            lines.append("flip up")               # Pause, then say it was accidental
+            lines.append("web cancelComplete")
+            lines.append("wait 30s")
+            lines.append("flip down")
+            lines.append(f"wait {rng.randint(1, focus - first - 1)}m")
+        lines.append("flip up")
+        lines.append("web confirmComplete")
+        lines.append("web water")
+        if rng.random() < 0.1:
+            lines.append(f'web toggleTask task="{name}"')
+            lines.append(f'web toggleTask task="{name}"')
+        lines.append("wait 20s")
+
+    lines.append("midnight")
+    return "\n".join(lines) + "\n"
+
+
+def run_scenario(host, script, timeout=120):
+    request = urllib.request.Request(
+        f"http://{host}/api/scenario", data=script.encode(),
+        headers={"Content-Type": "text/plain"}, method="POST")
+    try:
+        with urllib.request.urlopen(request, timeout=timeout) as response:
+            return json.loads(response.read().decode())
+    except urllib.error.HTTPError as e:
+        if e.code == 404:
+            raise SystemExit(f"{host} has no /api/scenario: flash a build with "
+                             "SCENARIO_RUNNER true in config.h") from None
+        raise
+
+
+class HostSoak:
+    """host/build/soak_host in place of a cube: a day's script in, one JSON line out"""
+
+    def __init__(self, binary):
+        if not os.access(binary, os.X_OK):
+            raise SystemExit(f"{binary} not found: build it with make -C host")
+        self.binary = binary
+        self.proc = subprocess.Popen([binary], stdin=subprocess.PIPE,
+                                     stdout=subprocess.PIPE, text=True)
+
+    def run_day(self, script, reset):
+        self.proc.stdin.write(script + ("%% sample reset\n" if reset else "%% sample\n"))
+        self.proc.stdin.flush()
+        line = self.proc.stdout.readline()
+        if not line:
+            raise SystemExit(f"{self.binary} exited with {self.proc.wait()}")
+        result = json.loads(line)
+        return result, with_site_table(result.pop("heap"))
+
+    def close(self):
+        self.proc.stdin.close()
+        self.proc.wait()
+
+
+def reconnect_storm(host, clients, rounds):
+    """Open clients, let them receive the initial sync, drop them without a close frame"""
+    for _ in range(rounds):
+        open_clients = []
+        for _ in range(clients):
+            try:
+                open_clients.append(WebSocketClient(host))
+            except (OSError, ConnectionError):
+                pass
+        time.sleep(0.5)
+        for client in open_clients:
+            client.close()
+        time.sleep(0.5)
+
+
+# ============================================
+# Heap sampling
+# ============================================
+
+def read_heap(host, reset=False):
+    """/api/heap with all site pages merged"""
+    heap = http_get_json(host, "/api/heap?reset=1" if reset else "/api/heap")
+    sites = list(heap["sites"])
+    offset = heap["nextOffset"]
+    while offset:
+        page = http_get_json(host, f"/api/heap?offset={offset}")
+        sites += page["sites"]
+        offset = page["nextOffset"]
+    heap["sites"] = sites
+    return with_site_table(heap)
+
+
+def with_site_table(heap):
+    """/api/heap's [index, addr, allocs, frees, live, peak] rows keyed by index"""
+    heap["sites"] = {s[0]: {"addr": s[1], "allocs": s[2], "frees": s[3],
+                            "liveBytes": s[4], "peakLiveBytes": s[5]} for s in heap["sites"]}
+    return heap
+
+
+def slope(points):
+    """Least-squares slope of [(x, y)]"""
+    n = len(points)
+    if n < 2:
+        return 0.0
+    mx = sum(x for x, _ in points) / n
+    my = sum(y for _, y in points) / n
+    sxx = sum((x - mx) ** 2 for x, _ in points)
+    return sum((x - mx) * (y - my) for x, y in points) / sxx if sxx else 0.0
+
+
+def resolve(addresses, elf, addr2line="xtensa-esp32-elf-addr2line"):
+    if not elf or not addresses:
+        return {}
+    tool = shutil.which(addr2line)
+    if not tool:
+        print(f"({addr2line} not found - addresses left unresolved)")
+        return {}
+    out = subprocess.run([tool, "-f", "-C", "-e", elf] + [hex(a) for a in addresses],
+                         capture_output=True, text=True).stdout.splitlines()
+    return {a: f"{out[2 * i]} ({out[2 * i + 1].rsplit('/', 1)[-1]})"
+            for i, a in enumerate(addresses) if 2 * i + 1 < len(out)}
+
+
+# ============================================
+# Report
+# ============================================
+
+def report(samples, warm, final, warmup, days_after_warmup, elf, addr2line):
+    """Prints the report; returns the number of sites with live growth"""
+    print("\nHeap over time (sampled after each simulated day)")
+    print(f"{'day':>5}  {'free':>7}  {'largest':>7}  {'minfree':>7}  {'frag‰':>5}  {'tracked':>7}")
+    step = max(1, -(-len(samples) // 24))
+    for s in samples[::step] + ([samples[-1]] if (len(samples) - 1) % step else []):
+        print(f"{s['day']:>5}  {s['freeBytes']:>7}  {s['largestBlock']:>7}  "
+              f"{s['minFreeBytes']:>7}  {s['fragPermille']:>5}  {s['liveBytes']:>7}")
+
+    steady = [s for s in samples if s["day"] >= warmup] or samples
+    free_trend = slope([(s["day"], s["freeBytes"]) for s in steady])
+    block_trend = slope([(s["day"], s["largestBlock"]) for s in steady])
+    frag_trend = slope([(s["day"], s["fragPermille"]) for s in steady])
+    print(f"\nAfter warm-up: free {free_trend:+.1f} B/day, largest block {block_trend:+.1f} B/day, "
+          f"fragmentation {frag_trend:+.2f} ‰/day")
+    if free_trend < -1 or block_trend < -1:
+        days_left = samples[-1]["largestBlock"] / -min(free_trend, block_trend)
+        print(f"  ! Shrinking heap: largest block gone in ~{days_left:.0f} days at this rate")
+
+    if not final.get("tracking"):
+        print("\nFirmware built without HEAP_TRACKER - no per-site report.")
+        return 0
+
+    rows = []
+    for index, site in final["sites"].items():
+        before = warm["sites"].get(index, {"liveBytes": 0})
+        growth = site["liveBytes"] - before["liveBytes"]
+        rows.append((site, site["allocs"] / max(1, days_after_warmup), growth))
+    rows.sort(key=lambda r: -r[1])
+
+    names = resolve([r[0]["addr"] for r in rows if r[0]["addr"]], elf, addr2line)
+    print(f"\nAllocation sites after warm-up ({days_after_warmup} days)")
+    print(f"{'site':>10}  {'allocs/day':>10}  {'live':>7}  {'peak':>7}  {'growth':>7}  flags")
+    for site, per_day, growth in rows:
+        flags = []
+        if per_day > 0:
+            flags.append("steady-state")
+        if growth > 0:
+            flags.append("LIVE GROWTH")
+        addr = f"0x{site['addr']:08x}" if site["addr"] else "overflow"
+        print(f"{addr:>10}  {per_day:>10.1f}  {site['liveBytes']:>7}  {site['peakLiveBytes']:>7}  "
+              f"{growth:>+7}  {' '.join(flags)}  {names.get(site['addr'], '')}")
+    return sum(1 for _, _, growth in rows if growth > 0)
+
+
+# ============================================
+# Main
+# ============================================
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("host", nargs="?", help="Cube IP address")
+    parser.add_argument("--host-build", nargs="?", metavar="BINARY",
+                        const=os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                           "host", "build", "soak_host"),
+                        help="Run on the host build instead of a cube (default host/build/soak_host)")
+    parser.add_argument("--days", type=int, default=365, help="Simulated days")
+    parser.add_argument("--warmup", type=int, default=14, help="Days before site counters reset")
+    parser.add_argument("--storm-every", type=int, default=7, help="Days between reconnect storms")
+    parser.add_argument("--storm-clients", type=int, default=6)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--elf", help="Firmware ELF for addr2line")
+    parser.add_argument("--json", help="Also write raw samples to this file")
+    args = parser.parse_args()
+    if not args.host and not args.host_build:
+        parser.error("give a cube IP address or --host-build")
+
+    local = HostSoak(args.host_build) if args.host_build else None
+    rng = random.Random(args.seed)
+    samples = []
+    warm = None
+    failures = 0
+    start = time.monotonic()
+
+    def check(day, result):
+        if result.get("passed"):
+            return 0
+        first = (result.get("failures") or [{}])[0]
+        print(f"  day {day}: line {first.get('line')}: {first.get('message')}")
+        return 1
+
+    for day in range(args.days):
+        script = generate_day(rng, day)
+        if local:
+            result, heap = local.run_day(script, reset=(day == args.warmup - 1))
+            failures += check(day, result)
+        else:
+            try:
+                failures += check(day, run_scenario(args.host, script))
+            except (OSError, ValueError) as e:
+                failures += 1
+                print(f"  day {day}: scenario request failed: {e}")
+                time.sleep(5)   # Give a rebooting cube time to come back
+
+            if args.storm_every and day % args.storm_every == args.storm_every - 1:
+                reconnect_storm(args.host, args.storm_clients, 3)
+
+            try:
+                heap = read_heap(args.host, reset=(day == args.warmup - 1))
+            except (OSError, ValueError) as e:
+                print(f"  day {day}: heap read failed: {e}")
+                continue
+        if day == args.warmup - 1:
+            warm = heap
+        heap["day"] = day
+        samples.append(heap)
+
+        if day % 30 == 0:
+            print(f"day {day:>3}: free {heap['freeBytes']} largest {heap['largestBlock']} "
+                  f"frag {heap['fragPermille']}‰ ({time.monotonic() - start:.0f} s)")
+
+    if local:
+        local.close()
+    if not samples:
+        raise SystemExit("No heap samples collected")
+    warm = warm or samples[0]
+    print(f"\n{args.days} days simulated in {time.monotonic() - start:.0f} s, {failures} scenario failures")
+    elf, addr2line = (args.host_build, "addr2line") if local else (args.elf, "xtensa-esp32-elf-addr2line")
+    growing = report(samples, warm, samples[-1], args.warmup, max(1, args.days - args.warmup), elf, addr2line)
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(samples, f)
+    if local and (failures or growing):
+        raise SystemExit(1)
+
+
+if __name__ == "__main__":
+    main()